@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t heap_allocs = 0;
+
+static void* counting_malloc(size_t size) {
+    heap_allocs++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ptr, size_t size) {
+    heap_allocs++;
+    return realloc(ptr, size);
+}
+
+#define JSON_MALLOC(size) counting_malloc(size)
+#define JSON_REALLOC(ptr, size) counting_realloc(ptr, size)
+
+#include "../json.h"
+#include "bench.h"
+
+#define ITERATIONS 20000
+
+// Entries of a request sized document: nested objects with short string and number fields
+static void item(bench_buf_t* b, int i) {
+    bench_printf(b, "\"item%d\":{\"name\":\"value%d\",\"count\":%d,\"enabled\":true,\"extra\":null}", i, i, i * 7);
+}
+
+int main() {
+    size_t len;
+    char* json = bench_records("{", ",", "}", 40, item, &len);
+
+    heap_allocs = 0;
+    double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        json_object_t obj;
+        json_parse(json, len, &obj);
+        json_deinit(&obj);
+    }
+    double heap_ns = (now_ns() - start) / ITERATIONS;
+    size_t heap_per_doc = heap_allocs / ITERATIONS;
+
+    heap_allocs = 0;
+    size_t arena_allocs = 0;
+    size_t arena_blocks = 0;
+    start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        json_document_t doc;
+        json_document_t_init(&doc);
+        json_document_t_parse(&doc, json, len);
+        arena_allocs = doc.arena.alloc_count;
+        arena_blocks = doc.arena.block_count;
+        json_document_t_deinit(&doc);
+    }
+    double arena_ns = (now_ns() - start) / ITERATIONS;
+    size_t arena_per_doc = heap_allocs / ITERATIONS;
+
+    heap_allocs = 0;
+    json_parse_opts_t opts = { .flags = JSON_PARSE_BORROW_STRINGS };
+    start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        json_object_t obj;
+        json_parse_ex(json, len, &obj, &opts);
+        json_deinit(&obj);
+    }
+    double borrowed_ns = (now_ns() - start) / ITERATIONS;
+    size_t borrowed_per_doc = heap_allocs / ITERATIONS;
+
+    printf("document size: %zu bytes\n", len);
+    printf("heap:  %8.0f ns/doc, %zu system allocations/doc\n", heap_ns, heap_per_doc);
+    printf("heap, borrowed strings: %8.0f ns/doc, %zu system allocations/doc\n", borrowed_ns, borrowed_per_doc);
+    printf("arena: %8.0f ns/doc, %zu system allocations/doc (%zu arena allocations in %zu blocks)\n",
+           arena_ns, arena_per_doc, arena_allocs, arena_blocks);
+
+    free(json);
+    return 0;
+}
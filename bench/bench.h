@@ -0,0 +1,85 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Helpers shared by the benchmarks. A new workload is best added to bench/suite.c as a corpus or a stage,
+// a separate benchmark is only worth it for comparing code paths the suite can't express
+
+/**
+ * @brief - Text a benchmark input is printed into, grown as needed
+ * @property data - The text so far, null terminated
+ * @property len - Length of data
+ * @property cap - Size of the allocation behind data
+ */
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+} bench_buf_t;
+
+static inline double now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static inline void bench_buf_init(bench_buf_t* b, size_t cap) {
+    b->cap = cap < 64 ? 64 : cap;
+    b->data = malloc(b->cap);
+    b->data[0] = '\0';
+    b->len = 0;
+}
+
+static inline void bench_printf(bench_buf_t* b, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static inline void bench_printf(bench_buf_t* b, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(b->data + b->len, b->cap - b->len, fmt, args);
+    va_end(args);
+
+    if ((size_t)n >= b->cap - b->len) {
+        while ((size_t)n >= b->cap - b->len) {
+            b->cap *= 2;
+        }
+        b->data = realloc(b->data, b->cap);
+        if (b->data == NULL) {
+            fprintf(stderr, "out of memory building a benchmark input\n");
+            exit(1);
+        }
+
+        va_start(args, fmt);
+        vsnprintf(b->data + b->len, b->cap - b->len, fmt, args);
+        va_end(args);
+    }
+
+    b->len += n;
+}
+
+/**
+ * @brief - Builds `open`, `count` records separated by `sep`, then `close`
+ * @param record - prints record `i` into the buffer
+ * @param len - set to the length of the text
+ * @return the text, release it with free
+ */
+static inline char* bench_records(const char* open, const char* sep, const char* close, int count,
+                                  void (*record)(bench_buf_t*, int), size_t* len) {
+    bench_buf_t b;
+    bench_buf_init(&b, (size_t)count * 64);
+
+    bench_printf(&b, "%s", open);
+    for (int i = 0; i < count; i++) {
+        bench_printf(&b, "%s", i == 0 ? "" : sep);
+        record(&b, i);
+    }
+    bench_printf(&b, "%s", close);
+
+    *len = b.len;
+    return b.data;
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../json.h"
+#include "bench.h"
+
+#define LOOKUPS 100
+
+// Named entries of a configuration style document, a few settings each
+static void service(bench_buf_t* b, int i) {
+    bench_printf(b, "\"service%d\":{\"host\":\"10.0.%d.%d\",\"port\":%d,\"weight\":%d.5,\"enabled\":true,\"tags\":[\"a\",\"b\"]}",
+                 i, i / 256 % 256, i % 256, 8000 + i % 1000, i % 10);
+}
+
+int main() {
+    const int sizes[] = { 1000, 10000, 100000 };
+    const char* path = "/tmp/json_bench_binary.cjb";
+
+    printf("%-9s %10s %10s %14s %14s\n", "entries", "json KB", "image KB", "parse+get ms", "mmap+get ms");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t len;
+        char* json = bench_records("{", ",", "}", sizes[s], service, &len);
+
+        json_object_t obj;
+        json_parse(json, len, &obj);
+        json_binary_write_file(&obj, path);
+        json_deinit(&obj);
+
+        char key[32];
+        int64_t port = 0;
+
+        // Startup the usual way: parse the whole document, then read a few settings
+        double start = now_ns();
+        json_object_t doc;
+        json_parse(json, len, &doc);
+        for (int i = 0; i < LOOKUPS; i++) {
+            sprintf(key, "service%d", (i * 7919) % sizes[s]);
+            json_object_t* service = json_object_map_t_get(doc.val.obj, key);
+            port += json_object_map_t_get(service->val.obj, "port")->val.integer;
+        }
+        double parsed = now_ns() - start;
+        json_deinit(&doc);
+
+        // Startup from the cached image: map it and read the same settings in place
+        start = now_ns();
+        json_binary_t bin;
+        json_binary_t_open_file(&bin, path);
+        json_binary_ref_t root = json_binary_t_root(&bin);
+        size_t image_len = bin.len;
+        for (int i = 0; i < LOOKUPS; i++) {
+            sprintf(key, "service%d", (i * 7919) % sizes[s]);
+            json_binary_ref_t service, v;
+            int64_t p = 0;
+            json_binary_ref_t_get(root, key, &service);
+            json_binary_ref_t_get(service, "port", &v);
+            json_binary_ref_t_int64(v, &p);
+            port -= p;
+        }
+        json_binary_t_close(&bin);
+        double mapped = now_ns() - start;
+
+        if (port != 0) {
+            printf("lookups disagree\n");
+            return 1;
+        }
+
+        printf("%-9d %10zu %10zu %14.3f %14.3f\n", sizes[s], len / 1024, image_len / 1024, parsed / 1e6, mapped / 1e6);
+        free(json);
+    }
+
+    unlink(path);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <stdlib.h>
+
+// Tracks live heap bytes so per document key memory shows up
+static size_t live_bytes = 0;
+static size_t peak_bytes = 0;
+
+static void* tracking_malloc(size_t size) {
+    size_t* p = malloc(size + sizeof(size_t));
+    if (p == NULL) return NULL;
+    *p = size;
+    live_bytes += size;
+    if (live_bytes > peak_bytes) peak_bytes = live_bytes;
+    return p + 1;
+}
+
+static void* tracking_realloc(void* ptr, size_t size) {
+    size_t old = ptr != NULL ? ((size_t*)ptr)[-1] : 0;
+    size_t* p = realloc(ptr != NULL ? (size_t*)ptr - 1 : NULL, size + sizeof(size_t));
+    if (p == NULL) return NULL;
+    *p = size;
+    live_bytes += size - old;
+    if (live_bytes > peak_bytes) peak_bytes = live_bytes;
+    return p + 1;
+}
+
+static void tracking_free(void* ptr) {
+    if (ptr == NULL) return;
+    live_bytes -= ((size_t*)ptr)[-1];
+    free((size_t*)ptr - 1);
+}
+
+#define JSON_MALLOC(size) tracking_malloc(size)
+#define JSON_REALLOC(ptr, size) tracking_realloc(ptr, size)
+#define JSON_FREE(ptr) tracking_free(ptr)
+
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MESSAGES 50000
+
+// Parses every message and keeps them all alive, the way a batch waiting to be processed would be
+static double run(char** messages, size_t* lens, json_intern_t* intern, size_t* peak) {
+    json_object_t* docs = malloc(MESSAGES * sizeof(json_object_t));
+    json_parse_opts_t opts = { .intern = intern };
+    size_t base = live_bytes;
+    peak_bytes = live_bytes;
+
+    double start = now_ns();
+    for (int i = 0; i < MESSAGES; i++) {
+        json_parse_ex(messages[i], lens[i], &docs[i], &opts);
+    }
+    double elapsed = now_ns() - start;
+    *peak = peak_bytes - base;
+
+    for (int i = 0; i < MESSAGES; i++) {
+        json_deinit(&docs[i]);
+    }
+    free(docs);
+    return elapsed;
+}
+
+int main() {
+    char** messages = malloc(MESSAGES * sizeof(char*));
+    size_t* lens = malloc(MESSAGES * sizeof(size_t));
+    for (int i = 0; i < MESSAGES; i++) {
+        messages[i] = malloc(512);
+        lens[i] = sprintf(messages[i], "{\"timestamp\": %d, \"service_name\": \"svc%d\", \"request_identifier\": %d,"
+                                       " \"http_status_code\": 200, \"response_time_ms\": %d.5, \"client\": {\"ip_address\": \"10.0.0.%d\","
+                                       " \"user_agent_string\": \"agent\", \"geo_region\": \"eu\"}, \"error_message\": null}",
+                          i, i % 13, i * 3, i % 300, i % 250);
+    }
+
+    size_t copied_peak, interned_peak;
+    double copied = run(messages, lens, NULL, &copied_peak);
+
+    json_intern_t intern;
+    json_intern_t_init(&intern);
+    double interned = run(messages, lens, &intern, &interned_peak);
+
+    json_intern_stats_t stats;
+    json_intern_t_stats(&intern, &stats);
+
+    printf("copied keys   %7.1f ns/doc  %8.1f KB live\n", copied / MESSAGES, copied_peak / 1e3);
+    printf("interned keys %7.1f ns/doc  %8.1f KB live\n", interned / MESSAGES, interned_peak / 1e3);
+    printf("hit rate %.4f, %zu unique keys in %zu bytes, %.1f KB of copies avoided\n",
+           (double)stats.hits / stats.lookups, stats.unique_keys, stats.bytes_stored, stats.bytes_saved / 1e3);
+
+    json_intern_t_deinit(&intern);
+    for (int i = 0; i < MESSAGES; i++) {
+        free(messages[i]);
+    }
+    free(messages);
+    free(lens);
+    return 0;
+}
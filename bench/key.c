@@ -0,0 +1,46 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOOKUPS 20000000
+
+static void field(bench_buf_t* b, int i) {
+    bench_printf(b, "\"field_%d\": %d", i, i);
+}
+
+int main() {
+    // A handler's view of a request: a few dozen fields, a handful of them looked up on every call
+    json_object_t obj;
+    size_t n;
+    char* buf = bench_records("{\"id\": 1, \"user_authentication_token_identifier\": 2, \"method\": 3, ", ", ", "}", 40, field, &n);
+    json_parse(buf, n, &obj);
+    json_object_map_t* map = obj.val.obj;
+
+    volatile int64_t sink = 0;
+
+    double start = now_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        sink += json_object_map_t_get(map, "id")->val.integer;
+        sink += json_object_map_t_get(map, "method")->val.integer;
+        sink += json_object_map_t_get(map, "user_authentication_token_identifier")->val.integer;
+    }
+    double plain = now_ns() - start;
+
+    start = now_ns();
+    for (int i = 0; i < LOOKUPS; i++) {
+        sink += json_object_map_t_get_key(map, JSON_KEY("id"))->val.integer;
+        sink += json_object_map_t_get_key(map, JSON_KEY("method"))->val.integer;
+        sink += json_object_map_t_get_key(map, JSON_KEY("user_authentication_token_identifier"))->val.integer;
+    }
+    double keyed = now_ns() - start;
+
+    printf("string get  %6.2f ns/lookup\n", plain / LOOKUPS / 3);
+    printf("key handle  %6.2f ns/lookup\n", keyed / LOOKUPS / 3);
+    printf("sum: %lld\n", (long long)sink);
+
+    json_deinit(&obj);
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RECORDS 1000000
+#define ROUNDS 3
+
+// Log shaped records, a couple hundred bytes each
+static void line(bench_buf_t* b, int i) {
+    bench_printf(b, "{\"ts\": %d, \"level\": \"%s\", \"service\": \"api-%d\", \"msg\": \"request handled in %d ms\", "
+                    "\"status\": %d, \"latency\": %d.%03d, \"tags\": [\"edge\", \"v2\"], \"user\": {\"id\": %d, \"tier\": \"free\"}}\n",
+                 1700000000 + i, i % 50 ? "info" : "error", i % 16, i % 300, i % 20 ? 200 : 500, i % 300, i % 1000, i * 7);
+}
+
+int main() {
+    size_t len;
+    char* data = bench_records("", "", "", RECORDS, line, &len);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("%d records, %.1f MB, %ld cpus\n", RECORDS, len / 1e6, cpus);
+
+    // One json_parse per line on a single thread, the baseline
+    double best = 1e30;
+    for (int round = 0; round < ROUNDS; round++) {
+        json_arena_t arena;
+        json_arena_t_init(&arena);
+
+        double start = now_ns();
+        for (const char* p = data; p < data + len;) {
+            const char* nl = memchr(p, '\n', data + len - p);
+            json_object_t obj;
+            json_parse_arena(p, nl - p, &obj, &arena);
+            p = nl + 1;
+        }
+        double elapsed = now_ns() - start;
+        if (elapsed < best) best = elapsed;
+
+        json_arena_t_deinit(&arena);
+    }
+    double baseline = best;
+    printf("json_parse loop  %7.1f MB/s\n", len / (baseline / 1e9) / 1e6);
+
+    for (size_t threads = 1; threads <= (size_t)(cpus > 0 ? cpus : 1) * 2; threads *= 2) {
+        json_lines_opts_t opts = { threads, 0, NULL };
+        best = 1e30;
+
+        for (int round = 0; round < ROUNDS; round++) {
+            json_lines_t lines;
+            json_lines_t_init(&lines);
+
+            double start = now_ns();
+            json_lines_t_parse(&lines, data, len, &opts);
+            double elapsed = now_ns() - start;
+            if (elapsed < best) best = elapsed;
+
+            json_lines_t_deinit(&lines);
+        }
+
+        printf("%2zu threads       %7.1f MB/s  %5.2fx\n", threads, len / (best / 1e9) / 1e6, baseline / best);
+    }
+
+    free(data);
+    return 0;
+}
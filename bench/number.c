@@ -0,0 +1,133 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUMBERS 1000000
+#define ROUNDS 5
+
+static uint64_t rng_state = 0x2545F4914F6CDD1Dull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// NUMBERS null separated numbers of one shape, `kind` picks ids, prices or full precision doubles
+static char* build_numbers(int kind, size_t* len) {
+    bench_buf_t b;
+    bench_buf_init(&b, (size_t)NUMBERS * 24);
+
+    for (int i = 0; i < NUMBERS; i++) {
+        uint64_t r = next_random();
+        switch (kind) {
+            case 0:
+                bench_printf(&b, "%llu", (unsigned long long)(r % 100000000));
+                break;
+
+            case 1:
+                bench_printf(&b, "%llu.%02llu", (unsigned long long)(r % 10000), (unsigned long long)(r >> 32) % 100);
+                break;
+
+            default:
+                bench_printf(&b, "%.17g", (double)(r >> 11) / (double)(1ull << 53) * 1e6);
+                break;
+        }
+
+        // Keeps the terminator bench_printf wrote, the next number goes after it
+        b.len++;
+    }
+
+    *len = b.len;
+    return b.data;
+}
+
+int main() {
+    static const char* kinds[] = { "integers", "prices", "doubles" };
+
+    for (int k = 0; k < 3; k++) {
+        size_t len;
+        char* numbers = build_numbers(k, &len);
+
+        double best_strtod = 1e30;
+        double best_parse = 1e30;
+        double sink = 0;
+
+        for (int round = 0; round < ROUNDS; round++) {
+            double start = now_ns();
+            for (const char* p = numbers; p < numbers + len; p += strlen(p) + 1) {
+                sink += strtod(p, NULL);
+            }
+            double elapsed = now_ns() - start;
+            if (elapsed < best_strtod) best_strtod = elapsed;
+
+            start = now_ns();
+            for (const char* p = numbers; p < numbers + len;) {
+                size_t n = strlen(p);
+                json_object_t obj;
+                double d = 0;
+                if (json_parse(p, n, &obj) != 0 || json_object_t_as_double(&obj, &d) != 0) {
+                    printf("failed to parse %s\n", p);
+                    return 1;
+                }
+                sink += d;
+                p += n + 1;
+            }
+            elapsed = now_ns() - start;
+            if (elapsed < best_parse) best_parse = elapsed;
+        }
+
+        printf("%-9s strtod %6.1f ns/number   json_parse %6.1f ns/number   (%g)\n", kinds[k],
+               best_strtod / NUMBERS, best_parse / NUMBERS, sink);
+        free(numbers);
+    }
+
+    // The same doubles as one document, parsed into a single contiguous array and read back out
+    size_t len;
+    char* numbers = build_numbers(2, &len);
+    char* doc_text = malloc(len + 2);
+    size_t n = 0;
+    doc_text[n++] = '[';
+    for (const char* p = numbers; p < numbers + len; p += strlen(p) + 1) {
+        if (n > 1) doc_text[n++] = ',';
+        size_t l = strlen(p);
+        memcpy(doc_text + n, p, l);
+        n += l;
+    }
+    doc_text[n++] = ']';
+
+    json_document_t doc;
+    json_document_t_init(&doc);
+    double start = now_ns();
+    int rc = json_document_t_parse(&doc, doc_text, n);
+    double parse_elapsed = now_ns() - start;
+    if (rc != 0 || doc.root.tag != ARRAY) {
+        printf("failed to parse the array document\n");
+        return 1;
+    }
+
+    double* out = malloc(NUMBERS * sizeof(double));
+    double best_scan = 1e30;
+    for (int round = 0; round < ROUNDS; round++) {
+        start = now_ns();
+        rc = json_array_t_copy_doubles(doc.root.val.arr, out);
+        double elapsed = now_ns() - start;
+        if (rc != 0) {
+            printf("failed to copy the doubles\n");
+            return 1;
+        }
+        if (elapsed < best_scan) best_scan = elapsed;
+    }
+
+    printf("array     parse %6.1f MB/s   copy_doubles %6.1f GB/s of elements\n",
+           n / (parse_elapsed / 1e9) / 1e6, NUMBERS * sizeof(json_object_t) / best_scan);
+
+    free(out);
+    json_document_t_deinit(&doc);
+    free(doc_text);
+    free(numbers);
+    return 0;
+}
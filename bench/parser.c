@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t heap_allocs = 0;
+
+static void* counting_malloc(size_t size) {
+    heap_allocs++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ptr, size_t size) {
+    heap_allocs++;
+    return realloc(ptr, size);
+}
+
+#define JSON_MALLOC(size) counting_malloc(size)
+#define JSON_REALLOC(ptr, size) counting_realloc(ptr, size)
+
+#include "../json.h"
+#include "bench.h"
+
+#define ITERATIONS 20000
+
+// Line items of a request sized document, with arrays, strings and numbers
+static void item(bench_buf_t* b, int i) {
+    bench_printf(b, "{\"sku\":\"item%d\",\"qty\":%d,\"price\":%d.%02d,\"tags\":[\"a\",\"b\"],\"gift\":false}", i, i % 7 + 1, 10 + i, i % 100);
+}
+
+int main() {
+    size_t len;
+    char* json = bench_records("{\"user\": {\"id\": 42, \"name\": \"Teller\"}, \"items\": [", ",", "]}", 40, item, &len);
+    double total = (double)len * ITERATIONS;
+
+    // A fresh tree on the heap for every request
+    heap_allocs = 0;
+    double start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        json_object_t obj;
+        json_parse(json, len, &obj);
+        json_deinit(&obj);
+    }
+    double heap = now_ns() - start;
+    size_t heap_per_doc = heap_allocs / ITERATIONS;
+
+    // A fresh document arena for every request
+    heap_allocs = 0;
+    start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        json_document_t doc;
+        json_document_t_init(&doc);
+        json_document_t_parse(&doc, json, len);
+        json_document_t_deinit(&doc);
+    }
+    double fresh = now_ns() - start;
+    size_t fresh_per_doc = heap_allocs / ITERATIONS;
+
+    // One parser and one document kept for the whole loop
+    json_parser_t parser;
+    json_parser_t_init(&parser);
+    json_document_t doc;
+    json_document_t_init(&doc);
+
+    heap_allocs = 0;
+    start = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        json_parser_t_parse_document(&parser, &doc, json, len, NULL);
+    }
+    double reused = now_ns() - start;
+    size_t reused_total = heap_allocs;
+
+    json_document_t_deinit(&doc);
+    json_parser_t_deinit(&parser);
+
+    printf("heap tree          %7.1f ns/doc  %6.1f MB/s  %zu allocs/doc\n", heap / ITERATIONS, total / (heap / 1e9) / 1e6, heap_per_doc);
+    printf("fresh document     %7.1f ns/doc  %6.1f MB/s  %zu allocs/doc\n", fresh / ITERATIONS, total / (fresh / 1e9) / 1e6, fresh_per_doc);
+    printf("reused parser+doc  %7.1f ns/doc  %6.1f MB/s  %zu allocs in %d docs\n", reused / ITERATIONS, total / (reused / 1e9) / 1e6,
+           reused_total, ITERATIONS);
+
+    free(json);
+    return 0;
+}
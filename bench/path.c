@@ -0,0 +1,69 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MESSAGES 2000
+#define ROUNDS 500
+
+int main() {
+    // Messages shaped like what a router sees, each evaluated against the same handful of paths
+    json_arena_t arena;
+    json_arena_t_init(&arena);
+    json_object_t* messages = malloc(MESSAGES * sizeof(json_object_t));
+
+    char buf[512];
+    for (int i = 0; i < MESSAGES; i++) {
+        int len = sprintf(buf, "{\"header\": {\"routing\": {\"destination_service\": \"svc-%d\", \"priority\": %d},"
+                                " \"correlation_identifier\": \"c%d\"}, \"payload\": {\"customer\": {\"account_number\": %d,"
+                                " \"region\": \"r%d\"}, \"items\": [%d, %d]}, \"version\": 3}",
+                          i % 17, i % 5, i, i * 7, i % 9, i, i + 1);
+        json_parse_arena(buf, len, &messages[i], &arena);
+    }
+
+    const char* paths[] = { "header.routing.destination_service", "header.routing.priority",
+                            "payload.customer.account_number", "payload.customer.region" };
+    json_path_t compiled[4];
+    for (int p = 0; p < 4; p++) {
+        json_path_t_compile(&compiled[p], paths[p]);
+    }
+
+    // Chained lookups: every level hashes and compares its key again
+    size_t hits = 0;
+    double start = now_ns();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < MESSAGES; i++) {
+            json_object_map_t* root = messages[i].val.obj;
+            json_object_map_t* routing = json_object_map_t_get(json_object_map_t_get(root, "header")->val.obj, "routing")->val.obj;
+            json_object_map_t* customer = json_object_map_t_get(json_object_map_t_get(root, "payload")->val.obj, "customer")->val.obj;
+            hits += json_object_map_t_get(routing, "destination_service") != NULL;
+            hits += json_object_map_t_get(routing, "priority") != NULL;
+            hits += json_object_map_t_get(customer, "account_number") != NULL;
+            hits += json_object_map_t_get(customer, "region") != NULL;
+        }
+    }
+    double chained = now_ns() - start;
+
+    start = now_ns();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < MESSAGES; i++) {
+            for (int p = 0; p < 4; p++) {
+                hits += json_path_t_eval(&compiled[p], &messages[i]) != NULL;
+            }
+        }
+    }
+    double evaluated = now_ns() - start;
+
+    double lookups = (double)MESSAGES * ROUNDS * 4;
+    printf("chained get   %6.1f ns/path\n", chained / lookups);
+    printf("compiled path %6.1f ns/path\n", evaluated / lookups);
+    printf("hits: %zu\n", hits);
+
+    for (int p = 0; p < 4; p++) {
+        json_path_t_deinit(&compiled[p]);
+    }
+    free(messages);
+    json_arena_t_deinit(&arena);
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FIELDS 300
+#define ROUNDS 2000
+
+// One wide record: the requested fields are scattered between hundreds of others, some of them nested
+static char* build_record(size_t* len) {
+    bench_buf_t b;
+    bench_buf_init(&b, FIELDS * 128);
+
+    bench_printf(&b, "{\"person\": {\"name\": \"Teller\", \"age\": 31, \"bio\": \"%s\"}", "lorem ipsum dolor sit amet");
+    for (int i = 0; i < FIELDS; i++) {
+        if (i % 3 == 0) {
+            bench_printf(&b, ", \"field_%d\": {\"values\": [%d, %d.5, \"s%d\"], \"ok\": true}", i, i, i, i);
+        } else {
+            bench_printf(&b, ", \"field_%d\": \"value number %d with some text\"", i, i);
+        }
+
+        if (i == FIELDS / 2) {
+            bench_printf(&b, ", \"meta\": {\"ts\": 1700000000, \"source\": \"api\", \"trace\": [1, 2, 3]}");
+        }
+    }
+    bench_printf(&b, ", \"id\": 42, \"total\": 99.5}");
+
+    *len = b.len;
+    return b.data;
+}
+
+int main() {
+    size_t len;
+    char* json = build_record(&len);
+    printf("record size: %.1f KB, %d fields, 5 requested\n", len / 1e3, FIELDS + 4);
+
+    json_projection_t proj;
+    json_projection_t_init(&proj);
+    json_projection_t_add(&proj, "person.name");
+    json_projection_t_add(&proj, "meta.ts");
+    json_projection_t_add(&proj, "meta.source");
+    json_projection_t_add(&proj, "id");
+    json_projection_t_add(&proj, "total");
+
+    double full = 0, projected = 0;
+    size_t full_bytes = 0, projected_bytes = 0;
+    json_object_t root;
+
+    for (int round = 0; round < ROUNDS; round++) {
+        json_arena_t arena;
+        json_arena_t_init(&arena);
+        double start = now_ns();
+        json_parse_arena(json, len, &root, &arena);
+        full += now_ns() - start;
+        full_bytes = arena.bytes_allocated;
+        json_arena_t_deinit(&arena);
+
+        json_arena_t_init(&arena);
+        json_parse_opts_t opts = { .arena = &arena };
+        start = now_ns();
+        json_parse_projected(json, len, &proj, &root, &opts);
+        projected += now_ns() - start;
+        projected_bytes = arena.bytes_allocated;
+        json_arena_t_deinit(&arena);
+    }
+
+    printf("full      %8.2f us/doc  %7zu bytes\n", full / ROUNDS / 1e3, full_bytes);
+    printf("projected %8.2f us/doc  %7zu bytes\n", projected / ROUNDS / 1e3, projected_bytes);
+
+    json_projection_t_deinit(&proj);
+    free(json);
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#define ORDERS 1000000
+
+static long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static void order(bench_buf_t* b, int i) {
+    bench_printf(b, "{\"id\": %d, \"customer\": \"c%d\", \"amount\": %d.%02d, \"items\": [%d, %d], \"paid\": %s}",
+                 i, i % 5000, i % 500, i % 100, i % 7, i % 11, i % 3 ? "true" : "false");
+}
+
+typedef struct {
+    int next_is_amount;
+    double total;
+} sum_t;
+
+static int sum_key(void* ctx, const char* key, size_t len, int escaped) {
+    ((sum_t*)ctx)->next_is_amount = len == 6 && memcmp(key, "amount", 6) == 0;
+    return 0;
+}
+
+static int sum_number(void* ctx, double value) {
+    sum_t* s = ctx;
+    if (s->next_is_amount) s->total += value;
+    return 0;
+}
+
+int main() {
+    size_t len;
+    char* json = bench_records("[", ",", "]", ORDERS, order, &len);
+    printf("document size: %.1f MB\n", len / 1e6);
+    long base_rss = peak_rss_kb();
+
+    // SAX first so its peak memory isn't hidden behind the tree's
+    json_sax_handler_t handler = { 0 };
+    handler.key = sum_key;
+    handler.number = sum_number;
+
+    sum_t sum = { 0, 0 };
+    double start = now_ns();
+    json_sax_parse(json, len, &handler, &sum);
+    double sax = now_ns() - start;
+    long sax_rss = peak_rss_kb();
+
+    start = now_ns();
+    json_object_t root;
+    json_parse(json, len, &root);
+    double dom_total = 0;
+    for (size_t i = 0; i < root.val.arr->len; i++) {
+        dom_total += json_object_map_t_get(root.val.arr->items[i].val.obj, "amount")->val.number;
+    }
+    json_deinit(&root);
+    double dom = now_ns() - start;
+    long dom_rss = peak_rss_kb();
+
+    printf("sax  %7.1f MB/s  +%6ld KB peak  total %.2f\n", len / (sax / 1e9) / 1e6, sax_rss - base_rss, sum.total);
+    printf("dom  %7.1f MB/s  +%6ld KB peak  total %.2f\n", len / (dom / 1e9) / 1e6, dom_rss - base_rss, dom_total);
+
+    free(json);
+    return 0;
+}
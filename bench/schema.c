@@ -0,0 +1,103 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MESSAGES 200000
+
+typedef struct {
+    int64_t id;
+    char* symbol;
+    double price;
+    int64_t quantity;
+    int buy;
+    char* venue;
+} order_t;
+
+#define ORDER_FIELDS(X)                                \
+    X("id", id, JSON_FIELD_INT64, NULL)                \
+    X("symbol", symbol, JSON_FIELD_STRING, NULL)       \
+    X("price", price, JSON_FIELD_DOUBLE, NULL)         \
+    X("quantity", quantity, JSON_FIELD_INT64, NULL)    \
+    X("buy", buy, JSON_FIELD_BOOL, NULL)               \
+    X("venue", venue, JSON_FIELD_STRING, NULL)
+
+JSON_SCHEMA(order, order_t, ORDER_FIELDS)
+
+// The usual way: build the tree, pull each field out of it, free the tree
+static void decode_dom(const char* json, size_t len, order_t* out) {
+    json_object_t obj;
+    json_parse(json, len, &obj);
+    json_object_map_t* map = obj.val.obj;
+
+    out->id = json_object_map_t_get(map, "id")->val.integer;
+    out->symbol = strdup(json_object_map_t_get(map, "symbol")->val.str);
+    json_object_t_as_double(json_object_map_t_get(map, "price"), &out->price);
+    out->quantity = json_object_map_t_get(map, "quantity")->val.integer;
+    out->buy = json_object_map_t_get(map, "buy")->val.boolean;
+    out->venue = strdup(json_object_map_t_get(map, "venue")->val.str);
+
+    json_deinit(&obj);
+}
+
+int main() {
+    char** messages = malloc(MESSAGES * sizeof(char*));
+    size_t* lens = malloc(MESSAGES * sizeof(size_t));
+    size_t total = 0;
+    for (int i = 0; i < MESSAGES; i++) {
+        messages[i] = malloc(256);
+        lens[i] = sprintf(messages[i], "{\"id\": %d, \"symbol\": \"SYM%d\", \"price\": %d.%02d, \"quantity\": %d,"
+                                       " \"buy\": %s, \"venue\": \"XNAS\", \"client_tag\": \"t%d\"}",
+                          i, i % 500, 100 + i % 900, i % 100, 1 + i % 1000, i % 2 ? "true" : "false", i);
+        total += lens[i];
+    }
+
+    order_t order;
+    double checksum = 0;
+
+    double start = now_ns();
+    for (int i = 0; i < MESSAGES; i++) {
+        decode_dom(messages[i], lens[i], &order);
+        checksum += order.price * order.quantity;
+        free(order.symbol);
+        free(order.venue);
+    }
+    double dom = now_ns() - start;
+
+    start = now_ns();
+    for (int i = 0; i < MESSAGES; i++) {
+        memset(&order, 0, sizeof(order));
+        order_decode(messages[i], lens[i], &order, NULL);
+        checksum -= order.price * order.quantity;
+        order_deinit(&order);
+    }
+    double schema = now_ns() - start;
+
+    // With an arena that's reset per message, strings cost a bump each
+    json_arena_t arena;
+    json_arena_t_init(&arena);
+    start = now_ns();
+    for (int i = 0; i < MESSAGES; i++) {
+        order_decode(messages[i], lens[i], &order, &arena);
+        checksum += order.price * order.quantity;
+        if (i % 1024 == 1023) {
+            json_arena_t_deinit(&arena);
+            json_arena_t_init(&arena);
+        }
+    }
+    double schema_arena = now_ns() - start;
+    json_arena_t_deinit(&arena);
+
+    printf("dom + copy     %7.1f ns/msg  %6.1f MB/s\n", dom / MESSAGES, total / (dom / 1e9) / 1e6);
+    printf("schema (heap)  %7.1f ns/msg  %6.1f MB/s\n", schema / MESSAGES, total / (schema / 1e9) / 1e6);
+    printf("schema (arena) %7.1f ns/msg  %6.1f MB/s\n", schema_arena / MESSAGES, total / (schema_arena / 1e9) / 1e6);
+    printf("checksum: %.2f\n", checksum);
+
+    for (int i = 0; i < MESSAGES; i++) {
+        free(messages[i]);
+    }
+    free(messages);
+    free(lens);
+    return 0;
+}
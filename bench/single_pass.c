@@ -0,0 +1,73 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define DOCUMENT_RECORDS 400000
+
+// A wide object of small records, roughly 30 MB
+static void record(bench_buf_t* b, int i) {
+    bench_printf(b, "\"r%d\":{\"id\":%d,\"name\":\"user%d\",\"score\":%d.5,\"ok\":true}", i, i, i, i % 1000);
+}
+
+static long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Each mode runs in its own process so peak RSS is not shared between them
+static void run(const char* mode) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        waitpid(pid, NULL, 0);
+        return;
+    }
+
+    size_t len;
+    char* json = bench_records("{", ",", "}", DOCUMENT_RECORDS, record, &len);
+    long base_rss = peak_rss_kb();
+
+    double start = now_ns();
+    size_t tokens = 0;
+
+    if (strcmp(mode, "tokenize") == 0) {
+        // The first phase of the old two pass json_parse
+        token_stream_t s;
+        tokenize_json(json, len, &s);
+        tokens = s.len;
+        token_stream_t_deinit(&s);
+    } else if (strcmp(mode, "tokenize+parse") == 0) {
+        // What json_parse used to cost: a full token array alive next to the tree
+        token_stream_t s;
+        tokenize_json(json, len, &s);
+        tokens = s.len;
+
+        json_object_t obj;
+        json_parse(json, len, &obj);
+        token_stream_t_deinit(&s);
+        json_deinit(&obj);
+    } else {
+        json_object_t obj;
+        json_parse(json, len, &obj);
+        json_deinit(&obj);
+    }
+
+    double elapsed = now_ns() - start;
+    printf("%-16s %8.1f ms %8.1f MB/s  extra peak RSS %6ld MB  tokens %zu\n",
+           mode, elapsed / 1e6, len / (elapsed / 1e9) / 1e6, (peak_rss_kb() - base_rss) / 1024, tokens);
+
+    free(json);
+    exit(0);
+}
+
+int main() {
+    run("tokenize");
+    run("tokenize+parse");
+    run("single-pass");
+    return 0;
+}
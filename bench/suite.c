@@ -0,0 +1,370 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Every stage is charged the allocations made while it runs
+static size_t heap_allocs = 0;
+
+static void* counting_malloc(size_t size) {
+    heap_allocs++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ptr, size_t size) {
+    heap_allocs++;
+    return realloc(ptr, size);
+}
+
+#define JSON_MALLOC(size) counting_malloc(size)
+#define JSON_REALLOC(ptr, size) counting_realloc(ptr, size)
+
+#include "../json.h"
+#include "bench.h"
+
+#define ROUNDS 5
+#define MIN_LOOKUPS 200000
+#define DEEP_CHAINS 2000
+#define DEEP_LEVELS 128
+#define NESTED_LEVELS 100000
+#define WIDE_KEYS 100000
+#define STRING_RECORDS 20000
+#define NUMBER_ROWS 40000
+#define NDJSON_LINES 50000
+#define TWEETS 10000
+
+// A regression is a stage whose best time grew by more than this fraction over the baseline
+#define REGRESSION_THRESHOLD 0.10
+
+typedef struct {
+    const char* start;
+    size_t len;
+} span_t;
+
+typedef struct {
+    const char* name;
+    const char* lookup;
+    size_t max_depth;
+    bench_buf_t text;
+    span_t* docs;
+    size_t n_docs;
+} corpus_t;
+
+typedef struct {
+    char corpus[32];
+    char stage[16];
+    double ns_per_op;
+} baseline_row_t;
+
+// Fixed seed xorshift so every run and every machine sees byte identical corpora
+static uint64_t rng_state = 0x9e3779b97f4a7c15ull;
+
+static uint64_t rng() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void corpus_init(corpus_t* c, const char* name, const char* lookup, size_t cap) {
+    c->name = name;
+    c->lookup = lookup;
+    c->max_depth = 0;
+    bench_buf_init(&c->text, cap);
+    c->docs = NULL;
+    c->n_docs = 0;
+}
+
+// Single document corpora, NDJSON is split at newlines instead
+static void corpus_whole(corpus_t* c) {
+    c->docs = malloc(sizeof(span_t));
+    c->docs[0].start = c->text.data;
+    c->docs[0].len = c->text.len;
+    c->n_docs = 1;
+}
+
+static void corpus_lines(corpus_t* c) {
+    c->docs = malloc(sizeof(span_t) * NDJSON_LINES);
+    const char* line = c->text.data;
+    const char* end = c->text.data + c->text.len;
+
+    while (line < end) {
+        const char* nl = memchr(line, '\n', end - line);
+        c->docs[c->n_docs].start = line;
+        c->docs[c->n_docs].len = nl - line;
+        c->n_docs++;
+        line = nl + 1;
+    }
+}
+
+static void build_deep(corpus_t* c) {
+    corpus_init(c, "deep", "[1000].a[0].a[0].a", (size_t)DEEP_CHAINS * DEEP_LEVELS * 8 + 1024);
+    bench_printf(&c->text, "[");
+    for (int i = 0; i < DEEP_CHAINS; i++) {
+        bench_printf(&c->text, "%s", i == 0 ? "" : ",");
+        for (int d = 0; d < DEEP_LEVELS; d++) {
+            bench_printf(&c->text, d % 2 ? "[" : "{\"a\":");
+        }
+        bench_printf(&c->text, "%d", i);
+        for (int d = DEEP_LEVELS - 1; d >= 0; d--) {
+            bench_printf(&c->text, d % 2 ? "]" : "}");
+        }
+    }
+    bench_printf(&c->text, "]");
+    corpus_whole(c);
+}
+
+// A single chain nested far past JSON_PARSE_MAX_DEPTH, parsed with the limit raised to fit
+static void build_nested(corpus_t* c) {
+    corpus_init(c, "nested", "next[2].next[0]", (size_t)NESTED_LEVELS * 24);
+    c->max_depth = NESTED_LEVELS;
+    for (int d = 0; d < NESTED_LEVELS; d++) {
+        bench_printf(&c->text, d % 2 ? "[%d,true," : "{\"id\":%d,\"next\":", d);
+    }
+    bench_printf(&c->text, "null");
+    for (int d = NESTED_LEVELS - 1; d >= 0; d--) {
+        bench_printf(&c->text, d % 2 ? "]" : "}");
+    }
+    corpus_whole(c);
+}
+
+static void build_wide(corpus_t* c) {
+    corpus_init(c, "wide", "key77777", (size_t)WIDE_KEYS * 48);
+    bench_printf(&c->text, "{");
+    for (int i = 0; i < WIDE_KEYS; i++) {
+        bench_printf(&c->text, "%s\"key%d\":%s", i == 0 ? "" : ",", i, i % 4 == 0 ? "true" : i % 4 == 1 ? "null" : "1");
+    }
+    bench_printf(&c->text, "}");
+    corpus_whole(c);
+}
+
+static void build_strings(corpus_t* c) {
+    static const char* words[] = { "lorem", "ipsum", "caf\\u00e9", "dolor", "\\\"quoted\\\"", "sit", "amet\\n", "na\\u00efve" };
+
+    corpus_init(c, "strings", "[500].text", (size_t)STRING_RECORDS * 640);
+    bench_printf(&c->text, "[");
+    for (int i = 0; i < STRING_RECORDS; i++) {
+        bench_printf(&c->text, "%s{\"title\":\"record %d\",\"text\":\"", i == 0 ? "" : ",", i);
+        int words_in_text = 20 + rng() % 40;
+        for (int w = 0; w < words_in_text; w++) {
+            bench_printf(&c->text, "%s%s", w == 0 ? "" : " ", words[rng() % 8]);
+        }
+        bench_printf(&c->text, "\",\"url\":\"https://example.com/r/%016llx\"}", (unsigned long long)rng());
+    }
+    bench_printf(&c->text, "]");
+    corpus_whole(c);
+}
+
+static void build_numbers(corpus_t* c) {
+    corpus_init(c, "numbers", "[500][3]", (size_t)NUMBER_ROWS * 160);
+    bench_printf(&c->text, "[");
+    for (int i = 0; i < NUMBER_ROWS; i++) {
+        bench_printf(&c->text, "%s[%d,%lld,%.6f,%.3e,%d,%.2f]", i == 0 ? "" : ",", i, (long long)(rng() >> 12) - (1ll << 50),
+                     (double)(rng() % 1000000) / 7.0, (double)(rng() % 100000) * 1e-12, (int)(rng() % 256),
+                     (double)(rng() % 100000) / 100.0);
+    }
+    bench_printf(&c->text, "]");
+    corpus_whole(c);
+}
+
+static void build_ndjson(corpus_t* c) {
+    static const char* events[] = { "click", "view", "purchase", "signup" };
+
+    corpus_init(c, "ndjson", "user.id", (size_t)NDJSON_LINES * 256);
+    for (int i = 0; i < NDJSON_LINES; i++) {
+        bench_printf(&c->text, "{\"ts\":%d,\"event\":\"%s\",\"user\":{\"id\":%d,\"country\":\"c%d\"},\"value\":%.2f,\"tags\":[\"t%d\",\"t%d\"]}\n",
+                     1700000000 + i, events[rng() % 4], (int)(rng() % 100000), (int)(rng() % 50),
+                     (double)(rng() % 10000) / 100.0, (int)(rng() % 20), (int)(rng() % 20));
+    }
+    corpus_lines(c);
+}
+
+// Shaped after the search API responses that twitter.json made a standard benchmark input
+static void build_twitter(corpus_t* c) {
+    static const char* langs[] = { "en", "ja", "es", "pt" };
+
+    corpus_init(c, "twitter", "statuses[50].user.screen_name", (size_t)TWEETS * 1400);
+    bench_printf(&c->text, "{\"statuses\":[");
+    for (int i = 0; i < TWEETS; i++) {
+        uint64_t id = 505874924095815681ull + rng() % 1000000;
+        int user = (int)(rng() % 100000);
+        bench_printf(&c->text,
+                     "%s{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"%s\"},"
+                     "\"created_at\":\"Sun Aug 31 00:29:%02d +0000 2014\",\"id\":%llu,\"id_str\":\"%llu\","
+                     "\"text\":\"@user%d \\u3084\\u3063\\u3068 tweet number %d with a link http:\\/\\/t.co\\/%06d\","
+                     "\"source\":\"<a href=\\\"http:\\/\\/twitter.com\\/download\\/iphone\\\" rel=\\\"nofollow\\\">Twitter for iPhone<\\/a>\","
+                     "\"truncated\":false,\"in_reply_to_status_id\":null,\"in_reply_to_user_id\":%s,"
+                     "\"user\":{\"id\":%d,\"id_str\":\"%d\",\"name\":\"User %d\",\"screen_name\":\"user%d\",\"location\":\"\","
+                     "\"description\":\"Just another account \\ud83d\\ude00 number %d\",\"url\":null,"
+                     "\"entities\":{\"description\":{\"urls\":[]}},\"protected\":false,\"followers_count\":%d,"
+                     "\"friends_count\":%d,\"listed_count\":%d,\"favourites_count\":%d,\"utc_offset\":%s,"
+                     "\"verified\":%s,\"statuses_count\":%d,\"lang\":\"%s\"},"
+                     "\"geo\":null,\"coordinates\":null,\"retweet_count\":%d,\"favorite_count\":%d,"
+                     "\"entities\":{\"hashtags\":[{\"text\":\"tag%d\",\"indices\":[%d,%d]}],\"symbols\":[],\"urls\":[],"
+                     "\"user_mentions\":[{\"screen_name\":\"user%d\",\"id\":%d,\"indices\":[0,%d]}]},"
+                     "\"favorited\":false,\"retweeted\":false,\"possibly_sensitive\":%s,\"lang\":\"%s\"}",
+                     i == 0 ? "" : ",", langs[rng() % 4], i % 60, (unsigned long long)id, (unsigned long long)id, user, i,
+                     (int)(rng() % 1000000), rng() % 3 ? "null" : "1186275104", user, user, user, user, i,
+                     (int)(rng() % 5000), (int)(rng() % 2000), (int)(rng() % 50), (int)(rng() % 9000),
+                     rng() % 2 ? "null" : "32400", rng() % 10 ? "false" : "true", (int)(rng() % 90000),
+                     langs[rng() % 4], (int)(rng() % 100), (int)(rng() % 300), i % 97, 10 + i % 20, 14 + i % 20,
+                     user, user, 8 + (int)(user % 6), rng() % 2 ? "false" : "true", langs[rng() % 4]);
+    }
+    bench_printf(&c->text, "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"count\":%d}}", TWEETS);
+    corpus_whole(c);
+}
+
+static void corpus_deinit(corpus_t* c) {
+    free(c->text.data);
+    free(c->docs);
+}
+
+static void report(const corpus_t* c, const char* stage, size_t ops, double best_ns, size_t allocs, int throughput,
+                   const baseline_row_t* baseline, size_t n_baseline, int* regressions) {
+    double ns_per_op = best_ns / ops;
+    double mb_s = throughput ? c->text.len / (best_ns / 1e9) / 1e6 : 0;
+
+    printf("%s,%s,%zu,%zu,%zu,%.1f,%.1f,%.2f\n", c->name, stage, c->text.len, c->n_docs, ops, ns_per_op, mb_s,
+           (double)allocs / ops);
+
+    for (size_t i = 0; i < n_baseline; i++) {
+        if (strcmp(baseline[i].corpus, c->name) == 0 && strcmp(baseline[i].stage, stage) == 0 &&
+            ns_per_op > baseline[i].ns_per_op * (1 + REGRESSION_THRESHOLD)) {
+            fprintf(stderr, "regression: %s %s %.1f ns/op, baseline %.1f ns/op (%+.0f%%)\n", c->name, stage, ns_per_op,
+                    baseline[i].ns_per_op, (ns_per_op / baseline[i].ns_per_op - 1) * 100);
+            (*regressions)++;
+        }
+    }
+}
+
+static void run(const corpus_t* c, const baseline_row_t* baseline, size_t n_baseline, int* regressions) {
+    json_object_t* objs = malloc(sizeof(json_object_t) * c->n_docs);
+    json_parse_opts_t opts = { .max_depth = c->max_depth };
+    double best[4] = { 1e30, 1e30, 1e30, 1e30 };
+    size_t allocs[4] = { 0 };
+
+    json_path_t path;
+    if (json_path_t_compile(&path, c->lookup) != 0) {
+        fprintf(stderr, "bad lookup %s\n", c->lookup);
+        exit(1);
+    }
+
+    // Lookups are too quick to time one at a time, so each document is queried until the total is measurable
+    size_t repeat = (MIN_LOOKUPS + c->n_docs - 1) / c->n_docs;
+    size_t found = 0;
+
+    for (int round = 0; round < ROUNDS; round++) {
+        size_t before = heap_allocs;
+        double start = now_ns();
+        for (size_t i = 0; i < c->n_docs; i++) {
+            token_stream_t s;
+            if (tokenize_json(c->docs[i].start, c->docs[i].len, &s) != 0) {
+                fprintf(stderr, "%s failed to tokenize\n", c->name);
+                exit(1);
+            }
+            token_stream_t_deinit(&s);
+        }
+        double elapsed = now_ns() - start;
+        if (elapsed < best[0]) best[0] = elapsed;
+        allocs[0] = heap_allocs - before;
+
+        before = heap_allocs;
+        start = now_ns();
+        for (size_t i = 0; i < c->n_docs; i++) {
+            if (json_parse_ex(c->docs[i].start, c->docs[i].len, &objs[i], &opts) != 0) {
+                fprintf(stderr, "%s failed to parse\n", c->name);
+                exit(1);
+            }
+        }
+        elapsed = now_ns() - start;
+        if (elapsed < best[1]) best[1] = elapsed;
+        allocs[1] = heap_allocs - before;
+
+        before = heap_allocs;
+        found = 0;
+        start = now_ns();
+        for (size_t r = 0; r < repeat; r++) {
+            for (size_t i = 0; i < c->n_docs; i++) {
+                found += json_path_t_eval(&path, &objs[i]) != NULL;
+            }
+        }
+        elapsed = now_ns() - start;
+        if (elapsed < best[2]) best[2] = elapsed;
+        allocs[2] = heap_allocs - before;
+
+        before = heap_allocs;
+        start = now_ns();
+        for (size_t i = 0; i < c->n_docs; i++) {
+            json_deinit(&objs[i]);
+        }
+        elapsed = now_ns() - start;
+        if (elapsed < best[3]) best[3] = elapsed;
+        allocs[3] = heap_allocs - before;
+    }
+
+    if (found != repeat * c->n_docs) {
+        fprintf(stderr, "%s lookup %s missed\n", c->name, c->lookup);
+        exit(1);
+    }
+
+    report(c, "tokenize", c->n_docs, best[0], allocs[0], 1, baseline, n_baseline, regressions);
+    report(c, "parse", c->n_docs, best[1], allocs[1], 1, baseline, n_baseline, regressions);
+    report(c, "deinit", c->n_docs, best[3], allocs[3], 1, baseline, n_baseline, regressions);
+    report(c, "lookup", repeat * c->n_docs, best[2], allocs[2], 0, baseline, n_baseline, regressions);
+
+    json_path_t_deinit(&path);
+    free(objs);
+}
+
+// Reads the corpus, stage and ns_per_op columns of a previous run's output
+static baseline_row_t* load_baseline(const char* file, size_t* n) {
+    FILE* f = fopen(file, "r");
+    if (f == NULL) {
+        fprintf(stderr, "cannot open baseline %s\n", file);
+        exit(1);
+    }
+
+    size_t cap = 64;
+    baseline_row_t* rows = malloc(sizeof(baseline_row_t) * cap);
+    char line[256];
+    *n = 0;
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        baseline_row_t row;
+        if (sscanf(line, "%31[^,],%15[^,],%*u,%*u,%*u,%lf", row.corpus, row.stage, &row.ns_per_op) != 3) {
+            continue;
+        }
+
+        if (*n == cap) {
+            cap *= 2;
+            rows = realloc(rows, sizeof(baseline_row_t) * cap);
+        }
+        rows[(*n)++] = row;
+    }
+
+    fclose(f);
+    return rows;
+}
+
+/**
+ * Runs every stage over every corpus and prints one CSV row per pair:
+ * corpus,stage,bytes,docs,ops,ns_per_op,mb_per_s,allocs_per_op
+ * Given a previous run's output as an argument, stages that got slower are reported on stderr and the exit status is 1
+ */
+int main(int argc, char** argv) {
+    void (*builders[])(corpus_t*) = { build_deep, build_nested, build_wide, build_strings, build_numbers, build_ndjson, build_twitter };
+    size_t n_baseline = 0;
+    baseline_row_t* baseline = argc > 1 ? load_baseline(argv[1], &n_baseline) : NULL;
+    int regressions = 0;
+
+    printf("corpus,stage,bytes,docs,ops,ns_per_op,mb_per_s,allocs_per_op\n");
+    for (size_t i = 0; i < sizeof(builders) / sizeof(builders[0]); i++) {
+        corpus_t c;
+        builders[i](&c);
+        run(&c, baseline, n_baseline, &regressions);
+        fflush(stdout);
+        corpus_deinit(&c);
+    }
+
+    free(baseline);
+    return regressions != 0;
+}
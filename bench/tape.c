@@ -0,0 +1,77 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ORDERS 500000
+#define ROUNDS 5
+
+static void order(bench_buf_t* b, int i) {
+    bench_printf(b, "{\"id\": %d, \"customer\": \"c%d\", \"items\": [%d, %d, {\"sku\": %d}], \"paid\": %s, \"amount\": %d.%02d}",
+                 i, i % 5000, i % 7, i % 11, i, i % 3 ? "true" : "false", i % 500, i % 100);
+}
+
+int main() {
+    size_t len;
+    char* json = bench_records("[", ",", "]", ORDERS, order, &len);
+    printf("document size: %.1f MB\n", len / 1e6);
+
+    double tape_parse = 0, tape_query = 0, dom_parse = 0, dom_query = 0;
+    double tape_total = 0, dom_total = 0;
+    size_t tape_bytes = 0, dom_bytes = 0;
+
+    json_tape_t tape;
+    json_tape_t_init(&tape);
+
+    for (int round = 0; round < ROUNDS; round++) {
+        // The tape keeps its buffers between rounds, the arena is rebuilt like a fresh parse would be
+        double start = now_ns();
+        json_tape_t_parse(&tape, json, len);
+        double mid = now_ns();
+
+        json_tape_iter_t it;
+        json_tape_ref_t order, amount;
+        double amount_value;
+        json_tape_iter_t_init(&it, json_tape_t_root(&tape));
+        while (json_tape_iter_t_next(&it, NULL, NULL, &order)) {
+            // "amount" sits behind the nested items, which the lookup hops over
+            json_tape_ref_t_get(order, "amount", &amount);
+            json_tape_ref_t_double(amount, &amount_value);
+            tape_total += amount_value;
+        }
+        double end = now_ns();
+
+        tape_parse += mid - start;
+        tape_query += end - mid;
+        tape_bytes = tape.len * sizeof(uint64_t) + tape.strings_len;
+
+        json_arena_t arena;
+        json_arena_t_init(&arena);
+        json_object_t root;
+
+        start = now_ns();
+        json_parse_arena(json, len, &root, &arena);
+        mid = now_ns();
+
+        json_array_t* orders = root.val.arr;
+        for (size_t i = 0; i < orders->len; i++) {
+            dom_total += json_object_map_t_get(orders->items[i].val.obj, "amount")->val.number;
+        }
+        end = now_ns();
+
+        dom_parse += mid - start;
+        dom_query += end - mid;
+        dom_bytes = arena.bytes_allocated;
+        json_arena_t_deinit(&arena);
+    }
+
+    printf("tape parse %7.1f MB/s  query %6.2f ms  %6.1f MB  total %.2f\n",
+           len * ROUNDS / (tape_parse / 1e9) / 1e6, tape_query / ROUNDS / 1e6, tape_bytes / 1e6, tape_total / ROUNDS);
+    printf("dom  parse %7.1f MB/s  query %6.2f ms  %6.1f MB  total %.2f\n",
+           len * ROUNDS / (dom_parse / 1e9) / 1e6, dom_query / ROUNDS / 1e6, dom_bytes / 1e6, dom_total / ROUNDS);
+
+    json_tape_t_deinit(&tape);
+    free(json);
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DOCUMENT_RECORDS 200000
+#define ROUNDS 5
+
+// Pretty printed records with longer string values, the shape ingestion sees most
+static void record(bench_buf_t* b, int i) {
+    bench_printf(b, "    \"record%d\": {\n        \"id\": %d,\n        \"description\": \"Lorem ipsum dolor sit amet consectetur %d\",\n        \"active\": true\n    }",
+                 i, i, i);
+}
+
+int main() {
+    static const char* backends[] = { "scalar", "sse2", "avx2", "neon" };
+
+    size_t len;
+    char* json = bench_records("{\n", ",\n", "\n}\n", DOCUMENT_RECORDS, record, &len);
+    printf("document size: %.1f MB\n", len / 1e6);
+
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+        if (json_simd_set_backend(backends[b]) != 0) {
+            continue;
+        }
+
+        double best_tokenize = 1e30;
+        double best_parse = 1e30;
+        size_t tokens = 0;
+
+        for (int round = 0; round < ROUNDS; round++) {
+            double start = now_ns();
+            token_stream_t s;
+            tokenize_json(json, len, &s);
+            double elapsed = now_ns() - start;
+            tokens = s.len;
+            token_stream_t_deinit(&s);
+            if (elapsed < best_tokenize) best_tokenize = elapsed;
+
+            json_document_t doc;
+            json_document_t_init(&doc);
+            start = now_ns();
+            json_document_t_parse(&doc, json, len);
+            elapsed = now_ns() - start;
+            json_document_t_deinit(&doc);
+            if (elapsed < best_parse) best_parse = elapsed;
+        }
+
+        printf("%-7s tokenize %7.1f MB/s (%zu tokens)   parse %7.1f MB/s\n", backends[b],
+               len / (best_tokenize / 1e9) / 1e6, tokens, len / (best_parse / 1e9) / 1e6);
+    }
+
+    free(json);
+    return 0;
+}
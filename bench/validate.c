@@ -0,0 +1,42 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RECORDS 100000
+#define ROUNDS 20
+
+// Records of a gateway sized payload, mixing text, escapes, UTF-8 and numbers
+static void record(bench_buf_t* b, int i) {
+    bench_printf(b, "{\"id\": %d, \"user\": \"user_%d\", \"text\": \"caf\xc3\xa9 order #%d shipped \\\"today\\\"\\n\","
+                    " \"price\": %d.%02d, \"tags\": [\"a\", \"b\", \"c\"], \"active\": %s, \"note\": null}",
+                 i, i % 1000, i, i % 500, i % 100, i % 2 ? "true" : "false");
+}
+
+int main() {
+    size_t len;
+    char* json = bench_records("[", ",\n  ", "]", RECORDS, record, &len);
+    double total = (double)len * ROUNDS;
+    int rc = 0;
+
+    double start = now_ns();
+    for (int i = 0; i < ROUNDS; i++) {
+        rc |= json_validate(json, len);
+    }
+    double validate = now_ns() - start;
+
+    start = now_ns();
+    for (int i = 0; i < ROUNDS; i++) {
+        json_object_t obj;
+        rc |= json_parse(json, len, &obj);
+        json_deinit(&obj);
+    }
+    double parse = now_ns() - start;
+
+    printf("json_validate         %8.1f MB/s\n", total / (validate / 1e9) / 1e6);
+    printf("json_parse + deinit   %8.1f MB/s\n", total / (parse / 1e9) / 1e6);
+
+    free(json);
+    return rc != 0;
+}
@@ -0,0 +1,89 @@
+#include "../json.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DOCUMENT_RECORDS 100000
+#define ROUNDS 5
+
+// Response shaped records: ids, prices, a measurement array and a string that needs escaping now and then
+static void record(bench_buf_t* b, int i) {
+    bench_printf(b, "{\"id\": %d, \"price\": %d.%02d, \"samples\": [%.17g, %.17g, %.17g], \"note\": \"line %d%s\", \"active\": %s}",
+                 i, i % 1000, i % 100, i / 7.0, i * 1.1, 1.0 / (i + 1), i,
+                 i % 10 == 0 ? "\\nwith \\\"quotes\\\"" : " of plain text", i % 2 ? "true" : "false");
+}
+
+// The hand rolled alternative: printf for every field
+static size_t printf_records(const json_object_t* root, char* out) {
+    const json_array_t* records = json_object_map_t_get(root->val.obj, "records")->val.arr;
+    size_t n = 0;
+
+    n += sprintf(out + n, "{\"records\":[");
+    for (size_t i = 0; i < records->len; i++) {
+        json_object_map_t* r = records->items[i].val.obj;
+        json_array_t* samples = json_object_map_t_get(r, "samples")->val.arr;
+        n += sprintf(out + n, "%s{\"id\":%lld,\"price\":%.17g,\"samples\":[%.17g,%.17g,%.17g],\"note\":\"%s\",\"active\":%s}",
+                     i == 0 ? "" : ",", (long long)json_object_map_t_get(r, "id")->val.integer,
+                     json_object_map_t_get(r, "price")->val.number, samples->items[0].val.number,
+                     samples->items[1].val.number, samples->items[2].val.number,
+                     json_object_map_t_get(r, "note")->val.str,
+                     json_object_map_t_get(r, "active")->val.boolean ? "true" : "false");
+    }
+    n += sprintf(out + n, "]}");
+    return n;
+}
+
+int main() {
+    size_t len;
+    char* json = bench_records("{\"records\": [", ", ", "]}", DOCUMENT_RECORDS, record, &len);
+    printf("document size: %.1f MB\n", len / 1e6);
+
+    double best_parse = 1e30, best_compact = 1e30, best_pretty = 1e30, best_printf = 1e30;
+    size_t compact_len = 0, pretty_len = 0, printf_len = 0;
+    char* printf_buf = malloc(len * 2);
+
+    for (int round = 0; round < ROUNDS; round++) {
+        json_document_t doc;
+        json_document_t_init(&doc);
+
+        double start = now_ns();
+        json_document_t_parse(&doc, json, len);
+        double elapsed = now_ns() - start;
+        if (elapsed < best_parse) best_parse = elapsed;
+
+        json_writer_t w;
+        json_writer_t_init(&w, 0);
+        start = now_ns();
+        json_writer_t_write(&w, &doc.root);
+        elapsed = now_ns() - start;
+        compact_len = w.len;
+        json_writer_t_deinit(&w);
+        if (elapsed < best_compact) best_compact = elapsed;
+
+        json_writer_t_init(&w, JSON_WRITE_PRETTY);
+        start = now_ns();
+        json_writer_t_write(&w, &doc.root);
+        elapsed = now_ns() - start;
+        pretty_len = w.len;
+        json_writer_t_deinit(&w);
+        if (elapsed < best_pretty) best_pretty = elapsed;
+
+        start = now_ns();
+        printf_len = printf_records(&doc.root, printf_buf);
+        elapsed = now_ns() - start;
+        if (elapsed < best_printf) best_printf = elapsed;
+
+        json_document_t_deinit(&doc);
+    }
+
+    printf("parse          %7.1f MB/s\n", len / (best_parse / 1e9) / 1e6);
+    printf("write compact  %7.1f MB/s (%zu bytes)\n", compact_len / (best_compact / 1e9) / 1e6, compact_len);
+    printf("write pretty   %7.1f MB/s (%zu bytes)\n", pretty_len / (best_pretty / 1e9) / 1e6, pretty_len);
+    printf("printf loop    %7.1f MB/s (%zu bytes, no escaping)\n", printf_len / (best_printf / 1e9) / 1e6, printf_len);
+    printf("round trip     %7.1f ms\n", (best_parse + best_compact) / 1e6);
+
+    free(printf_buf);
+    free(json);
+    return 0;
+}
@@ -7,16 +7,70 @@
 #ifndef JSON_H
 #define JSON_H
 
+#include <math.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
-#define TABLE_SIZE 10
+#include <time.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if !defined(JSON_NO_SIMD) && (defined(__x86_64__) || defined(__i386__))
+#define JSON_SIMD_X86
+#include <immintrin.h>
+#elif !defined(JSON_NO_SIMD) && defined(__aarch64__)
+#define JSON_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#define JSON_MAP_START_SLOTS 8
+#define JSON_ARRAY_START_SIZE 8
 #define STREAM_START_SIZE 10
+#define JSON_ARENA_BLOCK_SIZE 65536
+#define JSON_ARENA_MAX_BLOCK_SIZE (16 * 1024 * 1024)
+#define JSON_ARENA_ALIGN 16
+
+#ifndef JSON_MALLOC
+#define JSON_MALLOC(size) malloc(size)
+#endif
+
+#ifndef JSON_REALLOC
+#define JSON_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+
+#ifndef JSON_FREE
+#define JSON_FREE(ptr) free(ptr)
+#endif
 
 #define INDEX_GREATER_THAN_LEN -1
 #define UNEXPECTED_TOKEN -2
+#define ALLOCATION_FAILED -3
+#define IO_ERROR -4
+#define DEPTH_LIMIT_EXCEEDED -5
+
+#define JSON_PUSH_NEED_MORE 1
+#define PUSH_STACK_START_SIZE 8
+#define PUSH_SCRATCH_START_SIZE 64
+#define JSON_WRITER_START_SIZE 256
+#define JSON_WRITER_BUFFER_SIZE 4096
+#define JSON_WRITE_INDENT 4
+#define JSON_LINES_TASK_BYTES 65536
+#define JSON_SAX_MAX_DEPTH 1024
+#define JSON_VALIDATE_MAX_DEPTH 4096
+#define JSON_PARSE_MAX_DEPTH 1024
+#define JSON_PARSE_FRAMES_START_SIZE 16
+#define JSON_WALK_STACK_SIZE 32
+#define JSON_TAPE_START_SIZE 64
+#define JSON_STATS_PROBE_BUCKETS 8
+#define JSON_BINARY_VERSION 1
+#define JSON_BINARY_START_SIZE 4096
+#define JSON_BINARY_KEYS_START_SLOTS 64
 
 /**
  * @brief - Types a JSON value can be
@@ -42,79 +96,125 @@ typedef enum {
      * @brief - NULL values
      */
     NULL_VAL,
+    /**
+     * @brief - String value borrowed from the parsed input, not null terminated and not owned
+     */
+    STRING_VIEW,
+    /**
+     * @brief - A number with no fraction or exponent that fits in an int64_t
+     */
+    INTEGER,
+    /**
+     * @brief - An ordered list of JSON values
+     */
+    ARRAY,
 } value_tag_t;
 
 struct json_object_t;
 
 /**
- * @brief - A linked list structure containing JSON objects at every node, used internally for the hashmap implementation
- * @property key - The name of the field
- * @property value - owned pointer to the value (gets freed at `deinit` time)
- * @property next - Pointer to the next node in this LL
+ * @brief - A single chunk of memory owned by an arena, allocations are bumped out of `data`
+ * @property next - Previously filled block
+ * @property used - Bytes of `data` handed out so far
+ * @property capacity - Total bytes available in `data`
  */
-typedef struct json_object_node_t {
-    char* key;
-    struct json_object_t* value;
-
-    struct json_object_node_t* next;
-} json_object_node_t;
+typedef struct json_arena_block_t {
+    struct json_arena_block_t* next;
+    size_t used;
+    size_t capacity;
+    char* data;
+} json_arena_block_t;
 
 /**
- * @brief - A hashtable of Linked List Json Object Nodes
- * @property table - hash table of linked lists
+ * @brief - A bump allocator that owns every allocation made through it, freed all at once on `deinit`
+ * @property head - Block currently being allocated from
+ * @property block_size - Size of the next block to request from the system
+ * @property alloc_count - Number of allocations served by the arena
+ * @property bytes_allocated - Number of bytes handed out to callers
+ * @property block_count - Number of blocks (system allocations) the arena has made
+ * @property bytes_reserved - Total size of all blocks owned by the arena
  */
 typedef struct {
-    json_object_node_t* table[TABLE_SIZE];
-} json_object_map_t;
+    json_arena_block_t* head;
+    size_t block_size;
+
+    size_t alloc_count;
+    size_t bytes_allocated;
+    size_t block_count;
+    size_t bytes_reserved;
+} json_arena_t;
 
 /**
- * @brief - Hashes a string
- * @param str - the string to hash
- * @return hash number of the string
+ * @brief - Initializes an empty arena, no memory is requested until the first allocation
+ * @param arena - pointer to the arena to initialize
  */
-int hash(const char* str);
+void json_arena_t_init(json_arena_t* arena);
 
 /**
- * @brief - Initializes a JSON Object HashMap
- * @param map - pointer to the HashMap to initialize
+ * @brief - Allocates `size` bytes from the arena, aligned to `JSON_ARENA_ALIGN`
+ * @param arena - pointer to the arena to allocate from
+ * @param size - number of bytes to allocate
+ * @return pointer to the memory, owned by the arena
+ * @return NULL if the system is out of memory
  */
-void json_object_map_t_init(json_object_map_t* map);
+void* json_arena_t_alloc(json_arena_t* arena, size_t size);
 
 /**
- * @brief - Deinitializes and frees all allocated memory for a JSON Object HashMap
- * @param map - pointer to the HashMap to initialize
+ * @brief - Grows an allocation made from the arena, extending it in place when it was the most recent one
+ * @param arena - pointer to the arena the allocation came from
+ * @param ptr - previous allocation (or NULL)
+ * @param old_size - size of the previous allocation
+ * @param new_size - requested size
+ * @return pointer to the (possibly moved) memory
+ * @return NULL if the system is out of memory
  */
-void json_object_map_t_deinit(json_object_map_t* map);
+void* json_arena_t_realloc(json_arena_t* arena, void* ptr, size_t old_size, size_t new_size);
 
 /**
- * @brief - Registers a key value json object pair
- * @param map - pointer to the HashMap to initialize
- * @param key - The name of the object to register
- * @param val - pointer to the json object to register, map will not own the pointer and rather perform a deep clone internally, so you have to free this val itself if you malloc'd it.
+ * @brief - Empties the arena but keeps its memory, invalidating everything allocated from it
+ * When it owns more than one block they are merged into a single block of their combined size,
+ * so refilling it with the same amount of data needs no new blocks
+ * @param arena - pointer to the arena to reset
+ * @return 0 on success
+ * @return ALLOCATION_FAILED if the merged block could not be allocated, the arena is left empty
  */
-void json_object_map_t_insert(json_object_map_t* map, const char* key, struct json_object_t* val);
+int json_arena_t_reset(json_arena_t* arena);
 
 /**
- * @brief - Checks the HashMap for a key, returning a pointer to its JSON object if it exists
- * @param map - Pointer to the HashMap to initialize
- * @param key - Name of the entry to find
- *
- * @return pointer to the JSON object if it exists
- * @return NULL if key doesn't exist
+ * @brief - Frees every block owned by the arena, invalidating everything allocated from it
+ * @param arena - pointer to the arena to deinit
+ */
+void json_arena_t_deinit(json_arena_t* arena);
+
+struct json_object_map_t;
+
+/**
+ * @brief - A pointer and length pair referencing string bytes
+ * @property ptr - first byte of the string
+ * @property len - length in bytes
  */
-struct json_object_t* json_object_map_t_get(json_object_map_t* map, const char* key);
+typedef struct {
+    const char* ptr;
+    size_t len;
+} json_string_view_t;
 
 /**
  * @brief - Union of all different JSON object leaf types
  * @property number - floating point number
+ * @property integer - whole number
  * @property str - string
+ * @property view - borrowed string, `view.ptr` aliases `str` and parsed STRING values keep their length in `view.len` too
  * @property obj - Recursive object map pointer
+ * @property arr - Array pointer
  * @property boolean - bool
  */
 typedef union {
     double number;
+    int64_t integer;
     char* str;
-    json_object_map_t* obj;
+    json_string_view_t view;
+    struct json_object_map_t* obj;
+    struct json_array_t* arr;
     int boolean;
 } value_type_t;
 
@@ -128,194 +228,115 @@ typedef struct json_object_t {
     value_type_t val;
 } json_object_t;
 
-
-/**
- * @brief Parses a JSON buffer into a JSON Object
- * @param json - JSON string buffer
- * @param len - length of the JSON string buffer
- * @param obj - pointer to the JSON object to populate
- * @return 0 on success
- * @return negative number on failure
- */
-int json_parse(const char* json, int len, json_object_t* obj);
-
 /**
- * @brief Frees all memory tied to the JSON Object if it had any heap stored values (sub-objects or strings)
- * Does not free the underlying pointer
- * @param json - JSON object to deinit
+ * @brief - Returns the bytes of a STRING or STRING_VIEW value
+ * @param obj - the value
+ * @param len - set to the length of the string, may be NULL
+ * @return pointer to the first byte, only null terminated for STRING
+ * @return NULL if the value is not a string
  */
-void json_deinit(json_object_t* json);
+const char* json_object_t_string(const json_object_t* obj, size_t* len);
 
 /**
- * @brief - Token Types
+ * @brief - Reads a NUMBER or INTEGER value as a double
+ * @param obj - the value
+ * @param out - set to the number, INTEGER values beyond 2^53 are rounded
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a number
  */
-typedef enum {
-    /**
-     * @brief - {
-     */
-    OPEN_BRACE,
-    /**
-     * @brief - }
-     */
-    CLOSE_BRACE,
-    /**
-     * @brief - [
-     */
-    OPEN_BRACKET,
-    /**
-     * @brief - ]
-     */
-    CLOSE_BRACKET,
-    /**
-     * @brief - "
-     */
-    QUOTATION,
-    /**
-     * @brief - ,
-     */
-    COMMA,
-    /**
-     * @brief - :
-     */
-    COLON,
-
-    /**
-     * @brief - true
-     */
-    TRUE,
-    /**
-     * @brief - false
-     */
-    FALSE,
-    /**
-     * @brief - null
-     */
-    NULL_TAG,
-
-    /**
-     * @brief - a string
-     */
-    STR,
-    /**
-     * @brief - a number
-     */
-    NUM,
-} token_tag_t;
+int json_object_t_as_double(const json_object_t* obj, double* out);
 
 /**
- * @brief - A token with it's type and pointer into the underlying buffer
- * @property start - start of the token in the underlying string
- * @property len - length of the token
- * @property tag - type of the token
+ * @brief - Reads an INTEGER value, or a NUMBER holding an exact whole number, as an int64_t
+ * @param obj - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a whole number that fits in an int64_t
  */
-typedef struct {
-    const char* start;
-    int len;
-    token_tag_t tag;
-} token_t;
+int json_object_t_as_int64(const json_object_t* obj, int64_t* out);
 
 /**
- * @brief prints the token out
- * @param t - pointer to the token to print
+ * @brief - Entry flag set when the key points into the parsed input instead of memory owned by the map
  */
-void token_t_print(token_t* t);
+#define JSON_ENTRY_BORROWED_KEY 1
 
 /**
- * @brief prints the token's value within a buffer
- * @param t - pointer to the token to print
+ * @brief - Entry flag set when the key is owned by a `json_intern_t` and shared with every other map using it
  */
-void token_t_src_print(token_t* t);
+#define JSON_ENTRY_INTERNED_KEY 2
 
 /**
- * @brief - A growing stream of tokens
- * @property items - pointer to the tokens
- * @property len - length of the stream
- * @property capacity - total length of the memory allocated
+ * @brief - A single key value pair stored inline in a map's entry array
+ * @property key - The name of the field (owned by the map unless `JSON_ENTRY_BORROWED_KEY` is set, then not null terminated,
+ *                 or `JSON_ENTRY_INTERNED_KEY`, then shared)
+ * @property key_len - Length of the key in bytes
+ * @property hash - Seeded hash of the key
+ * @property flags - `JSON_ENTRY_*` flags
+ * @property value - The value itself, stored inline (gets deinit'd at `deinit` time)
  */
 typedef struct {
-    token_t* items;
-    int len;
-    int capacity;
-} token_stream_t;
-
-/**
- * @brief initializes a token stream
- * @param s - pointer to the stream to init
- */
-void token_stream_t_init(token_stream_t* s);
+    char* key;
+    size_t key_len;
+    uint64_t hash;
+    unsigned int flags;
+    json_object_t value;
+} json_object_entry_t;
 
 /**
- * @brief frees a token stream
- * @param s - pointer to the stream to free
+ * @brief - An open addressing hashtable of JSON Objects
+ * Entries are stored contiguously in insertion order, while `slots` is a linearly probed index into them.
+ * Each occupied slot packs the upper half of the key's hash next to `entry index + 1` so most probes never touch an entry.
+ * Pointers returned by `get` stay valid until the next insert into the same map.
+ * @property entries - Contiguous key value pairs, in insertion order
+ * @property slots - Power of two sized probe table, 0 marks an empty slot
+ * @property len - Number of entries in the map
+ * @property entries_capacity - Number of entries that fit before `entries` has to grow
+ * @property slot_mask - Number of slots - 1, or 0 when no slots are allocated yet
+ * @property seed - Seed this map's keys were hashed with
+ * @property arena - arena the entries, slots, keys and values are allocated from, NULL for the heap
  */
-void token_stream_t_deinit(token_stream_t* s);
+typedef struct json_object_map_t {
+    json_object_entry_t* entries;
+    uint64_t* slots;
+    size_t len;
+    size_t entries_capacity;
+    size_t slot_mask;
+    uint64_t seed;
+    json_arena_t* arena;
+} json_object_map_t;
 
 /**
- * @brief Pushes a new token to the stream
- * @param s - pointer to the stream to add to
- * @param add - new token to add
+ * @brief - Hashes a byte string with a seed, keys hashed with different seeds are unrelated
+ * @param key - the bytes to hash
+ * @param len - number of bytes in key
+ * @param seed - seed to mix into the hash
+ * @return 64 bit hash of the key
  */
-void token_stream_t_push(token_stream_t* s, token_t add);
+uint64_t json_hash(const char* key, size_t len, uint64_t seed);
 
 /**
- * @brief Tokenizes a string and appends all tokens to a stream
- * @param json - JSON string to tokenize
- * @param size - size of the JSON string
- * @param stream - token stream to append to
+ * @brief - Returns the process wide seed new maps hash their keys with, picking a random one on first use
+ * @return the current seed
  */
-int tokenize_json(const char* json, int size, token_stream_t* stream);
-
-// HASHMAP IMPL
+uint64_t json_hash_seed(void);
 
 /**
- * @brief - Hashes a string
- * @param str - the string to hash
- * @return hash number of the string
+ * @brief - Overrides the process wide hash seed, only maps initialized afterwards use it
+ * @param seed - the new seed
  */
-int hash(const char* str) {
-    if (str == NULL) {
-        return -1;
-    }
-
-    int result = 0;
-    int idx = 0;
-
-    while (str[idx] != '\0') {
-        result += str[idx++];
-    }
-
-    return result;
-}
+void json_set_hash_seed(uint64_t seed);
 
 /**
  * @brief - Initializes a JSON Object HashMap
  * @param map - pointer to the HashMap to initialize
  */
-void json_object_map_t_init(json_object_map_t* map) {
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        map->table[i] = NULL;
-    }
-}
+void json_object_map_t_init(json_object_map_t* map);
 
 /**
  * @brief - Deinitializes and frees all allocated memory for a JSON Object HashMap
  * @param map - pointer to the HashMap to initialize
  */
-void json_object_map_t_deinit(json_object_map_t* map) {
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        json_object_node_t* curr = map->table[i];
-
-        while (curr != NULL) {
-            free(curr->key);
-            json_deinit(curr->value);
-            free(curr->value);
-
-            json_object_node_t* tmp = curr;
-            curr = curr->next;
-            free(tmp);
-        }
-    }
-}
+void json_object_map_t_deinit(json_object_map_t* map);
 
 /**
  * @brief - Registers a key value json object pair
@@ -323,33 +344,18 @@ void json_object_map_t_deinit(json_object_map_t* map) {
  * @param key - The name of the object to register
  * @param val - pointer to the json object to register, map will not own the pointer and rather perform a deep clone internally, so you have to free this val itself if you malloc'd it.
  */
-void json_object_map_t_insert(json_object_map_t* map, const char* key, struct json_object_t* val) {
-    int hashed = hash(key);
-    int idx = hashed % TABLE_SIZE;
-
-    json_object_node_t* curr = map->table[idx];
-
-    json_object_t* clone = malloc(sizeof(json_object_t));
-    *clone = *val;
-
-    while (curr != NULL) {
-        if (strcmp(curr->key, key) == 0) {
-            free(curr->value);
+void json_object_map_t_insert(json_object_map_t* map, const char* key, json_object_t* val);
 
-            curr->value = clone;
-            return;
-        }
-        curr = curr->next;
-    }
-
-    json_object_node_t* new = malloc(sizeof(json_object_node_t));
-    new->next = NULL;
-    new->key = strdup(key);
-    new->value = clone;
-
-    new->next = map->table[idx];
-    map->table[idx] = new;
-}
+/**
+ * @brief - Registers a key value json object pair whose key is not null terminated
+ * @param map - pointer to the HashMap to insert into
+ * @param key - The name of the object to register
+ * @param key_len - Length of the key in bytes
+ * @param val - pointer to the json object to register, copied the same way as `json_object_map_t_insert`
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_object_map_t_insert_n(json_object_map_t* map, const char* key, size_t key_len, json_object_t* val);
 
 /**
  * @brief - Checks the HashMap for a key, returning a pointer to its JSON object if it exists
@@ -359,450 +365,10344 @@ void json_object_map_t_insert(json_object_map_t* map, const char* key, struct js
  * @return pointer to the JSON object if it exists
  * @return NULL if key doesn't exist
  */
-json_object_t* json_object_map_t_get(json_object_map_t* map, const char* key) {
-    int hashed = hash(key);
-    int idx = hashed % TABLE_SIZE;
-
-    json_object_node_t* curr = map->table[idx];
-
-    while (curr != NULL) {
-        if (strcmp(curr->key, key) == 0) {
-            return curr->value;
-        }
+json_object_t* json_object_map_t_get(json_object_map_t* map, const char* key);
 
-        curr = curr->next;
-    }
-
-    return NULL;
-}
+/**
+ * @brief - Checks the HashMap for a key that is not null terminated
+ * @param map - Pointer to the HashMap to search
+ * @param key - Name of the entry to find
+ * @param key_len - Length of the key in bytes
+ *
+ * @return pointer to the JSON object if it exists
+ * @return NULL if key doesn't exist
+ */
+json_object_t* json_object_map_t_get_n(json_object_map_t* map, const char* key, size_t key_len);
 
-// TOKENIZER IMPL
+/**
+ * @brief - A key whose hash is worked out once and cached, for lookups repeated on the hot path
+ * The hash is tied to the seed it was computed with and is recomputed when used with a map seeded differently.
+ * Handles may be shared between threads as long as those threads only use them with maps of the same seed.
+ * @property key - The key bytes, not owned
+ * @property len - Length of the key in bytes
+ * @property hash - Cached hash of the key
+ * @property seed - Seed `hash` was computed with, 0 when nothing is cached yet
+ */
+typedef struct {
+    const char* key;
+    size_t len;
+    uint64_t hash;
+    uint64_t seed;
+} json_key_t;
 
 /**
- * @brief initializes a token stream
- * @param s - pointer to the stream to init
+ * @brief - Expands to a `json_key_t*` for a string literal, backed by one static handle per call site
+ * so the hash is only ever computed the first time that line runs
  */
-void token_stream_t_init(token_stream_t* s) {
-    s->items = malloc(sizeof(token_t) * STREAM_START_SIZE);
-    s->capacity = STREAM_START_SIZE;
-    s->len = 0;
-}
+#define JSON_KEY(literal) ({ static json_key_t json_key_literal_ = { literal, sizeof(literal) - 1, 0, 0 }; &json_key_literal_; })
 
 /**
- * @brief frees a token stream
- * @param s - pointer to the stream to free
+ * @brief - Initializes a key handle and hashes it with the current process wide seed
+ * @param key - pointer to the handle to initialize
+ * @param str - the key bytes, must outlive the handle
+ * @param len - length of str
  */
-void token_stream_t_deinit(token_stream_t* s) {
-    free(s->items);
-    s->capacity=0;
-    s->len=0;
-}
+void json_key_t_init(json_key_t* key, const char* str, size_t len);
 
 /**
- * @brief Pushes a new token to the stream
- * @param s - pointer to the stream to add to
- * @param add - new token to add
+ * @brief - Checks the HashMap for a pre-hashed key, comparing hashes and lengths before any bytes
+ * @param map - Pointer to the HashMap to search
+ * @param key - Handle of the entry to find
+ * @return pointer to the JSON object if it exists
+ * @return NULL if key doesn't exist
  */
-void token_stream_t_push(token_stream_t* s, token_t add) {
-    if (s->capacity == 0) {
-        token_stream_t_init(s);
-    }
+json_object_t* json_object_map_t_get_key(json_object_map_t* map, json_key_t* key);
 
-    if (s->len < s->capacity) {
-        s->items[s->len++] = add;
-        return;
-    }
+/**
+ * @brief - Registers a key value json object pair under a pre-hashed key, copied the same way as `json_object_map_t_insert`
+ * @param map - pointer to the HashMap to insert into
+ * @param key - Handle of the key to register
+ * @param val - pointer to the json object to register
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_object_map_t_insert_key(json_object_map_t* map, json_key_t* key, json_object_t* val);
 
-    s->capacity *= 2;
-    s->items = realloc(s->items, s->capacity * sizeof(token_t));
-    s->items[s->len++] = add;
-}
+#define JSON_INTERN_SHARD_BITS 4
+#define JSON_INTERN_SHARDS (1 << JSON_INTERN_SHARD_BITS)
+#define JSON_INTERN_START_SLOTS 64
 
-static int is_whitespace(char c) {
-    return c == ' ' || c == '\t' || c == '\n';
-}
+/**
+ * @brief - A canonical key held by an intern table
+ * @property key - Null terminated key, NULL marks an empty slot
+ * @property len - Length of the key in bytes
+ * @property hash - Hash of the key under the table's seed
+ */
+typedef struct {
+    const char* key;
+    size_t len;
+    uint64_t hash;
+} json_intern_entry_t;
 
-static int is_alphabetic(char c) {
-    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c  <= 'z') || c == '_';
-}
+/**
+ * @brief - One independently locked slice of an intern table, picked by the top bits of a key's hash
+ * @property lock - Readers probe in parallel, inserting a new key takes it exclusively
+ * @property slots - Power of two sized, linearly probed table of keys
+ * @property slot_mask - Number of slots - 1, or 0 when no slots are allocated yet
+ * @property len - Number of keys in the shard
+ * @property arena - Memory the keys are copied into
+ * @property lookups - Number of keys looked up
+ * @property hits - Number of lookups that found the key already interned
+ * @property bytes_saved - Bytes of key copies hits avoided
+ */
+typedef struct {
+    pthread_rwlock_t lock;
+    json_intern_entry_t* slots;
+    size_t slot_mask;
+    size_t len;
+    json_arena_t arena;
 
-static int is_numeric(char c) {
-    return c >= '0' && c <= '9';
-}
+    size_t lookups;
+    size_t hits;
+    size_t bytes_saved;
+} json_intern_shard_t;
 
-static int is_alphanumeric(char c) {
-    return is_alphabetic(c) || is_numeric(c);
-}
+/**
+ * @brief - A thread safe table mapping every key to one canonical copy, shared by any number of documents
+ * Maps built with it store the canonical pointer instead of a copy, so the table has to outlive them.
+ * @property shards - Slices of the table, each with its own lock
+ * @property seed - Seed the keys are hashed with
+ */
+typedef struct {
+    json_intern_shard_t shards[JSON_INTERN_SHARDS];
+    uint64_t seed;
+} json_intern_t;
 
 /**
- * @brief Tokenizes a string and appends all tokens to a stream
- * @param json - JSON string to tokenize
- * @param size - size of the JSON string
- * @param stream - token stream to append to
+ * @brief - Counters summed over every shard of an intern table
+ * @property lookups - Number of keys looked up
+ * @property hits - Number of lookups that found the key already interned
+ * @property unique_keys - Number of distinct keys held
+ * @property bytes_stored - Bytes the canonical keys take up
+ * @property bytes_saved - Bytes of key copies hits avoided
  */
-int tokenize_json(const char* json, int size, token_stream_t* stream) {
-    token_stream_t_init(stream);
-    int idx = 0;
+typedef struct {
+    size_t lookups;
+    size_t hits;
+    size_t unique_keys;
+    size_t bytes_stored;
+    size_t bytes_saved;
+} json_intern_stats_t;
 
-    int flag = 1;
-    token_t tok = {0};
+/**
+ * @brief - Initializes an empty intern table
+ * @param intern - pointer to the table to initialize
+ * @return 0 on success
+ * @return ALLOCATION_FAILED if a lock could not be created
+ */
+int json_intern_t_init(json_intern_t* intern);
+
+/**
+ * @brief - Returns the canonical copy of a key, adding it on first sight
+ * @param intern - pointer to the table
+ * @param key - the key bytes
+ * @param len - length of key
+ * @return null terminated canonical key, equal keys always get the same pointer
+ * @return NULL if memory could not be allocated
+ */
+const char* json_intern_t_intern(json_intern_t* intern, const char* key, size_t len);
+
+/**
+ * @brief - Reads the table's counters
+ * @param intern - pointer to the table
+ * @param stats - filled with the counters
+ */
+void json_intern_t_stats(json_intern_t* intern, json_intern_stats_t* stats);
+
+/**
+ * @brief - Frees every canonical key, maps still pointing at them must not be used afterwards
+ * @param intern - pointer to the table to deinit
+ */
+void json_intern_t_deinit(json_intern_t* intern);
+
+/**
+ * @brief - Pre-sizes the HashMap so `count` entries fit without growing
+ * @param map - Pointer to the HashMap to grow
+ * @param count - Number of entries to make room for
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_object_map_t_reserve(json_object_map_t* map, size_t count);
+
+/**
+ * @brief - A list of JSON values stored inline in one contiguous buffer, in document order
+ * Elements can be walked directly through `items[0..len)`. Pointers into `items` stay valid until the next push onto the same array.
+ * @property items - Contiguous elements
+ * @property len - Number of elements
+ * @property capacity - Number of elements that fit before `items` has to grow
+ * @property arena - arena the items and their values are allocated from, NULL for the heap
+ */
+typedef struct json_array_t {
+    json_object_t* items;
+    size_t len;
+    size_t capacity;
+    json_arena_t* arena;
+} json_array_t;
+
+/**
+ * @brief - Initializes an empty array
+ * @param arr - pointer to the array to initialize
+ */
+void json_array_t_init(json_array_t* arr);
+
+/**
+ * @brief - Deinitializes every element and frees the array's buffer
+ * @param arr - pointer to the array to deinit
+ */
+void json_array_t_deinit(json_array_t* arr);
+
+/**
+ * @brief - Pre-sizes the array so `count` elements fit without growing
+ * @param arr - pointer to the array to grow
+ * @param count - number of elements to make room for
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_array_t_reserve(json_array_t* arr, size_t count);
+
+/**
+ * @brief - Appends a value, growing the buffer geometrically
+ * @param arr - pointer to the array to append to
+ * @param val - pointer to the value to append, the array takes over whatever it owns the same way a map does
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_array_t_push(json_array_t* arr, json_object_t* val);
+
+/**
+ * @brief - Returns the element at `idx`
+ * @param arr - pointer to the array
+ * @param idx - index of the element
+ * @return pointer to the element
+ * @return NULL if `idx` is out of bounds
+ */
+json_object_t* json_array_t_get(json_array_t* arr, size_t idx);
+
+/**
+ * @brief - Copies an array of numbers out into a plain double buffer in one linear pass
+ * @param arr - pointer to the array
+ * @param out - buffer with room for `arr->len` doubles
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if an element is not a NUMBER or INTEGER, `out` is then only partially written
+ */
+int json_array_t_copy_doubles(const json_array_t* arr, double* out);
+
+
+/**
+ * @brief Parses a JSON buffer into a JSON Object
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param obj - pointer to the JSON object to populate
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse(const char* json, size_t len, json_object_t* obj);
+
+/**
+ * @brief Parses a JSON buffer into a JSON Object whose entire tree is allocated from an arena
+ * The result must not be passed to `json_deinit`, release it with `json_arena_t_deinit` instead
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param obj - pointer to the JSON object to populate
+ * @param arena - arena to allocate maps, nodes, keys and strings from
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse_arena(const char* json, size_t len, json_object_t* obj, json_arena_t* arena);
+
+/**
+ * @brief - Parse option flag: STRING values and keys without escapes become views into the input instead of copies,
+ * the input buffer must then outlive the parsed tree
+ */
+#define JSON_PARSE_BORROW_STRINGS 1
+
+/**
+ * @brief - Timed stages of a parse, PARSE includes the time spent in ALLOC
+ */
+typedef enum {
+    JSON_PHASE_PARSE,
+    JSON_PHASE_ALLOC,
+    JSON_PHASE_DEINIT,
+    JSON_PHASE_COUNT,
+} json_phase_t;
+
+/**
+ * @brief - Callbacks fired while statistics are being collected, any of them may be NULL
+ * @property on_phase - called as PARSE or DEINIT begins (`end` 0) and ends (`end` 1)
+ * @property on_alloc - called after every allocation the parser makes, with its size
+ * @property ctx - passed back to every hook
+ */
+typedef struct {
+    void (*on_phase)(void* ctx, json_phase_t phase, int end);
+    void (*on_alloc)(void* ctx, void* ptr, size_t size);
+    void* ctx;
+} json_stats_hooks_t;
+
+/**
+ * @brief - Counters filled in by `json_parse_ex` and `json_deinit_stats` when built with `JSON_ENABLE_STATS`,
+ * they add up across parses until the stats are initialized again. Without the define nothing is recorded
+ * @property hooks - user callbacks, set them after `json_parse_stats_t_init`
+ * @property tokens - values and keys read
+ * @property bytes - input bytes consumed, up to the error for a failed parse
+ * @property max_depth - deepest nesting of objects and arrays
+ * @property allocs - allocations made by the parser, from the heap or an arena
+ * @property alloc_bytes - bytes requested by those allocations
+ * @property map_inserts - keys inserted into `json_object_map_t`s
+ * @property probe_histogram - slots probed per insert, bucket `i` counts lengths in [2^i, 2^(i+1)), the last takes the rest
+ * @property max_probe - longest probe sequence seen
+ * @property ns - wall clock nanoseconds per `json_phase_t`
+ * @property cycles - CPU timestamp counter ticks per `json_phase_t`, zero where there is no counter
+ */
+typedef struct {
+    json_stats_hooks_t hooks;
+
+    size_t tokens;
+    size_t bytes;
+    size_t max_depth;
+
+    size_t allocs;
+    size_t alloc_bytes;
+
+    size_t map_inserts;
+    size_t probe_histogram[JSON_STATS_PROBE_BUCKETS];
+    size_t max_probe;
+
+    uint64_t ns[JSON_PHASE_COUNT];
+    uint64_t cycles[JSON_PHASE_COUNT];
+} json_parse_stats_t;
+
+/**
+ * @brief - Zeroes every counter and clears the hooks
+ * @param stats - pointer to the stats to initialize
+ */
+void json_parse_stats_t_init(json_parse_stats_t* stats);
+
+/**
+ * @brief - Options for `json_parse_ex`, zero initialize for the `json_parse` defaults
+ * @property arena - arena to allocate the tree from, NULL for the heap
+ * @property flags - `JSON_PARSE_*` flags
+ * @property intern - table to take object keys from instead of copying them, NULL to copy
+ * @property stats - statistics to add this parse to, NULL to skip them, ignored unless built with `JSON_ENABLE_STATS`
+ * @property max_depth - deepest nesting of objects and arrays accepted, 0 for `JSON_PARSE_MAX_DEPTH`
+ */
+typedef struct {
+    json_arena_t* arena;
+    unsigned int flags;
+    json_intern_t* intern;
+    json_parse_stats_t* stats;
+    size_t max_depth;
+} json_parse_opts_t;
+
+/**
+ * @brief Parses a JSON buffer into a JSON Object with explicit options
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param obj - pointer to the JSON object to populate
+ * @param opts - parse options, NULL for the defaults
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse_ex(const char* json, size_t len, json_object_t* obj, const json_parse_opts_t* opts);
+
+/**
+ * @brief Frees all memory tied to the JSON Object if it had any heap stored values (sub-objects or strings)
+ * Does not free the underlying pointer
+ * @param json - JSON object to deinit
+ */
+void json_deinit(json_object_t* json);
+
+/**
+ * @brief - `json_deinit` that times the teardown into the DEINIT phase of `stats`
+ * @param json - JSON object to deinit
+ * @param stats - statistics to add the teardown to, ignored unless built with `JSON_ENABLE_STATS`
+ */
+void json_deinit_stats(json_object_t* json, json_parse_stats_t* stats);
+
+/**
+ * @brief - A parsed JSON document that owns its whole tree through a single arena
+ * @property root - The top level JSON value
+ * @property arena - Arena backing every allocation in `root`
+ */
+typedef struct {
+    json_object_t root;
+    json_arena_t arena;
+} json_document_t;
+
+/**
+ * @brief - Initializes an empty document
+ * @param doc - pointer to the document to initialize
+ */
+void json_document_t_init(json_document_t* doc);
+
+/**
+ * @brief - Parses a JSON buffer into the document's arena
+ * @param doc - pointer to an initialized document
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_document_t_parse(json_document_t* doc, const char* json, size_t len);
+
+/**
+ * @brief - Releases the whole document tree in one call
+ * @param doc - pointer to the document to deinit
+ */
+void json_document_t_deinit(json_document_t* doc);
+
+/**
+ * @brief - An object or array the parser has opened but not closed yet
+ * @property container - The value being filled in
+ * @property base - Where this array's elements start on the element stack
+ * @property key - Key of the object member being parsed, still pointing into the input
+ * @property key_len - Length of key
+ * @property key_escaped - Whether the key holds escapes that have to be decoded
+ */
+typedef struct {
+    json_object_t container;
+    size_t base;
+    const char* key;
+    size_t key_len;
+    int key_escaped;
+} json_parse_frame_t;
+
+/**
+ * @brief - A long lived parser that keeps its scratch buffers between parses
+ * @property items - Stack the elements of open arrays are collected on
+ * @property items_capacity - Number of elements `items` has room for
+ * @property frames - Stack of the objects and arrays still open
+ * @property frames_capacity - Number of frames `frames` has room for
+ */
+typedef struct {
+    json_object_t* items;
+    size_t items_capacity;
+    json_parse_frame_t* frames;
+    size_t frames_capacity;
+} json_parser_t;
+
+/**
+ * @brief - Initializes a parser, no memory is requested until the first parse
+ * @param parser - pointer to the parser to initialize
+ */
+void json_parser_t_init(json_parser_t* parser);
+
+/**
+ * @brief - `json_parse_ex` that reuses the parser's scratch buffers instead of allocating its own
+ * @param parser - pointer to an initialized parser
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param obj - pointer to the JSON object to populate
+ * @param opts - parse options, NULL for the defaults
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parser_t_parse(json_parser_t* parser, const char* json, size_t len, json_object_t* obj, const json_parse_opts_t* opts);
+
+/**
+ * @brief - Parses into a document, replacing its previous tree and reusing the memory that held it
+ * Once the document's arena has grown to fit the largest input, parsing similar documents makes no system allocations
+ * @param parser - pointer to an initialized parser
+ * @param doc - pointer to an initialized document, anything borrowed from its old tree becomes invalid
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param opts - parse options, NULL for the defaults, `arena` is ignored in favour of the document's
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parser_t_parse_document(json_parser_t* parser, json_document_t* doc, const char* json, size_t len,
+                                 const json_parse_opts_t* opts);
+
+/**
+ * @brief - Frees the parser's scratch buffers
+ * @param parser - pointer to the parser to deinit
+ */
+void json_parser_t_deinit(json_parser_t* parser);
+
+/**
+ * @brief - A read only memory mapping of a whole file
+ * @property data - Start of the mapping, NULL for an empty file
+ * @property len - Size of the file in bytes
+ */
+typedef struct {
+    const char* data;
+    size_t len;
+} json_mapped_file_t;
+
+/**
+ * @brief - Maps a file read only, hinting the kernel that it will be read front to back
+ * @param file - pointer to the mapping to populate
+ * @param path - path of the file to map
+ * @return 0 on success
+ * @return IO_ERROR if the file could not be opened or mapped
+ */
+int json_mapped_file_t_open(json_mapped_file_t* file, const char* path);
+
+/**
+ * @brief - Unmaps a file mapped by `json_mapped_file_t_open`
+ * @param file - pointer to the mapping
+ */
+void json_mapped_file_t_close(json_mapped_file_t* file);
+
+/**
+ * @brief Parses a JSON file into a JSON Object straight from a read only mapping, without reading it into a buffer first
+ * @param path - path of the JSON file
+ * @param obj - pointer to the JSON object to populate
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse_file(const char* path, json_object_t* obj);
+
+/**
+ * @brief - Parses a JSON file into the document's arena straight from a read only mapping
+ * @param doc - pointer to an initialized document
+ * @param path - path of the JSON file
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_document_t_parse_file(json_document_t* doc, const char* path);
+
+/**
+ * @brief - One record of a JSON Lines batch
+ * @property value - The parsed record, allocated from one of the batch's arenas
+ * @property rc - 0, or the error the record failed with, `value` is then NULL_VAL
+ * @property offset - Byte offset of the record's line in the input
+ * @property len - Length of the line, without its newline
+ */
+typedef struct {
+    json_object_t value;
+    int rc;
+    size_t offset;
+    size_t len;
+} json_lines_record_t;
+
+/**
+ * @brief - A batch of newline delimited JSON records parsed in parallel, in input order
+ * Blank lines are skipped, so `records[i]` is the i-th non blank line of the input.
+ * @property records - The records, in input order
+ * @property len - Number of records
+ * @property errors - Number of records that failed to parse
+ * @property arenas - One arena per worker, together they own every record's tree
+ * @property arena_count - Number of arenas
+ * @property file - Mapping `json_lines_t_parse_file` parsed, kept open so borrowed strings stay valid
+ */
+typedef struct {
+    json_lines_record_t* records;
+    size_t len;
+    size_t errors;
+    json_arena_t* arenas;
+    size_t arena_count;
+    json_mapped_file_t file;
+} json_lines_t;
+
+/**
+ * @brief - Options for parsing a JSON Lines batch
+ * @property threads - Number of worker threads, 0 for one per online CPU
+ * @property flags - `JSON_PARSE_*` flags applied to every record
+ * @property intern - table every worker takes object keys from, NULL to copy them
+ */
+typedef struct {
+    size_t threads;
+    unsigned int flags;
+    json_intern_t* intern;
+} json_lines_opts_t;
+
+/**
+ * @brief - Initializes an empty batch
+ * @param lines - pointer to the batch to initialize
+ */
+void json_lines_t_init(json_lines_t* lines);
+
+/**
+ * @brief - Splits a buffer of JSON Lines at record boundaries and parses the records on a work stealing thread pool
+ * Records from a previous parse into the same batch are released first.
+ * @param lines - pointer to an initialized batch
+ * @param data - the records, one per line
+ * @param len - length of data
+ * @param opts - options, NULL for the defaults
+ * @return 0 once every record was attempted, check `errors` and each record's `rc` for bad lines
+ * @return ALLOCATION_FAILED if the batch could not be set up
+ */
+int json_lines_t_parse(json_lines_t* lines, const char* data, size_t len, const json_lines_opts_t* opts);
+
+/**
+ * @brief - Parses a JSON Lines file straight from a read only mapping, see `json_lines_t_parse`
+ * @param lines - pointer to an initialized batch
+ * @param path - path of the file
+ * @param opts - options, NULL for the defaults
+ * @return 0 once every record was attempted
+ * @return IO_ERROR or ALLOCATION_FAILED on failure
+ */
+int json_lines_t_parse_file(json_lines_t* lines, const char* path, const json_lines_opts_t* opts);
+
+/**
+ * @brief - Releases every record, the arenas and the file mapping
+ * @param lines - pointer to the batch to deinit
+ */
+void json_lines_t_deinit(json_lines_t* lines);
+
+/**
+ * @brief - Callbacks fired by `json_sax_parse`, any of them may be NULL
+ * String views point straight into the input and are not null terminated. When `escaped` is set they still hold
+ * the raw escape sequences, `json_unescape` decodes them. Returning non zero from a callback stops the parse.
+ * @property start_object - `{`
+ * @property end_object - `}`
+ * @property start_array - `[`
+ * @property end_array - `]`
+ * @property key - An object key, always followed by its value's events
+ * @property string - A string value
+ * @property integer - A number with no fraction or exponent that fits in an int64_t
+ * @property number - Any other number
+ * @property boolean - true or false
+ * @property null - null
+ */
+typedef struct {
+    int (*start_object)(void* ctx);
+    int (*end_object)(void* ctx);
+    int (*start_array)(void* ctx);
+    int (*end_array)(void* ctx);
+    int (*key)(void* ctx, const char* key, size_t len, int escaped);
+    int (*string)(void* ctx, const char* str, size_t len, int escaped);
+    int (*integer)(void* ctx, int64_t value);
+    int (*number)(void* ctx, double value);
+    int (*boolean)(void* ctx, int value);
+    int (*null)(void* ctx);
+} json_sax_handler_t;
+
+/**
+ * @brief - Walks a JSON buffer firing a callback per event, without building a tree or allocating anything
+ * Nesting is tracked in a fixed bit stack, so documents deeper than `JSON_SAX_MAX_DEPTH` are rejected.
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param handler - callbacks to fire
+ * @param ctx - passed through to every callback
+ * @return 0 on success
+ * @return whatever non zero value a callback returned to stop the parse
+ * @return negative number if the input is malformed, events already fired stay fired
+ */
+int json_sax_parse(const char* json, size_t len, const json_sax_handler_t* handler, void* ctx);
+
+/**
+ * @brief - Runs `json_sax_parse` over a file through a read only mapping, so memory stays flat however large it is
+ * @param path - path of the JSON file
+ * @param handler - callbacks to fire
+ * @param ctx - passed through to every callback
+ * @return the result of `json_sax_parse`, or IO_ERROR if the file could not be mapped
+ */
+int json_sax_parse_file(const char* path, const json_sax_handler_t* handler, void* ctx);
+
+/**
+ * @brief - Decodes the escape sequences of a raw string view
+ * @param str - raw string contents, without the quotes
+ * @param len - length of str
+ * @param out - buffer with room for at least `len` bytes, decoded strings are never longer
+ * @param out_len - set to the decoded length
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if an escape is malformed
+ */
+int json_unescape(const char* str, size_t len, char* out, size_t* out_len);
+
+/**
+ * @brief - Checks that a buffer holds exactly one well formed JSON document without building anything or allocating
+ * Covers the whole RFC 8259 grammar, including escapes, surrogate pairs and UTF-8 inside strings.
+ * Nesting is tracked in a fixed bit stack, so documents deeper than `JSON_VALIDATE_MAX_DEPTH` are rejected.
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @return 0 if the document is valid
+ * @return negative number if it is not
+ */
+int json_validate(const char* json, size_t len);
+
+/**
+ * @brief - A whole document flattened into one array of 64 bit entries plus a side buffer of strings
+ * Every entry has its type character in the top byte and a payload in the low 56 bits:
+ * `{`/`[` hold the index just past their matching close in the low 32 bits and their element count (saturating) above that,
+ * `}`/`]` hold the index of their open, `"` holds the offset of a 4 byte length prefix in `strings`,
+ * `l`/`d` are followed by a second entry with the raw int64_t or double bits, and `t`, `f`, `n` have no payload.
+ * Object members are laid out as a key entry followed by the value's entries.
+ * @property tape - The entries, the root value starts at index 0
+ * @property len - Number of entries
+ * @property capacity - Number of entries `tape` has room for
+ * @property strings - Length prefixed, null terminated strings and keys
+ * @property strings_len - Bytes used in `strings`
+ * @property strings_capacity - Size of `strings`
+ */
+typedef struct {
+    uint64_t* tape;
+    size_t len;
+    size_t capacity;
+    char* strings;
+    size_t strings_len;
+    size_t strings_capacity;
+} json_tape_t;
+
+/**
+ * @brief - A value inside a tape, cheap to copy around
+ * @property tape - The tape the value lives in
+ * @property idx - Index of the value's first entry
+ */
+typedef struct {
+    const json_tape_t* tape;
+    size_t idx;
+} json_tape_ref_t;
+
+/**
+ * @brief - Walks the members of an object or the elements of an array in a tape
+ * @property tape - The tape being walked
+ * @property idx - Index of the next member or element
+ * @property end - Index of the container's closing entry
+ * @property is_object - Whether members have keys
+ */
+typedef struct {
+    const json_tape_t* tape;
+    size_t idx;
+    size_t end;
+    int is_object;
+} json_tape_iter_t;
+
+/**
+ * @brief - Initializes an empty tape
+ * @param tape - pointer to the tape to initialize
+ */
+void json_tape_t_init(json_tape_t* tape);
+
+/**
+ * @brief - Parses a JSON buffer onto the tape, replacing whatever it held but keeping its buffers
+ * @param tape - pointer to an initialized tape
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_tape_t_parse(json_tape_t* tape, const char* json, size_t len);
+
+/**
+ * @brief - Frees the tape's buffers
+ * @param tape - pointer to the tape to deinit
+ */
+void json_tape_t_deinit(json_tape_t* tape);
+
+/**
+ * @brief - Returns the top level value of a parsed tape
+ * @param tape - pointer to the tape
+ * @return reference to the root value
+ */
+json_tape_ref_t json_tape_t_root(const json_tape_t* tape);
+
+/**
+ * @brief - Returns what kind of value a reference points at
+ * @param ref - the value
+ * @return OBJECT, ARRAY, STRING, INTEGER, NUMBER, BOOLEAN or NULL_VAL
+ */
+value_tag_t json_tape_ref_t_tag(json_tape_ref_t ref);
+
+/**
+ * @brief - Returns the number of members of an object or elements of an array
+ * @param ref - the container
+ * @return the count, 0 for anything that is not a container
+ */
+size_t json_tape_ref_t_len(json_tape_ref_t ref);
+
+/**
+ * @brief - Looks up an object member, hopping over other members' values in constant time each
+ * @param ref - the object
+ * @param key - name of the member
+ * @param key_len - length of key
+ * @param out - set to the member's value
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an object or the key is missing
+ */
+int json_tape_ref_t_get_n(json_tape_ref_t ref, const char* key, size_t key_len, json_tape_ref_t* out);
+
+/**
+ * @brief - Looks up an object member by a null terminated key, see `json_tape_ref_t_get_n`
+ * @param ref - the object
+ * @param key - name of the member
+ * @param out - set to the member's value
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an object or the key is missing
+ */
+int json_tape_ref_t_get(json_tape_ref_t ref, const char* key, json_tape_ref_t* out);
+
+/**
+ * @brief - Returns an array element
+ * @param ref - the array
+ * @param idx - index of the element
+ * @param out - set to the element
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an array
+ * @return INDEX_GREATER_THAN_LEN if `idx` is out of bounds
+ */
+int json_tape_ref_t_at(json_tape_ref_t ref, size_t idx, json_tape_ref_t* out);
+
+/**
+ * @brief - Reads a string value
+ * @param ref - the value
+ * @param len - set to the length of the string, may be NULL
+ * @return pointer to the null terminated, unescaped string
+ * @return NULL if the value is not a string
+ */
+const char* json_tape_ref_t_string(json_tape_ref_t ref, size_t* len);
+
+/**
+ * @brief - Reads a number as a double
+ * @param ref - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a number
+ */
+int json_tape_ref_t_double(json_tape_ref_t ref, double* out);
+
+/**
+ * @brief - Reads an integer
+ * @param ref - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not an INTEGER
+ */
+int json_tape_ref_t_int64(json_tape_ref_t ref, int64_t* out);
+
+/**
+ * @brief - Reads a boolean
+ * @param ref - the value
+ * @param out - set to 1 for true and 0 for false
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a boolean
+ */
+int json_tape_ref_t_boolean(json_tape_ref_t ref, int* out);
+
+/**
+ * @brief - Builds a regular `json_object_t` tree out of a tape value
+ * @param ref - the value
+ * @param out - set to the converted value
+ * @param arena - arena to allocate the tree from, NULL for the heap
+ * @return 0 on success
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_tape_ref_t_to_object(json_tape_ref_t ref, json_object_t* out, json_arena_t* arena);
+
+/**
+ * @brief - Starts walking an object or array
+ * @param it - pointer to the iterator to initialize
+ * @param ref - the container, anything else yields no members
+ */
+void json_tape_iter_t_init(json_tape_iter_t* it, json_tape_ref_t ref);
+
+/**
+ * @brief - Moves to the next member or element
+ * @param it - pointer to the iterator
+ * @param key - set to the member's key, or NULL for array elements, may be NULL
+ * @param key_len - set to the length of the key, may be NULL
+ * @param value - set to the member's value
+ * @return 1 if a member was produced
+ * @return 0 once the container is exhausted
+ */
+int json_tape_iter_t_next(json_tape_iter_t* it, const char** key, size_t* key_len, json_tape_ref_t* value);
+
+/**
+ * @brief - One segment of a projection's path trie
+ * @property name - Key this node matches, owned by the projection
+ * @property name_len - Length of name
+ * @property first_child - Index of the first child node, 0 if none
+ * @property next_sibling - Index of the next node under the same parent, 0 if none
+ * @property terminal - Set when a path ends here, the whole value is then kept
+ */
+typedef struct {
+    char* name;
+    size_t name_len;
+    size_t first_child;
+    size_t next_sibling;
+    int terminal;
+} json_projection_node_t;
+
+/**
+ * @brief - A compiled set of dotted field paths for `json_parse_projected`, node 0 is the document root
+ * @property nodes - Trie nodes, children linked through sibling indices
+ * @property len - Number of nodes
+ * @property capacity - Number of nodes `nodes` has room for
+ */
+typedef struct {
+    json_projection_node_t* nodes;
+    size_t len;
+    size_t capacity;
+} json_projection_t;
+
+/**
+ * @brief - Initializes an empty projection, which keeps nothing
+ * @param proj - pointer to the projection to initialize
+ */
+void json_projection_t_init(json_projection_t* proj);
+
+/**
+ * @brief - Adds a dotted path such as `person.name`, each segment naming an object member
+ * A path that is a prefix of another keeps the whole value and makes the longer one redundant.
+ * @param proj - pointer to the projection
+ * @param path - null terminated path, segments are split on `.`
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the path has an empty segment
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_projection_t_add(json_projection_t* proj, const char* path);
+
+/**
+ * @brief - Frees the projection's nodes
+ * @param proj - pointer to the projection to deinit
+ */
+void json_projection_t_deinit(json_projection_t* proj);
+
+/**
+ * @brief - Parses only the members a projection names, skipping every other subtree without allocating
+ * The result is an OBJECT holding the matched values under their enclosing objects. Paths only descend through
+ * objects, a path reaching an array or scalar before its last segment matches nothing.
+ * Skipped subtrees are only checked for balanced brackets and terminated strings.
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param proj - the fields to keep
+ * @param obj - pointer to the JSON object to populate
+ * @param opts - parse options, NULL for the defaults
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse_projected(const char* json, size_t len, const json_projection_t* proj, json_object_t* obj,
+                         const json_parse_opts_t* opts);
+
+/**
+ * @brief - Marks a path step that can never index an array
+ */
+#define JSON_PATH_NO_INDEX ((size_t)-1)
+
+/**
+ * @brief - One member name or array index of a compiled path
+ * @property key - Decoded member name, points into the path's key buffer
+ * @property key_len - Length of key
+ * @property hash - Hash of the key under the path's seed
+ * @property index - The key read as an array index, `JSON_PATH_NO_INDEX` if it is not one
+ */
+typedef struct {
+    const char* key;
+    size_t key_len;
+    uint64_t hash;
+    size_t index;
+} json_path_step_t;
+
+/**
+ * @brief - A query compiled once and evaluated against any number of documents
+ * Each step applies to objects by key and to arrays by index, so the same path works on either.
+ * @property steps - The steps, outermost first
+ * @property len - Number of steps, 0 selects the root itself
+ * @property seed - Hash seed the step hashes were computed with, maps using any other seed rehash the key
+ * @property keys - Buffer holding every step's key
+ */
+typedef struct {
+    json_path_step_t* steps;
+    size_t len;
+    uint64_t seed;
+    char* keys;
+} json_path_t;
+
+/**
+ * @brief - Compiles an RFC 6901 JSON Pointer such as `/person/tags/0`, with `~0` and `~1` escaping `~` and `/`
+ * @param path - pointer to the path to initialize
+ * @param pointer - null terminated pointer, the empty string selects the root
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the pointer is malformed
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_path_t_compile_pointer(json_path_t* path, const char* pointer);
+
+/**
+ * @brief - Compiles a dotted path such as `person.tags[0]`, keys are split on `.` and `[`
+ * @param path - pointer to the path to initialize
+ * @param expr - null terminated path, the empty string selects the root
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the path is malformed
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_path_t_compile(json_path_t* path, const char* expr);
+
+/**
+ * @brief - Follows a compiled path from a value, using the precomputed hashes for every map lookup
+ * @param path - the compiled path
+ * @param root - value to start from
+ * @return pointer to the selected value
+ * @return NULL if any step is missing or lands on a scalar
+ */
+json_object_t* json_path_t_eval(const json_path_t* path, json_object_t* root);
+
+/**
+ * @brief - Frees a compiled path
+ * @param path - pointer to the path to deinit
+ */
+void json_path_t_deinit(json_path_t* path);
+
+#define JSON_SCHEMA_MAX_FIELDS 64
+#define JSON_SCHEMA_TABLE_SIZE 1024
+
+/**
+ * @brief - How a schema field is stored in its struct
+ */
+typedef enum {
+    /**
+     * @brief - int64_t, the JSON value has to be an integer
+     */
+    JSON_FIELD_INT64,
+    /**
+     * @brief - double, any JSON number
+     */
+    JSON_FIELD_DOUBLE,
+    /**
+     * @brief - int set to 1 or 0
+     */
+    JSON_FIELD_BOOL,
+    /**
+     * @brief - char*, null terminated and unescaped, from the arena or the heap
+     */
+    JSON_FIELD_STRING,
+    /**
+     * @brief - A nested struct with its own schema
+     */
+    JSON_FIELD_STRUCT,
+    /**
+     * @brief - A json_object_t holding whatever value is there, for parts with no fixed shape
+     */
+    JSON_FIELD_VALUE,
+} json_field_kind_t;
+
+struct json_schema_t;
+
+/**
+ * @brief - Describes one member of a decoded struct, usually generated by `JSON_SCHEMA`
+ * @property key - JSON key of the member
+ * @property key_len - Length of key
+ * @property offset - Offset of the field inside the struct
+ * @property kind - How the field is stored
+ * @property schema - Returns the nested schema of a `JSON_FIELD_STRUCT`, NULL for anything else
+ */
+typedef struct {
+    const char* key;
+    size_t key_len;
+    size_t offset;
+    json_field_kind_t kind;
+    const struct json_schema_t* (*schema)(void);
+} json_field_t;
+
+/**
+ * @brief - A set of fields compiled into a collision free hash table, so every key is dispatched with one probe
+ * @property fields - The fields, not owned
+ * @property count - Number of fields
+ * @property seed - Seed that made the hash perfect for these keys
+ * @property full_hash - Set when the keys' first and last 8 bytes alone can't tell them apart, `json_hash` is then used
+ * @property mask - Number of table slots in use - 1
+ * @property status - Result of compiling the schema
+ * @property table - Field index + 1 per slot, 0 for keys that aren't in the schema
+ */
+typedef struct json_schema_t {
+    const json_field_t* fields;
+    size_t count;
+    uint64_t seed;
+    int full_hash;
+    size_t mask;
+    int status;
+    uint8_t table[JSON_SCHEMA_TABLE_SIZE];
+} json_schema_t;
+
+/**
+ * @brief - Finds a perfect hash for a set of fields, without allocating
+ * @param schema - pointer to the schema to fill in
+ * @param fields - the fields, they have to outlive the schema
+ * @param count - number of fields, at most `JSON_SCHEMA_MAX_FIELDS`
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if there are too many fields or two share a key
+ */
+int json_schema_t_compile(json_schema_t* schema, const json_field_t* fields, size_t count);
+
+/**
+ * @brief - Decodes a JSON object straight into a struct, without building a tree
+ * Members missing from the JSON, or null in it, leave their field untouched. Unknown members are skipped.
+ * Without an arena, string and value fields have to start out zeroed and are released with `json_schema_t_deinit_struct`.
+ * @param schema - the struct's compiled schema
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param out - pointer to the struct to fill in
+ * @param arena - arena to allocate strings and values from, NULL for the heap
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if a member has the wrong type
+ * @return negative number on failure, `out` may be partially filled
+ */
+int json_schema_t_decode(const json_schema_t* schema, const char* json, size_t len, void* out, json_arena_t* arena);
+
+/**
+ * @brief - Frees the heap strings and values a decode stored in a struct, including nested ones
+ * @param schema - the struct's compiled schema
+ * @param out - pointer to the struct
+ */
+void json_schema_t_deinit_struct(const json_schema_t* schema, void* out);
+
+#define JSON_SCHEMA_FIELD_(key, field, kind, schema) \
+    { key, sizeof(key) - 1, offsetof(json_schema_type_, field), kind, schema },
+
+/**
+ * @brief - Generates `name_schema()`, `name_decode(json, len, type* out, arena)` and `name_deinit(type* out)` from an
+ * X-macro list of `X(key, field, kind, schema)` entries, where `schema` is the `name_schema` of a nested
+ * `JSON_FIELD_STRUCT` or NULL. The schema is compiled once, the first time it is used.
+ */
+#define JSON_SCHEMA(name, type, FIELDS)                                                         \
+    static const json_field_t* name##_schema_fields(size_t* count) {                            \
+        typedef type json_schema_type_;                                                         \
+        static const json_field_t fields[] = { FIELDS(JSON_SCHEMA_FIELD_) };                    \
+        *count = sizeof(fields) / sizeof(fields[0]);                                            \
+        return fields;                                                                          \
+    }                                                                                           \
+    static json_schema_t name##_schema_compiled;                                                \
+    static pthread_once_t name##_schema_once = PTHREAD_ONCE_INIT;                               \
+    static void name##_schema_compile(void) {                                                   \
+        size_t count;                                                                           \
+        const json_field_t* fields = name##_schema_fields(&count);                              \
+        json_schema_t_compile(&name##_schema_compiled, fields, count);                          \
+    }                                                                                           \
+    static inline const json_schema_t* name##_schema(void) {                                    \
+        pthread_once(&name##_schema_once, name##_schema_compile);                               \
+        return &name##_schema_compiled;                                                         \
+    }                                                                                           \
+    static inline int name##_decode(const char* json, size_t len, type* out, json_arena_t* arena) { \
+        return json_schema_t_decode(name##_schema(), json, len, out, arena);                    \
+    }                                                                                           \
+    static inline void name##_deinit(type* out) {                                               \
+        json_schema_t_deinit_struct(name##_schema(), out);                                      \
+    }
+
+/**
+ * @brief - What the push parser expects next
+ */
+typedef enum {
+    /**
+     * @brief - Any JSON value
+     */
+    PUSH_VALUE,
+    /**
+     * @brief - A value or the end of an array that has no elements yet
+     */
+    PUSH_VALUE_OR_END,
+    /**
+     * @brief - A key or the end of an object that has no entries yet
+     */
+    PUSH_KEY_OR_END,
+    /**
+     * @brief - A key, after a comma
+     */
+    PUSH_KEY,
+    /**
+     * @brief - The colon between a key and its value
+     */
+    PUSH_COLON,
+    /**
+     * @brief - A comma or the end of the enclosing container
+     */
+    PUSH_AFTER_VALUE,
+    /**
+     * @brief - Inside a string whose bytes are being collected
+     */
+    PUSH_STRING,
+    /**
+     * @brief - Inside a number or literal whose bytes are being collected
+     */
+    PUSH_SCALAR,
+} json_push_state_t;
+
+/**
+ * @brief - A container that is still open in the push parser
+ * @property value - The container being filled
+ * @property key - Key the next completed value is stored under (owned by the parser), unused by arrays
+ * @property key_len - Length of the pending key
+ */
+typedef struct {
+    json_object_t value;
+    char* key;
+    size_t key_len;
+} json_push_frame_t;
+
+/**
+ * @brief - A resumable parser that is fed a document in arbitrary chunks
+ * Only the token that straddles a chunk boundary is buffered, everything else is built straight into the tree as it arrives.
+ * @property stack - Containers that are still open, innermost last
+ * @property depth - Number of open containers
+ * @property capacity - Number of frames `stack` has room for
+ * @property max_depth - Deepest nesting accepted, `JSON_PARSE_MAX_DEPTH` unless set after init
+ * @property state - What the parser expects next
+ * @property string_is_key - Whether the string being collected is an object key
+ * @property string_escaped - Whether the string being collected contains escapes
+ * @property escape_pending - Whether the last collected byte was a backslash, so the next byte is taken literally
+ * @property scratch - Bytes of the partial string, number or literal
+ * @property scratch_len - Number of bytes in `scratch`
+ * @property scratch_capacity - Size of `scratch`
+ * @property arena - Arena to build trees in, NULL for the heap
+ */
+typedef struct {
+    json_push_frame_t* stack;
+    size_t depth;
+    size_t capacity;
+    size_t max_depth;
+
+    json_push_state_t state;
+    int string_is_key;
+    int string_escaped;
+    int escape_pending;
+
+    char* scratch;
+    size_t scratch_len;
+    size_t scratch_capacity;
+
+    json_arena_t* arena;
+} json_push_parser_t;
+
+/**
+ * @brief - Initializes a push parser
+ * @param p - pointer to the parser to initialize
+ * @param arena - arena to build documents in, or NULL to build them on the heap
+ */
+void json_push_parser_t_init(json_push_parser_t* p, json_arena_t* arena);
+
+/**
+ * @brief - Feeds the next chunk of input to the parser
+ * @param p - pointer to the parser
+ * @param chunk - next bytes of the input
+ * @param len - number of bytes in chunk
+ * @param consumed - set to the number of bytes of `chunk` that were used, may be NULL
+ * @param obj - populated once the top level value closes
+ * @return 0 when a complete document was written to `obj`, bytes after `consumed` belong to the next one
+ * @return JSON_PUSH_NEED_MORE if the whole chunk was consumed without finishing the document
+ * @return DEPTH_LIMIT_EXCEEDED if containers nest deeper than `max_depth`
+ * @return negative number on failure, the partial document is discarded
+ */
+int json_push_parser_t_feed(json_push_parser_t* p, const char* chunk, size_t len, size_t* consumed, json_object_t* obj);
+
+/**
+ * @brief - Signals the end of the input, completing a top level number or literal that was waiting for a delimiter
+ * @param p - pointer to the parser
+ * @param obj - populated with the final document
+ * @return 0 when a complete document was written to `obj`
+ * @return negative number if the input ended in the middle of a value
+ */
+int json_push_parser_t_finish(json_push_parser_t* p, json_object_t* obj);
+
+/**
+ * @brief - Discards any partially parsed document so the parser can start over
+ * @param p - pointer to the parser
+ */
+void json_push_parser_t_reset(json_push_parser_t* p);
+
+/**
+ * @brief - Frees the parser's buffers and any partially parsed document
+ * @param p - pointer to the parser
+ */
+void json_push_parser_t_deinit(json_push_parser_t* p);
+
+/**
+ * @brief - Writer flag that puts every entry and element on its own line, indented by `JSON_WRITE_INDENT` spaces per level
+ */
+#define JSON_WRITE_PRETTY 1
+
+/**
+ * @brief - Receives serialized output from a writer
+ * @param ctx - the `ctx` the writer was initialized with
+ * @param data - next bytes of output
+ * @param len - number of bytes in data
+ * @return 0 on success, anything else stops the writer with IO_ERROR
+ */
+typedef int (*json_sink_t)(void* ctx, const char* data, size_t len);
+
+/**
+ * @brief - Serializes JSON values either into a growable buffer or, through a fixed size buffer, into a sink
+ * @property buf - Output so far (buffer mode) or output not yet handed to the sink
+ * @property len - Number of bytes in `buf`
+ * @property capacity - Size of `buf`
+ * @property sink - Where full buffers go, NULL to keep everything in `buf`
+ * @property ctx - Passed through to `sink`
+ * @property flags - `JSON_WRITE_*` flags
+ */
+typedef struct {
+    char* buf;
+    size_t len;
+    size_t capacity;
+    json_sink_t sink;
+    void* ctx;
+    unsigned int flags;
+} json_writer_t;
+
+/**
+ * @brief - Initializes a writer that collects its output in `buf`
+ * @param w - pointer to the writer to initialize
+ * @param flags - `JSON_WRITE_*` flags
+ */
+void json_writer_t_init(json_writer_t* w, unsigned int flags);
+
+/**
+ * @brief - Initializes a writer that streams its output to a sink in `JSON_WRITER_BUFFER_SIZE` chunks
+ * @param w - pointer to the writer to initialize
+ * @param flags - `JSON_WRITE_*` flags
+ * @param sink - function receiving the output
+ * @param ctx - passed through to `sink`
+ */
+void json_writer_t_init_sink(json_writer_t* w, unsigned int flags, json_sink_t sink, void* ctx);
+
+/**
+ * @brief - Serializes a value, appending it to what the writer already holds
+ * Doubles are written in the shortest form that reads back to the same value, non finite ones as null.
+ * In sink mode everything is flushed before returning.
+ * @param w - pointer to the writer
+ * @param obj - the value to write
+ * @return 0 on success
+ * @return ALLOCATION_FAILED or IO_ERROR on failure
+ */
+int json_writer_t_write(json_writer_t* w, const json_object_t* obj);
+
+/**
+ * @brief - Hands any buffered output to the sink, does nothing in buffer mode
+ * @param w - pointer to the writer
+ * @return 0 on success
+ * @return IO_ERROR if the sink failed
+ */
+int json_writer_t_flush(json_writer_t* w);
+
+/**
+ * @brief - Frees the writer's buffer
+ * @param w - pointer to the writer
+ */
+void json_writer_t_deinit(json_writer_t* w);
+
+/**
+ * @brief - Serializes a value into a newly allocated null terminated string
+ * @param obj - the value to write
+ * @param flags - `JSON_WRITE_*` flags
+ * @param out - set to the string, release it with JSON_FREE
+ * @param len - set to the length of the string, may be NULL
+ * @return 0 on success
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_write(const json_object_t* obj, unsigned int flags, char** out, size_t* len);
+
+
+/**
+ * @brief - A document encoded by `json_binary_write`, queried in place without decoding it
+ * The image is laid out with offsets so it can be mapped straight from disk. Fields are little endian, nodes and members are 8 byte aligned.
+ * Header (40 bytes): the magic "CJB1", u32 version, u64 hash seed of the keys, u64 image size, then the root node.
+ * Node (16 bytes): u8 type, three zero bytes, u32 len, u64 payload. By type:
+ * `n` null, `t`/`f` booleans, `l` payload is the int64_t, `d` payload is the double's bits,
+ * `s` payload is the offset of `len` bytes followed by a zero byte,
+ * `[` payload is the offset of `len` element nodes,
+ * `{` payload is the offset of `len` members followed by `len` u32 member indices sorted by key hash.
+ * Member (40 bytes): u64 key hash, u64 key offset, u32 key len, four zero bytes, then the value node.
+ * Keys are null terminated like strings, and equal keys share one copy.
+ * @property data - Start of the image
+ * @property len - Size of the image in bytes
+ * @property seed - Seed the member hashes were computed with
+ * @property mapped - Whether `data` is a mapping owned by this image
+ */
+typedef struct {
+    const char* data;
+    size_t len;
+    uint64_t seed;
+    int mapped;
+} json_binary_t;
+
+/**
+ * @brief - A value inside a binary image, cheap to copy around
+ * @property bin - The image the value lives in
+ * @property off - Offset of the value's node
+ */
+typedef struct {
+    const json_binary_t* bin;
+    size_t off;
+} json_binary_ref_t;
+
+/**
+ * @brief - Walks the members of an object or the elements of an array in a binary image
+ * @property bin - The image being walked
+ * @property body - Offset of the container's first member or element
+ * @property idx - Index of the next member or element
+ * @property len - Number of members or elements
+ * @property is_object - Whether members have keys
+ */
+typedef struct {
+    const json_binary_t* bin;
+    size_t body;
+    size_t idx;
+    size_t len;
+    int is_object;
+} json_binary_iter_t;
+
+/**
+ * @brief - Encodes a value into a newly allocated binary image
+ * @param obj - the value to encode
+ * @param out - set to the image, release it with JSON_FREE
+ * @param len - set to the size of the image
+ * @return 0 on success
+ * @return ALLOCATION_FAILED on failure
+ * @return UNEXPECTED_TOKEN if a string or container is too large for its 32 bit length
+ */
+int json_binary_write(const json_object_t* obj, char** out, size_t* len);
+
+/**
+ * @brief - Encodes a value and writes the image to a file
+ * @param obj - the value to encode
+ * @param path - path of the file to create or replace
+ * @return 0 on success
+ * @return IO_ERROR if the file could not be written, or any error of `json_binary_write`
+ */
+int json_binary_write_file(const json_object_t* obj, const char* path);
+
+/**
+ * @brief - Opens an image held in memory without copying or decoding it, the buffer has to outlive the image
+ * @param bin - pointer to the image to populate
+ * @param data - start of the image
+ * @param len - size of the buffer
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the buffer does not hold an image of this version
+ */
+int json_binary_t_open(json_binary_t* bin, const char* data, size_t len);
+
+/**
+ * @brief - Maps an image file read only and opens it in place, pages are only read once they are queried
+ * @param bin - pointer to the image to populate
+ * @param path - path of the image file
+ * @return 0 on success
+ * @return IO_ERROR if the file could not be mapped
+ * @return UNEXPECTED_TOKEN if the file does not hold an image of this version
+ */
+int json_binary_t_open_file(json_binary_t* bin, const char* path);
+
+/**
+ * @brief - Releases the mapping of an image opened with `json_binary_t_open_file`, refs into it become invalid
+ * @param bin - pointer to the image to close
+ */
+void json_binary_t_close(json_binary_t* bin);
+
+/**
+ * @brief - Returns the top level value of an image
+ * @param bin - pointer to the opened image
+ * @return reference to the root value
+ */
+json_binary_ref_t json_binary_t_root(const json_binary_t* bin);
+
+/**
+ * @brief - Returns what kind of value a reference points at
+ * @param ref - the value
+ * @return OBJECT, ARRAY, STRING, INTEGER, NUMBER, BOOLEAN or NULL_VAL, NULL_VAL for a node outside the image
+ */
+value_tag_t json_binary_ref_t_tag(json_binary_ref_t ref);
+
+/**
+ * @brief - Returns the number of members of an object or elements of an array
+ * @param ref - the container
+ * @return the count, 0 for anything that is not a container
+ */
+size_t json_binary_ref_t_len(json_binary_ref_t ref);
+
+/**
+ * @brief - Looks up an object member with a binary search over its hash sorted index
+ * @param ref - the object
+ * @param key - name of the member
+ * @param key_len - length of key
+ * @param out - set to the member's value
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an object or the key is missing
+ */
+int json_binary_ref_t_get_n(json_binary_ref_t ref, const char* key, size_t key_len, json_binary_ref_t* out);
+
+/**
+ * @brief - Looks up an object member by a null terminated key, see `json_binary_ref_t_get_n`
+ * @param ref - the object
+ * @param key - name of the member
+ * @param out - set to the member's value
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an object or the key is missing
+ */
+int json_binary_ref_t_get(json_binary_ref_t ref, const char* key, json_binary_ref_t* out);
+
+/**
+ * @brief - Returns an array element
+ * @param ref - the array
+ * @param idx - index of the element
+ * @param out - set to the element
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an array
+ * @return INDEX_GREATER_THAN_LEN if `idx` is out of bounds
+ */
+int json_binary_ref_t_at(json_binary_ref_t ref, size_t idx, json_binary_ref_t* out);
+
+/**
+ * @brief - Reads a string value straight out of the image
+ * @param ref - the value
+ * @param len - set to the length of the string, may be NULL
+ * @return pointer to the null terminated string
+ * @return NULL if the value is not a string
+ */
+const char* json_binary_ref_t_string(json_binary_ref_t ref, size_t* len);
+
+/**
+ * @brief - Reads a number as a double
+ * @param ref - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a number
+ */
+int json_binary_ref_t_double(json_binary_ref_t ref, double* out);
+
+/**
+ * @brief - Reads an integer
+ * @param ref - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not an INTEGER
+ */
+int json_binary_ref_t_int64(json_binary_ref_t ref, int64_t* out);
+
+/**
+ * @brief - Reads a boolean
+ * @param ref - the value
+ * @param out - set to 1 for true and 0 for false
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a boolean
+ */
+int json_binary_ref_t_boolean(json_binary_ref_t ref, int* out);
+
+/**
+ * @brief - Starts walking an object or array, members come back in their original order
+ * @param it - pointer to the iterator to initialize
+ * @param ref - the container, anything else yields no members
+ */
+void json_binary_iter_t_init(json_binary_iter_t* it, json_binary_ref_t ref);
+
+/**
+ * @brief - Moves to the next member or element
+ * @param it - pointer to the iterator
+ * @param key - set to the member's key, or NULL for array elements, may be NULL
+ * @param key_len - set to the length of the key, may be NULL
+ * @param value - set to the member's value
+ * @return 1 if a member was produced
+ * @return 0 once the container is exhausted
+ */
+int json_binary_iter_t_next(json_binary_iter_t* it, const char** key, size_t* key_len, json_binary_ref_t* value);
+
+/**
+ * @brief - Serializes a value of a binary image as JSON text, appending it to what the writer already holds
+ * @param w - pointer to the writer
+ * @param ref - the value to write
+ * @return 0 on success
+ * @return ALLOCATION_FAILED or IO_ERROR on failure
+ */
+int json_writer_t_write_binary(json_writer_t* w, json_binary_ref_t ref);
+
+/**
+ * @brief - Converts a value of a binary image back into a newly allocated JSON string
+ * @param ref - the value to write
+ * @param flags - `JSON_WRITE_*` flags
+ * @param out - set to the string, release it with JSON_FREE
+ * @param len - set to the length of the string, may be NULL
+ * @return 0 on success
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_binary_ref_t_to_json(json_binary_ref_t ref, unsigned int flags, char** out, size_t* len);
+
+/**
+ * @brief - Token Types
+ */
+typedef enum {
+    /**
+     * @brief - {
+     */
+    OPEN_BRACE,
+    /**
+     * @brief - }
+     */
+    CLOSE_BRACE,
+    /**
+     * @brief - [
+     */
+    OPEN_BRACKET,
+    /**
+     * @brief - ]
+     */
+    CLOSE_BRACKET,
+    /**
+     * @brief - "
+     */
+    QUOTATION,
+    /**
+     * @brief - ,
+     */
+    COMMA,
+    /**
+     * @brief - :
+     */
+    COLON,
+
+    /**
+     * @brief - true
+     */
+    TRUE,
+    /**
+     * @brief - false
+     */
+    FALSE,
+    /**
+     * @brief - null
+     */
+    NULL_TAG,
+
+    /**
+     * @brief - a string
+     */
+    STR,
+    /**
+     * @brief - a number
+     */
+    NUM,
+} token_tag_t;
+
+/**
+ * @brief - A token with it's type and pointer into the underlying buffer
+ * @property start - start of the token in the underlying string
+ * @property len - length of the token
+ * @property tag - type of the token
+ */
+typedef struct {
+    const char* start;
+    size_t len;
+    token_tag_t tag;
+} token_t;
+
+/**
+ * @brief prints the token out
+ * @param t - pointer to the token to print
+ */
+void token_t_print(token_t* t);
+
+/**
+ * @brief prints the token's value within a buffer
+ * @param t - pointer to the token to print
+ */
+void token_t_src_print(token_t* t);
+
+/**
+ * @brief - A growing stream of tokens
+ * @property items - pointer to the tokens
+ * @property len - length of the stream
+ * @property capacity - total length of the memory allocated
+ */
+typedef struct {
+    token_t* items;
+    size_t len;
+    size_t capacity;
+} token_stream_t;
+
+/**
+ * @brief initializes a token stream
+ * @param s - pointer to the stream to init
+ */
+void token_stream_t_init(token_stream_t* s);
+
+/**
+ * @brief frees a token stream
+ * @param s - pointer to the stream to free
+ */
+void token_stream_t_deinit(token_stream_t* s);
+
+/**
+ * @brief Pushes a new token to the stream
+ * @param s - pointer to the stream to add to
+ * @param add - new token to add
+ */
+void token_stream_t_push(token_stream_t* s, token_t add);
+
+/**
+ * @brief Tokenizes a string and appends all tokens to a stream
+ * @param json - JSON string to tokenize
+ * @param size - size of the JSON string
+ * @param stream - token stream to append to
+ */
+int tokenize_json(const char* json, size_t size, token_stream_t* stream);
+
+/**
+ * @brief - Character classes of a 64 byte block, bit `i` of every mask describes byte `i` of the block
+ * @property structural - { } [ ] : ,
+ * @property quote - "
+ * @property backslash - \\
+ * @property whitespace - space, tab, line feed and carriage return
+ * @property control - bytes below 0x20, which may never appear raw inside a string
+ */
+typedef struct {
+    uint64_t structural;
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t whitespace;
+    uint64_t control;
+} json_block_masks_t;
+
+/**
+ * @brief Classifies 64 bytes at once with the active vector kernels
+ * @param block - 64 readable bytes
+ * @param masks - classification output
+ */
+void json_classify_block(const char* block, json_block_masks_t* masks);
+
+/**
+ * @brief Returns the name of the vector kernels picked for this CPU ("avx2", "sse2", "neon" or "scalar")
+ * @return static string naming the backend
+ */
+const char* json_simd_backend(void);
+
+/**
+ * @brief Forces a kernel set, mostly useful for testing and benchmarking
+ * @param name - "avx2", "sse2", "neon" or "scalar"
+ * @return 0 on success
+ * @return negative number if the build or CPU does not support it
+ */
+int json_simd_set_backend(const char* name);
+
+// STATS IMPL
+
+/**
+ * @brief - Zeroes every counter and clears the hooks
+ * @param stats - pointer to the stats to initialize
+ */
+void json_parse_stats_t_init(json_parse_stats_t* stats) {
+    memset(stats, 0, sizeof(json_parse_stats_t));
+}
+
+#ifdef JSON_ENABLE_STATS
+
+// Stats of the parse running on this thread, for the allocators and maps that never see the parse state
+static __thread json_parse_stats_t* stats_current = NULL;
+
+typedef struct {
+    uint64_t ns;
+    uint64_t cycles;
+} stats_mark_t;
+
+static stats_mark_t stats_mark(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    stats_mark_t mark;
+    mark.ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#if defined(__x86_64__) || defined(__i386__)
+    mark.cycles = __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(mark.cycles));
+#else
+    mark.cycles = 0;
+#endif
+    return mark;
+}
+
+static void stats_add(json_parse_stats_t* stats, json_phase_t phase, stats_mark_t start) {
+    stats_mark_t end = stats_mark();
+    stats->ns[phase] += end.ns - start.ns;
+    stats->cycles[phase] += end.cycles - start.cycles;
+}
+
+static void stats_phase(json_parse_stats_t* stats, json_phase_t phase, int end) {
+    if (stats->hooks.on_phase != NULL) {
+        stats->hooks.on_phase(stats->hooks.ctx, phase, end);
+    }
+}
+
+static void stats_alloc(json_parse_stats_t* stats, stats_mark_t start, void* ptr, size_t size) {
+    stats_add(stats, JSON_PHASE_ALLOC, start);
+    stats->allocs++;
+    stats->alloc_bytes += size;
+
+    if (stats->hooks.on_alloc != NULL) {
+        stats->hooks.on_alloc(stats->hooks.ctx, ptr, size);
+    }
+}
+
+// Evaluates an allocation, timing and counting it when this thread is collecting stats
+#define STATS_ALLOC(size, expr) ({                                                  \
+    json_parse_stats_t* stats_ = stats_current;                                     \
+    stats_mark_t mark_ = { 0, 0 };                                                  \
+    if (stats_ != NULL) mark_ = stats_mark();                                       \
+    void* ptr_ = (expr);                                                            \
+    if (stats_ != NULL && ptr_ != NULL) stats_alloc(stats_, mark_, ptr_, (size));   \
+    ptr_;                                                                           \
+})
+
+static void stats_probe(size_t len) {
+    json_parse_stats_t* stats = stats_current;
+    if (stats == NULL) {
+        return;
+    }
+
+    size_t bucket = 0;
+    while (bucket < JSON_STATS_PROBE_BUCKETS - 1 && (len >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+
+    stats->map_inserts++;
+    stats->probe_histogram[bucket]++;
+    if (len > stats->max_probe) {
+        stats->max_probe = len;
+    }
+}
+
+#else
+
+#define STATS_ALLOC(size, expr) (expr)
+#define stats_probe(len) ((void)0)
+
+#endif
+
+// ARENA IMPL
+
+/**
+ * @brief - Initializes an empty arena, no memory is requested until the first allocation
+ * @param arena - pointer to the arena to initialize
+ */
+void json_arena_t_init(json_arena_t* arena) {
+    arena->head = NULL;
+    arena->block_size = JSON_ARENA_BLOCK_SIZE;
+
+    arena->alloc_count = 0;
+    arena->bytes_allocated = 0;
+    arena->block_count = 0;
+    arena->bytes_reserved = 0;
+}
+
+static size_t arena_align(size_t size) {
+    return (size + JSON_ARENA_ALIGN - 1) & ~((size_t)JSON_ARENA_ALIGN - 1);
+}
+
+static json_arena_block_t* arena_new_block(json_arena_t* arena, size_t min_size) {
+    size_t capacity = arena->block_size;
+    if (capacity < min_size) {
+        capacity = min_size;
+    }
+
+    // The header is padded so `data` keeps the arena alignment
+    size_t header = arena_align(sizeof(json_arena_block_t));
+    json_arena_block_t* block = JSON_MALLOC(header + capacity);
+    if (block == NULL) {
+        return NULL;
+    }
+
+    block->data = (char*)block + header;
+    block->used = 0;
+    block->capacity = capacity;
+
+    arena->block_count++;
+    arena->bytes_reserved += capacity;
+
+    // Later blocks get geometrically larger so big documents only take a few of them
+    if (arena->block_size < JSON_ARENA_MAX_BLOCK_SIZE) {
+        arena->block_size *= 2;
+    }
+
+    return block;
+}
+
+/**
+ * @brief - Allocates `size` bytes from the arena, aligned to `JSON_ARENA_ALIGN`
+ * @param arena - pointer to the arena to allocate from
+ * @param size - number of bytes to allocate
+ * @return pointer to the memory, owned by the arena
+ * @return NULL if the system is out of memory
+ */
+void* json_arena_t_alloc(json_arena_t* arena, size_t size) {
+    size = arena_align(size == 0 ? 1 : size);
+    json_arena_block_t* head = arena->head;
+
+    if (head == NULL || head->capacity - head->used < size) {
+        json_arena_block_t* block = arena_new_block(arena, size);
+        if (block == NULL) {
+            return NULL;
+        }
+
+        if (head != NULL && size > arena->block_size / 4) {
+            // Oversized allocations get a block of their own behind the head, so the
+            // space left in the current block is not thrown away
+            block->next = head->next;
+            head->next = block;
+            head = block;
+        } else {
+            block->next = head;
+            arena->head = block;
+            head = block;
+        }
+    }
+
+    void* ptr = head->data + head->used;
+    head->used += size;
+
+    arena->alloc_count++;
+    arena->bytes_allocated += size;
+
+    return ptr;
+}
+
+/**
+ * @brief - Grows an allocation made from the arena, extending it in place when it was the most recent one
+ * @param arena - pointer to the arena the allocation came from
+ * @param ptr - previous allocation (or NULL)
+ * @param old_size - size of the previous allocation
+ * @param new_size - requested size
+ * @return pointer to the (possibly moved) memory
+ * @return NULL if the system is out of memory
+ */
+void* json_arena_t_realloc(json_arena_t* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (ptr == NULL) {
+        return json_arena_t_alloc(arena, new_size);
+    }
+
+    json_arena_block_t* head = arena->head;
+    size_t old_aligned = arena_align(old_size == 0 ? 1 : old_size);
+    size_t new_aligned = arena_align(new_size == 0 ? 1 : new_size);
+
+    if (head != NULL && (char*)ptr + old_aligned == head->data + head->used
+            && new_aligned - old_aligned <= head->capacity - head->used
+            && new_aligned >= old_aligned) {
+        head->used += new_aligned - old_aligned;
+        arena->bytes_allocated += new_aligned - old_aligned;
+        return ptr;
+    }
+
+    if (new_size <= old_size) {
+        return ptr;
+    }
+
+    void* moved = json_arena_t_alloc(arena, new_size);
+    if (moved != NULL) {
+        memcpy(moved, ptr, old_size);
+    }
+
+    return moved;
+}
+
+/**
+ * @brief - Frees every block owned by the arena, invalidating everything allocated from it
+ * @param arena - pointer to the arena to deinit
+ */
+void json_arena_t_deinit(json_arena_t* arena) {
+    json_arena_block_t* curr = arena->head;
+
+    while (curr != NULL) {
+        json_arena_block_t* tmp = curr;
+        curr = curr->next;
+        JSON_FREE(tmp);
+    }
+
+    json_arena_t_init(arena);
+}
+
+/**
+ * @brief - Empties the arena but keeps its memory, invalidating everything allocated from it
+ * When it owns more than one block they are merged into a single block of their combined size,
+ * so refilling it with the same amount of data needs no new blocks
+ * @param arena - pointer to the arena to reset
+ * @return 0 on success
+ * @return ALLOCATION_FAILED if the merged block could not be allocated, the arena is left empty
+ */
+int json_arena_t_reset(json_arena_t* arena) {
+    json_arena_block_t* head = arena->head;
+    arena->alloc_count = 0;
+    arena->bytes_allocated = 0;
+
+    if (head == NULL || head->next == NULL) {
+        if (head != NULL) {
+            head->used = 0;
+        }
+        return 0;
+    }
+
+    size_t capacity = arena->bytes_reserved;
+    size_t block_count = arena->block_count;
+    size_t block_size = arena->block_size;
+    json_arena_t_deinit(arena);
+
+    // block_count keeps counting every block ever requested, so callers can tell when it stops growing
+    arena->block_count = block_count;
+    arena->block_size = capacity;
+
+    json_arena_block_t* block = arena_new_block(arena, capacity);
+    if (block == NULL) {
+        return ALLOCATION_FAILED;
+    }
+
+    block->next = NULL;
+    arena->head = block;
+    arena->block_size = block_size;
+    return 0;
+}
+
+static void* mem_alloc(json_arena_t* arena, size_t size) {
+    return STATS_ALLOC(size, arena != NULL ? json_arena_t_alloc(arena, size) : JSON_MALLOC(size));
+}
+
+static void mem_free(json_arena_t* arena, void* ptr) {
+    if (arena == NULL) {
+        JSON_FREE(ptr);
+    }
+}
+
+static char* mem_strndup(json_arena_t* arena, const char* str, size_t len) {
+    char* copy = mem_alloc(arena, len + 1);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+// WALK IMPL
+
+// Freeing, writing and converting trees keep their own stack of open containers instead of recursing, so the depth
+// the parser accepts never turns into depth on the C stack. The stack starts in `local` storage and moves to the heap
+// the first time it fills up, returning the new stack or NULL with the old one untouched
+static void* walk_stack_grow(void* stack, void* local, size_t* capacity, size_t size) {
+    size_t grown_capacity = *capacity * 2;
+    void* grown;
+
+    if (stack == local) {
+        grown = JSON_MALLOC(grown_capacity * size);
+        if (grown != NULL) {
+            memcpy(grown, local, *capacity * size);
+        }
+    } else {
+        grown = JSON_REALLOC(stack, grown_capacity * size);
+    }
+
+    if (grown != NULL) {
+        *capacity = grown_capacity;
+    }
+
+    return grown;
+}
+
+/**
+ * @brief - A heap container `json_deinit` is inside of
+ * @property container - The object or array
+ * @property idx - Index of the next member or element to release
+ */
+typedef struct {
+    json_object_t container;
+    size_t idx;
+} deinit_frame_t;
+
+/**
+ * @brief - Heap containers `json_deinit` has opened but not freed yet, innermost last
+ * @property frames - The open containers, `local` until it overflows
+ * @property len - Number of open containers
+ * @property capacity - Number of containers `frames` has room for
+ * @property local - Storage for the first levels, so shallow trees never allocate to be freed
+ */
+typedef struct {
+    deinit_frame_t* frames;
+    size_t len;
+    size_t capacity;
+    deinit_frame_t local[JSON_WALK_STACK_SIZE];
+} deinit_stack_t;
+
+static void deinit_stack_init(deinit_stack_t* s) {
+    s->frames = s->local;
+    s->len = 0;
+    s->capacity = JSON_WALK_STACK_SIZE;
+}
+
+static void deinit_stack_deinit(deinit_stack_t* s) {
+    if (s->frames != s->local) {
+        JSON_FREE(s->frames);
+    }
+}
+
+static void deinit_key(json_object_entry_t* entry) {
+    if (!(entry->flags & (JSON_ENTRY_BORROWED_KEY | JSON_ENTRY_INTERNED_KEY))) {
+        JSON_FREE(entry->key);
+    }
+}
+
+// Frees a string right away and opens a heap container, arena backed containers are left to their arena
+static void deinit_release(deinit_stack_t* s, json_object_t* obj) {
+    if (obj->tag == STRING) {
+        JSON_FREE(obj->val.str);
+        return;
+    }
+
+    if (!(obj->tag == OBJECT && obj->val.obj->arena == NULL) && !(obj->tag == ARRAY && obj->val.arr->arena == NULL)) {
+        return;
+    }
+
+    if (s->len == s->capacity) {
+        deinit_frame_t* frames = walk_stack_grow(s->frames, s->local, &s->capacity, sizeof(deinit_frame_t));
+        if (frames == NULL) {
+            // Nowhere to open it, so this subtree gets a walk of its own
+            json_deinit(obj);
+            return;
+        }
+        s->frames = frames;
+    }
+
+    s->frames[s->len].container = *obj;
+    s->frames[s->len].idx = 0;
+    s->len++;
+}
+
+// Frees the open containers depth first, each one after its last member, so the stack only ever holds one path
+static void deinit_drain(deinit_stack_t* s) {
+    while (s->len > 0) {
+        deinit_frame_t* frame = &s->frames[s->len - 1];
+
+        if (frame->container.tag == OBJECT) {
+            json_object_map_t* map = frame->container.val.obj;
+            if (frame->idx < map->len) {
+                json_object_entry_t* entry = &map->entries[frame->idx++];
+                deinit_key(entry);
+                deinit_release(s, &entry->value);
+                continue;
+            }
+
+            JSON_FREE(map->entries);
+            JSON_FREE(map->slots);
+            JSON_FREE(map);
+        } else {
+            json_array_t* arr = frame->container.val.arr;
+            if (frame->idx < arr->len) {
+                deinit_release(s, &arr->items[frame->idx++]);
+                continue;
+            }
+
+            JSON_FREE(arr->items);
+            JSON_FREE(arr);
+        }
+
+        s->len--;
+    }
+}
+
+// HASHMAP IMPL
+
+static void mul128(uint64_t a, uint64_t b, uint64_t* hi, uint64_t* lo) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t)a * b;
+    *hi = (uint64_t)(r >> 64);
+    *lo = (uint64_t)r;
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    *hi = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    *lo = (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+static uint64_t hash_mix(uint64_t a, uint64_t b) {
+    uint64_t hi, lo;
+    mul128(a, b, &hi, &lo);
+    return hi ^ lo;
+}
+
+static uint64_t read_u64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t read_partial_u64(const char* p, size_t len) {
+    uint64_t v = 0;
+    memcpy(&v, p, len);
+    return v;
+}
+
+#define HASH_K0 0xa0761d6478bd642full
+#define HASH_K1 0xe7037ed1a0b428dbull
+#define HASH_K2 0x8ebc6af09c88c6e3ull
+
+/**
+ * @brief - Hashes a byte string with a seed, keys hashed with different seeds are unrelated
+ * Every 16 bytes are folded in through a full 64x64->128 bit multiply, so flipping any input bit changes the whole result
+ * @param key - the bytes to hash
+ * @param len - number of bytes in key
+ * @param seed - seed to mix into the hash
+ * @return 64 bit hash of the key
+ */
+uint64_t json_hash(const char* key, size_t len, uint64_t seed) {
+    uint64_t h = hash_mix(seed ^ HASH_K0, HASH_K1);
+    size_t remaining = len;
+
+    while (remaining > 16) {
+        h = hash_mix(read_u64(key) ^ HASH_K1, read_u64(key + 8) ^ h);
+        key += 16;
+        remaining -= 16;
+    }
+
+    uint64_t a, b;
+    if (remaining > 8) {
+        a = read_u64(key);
+        b = read_partial_u64(key + 8, remaining - 8);
+    } else {
+        a = read_partial_u64(key, remaining);
+        b = 0;
+    }
+
+    return hash_mix(HASH_K2 ^ len, hash_mix(a ^ HASH_K1, b ^ h));
+}
+
+static uint64_t global_hash_seed = 0;
+
+/**
+ * @brief - Returns the process wide seed new maps hash their keys with, picking a random one on first use
+ * The default seed mixes the clock with stack and image addresses, so it differs between runs when ASLR is on
+ * @return the current seed
+ */
+uint64_t json_hash_seed(void) {
+    uint64_t seed = __atomic_load_n(&global_hash_seed, __ATOMIC_RELAXED);
+    if (seed != 0) {
+        return seed;
+    }
+
+    int local = 0;
+    uint64_t entropy = (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32);
+    entropy ^= hash_mix((uint64_t)(uintptr_t)&local, (uint64_t)(uintptr_t)&global_hash_seed ^ HASH_K0);
+    seed = hash_mix(entropy ^ HASH_K2, HASH_K1) | 1;
+
+    // Only the first caller gets to pick, everyone else adopts its seed
+    uint64_t expected = 0;
+    if (!__atomic_compare_exchange_n(&global_hash_seed, &expected, seed, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        seed = expected;
+    }
+
+    return seed;
+}
+
+/**
+ * @brief - Overrides the process wide hash seed, only maps initialized afterwards use it
+ * @param seed - the new seed
+ */
+void json_set_hash_seed(uint64_t seed) {
+    __atomic_store_n(&global_hash_seed, seed == 0 ? 1 : seed, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief - Initializes a JSON Object HashMap
+ * @param map - pointer to the HashMap to initialize
+ */
+void json_object_map_t_init(json_object_map_t* map) {
+    map->entries = NULL;
+    map->slots = NULL;
+    map->len = 0;
+    map->entries_capacity = 0;
+    map->slot_mask = 0;
+    map->seed = json_hash_seed();
+    map->arena = NULL;
+}
+
+/**
+ * @brief - Deinitializes and frees all allocated memory for a JSON Object HashMap
+ * @param map - pointer to the HashMap to initialize
+ */
+void json_object_map_t_deinit(json_object_map_t* map) {
+    // Everything lives in the arena and goes away with it
+    if (map->arena != NULL) {
+        return;
+    }
+
+    deinit_stack_t s;
+    deinit_stack_init(&s);
+    for (size_t i = 0; i < map->len; i++) {
+        deinit_key(&map->entries[i]);
+        deinit_release(&s, &map->entries[i].value);
+        deinit_drain(&s);
+    }
+    deinit_stack_deinit(&s);
+
+    JSON_FREE(map->entries);
+    JSON_FREE(map->slots);
+
+    map->entries = NULL;
+    map->slots = NULL;
+    map->len = 0;
+    map->entries_capacity = 0;
+    map->slot_mask = 0;
+}
+
+static uint64_t map_slot(uint64_t hash, size_t idx) {
+    return (hash & 0xFFFFFFFF00000000ull) | (uint64_t)(idx + 1);
+}
+
+static int map_resize(json_object_map_t* map, size_t slot_count) {
+    // Keeps the load factor at or below 3/4. Entries grow first so that in an arena
+    // they are usually the most recent allocation and get extended in place
+    size_t entries_capacity = slot_count / 4 * 3;
+    json_object_entry_t* entries;
+    if (map->arena != NULL) {
+        entries = STATS_ALLOC(entries_capacity * sizeof(json_object_entry_t),
+                              json_arena_t_realloc(map->arena, map->entries,
+                                                   map->entries_capacity * sizeof(json_object_entry_t),
+                                                   entries_capacity * sizeof(json_object_entry_t)));
+    } else {
+        entries = STATS_ALLOC(entries_capacity * sizeof(json_object_entry_t),
+                              JSON_REALLOC(map->entries, entries_capacity * sizeof(json_object_entry_t)));
+    }
+
+    if (entries == NULL) {
+        return ALLOCATION_FAILED;
+    }
+
+    map->entries = entries;
+
+    uint64_t* slots = mem_alloc(map->arena, slot_count * sizeof(uint64_t));
+    if (slots == NULL) {
+        return ALLOCATION_FAILED;
+    }
+    memset(slots, 0, slot_count * sizeof(uint64_t));
+
+    size_t mask = slot_count - 1;
+    for (size_t i = 0; i < map->len; i++) {
+        size_t pos = entries[i].hash & mask;
+        while (slots[pos] != 0) {
+            pos = (pos + 1) & mask;
+        }
+        slots[pos] = map_slot(entries[i].hash, i);
+    }
+
+    mem_free(map->arena, map->slots);
+    map->slots = slots;
+    map->slot_mask = mask;
+    map->entries_capacity = entries_capacity;
+    return 0;
+}
+
+static json_object_entry_t* map_find(json_object_map_t* map, const char* key, size_t key_len, uint64_t hash, size_t* slot_pos) {
+    size_t mask = map->slot_mask;
+    size_t pos = hash & mask;
+    uint64_t tag = hash & 0xFFFFFFFF00000000ull;
+
+    while (map->slots[pos] != 0) {
+        uint64_t slot = map->slots[pos];
+        if ((slot & 0xFFFFFFFF00000000ull) == tag) {
+            json_object_entry_t* entry = &map->entries[(uint32_t)slot - 1];
+            // Interned keys are equal exactly when their pointers are, so the bytes are only compared otherwise
+            if (entry->hash == hash && entry->key_len == key_len && (entry->key == key || memcmp(entry->key, key, key_len) == 0)) {
+                stats_probe(((pos - hash) & mask) + 1);
+                return entry;
+            }
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    stats_probe(((pos - hash) & mask) + 1);
+    *slot_pos = pos;
+    return NULL;
+}
+
+// Looks up a key whose hash under this map's seed is already known, the map must not be empty
+static json_object_t* map_lookup(json_object_map_t* map, const char* key, size_t key_len, uint64_t hash) {
+    size_t pos;
+    json_object_entry_t* entry = map_find(map, key, key_len, hash, &pos);
+    return entry != NULL ? &entry->value : NULL;
+}
+
+/**
+ * @brief - Pre-sizes the HashMap so `count` entries fit without growing
+ * @param map - Pointer to the HashMap to grow
+ * @param count - Number of entries to make room for
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_object_map_t_reserve(json_object_map_t* map, size_t count) {
+    if (count <= map->entries_capacity) {
+        return 0;
+    }
+
+    size_t slot_count = JSON_MAP_START_SLOTS;
+    while (slot_count / 4 * 3 < count) {
+        slot_count *= 2;
+    }
+
+    return map_resize(map, slot_count);
+}
+
+/**
+ * @brief - How `map_insert` treats the key it is given
+ */
+typedef enum {
+    /**
+     * @brief - Copy the key into memory owned by the map
+     */
+    MAP_KEY_COPY,
+    /**
+     * @brief - The key was allocated from the map's allocator, the map takes ownership of it
+     */
+    MAP_KEY_TAKE,
+    /**
+     * @brief - Reference the key where it is, it has to outlive the map
+     */
+    MAP_KEY_BORROW,
+    /**
+     * @brief - The key is the canonical copy held by an intern table
+     */
+    MAP_KEY_INTERNED,
+} map_key_mode_t;
+
+// Inserts a key whose hash under this map's seed is already known
+static int map_insert_hashed(json_object_map_t* map, char* key, size_t key_len, uint64_t hashed, json_object_t* val,
+                             map_key_mode_t mode) {
+    if (map->len == map->entries_capacity) {
+        size_t slot_count = map->slot_mask == 0 ? JSON_MAP_START_SLOTS : (map->slot_mask + 1) * 2;
+        if (map_resize(map, slot_count) != 0) {
+            return ALLOCATION_FAILED;
+        }
+    }
+
+    size_t pos;
+
+    json_object_entry_t* existing = map_find(map, key, key_len, hashed, &pos);
+    if (existing != NULL) {
+        if (map->arena == NULL) {
+            json_deinit(&existing->value);
+        }
+
+        if (mode == MAP_KEY_TAKE) {
+            mem_free(map->arena, key);
+        }
+
+        existing->value = *val;
+        return 0;
+    }
+
+    char* stored = key;
+    if (mode == MAP_KEY_COPY) {
+        stored = mem_strndup(map->arena, key, key_len);
+        if (stored == NULL) {
+            return ALLOCATION_FAILED;
+        }
+    }
+
+    json_object_entry_t* entry = &map->entries[map->len];
+    entry->key = stored;
+    entry->key_len = key_len;
+    entry->hash = hashed;
+    entry->flags = mode == MAP_KEY_BORROW ? JSON_ENTRY_BORROWED_KEY : mode == MAP_KEY_INTERNED ? JSON_ENTRY_INTERNED_KEY : 0;
+    entry->value = *val;
+
+    map->slots[pos] = map_slot(hashed, map->len);
+    map->len++;
+    return 0;
+}
+
+static int map_insert(json_object_map_t* map, char* key, size_t key_len, json_object_t* val, map_key_mode_t mode) {
+    return map_insert_hashed(map, key, key_len, json_hash(key, key_len, map->seed), val, mode);
+}
+
+/**
+ * @brief - Registers a key value json object pair whose key is not null terminated
+ * @param map - pointer to the HashMap to insert into
+ * @param key - The name of the object to register
+ * @param key_len - Length of the key in bytes
+ * @param val - pointer to the json object to register, copied the same way as `json_object_map_t_insert`
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_object_map_t_insert_n(json_object_map_t* map, const char* key, size_t key_len, json_object_t* val) {
+    return map_insert(map, (char*)key, key_len, val, MAP_KEY_COPY);
+}
+
+/**
+ * @brief - Registers a key value json object pair
+ * @param map - pointer to the HashMap to initialize
+ * @param key - The name of the object to register
+ * @param val - pointer to the json object to register, map will not own the pointer and rather perform a deep clone internally, so you have to free this val itself if you malloc'd it.
+ */
+void json_object_map_t_insert(json_object_map_t* map, const char* key, json_object_t* val) {
+    json_object_map_t_insert_n(map, key, strlen(key), val);
+}
+
+/**
+ * @brief - Checks the HashMap for a key that is not null terminated
+ * @param map - Pointer to the HashMap to search
+ * @param key - Name of the entry to find
+ * @param key_len - Length of the key in bytes
+ *
+ * @return pointer to the JSON object if it exists
+ * @return NULL if key doesn't exist
+ */
+json_object_t* json_object_map_t_get_n(json_object_map_t* map, const char* key, size_t key_len) {
+    if (map->len == 0) {
+        return NULL;
+    }
+
+    return map_lookup(map, key, key_len, json_hash(key, key_len, map->seed));
+}
+
+/**
+ * @brief - Checks the HashMap for a key, returning a pointer to its JSON object if it exists
+ * @param map - Pointer to the HashMap to initialize
+ * @param key - Name of the entry to find
+ *
+ * @return pointer to the JSON object if it exists
+ * @return NULL if key doesn't exist
+ */
+json_object_t* json_object_map_t_get(json_object_map_t* map, const char* key) {
+    return json_object_map_t_get_n(map, key, strlen(key));
+}
+
+/**
+ * @brief - Initializes a key handle and hashes it with the current process wide seed
+ * @param key - pointer to the handle to initialize
+ * @param str - the key bytes, must outlive the handle
+ * @param len - length of str
+ */
+void json_key_t_init(json_key_t* key, const char* str, size_t len) {
+    key->key = str;
+    key->len = len;
+    key->seed = json_hash_seed();
+    key->hash = json_hash(str, len, key->seed);
+}
+
+// Returns the key's hash under `seed`, caching it when the handle holds a hash for another seed
+static inline uint64_t key_hash(json_key_t* key, uint64_t seed) {
+    // The seed is published after the hash, so a reader that sees the seed also sees its hash
+    if (__atomic_load_n(&key->seed, __ATOMIC_ACQUIRE) == seed) {
+        return __atomic_load_n(&key->hash, __ATOMIC_RELAXED);
+    }
+
+    uint64_t hash = json_hash(key->key, key->len, seed);
+    __atomic_store_n(&key->seed, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&key->hash, hash, __ATOMIC_RELAXED);
+    __atomic_store_n(&key->seed, seed, __ATOMIC_RELEASE);
+    return hash;
+}
+
+/**
+ * @brief - Checks the HashMap for a pre-hashed key, comparing hashes and lengths before any bytes
+ * @param map - Pointer to the HashMap to search
+ * @param key - Handle of the entry to find
+ * @return pointer to the JSON object if it exists
+ * @return NULL if key doesn't exist
+ */
+json_object_t* json_object_map_t_get_key(json_object_map_t* map, json_key_t* key) {
+    if (map->len == 0) {
+        return NULL;
+    }
+
+    return map_lookup(map, key->key, key->len, key_hash(key, map->seed));
+}
+
+/**
+ * @brief - Registers a key value json object pair under a pre-hashed key, copied the same way as `json_object_map_t_insert`
+ * @param map - pointer to the HashMap to insert into
+ * @param key - Handle of the key to register
+ * @param val - pointer to the json object to register
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_object_map_t_insert_key(json_object_map_t* map, json_key_t* key, json_object_t* val) {
+    return map_insert_hashed(map, (char*)key->key, key->len, key_hash(key, map->seed), val, MAP_KEY_COPY);
+}
+
+// INTERN IMPL
+
+/**
+ * @brief - Initializes an empty intern table
+ * @param intern - pointer to the table to initialize
+ * @return 0 on success
+ * @return ALLOCATION_FAILED if a lock could not be created
+ */
+int json_intern_t_init(json_intern_t* intern) {
+    intern->seed = json_hash_seed();
+
+    for (size_t i = 0; i < JSON_INTERN_SHARDS; i++) {
+        json_intern_shard_t* shard = &intern->shards[i];
+        if (pthread_rwlock_init(&shard->lock, NULL) != 0) {
+            while (i-- > 0) {
+                pthread_rwlock_destroy(&intern->shards[i].lock);
+            }
+            return ALLOCATION_FAILED;
+        }
+
+        shard->slots = NULL;
+        shard->slot_mask = 0;
+        shard->len = 0;
+        json_arena_t_init(&shard->arena);
+        shard->lookups = 0;
+        shard->hits = 0;
+        shard->bytes_saved = 0;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief - Frees every canonical key, maps still pointing at them must not be used afterwards
+ * @param intern - pointer to the table to deinit
+ */
+void json_intern_t_deinit(json_intern_t* intern) {
+    for (size_t i = 0; i < JSON_INTERN_SHARDS; i++) {
+        json_intern_shard_t* shard = &intern->shards[i];
+        pthread_rwlock_destroy(&shard->lock);
+        JSON_FREE(shard->slots);
+        json_arena_t_deinit(&shard->arena);
+        shard->slots = NULL;
+        shard->slot_mask = 0;
+        shard->len = 0;
+    }
+}
+
+// Probes a shard for a key, returning its entry or the empty slot it would go in
+static json_intern_entry_t* intern_find(json_intern_shard_t* shard, const char* key, size_t len, uint64_t hash) {
+    size_t pos = hash & shard->slot_mask;
+
+    for (;;) {
+        json_intern_entry_t* entry = &shard->slots[pos];
+        if (entry->key == NULL ||
+            (entry->hash == hash && entry->len == len && memcmp(entry->key, key, len) == 0)) {
+            return entry;
+        }
+        pos = (pos + 1) & shard->slot_mask;
+    }
+}
+
+static int intern_resize(json_intern_shard_t* shard, size_t slot_count) {
+    json_intern_entry_t* slots = JSON_MALLOC(slot_count * sizeof(json_intern_entry_t));
+    if (slots == NULL) {
+        return ALLOCATION_FAILED;
+    }
+    memset(slots, 0, slot_count * sizeof(json_intern_entry_t));
+
+    json_intern_entry_t* old = shard->slots;
+    size_t old_count = old != NULL ? shard->slot_mask + 1 : 0;
+
+    shard->slots = slots;
+    shard->slot_mask = slot_count - 1;
+
+    for (size_t i = 0; i < old_count; i++) {
+        if (old[i].key != NULL) {
+            *intern_find(shard, old[i].key, old[i].len, old[i].hash) = old[i];
+        }
+    }
+
+    JSON_FREE(old);
+    return 0;
+}
+
+// Interns a key, also handing back its hash under the table's seed so maps sharing that seed don't hash it again
+static const char* intern_key(json_intern_t* intern, const char* key, size_t len, uint64_t* hash_out) {
+    uint64_t hash = json_hash(key, len, intern->seed);
+    json_intern_shard_t* shard = &intern->shards[hash >> (64 - JSON_INTERN_SHARD_BITS)];
+    *hash_out = hash;
+
+    __atomic_fetch_add(&shard->lookups, 1, __ATOMIC_RELAXED);
+
+    // Nearly every lookup of a repeated schema hits, and hits only need the shared lock
+    pthread_rwlock_rdlock(&shard->lock);
+    if (shard->slots != NULL) {
+        json_intern_entry_t* entry = intern_find(shard, key, len, hash);
+        if (entry->key != NULL) {
+            const char* canonical = entry->key;
+            pthread_rwlock_unlock(&shard->lock);
+
+            __atomic_fetch_add(&shard->hits, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&shard->bytes_saved, len + 1, __ATOMIC_RELAXED);
+            return canonical;
+        }
+    }
+    pthread_rwlock_unlock(&shard->lock);
+
+    pthread_rwlock_wrlock(&shard->lock);
+
+    // Grows at three quarters full, which also covers the first insert into an empty shard
+    if (shard->slots == NULL || (shard->len + 1) * 4 > (shard->slot_mask + 1) * 3) {
+        size_t slot_count = shard->slots == NULL ? JSON_INTERN_START_SLOTS : (shard->slot_mask + 1) * 2;
+        if (intern_resize(shard, slot_count) != 0) {
+            pthread_rwlock_unlock(&shard->lock);
+            return NULL;
+        }
+    }
+
+    // Another thread may have added the key between the two locks
+    json_intern_entry_t* entry = intern_find(shard, key, len, hash);
+    if (entry->key == NULL) {
+        char* copy = json_arena_t_alloc(&shard->arena, len + 1);
+        if (copy == NULL) {
+            pthread_rwlock_unlock(&shard->lock);
+            return NULL;
+        }
+
+        memcpy(copy, key, len);
+        copy[len] = '\0';
+
+        entry->key = copy;
+        entry->len = len;
+        entry->hash = hash;
+        shard->len++;
+    } else {
+        __atomic_fetch_add(&shard->hits, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&shard->bytes_saved, len + 1, __ATOMIC_RELAXED);
+    }
+
+    const char* canonical = entry->key;
+    pthread_rwlock_unlock(&shard->lock);
+    return canonical;
+}
+
+/**
+ * @brief - Returns the canonical copy of a key, adding it on first sight
+ * @param intern - pointer to the table
+ * @param key - the key bytes
+ * @param len - length of key
+ * @return null terminated canonical key, equal keys always get the same pointer
+ * @return NULL if memory could not be allocated
+ */
+const char* json_intern_t_intern(json_intern_t* intern, const char* key, size_t len) {
+    uint64_t hash;
+    return intern_key(intern, key, len, &hash);
+}
+
+/**
+ * @brief - Reads the table's counters
+ * @param intern - pointer to the table
+ * @param stats - filled with the counters
+ */
+void json_intern_t_stats(json_intern_t* intern, json_intern_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    for (size_t i = 0; i < JSON_INTERN_SHARDS; i++) {
+        json_intern_shard_t* shard = &intern->shards[i];
+        stats->lookups += __atomic_load_n(&shard->lookups, __ATOMIC_RELAXED);
+        stats->hits += __atomic_load_n(&shard->hits, __ATOMIC_RELAXED);
+        stats->bytes_saved += __atomic_load_n(&shard->bytes_saved, __ATOMIC_RELAXED);
+
+        pthread_rwlock_rdlock(&shard->lock);
+        stats->unique_keys += shard->len;
+        stats->bytes_stored += shard->arena.bytes_allocated;
+        pthread_rwlock_unlock(&shard->lock);
+    }
+}
+
+// ARRAY IMPL
+
+/**
+ * @brief - Initializes an empty array
+ * @param arr - pointer to the array to initialize
+ */
+void json_array_t_init(json_array_t* arr) {
+    arr->items = NULL;
+    arr->len = 0;
+    arr->capacity = 0;
+    arr->arena = NULL;
+}
+
+/**
+ * @brief - Deinitializes every element and frees the array's buffer
+ * @param arr - pointer to the array to deinit
+ */
+void json_array_t_deinit(json_array_t* arr) {
+    // Everything lives in the arena and goes away with it
+    if (arr->arena != NULL) {
+        return;
+    }
+
+    deinit_stack_t s;
+    deinit_stack_init(&s);
+    for (size_t i = 0; i < arr->len; i++) {
+        deinit_release(&s, &arr->items[i]);
+        deinit_drain(&s);
+    }
+    deinit_stack_deinit(&s);
+
+    JSON_FREE(arr->items);
+
+    arr->items = NULL;
+    arr->len = 0;
+    arr->capacity = 0;
+}
+
+static int array_resize(json_array_t* arr, size_t capacity) {
+    json_object_t* items;
+    if (arr->arena != NULL) {
+        items = STATS_ALLOC(capacity * sizeof(json_object_t),
+                            json_arena_t_realloc(arr->arena, arr->items,
+                                                 arr->capacity * sizeof(json_object_t),
+                                                 capacity * sizeof(json_object_t)));
+    } else {
+        items = STATS_ALLOC(capacity * sizeof(json_object_t), JSON_REALLOC(arr->items, capacity * sizeof(json_object_t)));
+    }
+
+    if (items == NULL) {
+        return ALLOCATION_FAILED;
+    }
+
+    arr->items = items;
+    arr->capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief - Pre-sizes the array so `count` elements fit without growing
+ * @param arr - pointer to the array to grow
+ * @param count - number of elements to make room for
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_array_t_reserve(json_array_t* arr, size_t count) {
+    if (count <= arr->capacity) {
+        return 0;
+    }
+
+    return array_resize(arr, count);
+}
+
+/**
+ * @brief - Appends a value, growing the buffer geometrically
+ * @param arr - pointer to the array to append to
+ * @param val - pointer to the value to append, the array takes over whatever it owns the same way a map does
+ * @return 0 on success
+ * @return negative number if memory could not be allocated
+ */
+int json_array_t_push(json_array_t* arr, json_object_t* val) {
+    if (arr->len == arr->capacity) {
+        size_t capacity = arr->capacity == 0 ? JSON_ARRAY_START_SIZE : arr->capacity * 2;
+        if (array_resize(arr, capacity) != 0) {
+            return ALLOCATION_FAILED;
+        }
+    }
+
+    arr->items[arr->len++] = *val;
+    return 0;
+}
+
+/**
+ * @brief - Returns the element at `idx`
+ * @param arr - pointer to the array
+ * @param idx - index of the element
+ * @return pointer to the element
+ * @return NULL if `idx` is out of bounds
+ */
+json_object_t* json_array_t_get(json_array_t* arr, size_t idx) {
+    if (idx >= arr->len) {
+        return NULL;
+    }
+
+    return &arr->items[idx];
+}
+
+/**
+ * @brief - Copies an array of numbers out into a plain double buffer in one linear pass
+ * @param arr - pointer to the array
+ * @param out - buffer with room for `arr->len` doubles
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if an element is not a NUMBER or INTEGER, `out` is then only partially written
+ */
+int json_array_t_copy_doubles(const json_array_t* arr, double* out) {
+    const json_object_t* item = arr->items;
+    const json_object_t* end = arr->items + arr->len;
+
+    for (; item < end; item++, out++) {
+        if (item->tag == NUMBER) {
+            *out = item->val.number;
+        } else if (item->tag == INTEGER) {
+            *out = (double)item->val.integer;
+        } else {
+            return UNEXPECTED_TOKEN;
+        }
+    }
+
+    return 0;
+}
+
+// SIMD SCANNER IMPL
+
+/**
+ * @brief - A set of vector kernels, one is picked at runtime based on the CPU
+ * @property name - backend name reported by `json_simd_backend`
+ * @property classify - builds the character class masks of a 64 byte block
+ * @property scan_string - returns the offset of the first quote, backslash or control byte (or `len` if none)
+ * @property utf8_valid - returns 1 if the bytes are well formed UTF-8, 0 otherwise
+ */
+typedef struct {
+    const char* name;
+    void (*classify)(const unsigned char* block, json_block_masks_t* masks);
+    size_t (*scan_string)(const char* str, size_t len);
+    int (*utf8_valid)(const char* str, size_t len);
+} simd_kernels_t;
+
+static int ctz64(uint64_t x) {
+    return __builtin_ctzll(x);
+}
+
+static void classify_scalar(const unsigned char* block, json_block_masks_t* masks) {
+    uint64_t structural = 0, quote = 0, backslash = 0, whitespace = 0, control = 0;
+
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = 1ull << i;
+        unsigned char c = block[i];
+
+        switch (c) {
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                structural |= bit;
+                break;
+
+            case '"':
+                quote |= bit;
+                break;
+
+            case '\\':
+                backslash |= bit;
+                break;
+
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                whitespace |= bit;
+                break;
+        }
+
+        if (c < 0x20) {
+            control |= bit;
+        }
+    }
+
+    masks->structural = structural;
+    masks->quote = quote;
+    masks->backslash = backslash;
+    masks->whitespace = whitespace;
+    masks->control = control;
+}
+
+static size_t scan_string_scalar(const char* str, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = str[i];
+        if (c == '"' || c == '\\' || c < 0x20) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+// Checks raw string bytes are well formed UTF-8: no stray continuation bytes, overlong forms, surrogates or code points past U+10FFFF
+static int utf8_valid_scalar(const char* str, size_t len) {
+    const unsigned char* p = (const unsigned char*)str;
+    const unsigned char* end = p + len;
+
+    while (p < end) {
+        // ASCII runs are checked a word at a time
+        while (end - p >= 8 && (read_u64((const char*)p) & 0x8080808080808080ull) == 0) {
+            p += 8;
+        }
+        if (p >= end) {
+            break;
+        }
+
+        unsigned char c = *p;
+        if (c < 0x80) {
+            p++;
+            continue;
+        }
+
+        size_t n;
+        if (c >= 0xC2 && c <= 0xDF) {
+            n = 2;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            n = 3;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            n = 4;
+        } else {
+            return 0;
+        }
+
+        if ((size_t)(end - p) < n) {
+            return 0;
+        }
+        for (size_t i = 1; i < n; i++) {
+            if ((p[i] & 0xC0) != 0x80) {
+                return 0;
+            }
+        }
+
+        // The second byte decides overlong forms, surrogates and the upper limit
+        if ((c == 0xE0 && p[1] < 0xA0) || (c == 0xED && p[1] > 0x9F) ||
+            (c == 0xF0 && p[1] < 0x90) || (c == 0xF4 && p[1] > 0x8F)) {
+            return 0;
+        }
+
+        p += n;
+    }
+
+    return 1;
+}
+
+static const simd_kernels_t scalar_kernels = { "scalar", classify_scalar, scan_string_scalar, utf8_valid_scalar };
+
+#ifdef JSON_SIMD_X86
+
+__attribute__((target("sse2")))
+static void classify_sse2(const unsigned char* block, json_block_masks_t* masks) {
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+
+    uint64_t structural = 0, quotes = 0, backslashes = 0, whitespace = 0, control = 0;
+
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+
+        // '[' and ']' are '{' and '}' with the 0x20 bit cleared
+        __m128i folded = _mm_or_si128(v, case_bit);
+        __m128i s = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+        __m128i w = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        __m128i c = _mm_cmpeq_epi8(_mm_min_epu8(v, control_max), v);
+
+        int shift = 16 * i;
+        structural |= (uint64_t)(uint16_t)_mm_movemask_epi8(s) << shift;
+        quotes |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)) << shift;
+        backslashes |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)) << shift;
+        whitespace |= (uint64_t)(uint16_t)_mm_movemask_epi8(w) << shift;
+        control |= (uint64_t)(uint16_t)_mm_movemask_epi8(c) << shift;
+    }
+
+    masks->structural = structural;
+    masks->quote = quotes;
+    masks->backslash = backslashes;
+    masks->whitespace = whitespace;
+    masks->control = control;
+}
+
+__attribute__((target("sse2")))
+static size_t scan_string_sse2(const char* str, size_t len) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(v, control_max), v));
+
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return i + scan_string_scalar(str + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static void classify_avx2(const unsigned char* block, json_block_masks_t* masks) {
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+
+    uint64_t structural = 0, quotes = 0, backslashes = 0, whitespace = 0, control = 0;
+
+    for (int i = 0; i < 2; i++) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(block + 32 * i));
+
+        __m256i folded = _mm256_or_si256(v, case_bit);
+        __m256i s = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, open), _mm256_cmpeq_epi8(folded, close)),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+        __m256i w = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr)));
+        __m256i c = _mm256_cmpeq_epi8(_mm256_min_epu8(v, control_max), v);
+
+        int shift = 32 * i;
+        structural |= (uint64_t)(uint32_t)_mm256_movemask_epi8(s) << shift;
+        quotes |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)) << shift;
+        backslashes |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)) << shift;
+        whitespace |= (uint64_t)(uint32_t)_mm256_movemask_epi8(w) << shift;
+        control |= (uint64_t)(uint32_t)_mm256_movemask_epi8(c) << shift;
+    }
+
+    masks->structural = structural;
+    masks->quote = quotes;
+    masks->backslash = backslashes;
+    masks->whitespace = whitespace;
+    masks->control = control;
+}
+
+__attribute__((target("avx2")))
+static size_t scan_string_avx2(const char* str, size_t len) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(str + i));
+        __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+                                          _mm256_cmpeq_epi8(_mm256_min_epu8(v, control_max), v));
+
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(special);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    // The tail stays in this function so it is VEX encoded too, calling into the legacy SSE kernel
+    // with the upper halves of the ymm registers dirty stalls on every transition
+    const __m128i quote16 = _mm256_castsi256_si128(quote);
+    const __m128i backslash16 = _mm256_castsi256_si128(backslash);
+    const __m128i control_max16 = _mm256_castsi256_si128(control_max);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote16), _mm_cmpeq_epi8(v, backslash16)),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(v, control_max16), v));
+
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    for (; i < len; i++) {
+        unsigned char c = str[i];
+        if (c == '"' || c == '\\' || c < 0x20) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+__attribute__((target("sse2")))
+static int utf8_valid_sse2(const char* str, size_t len) {
+    // Only the leading ASCII run is skipped in vectors, from the first non ASCII chunk on the scalar check takes over
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(str + i))) != 0) {
+            break;
+        }
+    }
+
+    return utf8_valid_scalar(str + i, len - i);
+}
+
+// Error flags of the UTF-8 lookup tables, a byte pair is invalid when all three lookups share a flag
+#define UTF8_TOO_SHORT (1 << 0)
+#define UTF8_TOO_LONG (1 << 1)
+#define UTF8_OVERLONG_3 (1 << 2)
+#define UTF8_TOO_LARGE (1 << 3)
+#define UTF8_SURROGATE (1 << 4)
+#define UTF8_OVERLONG_2 (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4 (1 << 6)
+#define UTF8_TWO_CONTS (1 << 7)
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+typedef struct {
+    __m256i prev;
+    __m256i prev_incomplete;
+    __m256i error;
+} utf8_avx2_state_t;
+
+// Checks 32 bytes against the previous ones with three nibble lookups, after Keiser and Lemire
+__attribute__((target("avx2")))
+static inline void utf8_block_avx2(utf8_avx2_state_t* u, __m256i input) {
+    if (_mm256_movemask_epi8(input) == 0) {
+        // An ASCII block is fine as long as the last one did not end inside a sequence
+        u->error = _mm256_or_si256(u->error, u->prev_incomplete);
+        u->prev_incomplete = _mm256_setzero_si256();
+        u->prev = input;
+        return;
+    }
+
+    const __m256i byte_1_high = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4));
+
+    const __m256i byte_1_low = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+        UTF8_CARRY | UTF8_OVERLONG_2,
+        UTF8_CARRY,
+        UTF8_CARRY,
+        UTF8_CARRY | UTF8_TOO_LARGE,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000));
+
+    const __m256i byte_2_high = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT));
+
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    // The bytes one, two and three places back, reaching into the previous block
+    __m256i carried = _mm256_permute2x128_si256(u->prev, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+    __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+
+    __m256i special = _mm256_and_si256(
+        _mm256_and_si256(_mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                         _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+        _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+    // Continuations two and three bytes after a lead must be there, the lookups above cannot see that far
+    __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+
+    u->error = _mm256_or_si256(u->error, _mm256_xor_si256(must_continue, special));
+
+    // Leads too close to the end for their sequence to fit are settled by the next block
+    const __m256i max_last = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+    u->prev_incomplete = _mm256_subs_epu8(input, max_last);
+    u->prev = input;
+}
+
+__attribute__((target("avx2")))
+static int utf8_valid_avx2(const char* str, size_t len) {
+    // Most keys and short values are plain ASCII, a word at a time settles them before any vector setup
+    if (len < 32) {
+        return utf8_valid_scalar(str, len);
+    }
+
+    // Longer ASCII strings are settled by one pass of loads, the last one overlapping so no tail copy is needed
+    __m256i any = _mm256_loadu_si256((const __m256i*)(str + len - 32));
+    for (size_t i = 0; i + 32 <= len; i += 32) {
+        any = _mm256_or_si256(any, _mm256_loadu_si256((const __m256i*)(str + i)));
+    }
+    if (_mm256_movemask_epi8(any) == 0) {
+        return 1;
+    }
+
+    utf8_avx2_state_t u;
+    u.prev = _mm256_setzero_si256();
+    u.prev_incomplete = _mm256_setzero_si256();
+    u.error = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        utf8_block_avx2(&u, _mm256_loadu_si256((const __m256i*)(str + i)));
+    }
+
+    // The tail is padded with zeros, which also ends any sequence left open by the last full block
+    char tail[32] = { 0 };
+    memcpy(tail, str + i, len - i);
+    utf8_block_avx2(&u, _mm256_loadu_si256((const __m256i*)tail));
+
+    __m256i error = _mm256_or_si256(u.error, u.prev_incomplete);
+    return _mm256_testz_si256(error, error);
+}
+
+static const simd_kernels_t sse2_kernels = { "sse2", classify_sse2, scan_string_sse2, utf8_valid_sse2 };
+static const simd_kernels_t avx2_kernels = { "avx2", classify_avx2, scan_string_avx2, utf8_valid_avx2 };
+
+#endif
+
+#ifdef JSON_SIMD_NEON
+
+static uint64_t neon_movemask64(uint8x16_t m0, uint8x16_t m1, uint8x16_t m2, uint8x16_t m3) {
+    const uint8x16_t bits = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+                              0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+
+    uint8x16_t sum0 = vpaddq_u8(vandq_u8(m0, bits), vandq_u8(m1, bits));
+    uint8x16_t sum1 = vpaddq_u8(vandq_u8(m2, bits), vandq_u8(m3, bits));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+static void classify_neon(const unsigned char* block, json_block_masks_t* masks) {
+    uint8x16_t s[4], q[4], b[4], w[4], c[4];
+
+    for (int i = 0; i < 4; i++) {
+        uint8x16_t v = vld1q_u8(block + 16 * i);
+        uint8x16_t folded = vorrq_u8(v, vdupq_n_u8(0x20));
+
+        s[i] = vorrq_u8(vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}'))),
+                        vorrq_u8(vceqq_u8(v, vdupq_n_u8(':')), vceqq_u8(v, vdupq_n_u8(','))));
+        w[i] = vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8('\t'))),
+                        vorrq_u8(vceqq_u8(v, vdupq_n_u8('\n')), vceqq_u8(v, vdupq_n_u8('\r'))));
+        q[i] = vceqq_u8(v, vdupq_n_u8('"'));
+        b[i] = vceqq_u8(v, vdupq_n_u8('\\'));
+        c[i] = vcltq_u8(v, vdupq_n_u8(0x20));
+    }
+
+    masks->structural = neon_movemask64(s[0], s[1], s[2], s[3]);
+    masks->quote = neon_movemask64(q[0], q[1], q[2], q[3]);
+    masks->backslash = neon_movemask64(b[0], b[1], b[2], b[3]);
+    masks->whitespace = neon_movemask64(w[0], w[1], w[2], w[3]);
+    masks->control = neon_movemask64(c[0], c[1], c[2], c[3]);
+}
+
+static size_t scan_string_neon(const char* str, size_t len) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t*)str + i);
+        uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')), vceqq_u8(v, vdupq_n_u8('\\'))),
+                                      vcltq_u8(v, vdupq_n_u8(0x20)));
+
+        // Narrowing shift packs each byte's match into 4 bits of a 64 bit word
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+        if (mask != 0) {
+            return i + (ctz64(mask) >> 2);
+        }
+    }
+
+    return i + scan_string_scalar(str + i, len - i);
+}
+
+static int utf8_valid_neon(const char* str, size_t len) {
+    // Only the leading ASCII run is skipped in vectors, from the first non ASCII chunk on the scalar check takes over
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        if (vmaxvq_u8(vld1q_u8((const uint8_t*)str + i)) >= 0x80) {
+            break;
+        }
+    }
+
+    return utf8_valid_scalar(str + i, len - i);
+}
+
+static const simd_kernels_t neon_kernels = { "neon", classify_neon, scan_string_neon, utf8_valid_neon };
+
+#endif
+
+static const simd_kernels_t* active_kernels = NULL;
+
+static const simd_kernels_t* select_kernels(void) {
+#ifdef JSON_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return &avx2_kernels;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return &sse2_kernels;
+    }
+#endif
+#ifdef JSON_SIMD_NEON
+    return &neon_kernels;
+#endif
+    return &scalar_kernels;
+}
+
+static const simd_kernels_t* simd_kernels(void) {
+    const simd_kernels_t* kernels = __atomic_load_n(&active_kernels, __ATOMIC_ACQUIRE);
+    if (kernels == NULL) {
+        kernels = select_kernels();
+        __atomic_store_n(&active_kernels, kernels, __ATOMIC_RELEASE);
+    }
+
+    return kernels;
+}
+
+/**
+ * @brief Classifies 64 bytes at once with the active vector kernels
+ * @param block - 64 readable bytes
+ * @param masks - classification output
+ */
+void json_classify_block(const char* block, json_block_masks_t* masks) {
+    simd_kernels()->classify((const unsigned char*)block, masks);
+}
+
+/**
+ * @brief Returns the name of the vector kernels picked for this CPU ("avx2", "sse2", "neon" or "scalar")
+ * @return static string naming the backend
+ */
+const char* json_simd_backend(void) {
+    return simd_kernels()->name;
+}
+
+/**
+ * @brief Forces a kernel set, mostly useful for testing and benchmarking
+ * @param name - "avx2", "sse2", "neon" or "scalar"
+ * @return 0 on success
+ * @return negative number if the build or CPU does not support it
+ */
+int json_simd_set_backend(const char* name) {
+    const simd_kernels_t* kernels = NULL;
+
+    if (strcmp(name, "scalar") == 0) {
+        kernels = &scalar_kernels;
+    }
+#ifdef JSON_SIMD_X86
+    __builtin_cpu_init();
+    if (strcmp(name, "sse2") == 0 && __builtin_cpu_supports("sse2")) {
+        kernels = &sse2_kernels;
+    } else if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        kernels = &avx2_kernels;
+    }
+#endif
+#ifdef JSON_SIMD_NEON
+    if (strcmp(name, "neon") == 0) {
+        kernels = &neon_kernels;
+    }
+#endif
+
+    if (kernels == NULL) {
+        return -1;
+    }
+
+    __atomic_store_n(&active_kernels, kernels, __ATOMIC_RELEASE);
+    return 0;
+}
+
+// Marks bytes preceded by an odd run of backslashes, `carry` tracks a run spilling over from the last block
+static uint64_t escaped_mask(uint64_t backslash, uint64_t* carry) {
+    if (backslash == 0) {
+        uint64_t escaped = *carry;
+        *carry = 0;
+        return escaped;
+    }
+
+    // A backslash escaped by the last block's run does not start a run of its own
+    backslash &= ~*carry;
+    uint64_t follows_backslash = (backslash << 1) | *carry;
+
+    // Adding the odd positioned run starts to the runs carries each one to its end, which flips
+    // the parity of the escaped byte for runs that start on odd bits
+    const uint64_t even_bits = 0x5555555555555555ull;
+    uint64_t odd_starts = backslash & ~even_bits & ~follows_backslash;
+    uint64_t even_runs;
+    *carry = __builtin_add_overflow(odd_starts, backslash, &even_runs);
+
+    return (even_bits ^ (even_runs << 1)) & follows_backslash;
+}
+
+// Bit i of the result is the xor of bits 0..i, turning quote positions into "inside a string" ranges
+static uint64_t prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// TOKENIZER IMPL
+
+/**
+ * @brief initializes a token stream
+ * @param s - pointer to the stream to init
+ */
+void token_stream_t_init(token_stream_t* s) {
+    s->items = JSON_MALLOC(sizeof(token_t) * STREAM_START_SIZE);
+    s->capacity = STREAM_START_SIZE;
+    s->len = 0;
+}
+
+/**
+ * @brief frees a token stream
+ * @param s - pointer to the stream to free
+ */
+void token_stream_t_deinit(token_stream_t* s) {
+    JSON_FREE(s->items);
+    s->capacity=0;
+    s->len=0;
+}
+
+/**
+ * @brief Pushes a new token to the stream
+ * @param s - pointer to the stream to add to
+ * @param add - new token to add
+ */
+void token_stream_t_push(token_stream_t* s, token_t add) {
+    if (s->capacity == 0) {
+        token_stream_t_init(s);
+    }
+
+    if (s->len < s->capacity) {
+        s->items[s->len++] = add;
+        return;
+    }
+
+    s->capacity *= 2;
+    s->items = JSON_REALLOC(s->items, s->capacity * sizeof(token_t));
+    s->items[s->len++] = add;
+}
+
+static int is_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static int is_alphabetic(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c  <= 'z') || c == '_';
+}
+
+static int is_numeric(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static int is_alphanumeric(char c) {
+    return is_alphabetic(c) || is_numeric(c);
+}
+
+static int push_structural(token_stream_t* stream, const char* at) {
+    token_t tok;
+    tok.start = at;
+    tok.len = 1;
+
+    switch (*at) {
+        case '[':
+            tok.tag = OPEN_BRACKET;
+            break;
+
+        case ']':
+            tok.tag = CLOSE_BRACKET;
+            break;
+
+        case '{':
+            tok.tag = OPEN_BRACE;
+            break;
+
+        case '}':
+            tok.tag = CLOSE_BRACE;
+            break;
+
+        case ',':
+            tok.tag = COMMA;
+            break;
+
+        case ':':
+            tok.tag = COLON;
+            break;
+
+        default:
+            return 1;
+    }
+
+    token_stream_t_push(stream, tok);
+    return 0;
+}
+
+static size_t number_length(const char* p, const char* end);
+
+// Consumes a bare word or number starting at `json[idx]`, returning how many bytes it spans or 0 if invalid
+static size_t push_scalar(token_stream_t* stream, const char* json, size_t idx, size_t size) {
+    token_t tok;
+    tok.start = json + idx;
+    size_t end = idx;
+
+    if (is_alphabetic(json[idx])) {
+        while (end < size && is_alphanumeric(json[end])) end++;
+        tok.len = end - idx;
+        tok.tag = STR;
+
+        if (tok.len == 4 && memcmp(tok.start, "true", 4) == 0) {
+            tok.tag = TRUE;
+        } else if (tok.len == 5 && memcmp(tok.start, "false", 5) == 0) {
+            tok.tag = FALSE;
+        } else if (tok.len == 4 && memcmp(tok.start, "null", 4) == 0) {
+            tok.tag = NULL_TAG;
+        }
+    } else if (is_numeric(json[idx]) || json[idx] == '-') {
+        tok.len = number_length(json + idx, json + size);
+        if (tok.len == 0) return 0;
+        end = idx + tok.len;
+        tok.tag = NUM;
+    } else {
+        return 0;
+    }
+
+    // The word has to run right up to whitespace, a structural character or a quote
+    if (end < size) {
+        char c = json[end];
+        if (!is_whitespace(c) && c != '"' && c != '{' && c != '}' && c != '[' && c != ']' && c != ':' && c != ',') {
+            return 0;
+        }
+    }
+
+    token_stream_t_push(stream, tok);
+    return tok.len;
+}
+
+/**
+ * @brief Tokenizes a string and appends all tokens to a stream
+ * The input is classified 64 bytes at a time by the vector kernels, then only the set bits of the
+ * structural, quote and word-start masks are visited, so whitespace and string contents are never walked byte by byte
+ * @param json - JSON string to tokenize
+ * @param size - size of the JSON string
+ * @param stream - token stream to append to
+ */
+int tokenize_json(const char* json, size_t size, token_stream_t* stream) {
+    token_stream_t_init(stream);
+    const simd_kernels_t* kernels = simd_kernels();
+
+    uint64_t escape_carry = 0;
+    uint64_t prev_in_string = 0;
+    uint64_t prev_scalar = 0;
+
+    int in_string = 0;
+    const char* string_start = NULL;
+
+    for (size_t base = 0; base < size; base += 64) {
+        json_block_masks_t m;
+        unsigned char tail[64];
+
+        if (size - base >= 64) {
+            kernels->classify((const unsigned char*)json + base, &m);
+        } else {
+            // Pad the last block with whitespace so it never produces tokens
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, json + base, size - base);
+            kernels->classify(tail, &m);
+        }
+
+        uint64_t quote = m.quote & ~escaped_mask(m.backslash, &escape_carry);
+
+        // Set from an opening quote up to (not including) its closing quote
+        uint64_t strings = prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = (uint64_t)((int64_t)strings >> 63);
+
+        uint64_t structural = m.structural & ~strings;
+        uint64_t scalar = ~(m.structural | m.whitespace | quote | strings);
+        uint64_t scalar_start = scalar & ~((scalar << 1) | prev_scalar);
+        prev_scalar = scalar >> 63;
+
+        uint64_t tokens = structural | quote | scalar_start;
+
+        while (tokens != 0) {
+            int bit = ctz64(tokens);
+            uint64_t mask = 1ull << bit;
+            tokens &= tokens - 1;
+
+            size_t idx = base + bit;
+            token_t tok;
+            tok.start = json + idx;
+            tok.len = 1;
+
+            if (quote & mask) {
+                if (in_string) {
+                    if (!kernels->utf8_valid(string_start, json + idx - string_start)) {
+                        return 1;
+                    }
+
+                    token_t str = { string_start, json + idx - string_start, STR };
+                    token_stream_t_push(stream, str);
+                } else {
+                    string_start = json + idx + 1;
+                }
+
+                in_string = !in_string;
+                tok.tag = QUOTATION;
+                token_stream_t_push(stream, tok);
+            } else if (structural & mask) {
+                push_structural(stream, json + idx);
+            } else if (push_scalar(stream, json, idx, size) == 0) {
+                return 1;
+            }
+        }
+    }
+
+    // Unterminated string
+    if (in_string) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief prints the token out
+ * @param t - pointer to the token to print
+ */
+void token_t_print(token_t* t) {
+    const char* tag = "UNKNOWN";
+
+    switch (t->tag) {
+        case OPEN_BRACE:
+            tag = "OPEN_BRACE";
+            break;
+
+        case CLOSE_BRACE:
+            tag = "CLOSE_BRACE";
+            break;
+
+        case OPEN_BRACKET:
+            tag = "OPEN_BRACKET";
+            break;
+
+        case CLOSE_BRACKET:
+            tag = "CLOSE_BRACKET";
+            break;
+
+        case QUOTATION:
+            tag = "QUOTATION";
+            break;
+
+        case COMMA:
+            tag = "COMMA";
+            break;
+
+        case NUM:
+            tag = "NUM";
+            break;
+
+        case TRUE:
+            tag = "TRUE";
+            break;
+
+        case COLON:
+            tag = "COLON";
+            break;
+
+        case FALSE:
+            tag = "FALSE";
+            break;
+
+        case NULL_TAG:
+            tag = "NULL_TAG";
+            break;
+
+        case STR:
+            tag = "STR";
+            break;
+
+    }
+
+    printf("%s - %zu\n", tag, t->len);
+}
+
+/**
+ * @brief prints the token's value within a buffer
+ * @param t - pointer to the token to print
+ */
+void token_t_src_print(token_t* t) {
+    for (size_t offset = 0; offset < t->len; offset++) {
+        printf("%c", (t->start + offset)[0]);
+    }
+}
+
+// NUMBER IMPL
+
+// Decimal exponents covered by `pow10_128`, anything outside is zero or infinity for a 19 digit mantissa
+#define POW10_MIN_EXP -342
+#define POW10_MAX_EXP 308
+
+// 10^q for q in [POW10_MIN_EXP, POW10_MAX_EXP] as {high, low} words of a 128 bit mantissa,
+// shifted so the top bit is set and rounded down
+static const uint64_t pow10_128[][2] = {
+    { 0xeef453d6923bd65aull, 0x113faa2906a13b3full },
+    { 0x9558b4661b6565f8ull, 0x4ac7ca59a424c507ull },
+    { 0xbaaee17fa23ebf76ull, 0x5d79bcf00d2df649ull },
+    { 0xe95a99df8ace6f53ull, 0xf4d82c2c107973dcull },
+    { 0x91d8a02bb6c10594ull, 0x79071b9b8a4be869ull },
+    { 0xb64ec836a47146f9ull, 0x9748e2826cdee284ull },
+    { 0xe3e27a444d8d98b7ull, 0xfd1b1b2308169b25ull },
+    { 0x8e6d8c6ab0787f72ull, 0xfe30f0f5e50e20f7ull },
+    { 0xb208ef855c969f4full, 0xbdbd2d335e51a935ull },
+    { 0xde8b2b66b3bc4723ull, 0xad2c788035e61382ull },
+    { 0x8b16fb203055ac76ull, 0x4c3bcb5021afcc31ull },
+    { 0xaddcb9e83c6b1793ull, 0xdf4abe242a1bbf3dull },
+    { 0xd953e8624b85dd78ull, 0xd71d6dad34a2af0dull },
+    { 0x87d4713d6f33aa6bull, 0x8672648c40e5ad68ull },
+    { 0xa9c98d8ccb009506ull, 0x680efdaf511f18c2ull },
+    { 0xd43bf0effdc0ba48ull, 0x0212bd1b2566def2ull },
+    { 0x84a57695fe98746dull, 0x014bb630f7604b57ull },
+    { 0xa5ced43b7e3e9188ull, 0x419ea3bd35385e2dull },
+    { 0xcf42894a5dce35eaull, 0x52064cac828675b9ull },
+    { 0x818995ce7aa0e1b2ull, 0x7343efebd1940993ull },
+    { 0xa1ebfb4219491a1full, 0x1014ebe6c5f90bf8ull },
+    { 0xca66fa129f9b60a6ull, 0xd41a26e077774ef6ull },
+    { 0xfd00b897478238d0ull, 0x8920b098955522b4ull },
+    { 0x9e20735e8cb16382ull, 0x55b46e5f5d5535b0ull },
+    { 0xc5a890362fddbc62ull, 0xeb2189f734aa831dull },
+    { 0xf712b443bbd52b7bull, 0xa5e9ec7501d523e4ull },
+    { 0x9a6bb0aa55653b2dull, 0x47b233c92125366eull },
+    { 0xc1069cd4eabe89f8ull, 0x999ec0bb696e840aull },
+    { 0xf148440a256e2c76ull, 0xc00670ea43ca250dull },
+    { 0x96cd2a865764dbcaull, 0x380406926a5e5728ull },
+    { 0xbc807527ed3e12bcull, 0xc605083704f5ecf2ull },
+    { 0xeba09271e88d976bull, 0xf7864a44c633682eull },
+    { 0x93445b8731587ea3ull, 0x7ab3ee6afbe0211dull },
+    { 0xb8157268fdae9e4cull, 0x5960ea05bad82964ull },
+    { 0xe61acf033d1a45dfull, 0x6fb92487298e33bdull },
+    { 0x8fd0c16206306babull, 0xa5d3b6d479f8e056ull },
+    { 0xb3c4f1ba87bc8696ull, 0x8f48a4899877186cull },
+    { 0xe0b62e2929aba83cull, 0x331acdabfe94de87ull },
+    { 0x8c71dcd9ba0b4925ull, 0x9ff0c08b7f1d0b14ull },
+    { 0xaf8e5410288e1b6full, 0x07ecf0ae5ee44dd9ull },
+    { 0xdb71e91432b1a24aull, 0xc9e82cd9f69d6150ull },
+    { 0x892731ac9faf056eull, 0xbe311c083a225cd2ull },
+    { 0xab70fe17c79ac6caull, 0x6dbd630a48aaf406ull },
+    { 0xd64d3d9db981787dull, 0x092cbbccdad5b108ull },
+    { 0x85f0468293f0eb4eull, 0x25bbf56008c58ea5ull },
+    { 0xa76c582338ed2621ull, 0xaf2af2b80af6f24eull },
+    { 0xd1476e2c07286faaull, 0x1af5af660db4aee1ull },
+    { 0x82cca4db847945caull, 0x50d98d9fc890ed4dull },
+    { 0xa37fce126597973cull, 0xe50ff107bab528a0ull },
+    { 0xcc5fc196fefd7d0cull, 0x1e53ed49a96272c8ull },
+    { 0xff77b1fcbebcdc4full, 0x25e8e89c13bb0f7aull },
+    { 0x9faacf3df73609b1ull, 0x77b191618c54e9acull },
+    { 0xc795830d75038c1dull, 0xd59df5b9ef6a2417ull },
+    { 0xf97ae3d0d2446f25ull, 0x4b0573286b44ad1dull },
+    { 0x9becce62836ac577ull, 0x4ee367f9430aec32ull },
+    { 0xc2e801fb244576d5ull, 0x229c41f793cda73full },
+    { 0xf3a20279ed56d48aull, 0x6b43527578c1110full },
+    { 0x9845418c345644d6ull, 0x830a13896b78aaa9ull },
+    { 0xbe5691ef416bd60cull, 0x23cc986bc656d553ull },
+    { 0xedec366b11c6cb8full, 0x2cbfbe86b7ec8aa8ull },
+    { 0x94b3a202eb1c3f39ull, 0x7bf7d71432f3d6a9ull },
+    { 0xb9e08a83a5e34f07ull, 0xdaf5ccd93fb0cc53ull },
+    { 0xe858ad248f5c22c9ull, 0xd1b3400f8f9cff68ull },
+    { 0x91376c36d99995beull, 0x23100809b9c21fa1ull },
+    { 0xb58547448ffffb2dull, 0xabd40a0c2832a78aull },
+    { 0xe2e69915b3fff9f9ull, 0x16c90c8f323f516cull },
+    { 0x8dd01fad907ffc3bull, 0xae3da7d97f6792e3ull },
+    { 0xb1442798f49ffb4aull, 0x99cd11cfdf41779cull },
+    { 0xdd95317f31c7fa1dull, 0x40405643d711d583ull },
+    { 0x8a7d3eef7f1cfc52ull, 0x482835ea666b2572ull },
+    { 0xad1c8eab5ee43b66ull, 0xda3243650005eecfull },
+    { 0xd863b256369d4a40ull, 0x90bed43e40076a82ull },
+    { 0x873e4f75e2224e68ull, 0x5a7744a6e804a291ull },
+    { 0xa90de3535aaae202ull, 0x711515d0a205cb36ull },
+    { 0xd3515c2831559a83ull, 0x0d5a5b44ca873e03ull },
+    { 0x8412d9991ed58091ull, 0xe858790afe9486c2ull },
+    { 0xa5178fff668ae0b6ull, 0x626e974dbe39a872ull },
+    { 0xce5d73ff402d98e3ull, 0xfb0a3d212dc8128full },
+    { 0x80fa687f881c7f8eull, 0x7ce66634bc9d0b99ull },
+    { 0xa139029f6a239f72ull, 0x1c1fffc1ebc44e80ull },
+    { 0xc987434744ac874eull, 0xa327ffb266b56220ull },
+    { 0xfbe9141915d7a922ull, 0x4bf1ff9f0062baa8ull },
+    { 0x9d71ac8fada6c9b5ull, 0x6f773fc3603db4a9ull },
+    { 0xc4ce17b399107c22ull, 0xcb550fb4384d21d3ull },
+    { 0xf6019da07f549b2bull, 0x7e2a53a146606a48ull },
+    { 0x99c102844f94e0fbull, 0x2eda7444cbfc426dull },
+    { 0xc0314325637a1939ull, 0xfa911155fefb5308ull },
+    { 0xf03d93eebc589f88ull, 0x793555ab7eba27caull },
+    { 0x96267c7535b763b5ull, 0x4bc1558b2f3458deull },
+    { 0xbbb01b9283253ca2ull, 0x9eb1aaedfb016f16ull },
+    { 0xea9c227723ee8bcbull, 0x465e15a979c1cadcull },
+    { 0x92a1958a7675175full, 0x0bfacd89ec191ec9ull },
+    { 0xb749faed14125d36ull, 0xcef980ec671f667bull },
+    { 0xe51c79a85916f484ull, 0x82b7e12780e7401aull },
+    { 0x8f31cc0937ae58d2ull, 0xd1b2ecb8b0908810ull },
+    { 0xb2fe3f0b8599ef07ull, 0x861fa7e6dcb4aa15ull },
+    { 0xdfbdcece67006ac9ull, 0x67a791e093e1d49aull },
+    { 0x8bd6a141006042bdull, 0xe0c8bb2c5c6d24e0ull },
+    { 0xaecc49914078536dull, 0x58fae9f773886e18ull },
+    { 0xda7f5bf590966848ull, 0xaf39a475506a899eull },
+    { 0x888f99797a5e012dull, 0x6d8406c952429603ull },
+    { 0xaab37fd7d8f58178ull, 0xc8e5087ba6d33b83ull },
+    { 0xd5605fcdcf32e1d6ull, 0xfb1e4a9a90880a64ull },
+    { 0x855c3be0a17fcd26ull, 0x5cf2eea09a55067full },
+    { 0xa6b34ad8c9dfc06full, 0xf42faa48c0ea481eull },
+    { 0xd0601d8efc57b08bull, 0xf13b94daf124da26ull },
+    { 0x823c12795db6ce57ull, 0x76c53d08d6b70858ull },
+    { 0xa2cb1717b52481edull, 0x54768c4b0c64ca6eull },
+    { 0xcb7ddcdda26da268ull, 0xa9942f5dcf7dfd09ull },
+    { 0xfe5d54150b090b02ull, 0xd3f93b35435d7c4cull },
+    { 0x9efa548d26e5a6e1ull, 0xc47bc5014a1a6dafull },
+    { 0xc6b8e9b0709f109aull, 0x359ab6419ca1091bull },
+    { 0xf867241c8cc6d4c0ull, 0xc30163d203c94b62ull },
+    { 0x9b407691d7fc44f8ull, 0x79e0de63425dcf1dull },
+    { 0xc21094364dfb5636ull, 0x985915fc12f542e4ull },
+    { 0xf294b943e17a2bc4ull, 0x3e6f5b7b17b2939dull },
+    { 0x979cf3ca6cec5b5aull, 0xa705992ceecf9c42ull },
+    { 0xbd8430bd08277231ull, 0x50c6ff782a838353ull },
+    { 0xece53cec4a314ebdull, 0xa4f8bf5635246428ull },
+    { 0x940f4613ae5ed136ull, 0x871b7795e136be99ull },
+    { 0xb913179899f68584ull, 0x28e2557b59846e3full },
+    { 0xe757dd7ec07426e5ull, 0x331aeada2fe589cfull },
+    { 0x9096ea6f3848984full, 0x3ff0d2c85def7621ull },
+    { 0xb4bca50b065abe63ull, 0x0fed077a756b53a9ull },
+    { 0xe1ebce4dc7f16dfbull, 0xd3e8495912c62894ull },
+    { 0x8d3360f09cf6e4bdull, 0x64712dd7abbbd95cull },
+    { 0xb080392cc4349decull, 0xbd8d794d96aacfb3ull },
+    { 0xdca04777f541c567ull, 0xecf0d7a0fc5583a0ull },
+    { 0x89e42caaf9491b60ull, 0xf41686c49db57244ull },
+    { 0xac5d37d5b79b6239ull, 0x311c2875c522ced5ull },
+    { 0xd77485cb25823ac7ull, 0x7d633293366b828bull },
+    { 0x86a8d39ef77164bcull, 0xae5dff9c02033197ull },
+    { 0xa8530886b54dbdebull, 0xd9f57f830283fdfcull },
+    { 0xd267caa862a12d66ull, 0xd072df63c324fd7bull },
+    { 0x8380dea93da4bc60ull, 0x4247cb9e59f71e6dull },
+    { 0xa46116538d0deb78ull, 0x52d9be85f074e608ull },
+    { 0xcd795be870516656ull, 0x67902e276c921f8bull },
+    { 0x806bd9714632dff6ull, 0x00ba1cd8a3db53b6ull },
+    { 0xa086cfcd97bf97f3ull, 0x80e8a40eccd228a4ull },
+    { 0xc8a883c0fdaf7df0ull, 0x6122cd128006b2cdull },
+    { 0xfad2a4b13d1b5d6cull, 0x796b805720085f81ull },
+    { 0x9cc3a6eec6311a63ull, 0xcbe3303674053bb0ull },
+    { 0xc3f490aa77bd60fcull, 0xbedbfc4411068a9cull },
+    { 0xf4f1b4d515acb93bull, 0xee92fb5515482d44ull },
+    { 0x991711052d8bf3c5ull, 0x751bdd152d4d1c4aull },
+    { 0xbf5cd54678eef0b6ull, 0xd262d45a78a0635dull },
+    { 0xef340a98172aace4ull, 0x86fb897116c87c34ull },
+    { 0x9580869f0e7aac0eull, 0xd45d35e6ae3d4da0ull },
+    { 0xbae0a846d2195712ull, 0x8974836059cca109ull },
+    { 0xe998d258869facd7ull, 0x2bd1a438703fc94bull },
+    { 0x91ff83775423cc06ull, 0x7b6306a34627ddcfull },
+    { 0xb67f6455292cbf08ull, 0x1a3bc84c17b1d542ull },
+    { 0xe41f3d6a7377eecaull, 0x20caba5f1d9e4a93ull },
+    { 0x8e938662882af53eull, 0x547eb47b7282ee9cull },
+    { 0xb23867fb2a35b28dull, 0xe99e619a4f23aa43ull },
+    { 0xdec681f9f4c31f31ull, 0x6405fa00e2ec94d4ull },
+    { 0x8b3c113c38f9f37eull, 0xde83bc408dd3dd04ull },
+    { 0xae0b158b4738705eull, 0x9624ab50b148d445ull },
+    { 0xd98ddaee19068c76ull, 0x3badd624dd9b0957ull },
+    { 0x87f8a8d4cfa417c9ull, 0xe54ca5d70a80e5d6ull },
+    { 0xa9f6d30a038d1dbcull, 0x5e9fcf4ccd211f4cull },
+    { 0xd47487cc8470652bull, 0x7647c3200069671full },
+    { 0x84c8d4dfd2c63f3bull, 0x29ecd9f40041e073ull },
+    { 0xa5fb0a17c777cf09ull, 0xf468107100525890ull },
+    { 0xcf79cc9db955c2ccull, 0x7182148d4066eeb4ull },
+    { 0x81ac1fe293d599bfull, 0xc6f14cd848405530ull },
+    { 0xa21727db38cb002full, 0xb8ada00e5a506a7cull },
+    { 0xca9cf1d206fdc03bull, 0xa6d90811f0e4851cull },
+    { 0xfd442e4688bd304aull, 0x908f4a166d1da663ull },
+    { 0x9e4a9cec15763e2eull, 0x9a598e4e043287feull },
+    { 0xc5dd44271ad3cdbaull, 0x40eff1e1853f29fdull },
+    { 0xf7549530e188c128ull, 0xd12bee59e68ef47cull },
+    { 0x9a94dd3e8cf578b9ull, 0x82bb74f8301958ceull },
+    { 0xc13a148e3032d6e7ull, 0xe36a52363c1faf01ull },
+    { 0xf18899b1bc3f8ca1ull, 0xdc44e6c3cb279ac1ull },
+    { 0x96f5600f15a7b7e5ull, 0x29ab103a5ef8c0b9ull },
+    { 0xbcb2b812db11a5deull, 0x7415d448f6b6f0e7ull },
+    { 0xebdf661791d60f56ull, 0x111b495b3464ad21ull },
+    { 0x936b9fcebb25c995ull, 0xcab10dd900beec34ull },
+    { 0xb84687c269ef3bfbull, 0x3d5d514f40eea742ull },
+    { 0xe65829b3046b0afaull, 0x0cb4a5a3112a5112ull },
+    { 0x8ff71a0fe2c2e6dcull, 0x47f0e785eaba72abull },
+    { 0xb3f4e093db73a093ull, 0x59ed216765690f56ull },
+    { 0xe0f218b8d25088b8ull, 0x306869c13ec3532cull },
+    { 0x8c974f7383725573ull, 0x1e414218c73a13fbull },
+    { 0xafbd2350644eeacfull, 0xe5d1929ef90898faull },
+    { 0xdbac6c247d62a583ull, 0xdf45f746b74abf39ull },
+    { 0x894bc396ce5da772ull, 0x6b8bba8c328eb783ull },
+    { 0xab9eb47c81f5114full, 0x066ea92f3f326564ull },
+    { 0xd686619ba27255a2ull, 0xc80a537b0efefebdull },
+    { 0x8613fd0145877585ull, 0xbd06742ce95f5f36ull },
+    { 0xa798fc4196e952e7ull, 0x2c48113823b73704ull },
+    { 0xd17f3b51fca3a7a0ull, 0xf75a15862ca504c5ull },
+    { 0x82ef85133de648c4ull, 0x9a984d73dbe722fbull },
+    { 0xa3ab66580d5fdaf5ull, 0xc13e60d0d2e0ebbaull },
+    { 0xcc963fee10b7d1b3ull, 0x318df905079926a8ull },
+    { 0xffbbcfe994e5c61full, 0xfdf17746497f7052ull },
+    { 0x9fd561f1fd0f9bd3ull, 0xfeb6ea8bedefa633ull },
+    { 0xc7caba6e7c5382c8ull, 0xfe64a52ee96b8fc0ull },
+    { 0xf9bd690a1b68637bull, 0x3dfdce7aa3c673b0ull },
+    { 0x9c1661a651213e2dull, 0x06bea10ca65c084eull },
+    { 0xc31bfa0fe5698db8ull, 0x486e494fcff30a62ull },
+    { 0xf3e2f893dec3f126ull, 0x5a89dba3c3efccfaull },
+    { 0x986ddb5c6b3a76b7ull, 0xf89629465a75e01cull },
+    { 0xbe89523386091465ull, 0xf6bbb397f1135823ull },
+    { 0xee2ba6c0678b597full, 0x746aa07ded582e2cull },
+    { 0x94db483840b717efull, 0xa8c2a44eb4571cdcull },
+    { 0xba121a4650e4ddebull, 0x92f34d62616ce413ull },
+    { 0xe896a0d7e51e1566ull, 0x77b020baf9c81d17ull },
+    { 0x915e2486ef32cd60ull, 0x0ace1474dc1d122eull },
+    { 0xb5b5ada8aaff80b8ull, 0x0d819992132456baull },
+    { 0xe3231912d5bf60e6ull, 0x10e1fff697ed6c69ull },
+    { 0x8df5efabc5979c8full, 0xca8d3ffa1ef463c1ull },
+    { 0xb1736b96b6fd83b3ull, 0xbd308ff8a6b17cb2ull },
+    { 0xddd0467c64bce4a0ull, 0xac7cb3f6d05ddbdeull },
+    { 0x8aa22c0dbef60ee4ull, 0x6bcdf07a423aa96bull },
+    { 0xad4ab7112eb3929dull, 0x86c16c98d2c953c6ull },
+    { 0xd89d64d57a607744ull, 0xe871c7bf077ba8b7ull },
+    { 0x87625f056c7c4a8bull, 0x11471cd764ad4972ull },
+    { 0xa93af6c6c79b5d2dull, 0xd598e40d3dd89bcfull },
+    { 0xd389b47879823479ull, 0x4aff1d108d4ec2c3ull },
+    { 0x843610cb4bf160cbull, 0xcedf722a585139baull },
+    { 0xa54394fe1eedb8feull, 0xc2974eb4ee658828ull },
+    { 0xce947a3da6a9273eull, 0x733d226229feea32ull },
+    { 0x811ccc668829b887ull, 0x0806357d5a3f525full },
+    { 0xa163ff802a3426a8ull, 0xca07c2dcb0cf26f7ull },
+    { 0xc9bcff6034c13052ull, 0xfc89b393dd02f0b5ull },
+    { 0xfc2c3f3841f17c67ull, 0xbbac2078d443ace2ull },
+    { 0x9d9ba7832936edc0ull, 0xd54b944b84aa4c0dull },
+    { 0xc5029163f384a931ull, 0x0a9e795e65d4df11ull },
+    { 0xf64335bcf065d37dull, 0x4d4617b5ff4a16d5ull },
+    { 0x99ea0196163fa42eull, 0x504bced1bf8e4e45ull },
+    { 0xc06481fb9bcf8d39ull, 0xe45ec2862f71e1d6ull },
+    { 0xf07da27a82c37088ull, 0x5d767327bb4e5a4cull },
+    { 0x964e858c91ba2655ull, 0x3a6a07f8d510f86full },
+    { 0xbbe226efb628afeaull, 0x890489f70a55368bull },
+    { 0xeadab0aba3b2dbe5ull, 0x2b45ac74ccea842eull },
+    { 0x92c8ae6b464fc96full, 0x3b0b8bc90012929dull },
+    { 0xb77ada0617e3bbcbull, 0x09ce6ebb40173744ull },
+    { 0xe55990879ddcaabdull, 0xcc420a6a101d0515ull },
+    { 0x8f57fa54c2a9eab6ull, 0x9fa946824a12232dull },
+    { 0xb32df8e9f3546564ull, 0x47939822dc96abf9ull },
+    { 0xdff9772470297ebdull, 0x59787e2b93bc56f7ull },
+    { 0x8bfbea76c619ef36ull, 0x57eb4edb3c55b65aull },
+    { 0xaefae51477a06b03ull, 0xede622920b6b23f1ull },
+    { 0xdab99e59958885c4ull, 0xe95fab368e45ecedull },
+    { 0x88b402f7fd75539bull, 0x11dbcb0218ebb414ull },
+    { 0xaae103b5fcd2a881ull, 0xd652bdc29f26a119ull },
+    { 0xd59944a37c0752a2ull, 0x4be76d3346f0495full },
+    { 0x857fcae62d8493a5ull, 0x6f70a4400c562ddbull },
+    { 0xa6dfbd9fb8e5b88eull, 0xcb4ccd500f6bb952ull },
+    { 0xd097ad07a71f26b2ull, 0x7e2000a41346a7a7ull },
+    { 0x825ecc24c873782full, 0x8ed400668c0c28c8ull },
+    { 0xa2f67f2dfa90563bull, 0x728900802f0f32faull },
+    { 0xcbb41ef979346bcaull, 0x4f2b40a03ad2ffb9ull },
+    { 0xfea126b7d78186bcull, 0xe2f610c84987bfa8ull },
+    { 0x9f24b832e6b0f436ull, 0x0dd9ca7d2df4d7c9ull },
+    { 0xc6ede63fa05d3143ull, 0x91503d1c79720dbbull },
+    { 0xf8a95fcf88747d94ull, 0x75a44c6397ce912aull },
+    { 0x9b69dbe1b548ce7cull, 0xc986afbe3ee11abaull },
+    { 0xc24452da229b021bull, 0xfbe85badce996168ull },
+    { 0xf2d56790ab41c2a2ull, 0xfae27299423fb9c3ull },
+    { 0x97c560ba6b0919a5ull, 0xdccd879fc967d41aull },
+    { 0xbdb6b8e905cb600full, 0x5400e987bbc1c920ull },
+    { 0xed246723473e3813ull, 0x290123e9aab23b68ull },
+    { 0x9436c0760c86e30bull, 0xf9a0b6720aaf6521ull },
+    { 0xb94470938fa89bceull, 0xf808e40e8d5b3e69ull },
+    { 0xe7958cb87392c2c2ull, 0xb60b1d1230b20e04ull },
+    { 0x90bd77f3483bb9b9ull, 0xb1c6f22b5e6f48c2ull },
+    { 0xb4ecd5f01a4aa828ull, 0x1e38aeb6360b1af3ull },
+    { 0xe2280b6c20dd5232ull, 0x25c6da63c38de1b0ull },
+    { 0x8d590723948a535full, 0x579c487e5a38ad0eull },
+    { 0xb0af48ec79ace837ull, 0x2d835a9df0c6d851ull },
+    { 0xdcdb1b2798182244ull, 0xf8e431456cf88e65ull },
+    { 0x8a08f0f8bf0f156bull, 0x1b8e9ecb641b58ffull },
+    { 0xac8b2d36eed2dac5ull, 0xe272467e3d222f3full },
+    { 0xd7adf884aa879177ull, 0x5b0ed81dcc6abb0full },
+    { 0x86ccbb52ea94baeaull, 0x98e947129fc2b4e9ull },
+    { 0xa87fea27a539e9a5ull, 0x3f2398d747b36224ull },
+    { 0xd29fe4b18e88640eull, 0x8eec7f0d19a03aadull },
+    { 0x83a3eeeef9153e89ull, 0x1953cf68300424acull },
+    { 0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd7ull },
+    { 0xcdb02555653131b6ull, 0x3792f412cb06794dull },
+    { 0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd0ull },
+    { 0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec4ull },
+    { 0xc8de047564d20a8bull, 0xf245825a5a445275ull },
+    { 0xfb158592be068d2eull, 0xeed6e2f0f0d56712ull },
+    { 0x9ced737bb6c4183dull, 0x55464dd69685606bull },
+    { 0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull },
+    { 0xf53304714d9265dfull, 0xd53dd99f4b3066a8ull },
+    { 0x993fe2c6d07b7fabull, 0xe546a8038efe4029ull },
+    { 0xbf8fdb78849a5f96ull, 0xde98520472bdd033ull },
+    { 0xef73d256a5c0f77cull, 0x963e66858f6d4440ull },
+    { 0x95a8637627989aadull, 0xdde7001379a44aa8ull },
+    { 0xbb127c53b17ec159ull, 0x5560c018580d5d52ull },
+    { 0xe9d71b689dde71afull, 0xaab8f01e6e10b4a6ull },
+    { 0x9226712162ab070dull, 0xcab3961304ca70e8ull },
+    { 0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d22ull },
+    { 0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506aull },
+    { 0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb242ull },
+    { 0xb267ed1940f1c61cull, 0x55f038b237591ed3ull },
+    { 0xdf01e85f912e37a3ull, 0x6b6c46dec52f6688ull },
+    { 0x8b61313bbabce2c6ull, 0x2323ac4b3b3da015ull },
+    { 0xae397d8aa96c1b77ull, 0xabec975e0a0d081aull },
+    { 0xd9c7dced53c72255ull, 0x96e7bd358c904a21ull },
+    { 0x881cea14545c7575ull, 0x7e50d64177da2e54ull },
+    { 0xaa242499697392d2ull, 0xdde50bd1d5d0b9e9ull },
+    { 0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e864ull },
+    { 0x84ec3c97da624ab4ull, 0xbd5af13bef0b113eull },
+    { 0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58eull },
+    { 0xcfb11ead453994baull, 0x67de18eda5814af2ull },
+    { 0x81ceb32c4b43fcf4ull, 0x80eacf948770ced7ull },
+    { 0xa2425ff75e14fc31ull, 0xa1258379a94d028dull },
+    { 0xcad2f7f5359a3b3eull, 0x096ee45813a04330ull },
+    { 0xfd87b5f28300ca0dull, 0x8bca9d6e188853fcull },
+    { 0x9e74d1b791e07e48ull, 0x775ea264cf55347dull },
+    { 0xc612062576589ddaull, 0x95364afe032a819dull },
+    { 0xf79687aed3eec551ull, 0x3a83ddbd83f52204ull },
+    { 0x9abe14cd44753b52ull, 0xc4926a9672793542ull },
+    { 0xc16d9a0095928a27ull, 0x75b7053c0f178293ull },
+    { 0xf1c90080baf72cb1ull, 0x5324c68b12dd6338ull },
+    { 0x971da05074da7beeull, 0xd3f6fc16ebca5e03ull },
+    { 0xbce5086492111aeaull, 0x88f4bb1ca6bcf584ull },
+    { 0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e5ull },
+    { 0x9392ee8e921d5d07ull, 0x3aff322e62439fcfull },
+    { 0xb877aa3236a4b449ull, 0x09befeb9fad487c2ull },
+    { 0xe69594bec44de15bull, 0x4c2ebe687989a9b3ull },
+    { 0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a10ull },
+    { 0xb424dc35095cd80full, 0x538484c19ef38c94ull },
+    { 0xe12e13424bb40e13ull, 0x2865a5f206b06fb9ull },
+    { 0x8cbccc096f5088cbull, 0xf93f87b7442e45d3ull },
+    { 0xafebff0bcb24aafeull, 0xf78f69a51539d748ull },
+    { 0xdbe6fecebdedd5beull, 0xb573440e5a884d1bull },
+    { 0x89705f4136b4a597ull, 0x31680a88f8953030ull },
+    { 0xabcc77118461cefcull, 0xfdc20d2b36ba7c3dull },
+    { 0xd6bf94d5e57a42bcull, 0x3d32907604691b4cull },
+    { 0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b10full },
+    { 0xa7c5ac471b478423ull, 0x0fcf80dc33721d53ull },
+    { 0xd1b71758e219652bull, 0xd3c36113404ea4a8ull },
+    { 0x83126e978d4fdf3bull, 0x645a1cac083126e9ull },
+    { 0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a3ull },
+    { 0xccccccccccccccccull, 0xccccccccccccccccull },
+    { 0x8000000000000000ull, 0x0000000000000000ull },
+    { 0xa000000000000000ull, 0x0000000000000000ull },
+    { 0xc800000000000000ull, 0x0000000000000000ull },
+    { 0xfa00000000000000ull, 0x0000000000000000ull },
+    { 0x9c40000000000000ull, 0x0000000000000000ull },
+    { 0xc350000000000000ull, 0x0000000000000000ull },
+    { 0xf424000000000000ull, 0x0000000000000000ull },
+    { 0x9896800000000000ull, 0x0000000000000000ull },
+    { 0xbebc200000000000ull, 0x0000000000000000ull },
+    { 0xee6b280000000000ull, 0x0000000000000000ull },
+    { 0x9502f90000000000ull, 0x0000000000000000ull },
+    { 0xba43b74000000000ull, 0x0000000000000000ull },
+    { 0xe8d4a51000000000ull, 0x0000000000000000ull },
+    { 0x9184e72a00000000ull, 0x0000000000000000ull },
+    { 0xb5e620f480000000ull, 0x0000000000000000ull },
+    { 0xe35fa931a0000000ull, 0x0000000000000000ull },
+    { 0x8e1bc9bf04000000ull, 0x0000000000000000ull },
+    { 0xb1a2bc2ec5000000ull, 0x0000000000000000ull },
+    { 0xde0b6b3a76400000ull, 0x0000000000000000ull },
+    { 0x8ac7230489e80000ull, 0x0000000000000000ull },
+    { 0xad78ebc5ac620000ull, 0x0000000000000000ull },
+    { 0xd8d726b7177a8000ull, 0x0000000000000000ull },
+    { 0x878678326eac9000ull, 0x0000000000000000ull },
+    { 0xa968163f0a57b400ull, 0x0000000000000000ull },
+    { 0xd3c21bcecceda100ull, 0x0000000000000000ull },
+    { 0x84595161401484a0ull, 0x0000000000000000ull },
+    { 0xa56fa5b99019a5c8ull, 0x0000000000000000ull },
+    { 0xcecb8f27f4200f3aull, 0x0000000000000000ull },
+    { 0x813f3978f8940984ull, 0x4000000000000000ull },
+    { 0xa18f07d736b90be5ull, 0x5000000000000000ull },
+    { 0xc9f2c9cd04674edeull, 0xa400000000000000ull },
+    { 0xfc6f7c4045812296ull, 0x4d00000000000000ull },
+    { 0x9dc5ada82b70b59dull, 0xf020000000000000ull },
+    { 0xc5371912364ce305ull, 0x6c28000000000000ull },
+    { 0xf684df56c3e01bc6ull, 0xc732000000000000ull },
+    { 0x9a130b963a6c115cull, 0x3c7f400000000000ull },
+    { 0xc097ce7bc90715b3ull, 0x4b9f100000000000ull },
+    { 0xf0bdc21abb48db20ull, 0x1e86d40000000000ull },
+    { 0x96769950b50d88f4ull, 0x1314448000000000ull },
+    { 0xbc143fa4e250eb31ull, 0x17d955a000000000ull },
+    { 0xeb194f8e1ae525fdull, 0x5dcfab0800000000ull },
+    { 0x92efd1b8d0cf37beull, 0x5aa1cae500000000ull },
+    { 0xb7abc627050305adull, 0xf14a3d9e40000000ull },
+    { 0xe596b7b0c643c719ull, 0x6d9ccd05d0000000ull },
+    { 0x8f7e32ce7bea5c6full, 0xe4820023a2000000ull },
+    { 0xb35dbf821ae4f38bull, 0xdda2802c8a800000ull },
+    { 0xe0352f62a19e306eull, 0xd50b2037ad200000ull },
+    { 0x8c213d9da502de45ull, 0x4526f422cc340000ull },
+    { 0xaf298d050e4395d6ull, 0x9670b12b7f410000ull },
+    { 0xdaf3f04651d47b4cull, 0x3c0cdd765f114000ull },
+    { 0x88d8762bf324cd0full, 0xa5880a69fb6ac800ull },
+    { 0xab0e93b6efee0053ull, 0x8eea0d047a457a00ull },
+    { 0xd5d238a4abe98068ull, 0x72a4904598d6d880ull },
+    { 0x85a36366eb71f041ull, 0x47a6da2b7f864750ull },
+    { 0xa70c3c40a64e6c51ull, 0x999090b65f67d924ull },
+    { 0xd0cf4b50cfe20765ull, 0xfff4b4e3f741cf6dull },
+    { 0x82818f1281ed449full, 0xbff8f10e7a8921a4ull },
+    { 0xa321f2d7226895c7ull, 0xaff72d52192b6a0dull },
+    { 0xcbea6f8ceb02bb39ull, 0x9bf4f8a69f764490ull },
+    { 0xfee50b7025c36a08ull, 0x02f236d04753d5b4ull },
+    { 0x9f4f2726179a2245ull, 0x01d762422c946590ull },
+    { 0xc722f0ef9d80aad6ull, 0x424d3ad2b7b97ef5ull },
+    { 0xf8ebad2b84e0d58bull, 0xd2e0898765a7deb2ull },
+    { 0x9b934c3b330c8577ull, 0x63cc55f49f88eb2full },
+    { 0xc2781f49ffcfa6d5ull, 0x3cbf6b71c76b25fbull },
+    { 0xf316271c7fc3908aull, 0x8bef464e3945ef7aull },
+    { 0x97edd871cfda3a56ull, 0x97758bf0e3cbb5acull },
+    { 0xbde94e8e43d0c8ecull, 0x3d52eeed1cbea317ull },
+    { 0xed63a231d4c4fb27ull, 0x4ca7aaa863ee4bddull },
+    { 0x945e455f24fb1cf8ull, 0x8fe8caa93e74ef6aull },
+    { 0xb975d6b6ee39e436ull, 0xb3e2fd538e122b44ull },
+    { 0xe7d34c64a9c85d44ull, 0x60dbbca87196b616ull },
+    { 0x90e40fbeea1d3a4aull, 0xbc8955e946fe31cdull },
+    { 0xb51d13aea4a488ddull, 0x6babab6398bdbe41ull },
+    { 0xe264589a4dcdab14ull, 0xc696963c7eed2dd1ull },
+    { 0x8d7eb76070a08aecull, 0xfc1e1de5cf543ca2ull },
+    { 0xb0de65388cc8ada8ull, 0x3b25a55f43294bcbull },
+    { 0xdd15fe86affad912ull, 0x49ef0eb713f39ebeull },
+    { 0x8a2dbf142dfcc7abull, 0x6e3569326c784337ull },
+    { 0xacb92ed9397bf996ull, 0x49c2c37f07965404ull },
+    { 0xd7e77a8f87daf7fbull, 0xdc33745ec97be906ull },
+    { 0x86f0ac99b4e8dafdull, 0x69a028bb3ded71a3ull },
+    { 0xa8acd7c0222311bcull, 0xc40832ea0d68ce0cull },
+    { 0xd2d80db02aabd62bull, 0xf50a3fa490c30190ull },
+    { 0x83c7088e1aab65dbull, 0x792667c6da79e0faull },
+    { 0xa4b8cab1a1563f52ull, 0x577001b891185938ull },
+    { 0xcde6fd5e09abcf26ull, 0xed4c0226b55e6f86ull },
+    { 0x80b05e5ac60b6178ull, 0x544f8158315b05b4ull },
+    { 0xa0dc75f1778e39d6ull, 0x696361ae3db1c721ull },
+    { 0xc913936dd571c84cull, 0x03bc3a19cd1e38e9ull },
+    { 0xfb5878494ace3a5full, 0x04ab48a04065c723ull },
+    { 0x9d174b2dcec0e47bull, 0x62eb0d64283f9c76ull },
+    { 0xc45d1df942711d9aull, 0x3ba5d0bd324f8394ull },
+    { 0xf5746577930d6500ull, 0xca8f44ec7ee36479ull },
+    { 0x9968bf6abbe85f20ull, 0x7e998b13cf4e1ecbull },
+    { 0xbfc2ef456ae276e8ull, 0x9e3fedd8c321a67eull },
+    { 0xefb3ab16c59b14a2ull, 0xc5cfe94ef3ea101eull },
+    { 0x95d04aee3b80ece5ull, 0xbba1f1d158724a12ull },
+    { 0xbb445da9ca61281full, 0x2a8a6e45ae8edc97ull },
+    { 0xea1575143cf97226ull, 0xf52d09d71a3293bdull },
+    { 0x924d692ca61be758ull, 0x593c2626705f9c56ull },
+    { 0xb6e0c377cfa2e12eull, 0x6f8b2fb00c77836cull },
+    { 0xe498f455c38b997aull, 0x0b6dfb9c0f956447ull },
+    { 0x8edf98b59a373fecull, 0x4724bd4189bd5eacull },
+    { 0xb2977ee300c50fe7ull, 0x58edec91ec2cb657ull },
+    { 0xdf3d5e9bc0f653e1ull, 0x2f2967b66737e3edull },
+    { 0x8b865b215899f46cull, 0xbd79e0d20082ee74ull },
+    { 0xae67f1e9aec07187ull, 0xecd8590680a3aa11ull },
+    { 0xda01ee641a708de9ull, 0xe80e6f4820cc9495ull },
+    { 0x884134fe908658b2ull, 0x3109058d147fdcddull },
+    { 0xaa51823e34a7eedeull, 0xbd4b46f0599fd415ull },
+    { 0xd4e5e2cdc1d1ea96ull, 0x6c9e18ac7007c91aull },
+    { 0x850fadc09923329eull, 0x03e2cf6bc604ddb0ull },
+    { 0xa6539930bf6bff45ull, 0x84db8346b786151cull },
+    { 0xcfe87f7cef46ff16ull, 0xe612641865679a63ull },
+    { 0x81f14fae158c5f6eull, 0x4fcb7e8f3f60c07eull },
+    { 0xa26da3999aef7749ull, 0xe3be5e330f38f09dull },
+    { 0xcb090c8001ab551cull, 0x5cadf5bfd3072cc5ull },
+    { 0xfdcb4fa002162a63ull, 0x73d9732fc7c8f7f6ull },
+    { 0x9e9f11c4014dda7eull, 0x2867e7fddcdd9afaull },
+    { 0xc646d63501a1511dull, 0xb281e1fd541501b8ull },
+    { 0xf7d88bc24209a565ull, 0x1f225a7ca91a4226ull },
+    { 0x9ae757596946075full, 0x3375788de9b06958ull },
+    { 0xc1a12d2fc3978937ull, 0x0052d6b1641c83aeull },
+    { 0xf209787bb47d6b84ull, 0xc0678c5dbd23a49aull },
+    { 0x9745eb4d50ce6332ull, 0xf840b7ba963646e0ull },
+    { 0xbd176620a501fbffull, 0xb650e5a93bc3d898ull },
+    { 0xec5d3fa8ce427affull, 0xa3e51f138ab4cebeull },
+    { 0x93ba47c980e98cdfull, 0xc66f336c36b10137ull },
+    { 0xb8a8d9bbe123f017ull, 0xb80b0047445d4184ull },
+    { 0xe6d3102ad96cec1dull, 0xa60dc059157491e5ull },
+    { 0x9043ea1ac7e41392ull, 0x87c89837ad68db2full },
+    { 0xb454e4a179dd1877ull, 0x29babe4598c311fbull },
+    { 0xe16a1dc9d8545e94ull, 0xf4296dd6fef3d67aull },
+    { 0x8ce2529e2734bb1dull, 0x1899e4a65f58660cull },
+    { 0xb01ae745b101e9e4ull, 0x5ec05dcff72e7f8full },
+    { 0xdc21a1171d42645dull, 0x76707543f4fa1f73ull },
+    { 0x899504ae72497ebaull, 0x6a06494a791c53a8ull },
+    { 0xabfa45da0edbde69ull, 0x0487db9d17636892ull },
+    { 0xd6f8d7509292d603ull, 0x45a9d2845d3c42b6ull },
+    { 0x865b86925b9bc5c2ull, 0x0b8a2392ba45a9b2ull },
+    { 0xa7f26836f282b732ull, 0x8e6cac7768d7141eull },
+    { 0xd1ef0244af2364ffull, 0x3207d795430cd926ull },
+    { 0x8335616aed761f1full, 0x7f44e6bd49e807b8ull },
+    { 0xa402b9c5a8d3a6e7ull, 0x5f16206c9c6209a6ull },
+    { 0xcd036837130890a1ull, 0x36dba887c37a8c0full },
+    { 0x802221226be55a64ull, 0xc2494954da2c9789ull },
+    { 0xa02aa96b06deb0fdull, 0xf2db9baa10b7bd6cull },
+    { 0xc83553c5c8965d3dull, 0x6f92829494e5acc7ull },
+    { 0xfa42a8b73abbf48cull, 0xcb772339ba1f17f9ull },
+    { 0x9c69a97284b578d7ull, 0xff2a760414536efbull },
+    { 0xc38413cf25e2d70dull, 0xfef5138519684abaull },
+    { 0xf46518c2ef5b8cd1ull, 0x7eb258665fc25d69ull },
+    { 0x98bf2f79d5993802ull, 0xef2f773ffbd97a61ull },
+    { 0xbeeefb584aff8603ull, 0xaafb550ffacfd8faull },
+    { 0xeeaaba2e5dbf6784ull, 0x95ba2a53f983cf38ull },
+    { 0x952ab45cfa97a0b2ull, 0xdd945a747bf26183ull },
+    { 0xba756174393d88dfull, 0x94f971119aeef9e4ull },
+    { 0xe912b9d1478ceb17ull, 0x7a37cd5601aab85dull },
+    { 0x91abb422ccb812eeull, 0xac62e055c10ab33aull },
+    { 0xb616a12b7fe617aaull, 0x577b986b314d6009ull },
+    { 0xe39c49765fdf9d94ull, 0xed5a7e85fda0b80bull },
+    { 0x8e41ade9fbebc27dull, 0x14588f13be847307ull },
+    { 0xb1d219647ae6b31cull, 0x596eb2d8ae258fc8ull },
+    { 0xde469fbd99a05fe3ull, 0x6fca5f8ed9aef3bbull },
+    { 0x8aec23d680043beeull, 0x25de7bb9480d5854ull },
+    { 0xada72ccc20054ae9ull, 0xaf561aa79a10ae6aull },
+    { 0xd910f7ff28069da4ull, 0x1b2ba1518094da04ull },
+    { 0x87aa9aff79042286ull, 0x90fb44d2f05d0842ull },
+    { 0xa99541bf57452b28ull, 0x353a1607ac744a53ull },
+    { 0xd3fa922f2d1675f2ull, 0x42889b8997915ce8ull },
+    { 0x847c9b5d7c2e09b7ull, 0x69956135febada11ull },
+    { 0xa59bc234db398c25ull, 0x43fab9837e699095ull },
+    { 0xcf02b2c21207ef2eull, 0x94f967e45e03f4bbull },
+    { 0x8161afb94b44f57dull, 0x1d1be0eebac278f5ull },
+    { 0xa1ba1ba79e1632dcull, 0x6462d92a69731732ull },
+    { 0xca28a291859bbf93ull, 0x7d7b8f7503cfdcfeull },
+    { 0xfcb2cb35e702af78ull, 0x5cda735244c3d43eull },
+    { 0x9defbf01b061adabull, 0x3a0888136afa64a7ull },
+    { 0xc56baec21c7a1916ull, 0x088aaa1845b8fdd0ull },
+    { 0xf6c69a72a3989f5bull, 0x8aad549e57273d45ull },
+    { 0x9a3c2087a63f6399ull, 0x36ac54e2f678864bull },
+    { 0xc0cb28a98fcf3c7full, 0x84576a1bb416a7ddull },
+    { 0xf0fdf2d3f3c30b9full, 0x656d44a2a11c51d5ull },
+    { 0x969eb7c47859e743ull, 0x9f644ae5a4b1b325ull },
+    { 0xbc4665b596706114ull, 0x873d5d9f0dde1feeull },
+    { 0xeb57ff22fc0c7959ull, 0xa90cb506d155a7eaull },
+    { 0x9316ff75dd87cbd8ull, 0x09a7f12442d588f2ull },
+    { 0xb7dcbf5354e9beceull, 0x0c11ed6d538aeb2full },
+    { 0xe5d3ef282a242e81ull, 0x8f1668c8a86da5faull },
+    { 0x8fa475791a569d10ull, 0xf96e017d694487bcull },
+    { 0xb38d92d760ec4455ull, 0x37c981dcc395a9acull },
+    { 0xe070f78d3927556aull, 0x85bbe253f47b1417ull },
+    { 0x8c469ab843b89562ull, 0x93956d7478ccec8eull },
+    { 0xaf58416654a6babbull, 0x387ac8d1970027b2ull },
+    { 0xdb2e51bfe9d0696aull, 0x06997b05fcc0319eull },
+    { 0x88fcf317f22241e2ull, 0x441fece3bdf81f03ull },
+    { 0xab3c2fddeeaad25aull, 0xd527e81cad7626c3ull },
+    { 0xd60b3bd56a5586f1ull, 0x8a71e223d8d3b074ull },
+    { 0x85c7056562757456ull, 0xf6872d5667844e49ull },
+    { 0xa738c6bebb12d16cull, 0xb428f8ac016561dbull },
+    { 0xd106f86e69d785c7ull, 0xe13336d701beba52ull },
+    { 0x82a45b450226b39cull, 0xecc0024661173473ull },
+    { 0xa34d721642b06084ull, 0x27f002d7f95d0190ull },
+    { 0xcc20ce9bd35c78a5ull, 0x31ec038df7b441f4ull },
+    { 0xff290242c83396ceull, 0x7e67047175a15271ull },
+    { 0x9f79a169bd203e41ull, 0x0f0062c6e984d386ull },
+    { 0xc75809c42c684dd1ull, 0x52c07b78a3e60868ull },
+    { 0xf92e0c3537826145ull, 0xa7709a56ccdf8a82ull },
+    { 0x9bbcc7a142b17ccbull, 0x88a66076400bb691ull },
+    { 0xc2abf989935ddbfeull, 0x6acff893d00ea435ull },
+    { 0xf356f7ebf83552feull, 0x0583f6b8c4124d43ull },
+    { 0x98165af37b2153deull, 0xc3727a337a8b704aull },
+    { 0xbe1bf1b059e9a8d6ull, 0x744f18c0592e4c5cull },
+    { 0xeda2ee1c7064130cull, 0x1162def06f79df73ull },
+    { 0x9485d4d1c63e8be7ull, 0x8addcb5645ac2ba8ull },
+    { 0xb9a74a0637ce2ee1ull, 0x6d953e2bd7173692ull },
+    { 0xe8111c87c5c1ba99ull, 0xc8fa8db6ccdd0437ull },
+    { 0x910ab1d4db9914a0ull, 0x1d9c9892400a22a2ull },
+    { 0xb54d5e4a127f59c8ull, 0x2503beb6d00cab4bull },
+    { 0xe2a0b5dc971f303aull, 0x2e44ae64840fd61dull },
+    { 0x8da471a9de737e24ull, 0x5ceaecfed289e5d2ull },
+    { 0xb10d8e1456105dadull, 0x7425a83e872c5f47ull },
+    { 0xdd50f1996b947518ull, 0xd12f124e28f77719ull },
+    { 0x8a5296ffe33cc92full, 0x82bd6b70d99aaa6full },
+    { 0xace73cbfdc0bfb7bull, 0x636cc64d1001550bull },
+    { 0xd8210befd30efa5aull, 0x3c47f7e05401aa4eull },
+    { 0x8714a775e3e95c78ull, 0x65acfaec34810a71ull },
+    { 0xa8d9d1535ce3b396ull, 0x7f1839a741a14d0dull },
+    { 0xd31045a8341ca07cull, 0x1ede48111209a050ull },
+    { 0x83ea2b892091e44dull, 0x934aed0aab460432ull },
+    { 0xa4e4b66b68b65d60ull, 0xf81da84d5617853full },
+    { 0xce1de40642e3f4b9ull, 0x36251260ab9d668eull },
+    { 0x80d2ae83e9ce78f3ull, 0xc1d72b7c6b426019ull },
+    { 0xa1075a24e4421730ull, 0xb24cf65b8612f81full },
+    { 0xc94930ae1d529cfcull, 0xdee033f26797b627ull },
+    { 0xfb9b7cd9a4a7443cull, 0x169840ef017da3b1ull },
+    { 0x9d412e0806e88aa5ull, 0x8e1f289560ee864eull },
+    { 0xc491798a08a2ad4eull, 0xf1a6f2bab92a27e2ull },
+    { 0xf5b5d7ec8acb58a2ull, 0xae10af696774b1dbull },
+    { 0x9991a6f3d6bf1765ull, 0xacca6da1e0a8ef29ull },
+    { 0xbff610b0cc6edd3full, 0x17fd090a58d32af3ull },
+    { 0xeff394dcff8a948eull, 0xddfc4b4cef07f5b0ull },
+    { 0x95f83d0a1fb69cd9ull, 0x4abdaf101564f98eull },
+    { 0xbb764c4ca7a4440full, 0x9d6d1ad41abe37f1ull },
+    { 0xea53df5fd18d5513ull, 0x84c86189216dc5edull },
+    { 0x92746b9be2f8552cull, 0x32fd3cf5b4e49bb4ull },
+    { 0xb7118682dbb66a77ull, 0x3fbc8c33221dc2a1ull },
+    { 0xe4d5e82392a40515ull, 0x0fabaf3feaa5334aull },
+    { 0x8f05b1163ba6832dull, 0x29cb4d87f2a7400eull },
+    { 0xb2c71d5bca9023f8ull, 0x743e20e9ef511012ull },
+    { 0xdf78e4b2bd342cf6ull, 0x914da9246b255416ull },
+    { 0x8bab8eefb6409c1aull, 0x1ad089b6c2f7548eull },
+    { 0xae9672aba3d0c320ull, 0xa184ac2473b529b1ull },
+    { 0xda3c0f568cc4f3e8ull, 0xc9e5d72d90a2741eull },
+    { 0x8865899617fb1871ull, 0x7e2fa67c7a658892ull },
+    { 0xaa7eebfb9df9de8dull, 0xddbb901b98feeab7ull },
+    { 0xd51ea6fa85785631ull, 0x552a74227f3ea565ull },
+    { 0x8533285c936b35deull, 0xd53a88958f87275full },
+    { 0xa67ff273b8460356ull, 0x8a892abaf368f137ull },
+    { 0xd01fef10a657842cull, 0x2d2b7569b0432d85ull },
+    { 0x8213f56a67f6b29bull, 0x9c3b29620e29fc73ull },
+    { 0xa298f2c501f45f42ull, 0x8349f3ba91b47b8full },
+    { 0xcb3f2f7642717713ull, 0x241c70a936219a73ull },
+    { 0xfe0efb53d30dd4d7ull, 0xed238cd383aa0110ull },
+    { 0x9ec95d1463e8a506ull, 0xf4363804324a40aaull },
+    { 0xc67bb4597ce2ce48ull, 0xb143c6053edcd0d5ull },
+    { 0xf81aa16fdc1b81daull, 0xdd94b7868e94050aull },
+    { 0x9b10a4e5e9913128ull, 0xca7cf2b4191c8326ull },
+    { 0xc1d4ce1f63f57d72ull, 0xfd1c2f611f63a3f0ull },
+    { 0xf24a01a73cf2dccfull, 0xbc633b39673c8cecull },
+    { 0x976e41088617ca01ull, 0xd5be0503e085d813ull },
+    { 0xbd49d14aa79dbc82ull, 0x4b2d8644d8a74e18ull },
+    { 0xec9c459d51852ba2ull, 0xddf8e7d60ed1219eull },
+    { 0x93e1ab8252f33b45ull, 0xcabb90e5c942b503ull },
+    { 0xb8da1662e7b00a17ull, 0x3d6a751f3b936243ull },
+    { 0xe7109bfba19c0c9dull, 0x0cc512670a783ad4ull },
+    { 0x906a617d450187e2ull, 0x27fb2b80668b24c5ull },
+    { 0xb484f9dc9641e9daull, 0xb1f9f660802dedf6ull },
+    { 0xe1a63853bbd26451ull, 0x5e7873f8a0396973ull },
+    { 0x8d07e33455637eb2ull, 0xdb0b487b6423e1e8ull },
+    { 0xb049dc016abc5e5full, 0x91ce1a9a3d2cda62ull },
+    { 0xdc5c5301c56b75f7ull, 0x7641a140cc7810fbull },
+    { 0x89b9b3e11b6329baull, 0xa9e904c87fcb0a9dull },
+    { 0xac2820d9623bf429ull, 0x546345fa9fbdcd44ull },
+    { 0xd732290fbacaf133ull, 0xa97c177947ad4095ull },
+    { 0x867f59a9d4bed6c0ull, 0x49ed8eabcccc485dull },
+    { 0xa81f301449ee8c70ull, 0x5c68f256bfff5a74ull },
+    { 0xd226fc195c6a2f8cull, 0x73832eec6fff3111ull },
+    { 0x83585d8fd9c25db7ull, 0xc831fd53c5ff7eabull },
+    { 0xa42e74f3d032f525ull, 0xba3e7ca8b77f5e55ull },
+    { 0xcd3a1230c43fb26full, 0x28ce1bd2e55f35ebull },
+    { 0x80444b5e7aa7cf85ull, 0x7980d163cf5b81b3ull },
+    { 0xa0555e361951c366ull, 0xd7e105bcc332621full },
+    { 0xc86ab5c39fa63440ull, 0x8dd9472bf3fefaa7ull },
+    { 0xfa856334878fc150ull, 0xb14f98f6f0feb951ull },
+    { 0x9c935e00d4b9d8d2ull, 0x6ed1bf9a569f33d3ull },
+    { 0xc3b8358109e84f07ull, 0x0a862f80ec4700c8ull },
+    { 0xf4a642e14c6262c8ull, 0xcd27bb612758c0faull },
+    { 0x98e7e9cccfbd7dbdull, 0x8038d51cb897789cull },
+    { 0xbf21e44003acdd2cull, 0xe0470a63e6bd56c3ull },
+    { 0xeeea5d5004981478ull, 0x1858ccfce06cac74ull },
+    { 0x95527a5202df0ccbull, 0x0f37801e0c43ebc8ull },
+    { 0xbaa718e68396cffdull, 0xd30560258f54e6baull },
+    { 0xe950df20247c83fdull, 0x47c6b82ef32a2069ull },
+    { 0x91d28b7416cdd27eull, 0x4cdc331d57fa5441ull },
+    { 0xb6472e511c81471dull, 0xe0133fe4adf8e952ull },
+    { 0xe3d8f9e563a198e5ull, 0x58180fddd97723a6ull },
+    { 0x8e679c2f5e44ff8full, 0x570f09eaa7ea7648ull },
+};
+
+// Powers of ten a double holds exactly
+static const double exact_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// A number split up as mantissa * 10^exponent, holding at most the first 19 significant digits
+typedef struct {
+    uint64_t mantissa;
+    int64_t exponent;
+    int negative;
+    // No fraction or exponent part was written
+    int integral;
+    // A non zero digit past the first 19 was dropped, the value lies between mantissa and mantissa + 1
+    int truncated;
+} number_parts_t;
+
+// Matches the JSON number grammar at `p`, returning how many bytes it spans or 0 if there isn't a number there
+static size_t scan_number(const char* p, const char* end, number_parts_t* parts) {
+    const char* start = p;
+    uint64_t mantissa = 0;
+    int64_t exponent = 0;
+    int digits = 0;
+
+    parts->negative = 0;
+    parts->integral = 1;
+    parts->truncated = 0;
+
+    if (p < end && *p == '-') {
+        parts->negative = 1;
+        p++;
+    }
+
+    if (p >= end || !is_numeric(*p)) return 0;
+
+    // A leading zero stands alone
+    if (*p == '0') {
+        p++;
+    } else {
+        while (p < end && is_numeric(*p)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                digits++;
+            } else {
+                exponent++;
+                if (*p != '0') parts->truncated = 1;
+            }
+            p++;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        p++;
+        if (p >= end || !is_numeric(*p)) return 0;
+
+        parts->integral = 0;
+        while (p < end && is_numeric(*p)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                exponent--;
+                // Zeros ahead of the first non zero digit aren't significant
+                if (mantissa != 0) digits++;
+            } else if (*p != '0') {
+                parts->truncated = 1;
+            }
+            p++;
+        }
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+
+        int exp_negative = 0;
+        if (p < end && (*p == '+' || *p == '-')) {
+            exp_negative = *p == '-';
+            p++;
+        }
+
+        if (p >= end || !is_numeric(*p)) return 0;
+
+        parts->integral = 0;
+        int64_t exp = 0;
+        while (p < end && is_numeric(*p)) {
+            // Past this the result is zero or infinity whatever the mantissa is, stop growing so it can't overflow
+            if (exp < 100000) exp = exp * 10 + (*p - '0');
+            p++;
+        }
+
+        exponent += exp_negative ? -exp : exp;
+    }
+
+    parts->mantissa = mantissa;
+    parts->exponent = exponent;
+    return p - start;
+}
+
+static size_t number_length(const char* p, const char* end) {
+    number_parts_t parts;
+    return scan_number(p, end, &parts);
+}
+
+// Eisel-Lemire: converts mantissa * 10^exp10 with a 128 bit multiply, returning 0 in the rare cases
+// where the truncated power of ten leaves the rounding direction ambiguous
+static int eisel_lemire(uint64_t mantissa, int64_t exp10, int negative, double* out) {
+    if (mantissa == 0) {
+        *out = negative ? -0.0 : 0.0;
+        return 1;
+    }
+
+    if (exp10 < POW10_MIN_EXP || exp10 > POW10_MAX_EXP) return 0;
+
+    int clz = __builtin_clzll(mantissa);
+    mantissa <<= clz;
+
+    // floor(log2(10) * exp10) via 217706 / 2^16, then biased for a double
+    uint64_t exp2 = (uint64_t)(((217706 * (int32_t)exp10) >> 16) + 64 + 1023) - (uint64_t)clz;
+
+    const uint64_t* pow = pow10_128[exp10 - POW10_MIN_EXP];
+    uint64_t x_hi, x_lo;
+    mul128(mantissa, pow[0], &x_hi, &x_lo);
+
+    // The low bits could still carry into the ones that get kept, bring in the lower word of the power
+    if ((x_hi & 0x1FF) == 0x1FF && x_lo + mantissa < mantissa) {
+        uint64_t y_hi, y_lo;
+        mul128(mantissa, pow[1], &y_hi, &y_lo);
+
+        uint64_t merged_hi = x_hi;
+        uint64_t merged_lo = x_lo + y_hi;
+        if (merged_lo < x_lo) merged_hi++;
+
+        if ((merged_hi & 0x1FF) == 0x1FF && merged_lo + 1 == 0 && y_lo + mantissa < mantissa) {
+            return 0;
+        }
+
+        x_hi = merged_hi;
+        x_lo = merged_lo;
+    }
+
+    uint64_t msb = x_hi >> 63;
+    uint64_t bits = x_hi >> (msb + 9);
+    exp2 -= 1 ^ msb;
+
+    // Exactly halfway between two doubles, leave the tie to strtod
+    if (x_lo == 0 && (x_hi & 0x1FF) == 0 && (bits & 3) == 1) return 0;
+
+    bits += bits & 1;
+    bits >>= 1;
+    if (bits >> 53 > 0) {
+        bits >>= 1;
+        exp2++;
+    }
+
+    // Subnormals and overflow go through strtod too
+    if (exp2 - 1 >= 0x7FF - 1) return 0;
+
+    bits = exp2 << 52 | (bits & 0x000FFFFFFFFFFFFFull);
+    if (negative) bits |= 0x8000000000000000ull;
+
+    memcpy(out, &bits, sizeof(*out));
+    return 1;
+}
+
+// Converts the `len` bytes at `start` that `scan_number` split into `parts`
+static int number_to_double(const char* start, size_t len, const number_parts_t* parts, double* out) {
+    if (!parts->truncated) {
+        // Both the mantissa and the power of ten are exact doubles, so a single rounding gives the right answer
+        if (parts->mantissa <= (1ull << 53) && parts->exponent >= -22 && parts->exponent <= 22) {
+            double d = (double)parts->mantissa;
+            d = parts->exponent < 0 ? d / exact_pow10[-parts->exponent] : d * exact_pow10[parts->exponent];
+            *out = parts->negative ? -d : d;
+            return 0;
+        }
+
+        if (eisel_lemire(parts->mantissa, parts->exponent, parts->negative, out)) {
+            return 0;
+        }
+    } else {
+        double lo, hi;
+        if (eisel_lemire(parts->mantissa, parts->exponent, parts->negative, &lo)
+                && eisel_lemire(parts->mantissa + 1, parts->exponent, parts->negative, &hi)
+                && lo == hi) {
+            *out = lo;
+            return 0;
+        }
+    }
+
+    char small[64];
+    char* buf = small;
+    if (len >= sizeof(small)) {
+        buf = JSON_MALLOC(len + 1);
+        if (buf == NULL) return ALLOCATION_FAILED;
+    }
+
+    memcpy(buf, start, len);
+    buf[len] = '\0';
+    *out = strtod(buf, NULL);
+
+    if (buf != small) {
+        JSON_FREE(buf);
+    }
+
+    return 0;
+}
+
+// PARSER IMPL
+
+/**
+ * @brief - Cursor over the raw input used by the single pass parser, values are built straight from bytes
+ * @property cur - next unread byte
+ * @property end - one past the last byte of the input
+ * @property arena - arena to build the tree in, NULL for the heap
+ * @property flags - `JSON_PARSE_*` flags
+ * @property kernels - vector kernels used to jump over string contents and whitespace
+ * @property intern - table object keys are interned into, NULL to copy them
+ * @property items - Elements of the arrays still being parsed, innermost last, each array moves its own into an exact size buffer when it closes
+ * @property items_len - Number of elements in `items`
+ * @property items_capacity - Number of elements `items` has room for
+ * @property frames - Objects and arrays still open, innermost last, this stands in for recursion so nesting never grows the C stack
+ * @property frames_len - Number of frames in `frames`
+ * @property frames_capacity - Number of frames `frames` has room for
+ * @property max_depth - Deepest nesting accepted before failing with DEPTH_LIMIT_EXCEEDED
+ * @property stats - statistics being collected, only present with `JSON_ENABLE_STATS`
+ * @property depth - current nesting while collecting statistics
+ */
+typedef struct {
+    const char* cur;
+    const char* end;
+    json_arena_t* arena;
+    unsigned int flags;
+    const simd_kernels_t* kernels;
+    json_intern_t* intern;
+
+    json_object_t* items;
+    size_t items_len;
+    size_t items_capacity;
+
+    json_parse_frame_t* frames;
+    size_t frames_len;
+    size_t frames_capacity;
+    size_t max_depth;
+
+#ifdef JSON_ENABLE_STATS
+    json_parse_stats_t* stats;
+    size_t depth;
+#endif
+} json_parse_state_t;
+
+#ifdef JSON_ENABLE_STATS
+#define stats_token(st) ((st)->stats != NULL ? (void)(st)->stats->tokens++ : (void)0)
+#define stats_enter(st) ((st)->stats != NULL && ++(st)->depth > (st)->stats->max_depth ? (void)((st)->stats->max_depth = (st)->depth) : (void)0)
+#define stats_leave(st) ((st)->stats != NULL ? (void)(st)->depth-- : (void)0)
+#else
+#define stats_token(st) ((void)0)
+#define stats_enter(st) ((void)0)
+#define stats_leave(st) ((void)0)
+#endif
+
+static int parse_value(json_parse_state_t* st, json_object_t* obj);
+static int parse_number(json_parse_state_t* st, json_object_t* obj);
+static int parse_literal(json_parse_state_t* st, json_object_t* obj);
+static int parse_string(json_parse_state_t* st, json_object_t* obj);
+
+static void skip_whitespace(json_parse_state_t* st) {
+    // Most gaps are zero or one byte wide
+    for (int i = 0; i < 8; i++) {
+        if (st->cur >= st->end || !is_whitespace(*st->cur)) {
+            return;
+        }
+        st->cur++;
+    }
+
+    // Long indentation runs are skipped a block at a time
+    while (st->end - st->cur >= 64) {
+        json_block_masks_t m;
+        st->kernels->classify((const unsigned char*)st->cur, &m);
+
+        if (~m.whitespace != 0) {
+            st->cur += ctz64(~m.whitespace);
+            return;
+        }
+        st->cur += 64;
+    }
+
+    while (st->cur < st->end && is_whitespace(*st->cur)) {
+        st->cur++;
+    }
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static int read_hex4(const char* p, const char* end, uint32_t* out) {
+    if (end - p < 4) {
+        return UNEXPECTED_TOKEN;
+    }
+
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = hex_value(p[i]);
+        if (digit < 0) {
+            return UNEXPECTED_TOKEN;
+        }
+        value = (value << 4) | digit;
+    }
+
+    *out = value;
+    return 0;
+}
+
+static size_t write_utf8(uint32_t cp, char* dst) {
+    if (cp < 0x80) {
+        dst[0] = cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        dst[0] = 0xC0 | (cp >> 6);
+        dst[1] = 0x80 | (cp & 0x3F);
+        return 2;
+    }
+    if (cp < 0x10000) {
+        dst[0] = 0xE0 | (cp >> 12);
+        dst[1] = 0x80 | ((cp >> 6) & 0x3F);
+        dst[2] = 0x80 | (cp & 0x3F);
+        return 3;
+    }
+
+    dst[0] = 0xF0 | (cp >> 18);
+    dst[1] = 0x80 | ((cp >> 12) & 0x3F);
+    dst[2] = 0x80 | ((cp >> 6) & 0x3F);
+    dst[3] = 0x80 | (cp & 0x3F);
+    return 4;
+}
+
+// Reads the hex digits after a \u, joining a surrogate pair into one code point and moving `src` past all of it
+static int read_unicode_escape(const char** src, const char* end, uint32_t* out) {
+    const char* p = *src;
+    uint32_t cp;
+    if (read_hex4(p, end, &cp) != 0) {
+        return UNEXPECTED_TOKEN;
+    }
+    p += 4;
+
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        // A high surrogate has to be followed by an escaped low surrogate
+        uint32_t low;
+        if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || read_hex4(p + 2, end, &low) != 0
+                || low < 0xDC00 || low > 0xDFFF) {
+            return UNEXPECTED_TOKEN;
+        }
+        p += 6;
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        return UNEXPECTED_TOKEN;
+    }
+
+    *src = p;
+    *out = cp;
+    return 0;
+}
+
+// Checks every escape in raw string contents without decoding them
+static int escapes_valid(const char* str, size_t len) {
+    const char* end = str + len;
+
+    while ((str = memchr(str, '\\', end - str)) != NULL) {
+        if (end - str < 2) {
+            return 0;
+        }
+
+        char c = str[1];
+        str += 2;
+
+        if (c == 'u') {
+            uint32_t cp;
+            if (read_unicode_escape(&str, end, &cp) != 0) {
+                return 0;
+            }
+        } else if (c != '"' && c != '\\' && c != '/' && c != 'b' && c != 'f' && c != 'n' && c != 'r' && c != 't') {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Decodes the escapes in raw string contents, `dst` needs room for `len` bytes since decoding never grows a string
+static int unescape_string(const char* src, size_t len, char* dst, size_t* out_len) {
+    const char* end = src + len;
+    char* out = dst;
+
+    while (src < end) {
+        const char* backslash = memchr(src, '\\', end - src);
+        if (backslash == NULL) {
+            backslash = end;
+        }
+
+        memcpy(out, src, backslash - src);
+        out += backslash - src;
+        src = backslash;
+
+        if (src == end) {
+            break;
+        }
+
+        if (end - src < 2) {
+            return UNEXPECTED_TOKEN;
+        }
+
+        char c = src[1];
+        src += 2;
+
+        switch (c) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '/': *out++ = '/'; break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+
+            case 'u': {
+                uint32_t cp;
+                if (read_unicode_escape(&src, end, &cp) != 0) {
+                    return UNEXPECTED_TOKEN;
+                }
+
+                out += write_utf8(cp, out);
+                break;
+            }
+
+            default:
+                return UNEXPECTED_TOKEN;
+        }
+    }
+
+    *out_len = out - dst;
+    return 0;
+}
+
+// Copies raw string contents into a null terminated buffer from the arena (or heap), decoding escapes on the way
+static int copy_string(json_arena_t* arena, const char* raw, size_t len, int escaped, char** out, size_t* out_len) {
+    char* buf = mem_alloc(arena, len + 1);
+    if (buf == NULL) {
+        return ALLOCATION_FAILED;
+    }
+
+    size_t n = len;
+    if (escaped) {
+        int rc = unescape_string(raw, len, buf, &n);
+        if (rc != 0) {
+            mem_free(arena, buf);
+            return rc;
+        }
+    } else if (len > 0) {
+        // An empty string may come from a buffer that was never allocated
+        memcpy(buf, raw, len);
+    }
+
+    buf[n] = '\0';
+    *out = buf;
+    *out_len = n;
+    return 0;
+}
+
+// Consumes a quoted string, leaving `start`/`len` pointing at its raw contents in the input
+static int scan_string(json_parse_state_t* st, const char** start, size_t* len, int* escaped) {
+    // skip the "
+    st->cur++;
+    const char* begin = st->cur;
+    *escaped = 0;
+
+    for (;;) {
+        // Jump straight to the first quote, backslash or control character
+        st->cur += st->kernels->scan_string(st->cur, st->end - st->cur);
+        if (st->cur >= st->end) {
+            return INDEX_GREATER_THAN_LEN;
+        }
+
+        if (*st->cur == '"') {
+            break;
+        }
+
+        // Control characters are never valid raw
+        if (*st->cur != '\\') {
+            return UNEXPECTED_TOKEN;
+        }
+
+        // The escaped byte is skipped so an escaped quote does not end the string, escapes are checked when decoded
+        *escaped = 1;
+        st->cur += 2;
+        if (st->cur > st->end) {
+            return INDEX_GREATER_THAN_LEN;
+        }
+    }
+
+    *start = begin;
+    *len = st->cur - begin;
+
+    // Raw bytes have to be well formed UTF-8, escapes are checked when decoded
+    if (!st->kernels->utf8_valid(begin, *len)) {
+        return UNEXPECTED_TOKEN;
+    }
+
+    // skip the " again and move on
+    st->cur++;
+    return 0;
+}
+
+// Inserts a member under the canonical copy of its key, so no per document key memory is needed
+static int parse_insert_interned(json_parse_state_t* st, json_object_map_t* map, const char* key, size_t key_len,
+                                 int escaped, json_object_t* val) {
+    // Escaped keys are decoded first, short ones on the stack
+    char scratch[128];
+    char* decoded = NULL;
+    if (escaped) {
+        int rc = key_len <= sizeof(scratch) ? unescape_string(key, key_len, scratch, &key_len)
+                                            : copy_string(NULL, key, key_len, 1, &decoded, &key_len);
+        if (rc != 0) {
+            return rc;
+        }
+        key = decoded != NULL ? decoded : scratch;
+    }
+
+    uint64_t hash;
+    const char* canonical = intern_key(st->intern, key, key_len, &hash);
+    JSON_FREE(decoded);
+    if (canonical == NULL) {
+        return ALLOCATION_FAILED;
+    }
+
+    if (map->seed != st->intern->seed) {
+        hash = json_hash(canonical, key_len, map->seed);
+    }
+
+    return map_insert_hashed(map, (char*)canonical, key_len, hash, val, MAP_KEY_INTERNED);
+}
+
+// Adds a finished member to an object being parsed, releasing the value if it could not be added
+static int parse_insert_member(json_parse_state_t* st, json_object_map_t* map, const char* key, size_t key_len, int escaped,
+                               json_object_t* val) {
+    int rc;
+    if (st->intern != NULL) {
+        rc = parse_insert_interned(st, map, key, key_len, escaped, val);
+    } else if (escaped) {
+        // Escaped keys are decoded once and handed to the map as is
+        char* decoded;
+        rc = copy_string(st->arena, key, key_len, 1, &decoded, &key_len);
+        if (rc == 0) {
+            rc = map_insert(map, decoded, key_len, val, MAP_KEY_TAKE);
+        }
+    } else if (st->flags & JSON_PARSE_BORROW_STRINGS) {
+        rc = map_insert(map, (char*)key, key_len, val, MAP_KEY_BORROW);
+    } else {
+        // The key is copied once, straight out of the input
+        rc = map_insert(map, (char*)key, key_len, val, MAP_KEY_COPY);
+    }
+
+    if (rc != 0 && st->arena == NULL) {
+        json_deinit(val);
+    }
+
+    return rc;
+}
+
+static int parse_items_push(json_parse_state_t* st, json_object_t* item) {
+    if (st->items_len == st->items_capacity) {
+        size_t capacity = st->items_capacity == 0 ? JSON_ARRAY_START_SIZE : st->items_capacity * 2;
+        json_object_t* items = STATS_ALLOC(capacity * sizeof(json_object_t),
+                                           JSON_REALLOC(st->items, capacity * sizeof(json_object_t)));
+        if (items == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        st->items = items;
+        st->items_capacity = capacity;
+    }
+
+    st->items[st->items_len++] = *item;
+    return 0;
+}
+
+// Opens an object or array at the byte under the cursor, `depth` being the number of containers already open around it
+static int parse_open(json_parse_state_t* st, size_t depth) {
+    if (depth >= st->max_depth) {
+        return DEPTH_LIMIT_EXCEEDED;
+    }
+
+    if (st->frames_len == st->frames_capacity) {
+        size_t capacity = st->frames_capacity == 0 ? JSON_PARSE_FRAMES_START_SIZE : st->frames_capacity * 2;
+        json_parse_frame_t* frames = STATS_ALLOC(capacity * sizeof(json_parse_frame_t),
+                                                 JSON_REALLOC(st->frames, capacity * sizeof(json_parse_frame_t)));
+        if (frames == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        st->frames = frames;
+        st->frames_capacity = capacity;
+    }
+
+    json_parse_frame_t* frame = &st->frames[st->frames_len];
+    if (*st->cur == '{') {
+        json_object_map_t* map = mem_alloc(st->arena, sizeof(json_object_map_t));
+        if (map == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        json_object_map_t_init(map);
+        map->arena = st->arena;
+        frame->container.tag = OBJECT;
+        frame->container.val.obj = map;
+    } else {
+        json_array_t* arr = mem_alloc(st->arena, sizeof(json_array_t));
+        if (arr == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        json_array_t_init(arr);
+        arr->arena = st->arena;
+        frame->container.tag = ARRAY;
+        frame->container.val.arr = arr;
+    }
+
+    frame->base = st->items_len;
+    st->frames_len++;
+    st->cur++;
+    stats_enter(st);
+    return 0;
+}
+
+// Closes the innermost container, handing it back in `val`
+static int parse_close(json_parse_state_t* st, json_object_t* val) {
+    json_parse_frame_t* frame = &st->frames[st->frames_len - 1];
+
+    // Elements are collected on the shared stack first, so once the length is known
+    // the array gets a single allocation of exactly the right size
+    if (frame->container.tag == ARRAY && st->items_len > frame->base) {
+        json_array_t* arr = frame->container.val.arr;
+        size_t count = st->items_len - frame->base;
+        arr->items = mem_alloc(st->arena, count * sizeof(json_object_t));
+        if (arr->items == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        memcpy(arr->items, st->items + frame->base, count * sizeof(json_object_t));
+        arr->len = count;
+        arr->capacity = count;
+        st->items_len = frame->base;
+    }
+
+    *val = frame->container;
+    st->frames_len--;
+    stats_leave(st);
+    return 0;
+}
+
+static int parse_number(json_parse_state_t* st, json_object_t* obj) {
+    number_parts_t parts;
+    size_t len = scan_number(st->cur, st->end, &parts);
+    if (len == 0) return UNEXPECTED_TOKEN;
+
+    // Whole numbers that fit stay exact, -0 keeps its sign as a double
+    if (parts.integral && parts.exponent == 0 && !parts.truncated && (parts.mantissa != 0 || !parts.negative)) {
+        uint64_t limit = parts.negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+        if (parts.mantissa <= limit) {
+            obj->tag = INTEGER;
+            obj->val.integer = parts.negative ? -(int64_t)(parts.mantissa - 1) - 1 : (int64_t)parts.mantissa;
+            st->cur += len;
+            return 0;
+        }
+    }
+
+    double d;
+    int rc = number_to_double(st->cur, len, &parts, &d);
+    if (rc != 0) return rc;
+
+    obj->tag = NUMBER;
+    obj->val.number = d;
+    st->cur += len;
+    return 0;
+}
+
+static int literal_matches(json_parse_state_t* st, const char* literal, size_t len) {
+    if ((size_t)(st->end - st->cur) < len || memcmp(st->cur, literal, len) != 0) {
+        return 0;
+    }
+
+    // `trueish` is not `true`
+    if (st->cur + len < st->end && is_alphanumeric(st->cur[len])) {
+        return 0;
+    }
+
+    st->cur += len;
+    return 1;
+}
+
+static int parse_literal(json_parse_state_t* st, json_object_t* obj) {
+    if (literal_matches(st, "true", 4)) {
+        obj->tag = BOOLEAN;
+        obj->val.boolean = 1;
+    } else if (literal_matches(st, "false", 5)) {
+        obj->tag = BOOLEAN;
+        obj->val.boolean = 0;
+    } else if (literal_matches(st, "null", 4)) {
+        obj->tag = NULL_VAL;
+    } else {
+        return UNEXPECTED_TOKEN;
+    }
+
+    return 0;
+}
+
+static int parse_string(json_parse_state_t* st, json_object_t* obj) {
+    const char* start;
+    size_t len;
+    int escaped;
+
+    int rc = scan_string(st, &start, &len, &escaped);
+    if (rc != 0) {
+        return rc;
+    }
+
+    // Strings without escapes can point right into the input
+    if (!escaped && (st->flags & JSON_PARSE_BORROW_STRINGS)) {
+        obj->tag = STRING_VIEW;
+        obj->val.view.ptr = start;
+        obj->val.view.len = len;
+        return 0;
+    }
+
+    char* buf;
+    rc = copy_string(st->arena, start, len, escaped, &buf, &len);
+    if (rc != 0) {
+        return rc;
+    }
+
+    obj->tag = STRING;
+    obj->val.str = buf;
+    obj->val.view.len = len;
+    return 0;
+}
+
+// Parses one value of any depth. Instead of recursing into objects and arrays, every open container is a frame on
+// `st->frames`, and each finished value is handed to the innermost frame, so the C stack stays flat however deep the input
+static int parse_value(json_parse_state_t* st, json_object_t* obj) {
+    size_t frames_base = st->frames_len;
+    size_t items_base = st->items_len;
+    json_parse_frame_t* frame;
+    json_object_t val;
+    int rc;
+
+    obj->tag = NULL_VAL;
+
+value:
+    skip_whitespace(st);
+    if (st->cur >= st->end) {
+        rc = INDEX_GREATER_THAN_LEN;
+        goto fail;
+    }
+
+    stats_token(st);
+    switch (*st->cur) {
+        case '{':
+            rc = parse_open(st, st->frames_len - frames_base);
+            if (rc != 0) goto fail;
+
+            skip_whitespace(st);
+            if (st->cur < st->end && *st->cur == '}') {
+                st->cur++;
+                goto close;
+            }
+            goto key;
+
+        case '[':
+            rc = parse_open(st, st->frames_len - frames_base);
+            if (rc != 0) goto fail;
+
+            skip_whitespace(st);
+            if (st->cur < st->end && *st->cur == ']') {
+                st->cur++;
+                goto close;
+            }
+            goto value;
+
+        case '"':
+            rc = parse_string(st, &val);
+            break;
+
+        case 't':
+        case 'f':
+        case 'n':
+            rc = parse_literal(st, &val);
+            break;
+
+        default:
+            rc = is_numeric(*st->cur) || *st->cur == '-' ? parse_number(st, &val) : UNEXPECTED_TOKEN;
+            break;
+    }
+
+    if (rc != 0) goto fail;
+
+    // `val` is finished, it becomes the result or the next member or element of the innermost open container
+deliver:
+    if (st->frames_len == frames_base) {
+        *obj = val;
+        return 0;
+    }
+
+    frame = &st->frames[st->frames_len - 1];
+    if (frame->container.tag == OBJECT) {
+        rc = parse_insert_member(st, frame->container.val.obj, frame->key, frame->key_len, frame->key_escaped, &val);
+        if (rc != 0) goto fail;
+
+        skip_whitespace(st);
+        if (st->cur >= st->end) {
+            rc = INDEX_GREATER_THAN_LEN;
+            goto fail;
+        }
+
+        if (*st->cur == ',') {
+            st->cur++;
+            skip_whitespace(st);
+            goto key;
+        }
+
+        if (*st->cur == '}') {
+            st->cur++;
+            goto close;
+        }
+
+        rc = UNEXPECTED_TOKEN;
+        goto fail;
+    }
+
+    rc = parse_items_push(st, &val);
+    if (rc != 0) {
+        if (st->arena == NULL) {
+            json_deinit(&val);
+        }
+        goto fail;
+    }
+
+    skip_whitespace(st);
+    if (st->cur >= st->end) {
+        rc = INDEX_GREATER_THAN_LEN;
+        goto fail;
+    }
+
+    if (*st->cur == ',') {
+        st->cur++;
+        goto value;
+    }
+
+    if (*st->cur == ']') {
+        st->cur++;
+        goto close;
+    }
+
+    rc = UNEXPECTED_TOKEN;
+    goto fail;
+
+    // The cursor is where the next member of the innermost object should start
+key:
+    if (st->cur >= st->end) {
+        rc = INDEX_GREATER_THAN_LEN;
+        goto fail;
+    }
+
+    if (*st->cur != '"') {
+        rc = UNEXPECTED_TOKEN;
+        goto fail;
+    }
+
+    frame = &st->frames[st->frames_len - 1];
+    rc = scan_string(st, &frame->key, &frame->key_len, &frame->key_escaped);
+    if (rc != 0) goto fail;
+    stats_token(st);
+
+    skip_whitespace(st);
+    if (st->cur >= st->end || *st->cur != ':') {
+        rc = st->cur >= st->end ? INDEX_GREATER_THAN_LEN : UNEXPECTED_TOKEN;
+        goto fail;
+    }
+    st->cur++;
+    goto value;
+
+close:
+    rc = parse_close(st, &val);
+    if (rc != 0) goto fail;
+    goto deliver;
+
+fail:
+    // Open containers were never handed to a parent, so each is released here with the elements collected for it
+    if (st->arena == NULL) {
+        for (size_t i = items_base; i < st->items_len; i++) {
+            json_deinit(&st->items[i]);
+        }
+        for (size_t i = frames_base; i < st->frames_len; i++) {
+            json_deinit(&st->frames[i].container);
+        }
+    }
+
+    while (st->frames_len > frames_base) {
+        st->frames_len--;
+        stats_leave(st);
+    }
+
+    st->items_len = items_base;
+    obj->tag = NULL_VAL;
+    return rc;
+}
+
+// Moves past one value without building or allocating anything. Containers are skipped by matching brackets
+// and quotes only, so their contents are not checked beyond being balanced and having terminated strings
+static int skip_value(json_parse_state_t* st) {
+    skip_whitespace(st);
+    if (st->cur >= st->end) return INDEX_GREATER_THAN_LEN;
+
+    const char* str;
+    size_t len;
+    int escaped;
+    char c = *st->cur;
+
+    if (c == '"') {
+        return scan_string(st, &str, &len, &escaped);
+    }
+
+    if (c != '{' && c != '[') {
+        if (is_numeric(c) || c == '-') {
+            len = number_length(st->cur, st->end);
+            if (len == 0) return UNEXPECTED_TOKEN;
+
+            st->cur += len;
+            return 0;
+        }
+
+        json_object_t literal;
+        return parse_literal(st, &literal);
+    }
+
+    size_t depth = 0;
+    while (st->cur < st->end) {
+        c = *st->cur;
+
+        if (c == '"') {
+            // String contents are jumped over by the vector kernels, brackets inside them don't count
+            int rc = scan_string(st, &str, &len, &escaped);
+            if (rc != 0) return rc;
+            continue;
+        }
+
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) {
+                st->cur++;
+                return 0;
+            }
+        }
+
+        st->cur++;
+    }
+
+    return INDEX_GREATER_THAN_LEN;
+}
+
+static void parse_state_init(json_parse_state_t* st, json_arena_t* arena, unsigned int flags) {
+    st->cur = NULL;
+    st->end = NULL;
+    st->arena = arena;
+    st->flags = flags;
+    st->kernels = simd_kernels();
+    st->intern = NULL;
+    st->items = NULL;
+    st->items_len = 0;
+    st->items_capacity = 0;
+    st->frames = NULL;
+    st->frames_len = 0;
+    st->frames_capacity = 0;
+    st->max_depth = JSON_PARSE_MAX_DEPTH;
+#ifdef JSON_ENABLE_STATS
+    st->stats = NULL;
+    st->depth = 0;
+#endif
+}
+
+static void parse_state_deinit(json_parse_state_t* st) {
+    JSON_FREE(st->items);
+    st->items = NULL;
+    st->items_capacity = 0;
+
+    JSON_FREE(st->frames);
+    st->frames = NULL;
+    st->frames_capacity = 0;
+}
+
+// Parses one whole document with `st`, whose buffers are kept for the next one
+static int parse_document(json_parse_state_t* st, const char* json, size_t len, json_object_t* obj) {
+    st->cur = json;
+    st->end = json + len;
+    st->items_len = 0;
+    st->frames_len = 0;
+
+    int return_code = parse_value(st, obj);
+    if (return_code != 0) {
+        return return_code;
+    }
+
+    // Only whitespace may follow the top level value
+    skip_whitespace(st);
+    if (st->cur != st->end) {
+        if (st->arena == NULL) {
+            json_deinit(obj);
+        }
+        obj->tag = NULL_VAL;
+        return UNEXPECTED_TOKEN;
+    }
+
+    return 0;
+}
+
+// Runs `parse_document` with the intern table, depth limit and statistics from `opts`, the arena and flags are already in `st`
+static int parse_with_opts(json_parse_state_t* st, const char* json, size_t len, json_object_t* obj, const json_parse_opts_t* opts) {
+    st->intern = opts != NULL ? opts->intern : NULL;
+    st->max_depth = opts != NULL && opts->max_depth != 0 ? opts->max_depth : JSON_PARSE_MAX_DEPTH;
+
+#ifdef JSON_ENABLE_STATS
+    st->stats = opts != NULL ? opts->stats : NULL;
+    if (st->stats != NULL) {
+        // A parse started from inside a hook is charged to its own stats, not the outer ones
+        stats_phase(st->stats, JSON_PHASE_PARSE, 0);
+        json_parse_stats_t* outer = stats_current;
+        stats_current = st->stats;
+        stats_mark_t start = stats_mark();
+
+        int return_code = parse_document(st, json, len, obj);
+
+        stats_add(st->stats, JSON_PHASE_PARSE, start);
+        st->stats->bytes += st->cur - json;
+        stats_current = outer;
+        stats_phase(st->stats, JSON_PHASE_PARSE, 1);
+        return return_code;
+    }
+#endif
+
+    return parse_document(st, json, len, obj);
+}
+
+/**
+ * @brief Parses a JSON buffer into a JSON Object
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param obj - pointer to the JSON object to populate
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse(const char* json, size_t len, json_object_t* obj) {
+    return json_parse_ex(json, len, obj, NULL);
+}
+
+/**
+ * @brief Parses a JSON buffer into a JSON Object whose entire tree is allocated from an arena
+ * The result must not be passed to `json_deinit`, release it with `json_arena_t_deinit` instead
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param obj - pointer to the JSON object to populate
+ * @param arena - arena to allocate maps, nodes, keys and strings from
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse_arena(const char* json, size_t len, json_object_t* obj, json_arena_t* arena) {
+    json_parse_opts_t opts = { .arena = arena };
+    return json_parse_ex(json, len, obj, &opts);
+}
+
+/**
+ * @brief Parses a JSON buffer into a JSON Object with explicit options
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param obj - pointer to the JSON object to populate
+ * @param opts - parse options, NULL for the defaults
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse_ex(const char* json, size_t len, json_object_t* obj, const json_parse_opts_t* opts) {
+    json_parse_state_t st;
+    parse_state_init(&st, opts != NULL ? opts->arena : NULL, opts != NULL ? opts->flags : 0);
+
+    int return_code = parse_with_opts(&st, json, len, obj, opts);
+    parse_state_deinit(&st);
+    return return_code;
+}
+
+/**
+ * @brief Frees all memory tied to the JSON Object if it had any heap stored values (sub-objects or strings)
+ * Does not free the underlying pointer
+ * @param json - JSON object to deinit
+ */
+void json_deinit(json_object_t* json) {
+    // Arena backed containers are owned by their arena, heap ones are walked and freed without recursing
+    deinit_stack_t s;
+    deinit_stack_init(&s);
+    deinit_release(&s, json);
+    deinit_drain(&s);
+    deinit_stack_deinit(&s);
+}
+
+/**
+ * @brief - `json_deinit` that times the teardown into the DEINIT phase of `stats`
+ * @param json - JSON object to deinit
+ * @param stats - statistics to add the teardown to, ignored unless built with `JSON_ENABLE_STATS`
+ */
+void json_deinit_stats(json_object_t* json, json_parse_stats_t* stats) {
+#ifdef JSON_ENABLE_STATS
+    if (stats != NULL) {
+        stats_phase(stats, JSON_PHASE_DEINIT, 0);
+        stats_mark_t start = stats_mark();
+        json_deinit(json);
+        stats_add(stats, JSON_PHASE_DEINIT, start);
+        stats_phase(stats, JSON_PHASE_DEINIT, 1);
+        return;
+    }
+#else
+    (void)stats;
+#endif
+
+    json_deinit(json);
+}
+
+/**
+ * @brief - Returns the bytes of a STRING or STRING_VIEW value
+ * @param obj - the value
+ * @param len - set to the length of the string, may be NULL
+ * @return pointer to the first byte, only null terminated for STRING
+ * @return NULL if the value is not a string
+ */
+const char* json_object_t_string(const json_object_t* obj, size_t* len) {
+    if (obj->tag != STRING && obj->tag != STRING_VIEW) {
+        return NULL;
+    }
+
+    if (len != NULL) {
+        *len = obj->val.view.len;
+    }
+
+    return obj->val.view.ptr;
+}
+
+/**
+ * @brief - Reads a NUMBER or INTEGER value as a double
+ * @param obj - the value
+ * @param out - set to the number, INTEGER values beyond 2^53 are rounded
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a number
+ */
+int json_object_t_as_double(const json_object_t* obj, double* out) {
+    switch (obj->tag) {
+        case NUMBER:
+            *out = obj->val.number;
+            return 0;
+
+        case INTEGER:
+            *out = (double)obj->val.integer;
+            return 0;
+
+        default:
+            return UNEXPECTED_TOKEN;
+    }
+}
+
+/**
+ * @brief - Reads an INTEGER value, or a NUMBER holding an exact whole number, as an int64_t
+ * @param obj - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a whole number that fits in an int64_t
+ */
+int json_object_t_as_int64(const json_object_t* obj, int64_t* out) {
+    if (obj->tag == INTEGER) {
+        *out = obj->val.integer;
+        return 0;
+    }
+
+    if (obj->tag != NUMBER) {
+        return UNEXPECTED_TOKEN;
+    }
+
+    double d = obj->val.number;
+    // 2^63 itself is out of range, so test against it before the cast
+    if (!(d >= -9223372036854775808.0 && d < 9223372036854775808.0) || (double)(int64_t)d != d) {
+        return UNEXPECTED_TOKEN;
+    }
+
+    *out = (int64_t)d;
+    return 0;
+}
+
+// DOCUMENT IMPL
+
+/**
+ * @brief - Initializes an empty document
+ * @param doc - pointer to the document to initialize
+ */
+void json_document_t_init(json_document_t* doc) {
+    doc->root.tag = NULL_VAL;
+    json_arena_t_init(&doc->arena);
+}
+
+/**
+ * @brief - Parses a JSON buffer into the document's arena
+ * @param doc - pointer to an initialized document
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_document_t_parse(json_document_t* doc, const char* json, size_t len) {
+    return json_parse_arena(json, len, &doc->root, &doc->arena);
+}
+
+/**
+ * @brief - Releases the whole document tree in one call
+ * @param doc - pointer to the document to deinit
+ */
+void json_document_t_deinit(json_document_t* doc) {
+    json_arena_t_deinit(&doc->arena);
+    doc->root.tag = NULL_VAL;
+}
+
+// PARSER CONTEXT IMPL
+
+/**
+ * @brief - Initializes a parser, no memory is requested until the first parse
+ * @param parser - pointer to the parser to initialize
+ */
+void json_parser_t_init(json_parser_t* parser) {
+    parser->items = NULL;
+    parser->items_capacity = 0;
+    parser->frames = NULL;
+    parser->frames_capacity = 0;
+}
+
+/**
+ * @brief - `json_parse_ex` that reuses the parser's scratch buffers instead of allocating its own
+ * @param parser - pointer to an initialized parser
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param obj - pointer to the JSON object to populate
+ * @param opts - parse options, NULL for the defaults
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parser_t_parse(json_parser_t* parser, const char* json, size_t len, json_object_t* obj, const json_parse_opts_t* opts) {
+    json_parse_state_t st;
+    parse_state_init(&st, opts != NULL ? opts->arena : NULL, opts != NULL ? opts->flags : 0);
+
+    // The state borrows the element and frame stacks and hands them back, grown if the document needed more
+    st.items = parser->items;
+    st.items_capacity = parser->items_capacity;
+    st.frames = parser->frames;
+    st.frames_capacity = parser->frames_capacity;
+
+    int return_code = parse_with_opts(&st, json, len, obj, opts);
+
+    parser->items = st.items;
+    parser->items_capacity = st.items_capacity;
+    parser->frames = st.frames;
+    parser->frames_capacity = st.frames_capacity;
+    return return_code;
+}
+
+/**
+ * @brief - Parses into a document, replacing its previous tree and reusing the memory that held it
+ * Once the document's arena has grown to fit the largest input, parsing similar documents makes no system allocations
+ * @param parser - pointer to an initialized parser
+ * @param doc - pointer to an initialized document, anything borrowed from its old tree becomes invalid
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param opts - parse options, NULL for the defaults, `arena` is ignored in favour of the document's
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parser_t_parse_document(json_parser_t* parser, json_document_t* doc, const char* json, size_t len,
+                                 const json_parse_opts_t* opts) {
+    doc->root.tag = NULL_VAL;
+    if (json_arena_t_reset(&doc->arena) != 0) {
+        return ALLOCATION_FAILED;
+    }
+
+    json_parse_opts_t doc_opts = { 0 };
+    if (opts != NULL) {
+        doc_opts = *opts;
+    }
+    doc_opts.arena = &doc->arena;
+
+    return json_parser_t_parse(parser, json, len, &doc->root, &doc_opts);
+}
+
+/**
+ * @brief - Frees the parser's scratch buffers
+ * @param parser - pointer to the parser to deinit
+ */
+void json_parser_t_deinit(json_parser_t* parser) {
+    JSON_FREE(parser->items);
+    JSON_FREE(parser->frames);
+    json_parser_t_init(parser);
+}
+
+// FILE IMPL
+
+/**
+ * @brief - Maps a file read only, hinting the kernel that it will be read front to back
+ * @param file - pointer to the mapping to populate
+ * @param path - path of the file to map
+ * @return 0 on success
+ * @return IO_ERROR if the file could not be opened or mapped
+ */
+int json_mapped_file_t_open(json_mapped_file_t* file, const char* path) {
+    file->data = NULL;
+    file->len = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return IO_ERROR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return IO_ERROR;
+    }
+
+    // mmap refuses zero length mappings, an empty file is just an empty buffer
+    if (st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, flags, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return IO_ERROR;
+    }
+
+#ifdef MADV_SEQUENTIAL
+    madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+
+    file->data = data;
+    file->len = (size_t)st.st_size;
+    return 0;
+}
+
+/**
+ * @brief - Unmaps a file mapped by `json_mapped_file_t_open`
+ * @param file - pointer to the mapping
+ */
+void json_mapped_file_t_close(json_mapped_file_t* file) {
+    if (file->data != NULL) {
+        munmap((void*)file->data, file->len);
+    }
+
+    file->data = NULL;
+    file->len = 0;
+}
+
+/**
+ * @brief Parses a JSON file into a JSON Object straight from a read only mapping, without reading it into a buffer first
+ * @param path - path of the JSON file
+ * @param obj - pointer to the JSON object to populate
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse_file(const char* path, json_object_t* obj) {
+    json_mapped_file_t file;
+    int rc = json_mapped_file_t_open(&file, path);
+    if (rc != 0) {
+        return rc;
+    }
+
+    // Everything in the tree is copied out of the input, so the mapping can go right away
+    rc = json_parse(file.data, file.len, obj);
+    json_mapped_file_t_close(&file);
+    return rc;
+}
+
+/**
+ * @brief - Parses a JSON file into the document's arena straight from a read only mapping
+ * @param doc - pointer to an initialized document
+ * @param path - path of the JSON file
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_document_t_parse_file(json_document_t* doc, const char* path) {
+    json_mapped_file_t file;
+    int rc = json_mapped_file_t_open(&file, path);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = json_document_t_parse(doc, file.data, file.len);
+    json_mapped_file_t_close(&file);
+    return rc;
+}
+
+// PUSH PARSER IMPL
+
+/**
+ * @brief - Initializes a push parser
+ * @param p - pointer to the parser to initialize
+ * @param arena - arena to build documents in, or NULL to build them on the heap
+ */
+void json_push_parser_t_init(json_push_parser_t* p, json_arena_t* arena) {
+    p->stack = NULL;
+    p->depth = 0;
+    p->capacity = 0;
+    p->max_depth = JSON_PARSE_MAX_DEPTH;
+
+    p->state = PUSH_VALUE;
+    p->string_is_key = 0;
+    p->string_escaped = 0;
+    p->escape_pending = 0;
+
+    p->scratch = NULL;
+    p->scratch_len = 0;
+    p->scratch_capacity = 0;
+
+    p->arena = arena;
+}
+
+/**
+ * @brief - Discards any partially parsed document so the parser can start over
+ * @param p - pointer to the parser
+ */
+void json_push_parser_t_reset(json_push_parser_t* p) {
+    // Containers still on the stack have not been inserted into their parents yet, so each one is freed on its own
+    for (size_t i = 0; i < p->depth; i++) {
+        if (p->arena == NULL) {
+            json_deinit(&p->stack[i].value);
+        }
+        mem_free(p->arena, p->stack[i].key);
+    }
+
+    p->depth = 0;
+    p->state = PUSH_VALUE;
+    p->scratch_len = 0;
+    p->escape_pending = 0;
+}
+
+/**
+ * @brief - Frees the parser's buffers and any partially parsed document
+ * @param p - pointer to the parser
+ */
+void json_push_parser_t_deinit(json_push_parser_t* p) {
+    json_push_parser_t_reset(p);
+
+    JSON_FREE(p->stack);
+    JSON_FREE(p->scratch);
+    json_push_parser_t_init(p, p->arena);
+}
+
+static int push_scratch_append(json_push_parser_t* p, const char* bytes, size_t len) {
+    // Empty runs are common at chunk boundaries and scratch may not exist yet
+    if (len == 0) {
+        return 0;
+    }
+
+    if (p->scratch_len + len > p->scratch_capacity) {
+        size_t capacity = p->scratch_capacity == 0 ? PUSH_SCRATCH_START_SIZE : p->scratch_capacity;
+        while (capacity < p->scratch_len + len) {
+            capacity *= 2;
+        }
+
+        char* scratch = JSON_REALLOC(p->scratch, capacity);
+        if (scratch == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        p->scratch = scratch;
+        p->scratch_capacity = capacity;
+    }
+
+    memcpy(p->scratch + p->scratch_len, bytes, len);
+    p->scratch_len += len;
+    return 0;
+}
+
+static int push_open(json_push_parser_t* p, json_object_t* container) {
+    // Chunked input usually comes from a socket or pipe, so it gets the same nesting limit as a whole buffer
+    if (p->depth >= p->max_depth) {
+        return DEPTH_LIMIT_EXCEEDED;
+    }
+
+    if (p->depth == p->capacity) {
+        size_t capacity = p->capacity == 0 ? PUSH_STACK_START_SIZE : p->capacity * 2;
+        json_push_frame_t* stack = JSON_REALLOC(p->stack, capacity * sizeof(json_push_frame_t));
+        if (stack == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        p->stack = stack;
+        p->capacity = capacity;
+    }
+
+    json_push_frame_t* frame = &p->stack[p->depth++];
+    frame->value = *container;
+    frame->key = NULL;
+    frame->key_len = 0;
+    return 0;
+}
+
+// Hands a finished value to its parent, returns 0 if it was the top level value and has been written to `obj`
+static int push_complete(json_push_parser_t* p, json_object_t* val, json_object_t* obj) {
+    if (p->depth == 0) {
+        *obj = *val;
+        p->state = PUSH_VALUE;
+        return 0;
+    }
+
+    json_push_frame_t* frame = &p->stack[p->depth - 1];
+    int rc;
+    if (frame->value.tag == ARRAY) {
+        rc = json_array_t_push(frame->value.val.arr, val);
+    } else {
+        // The key was decoded from the parser's allocator, so the map takes it as is, on an arena it just keeps the arena copy
+        rc = map_insert(frame->value.val.obj, frame->key, frame->key_len, val, MAP_KEY_TAKE);
+        if (rc != 0) {
+            mem_free(p->arena, frame->key);
+        }
+        frame->key = NULL;
+    }
+
+    if (rc != 0) {
+        if (p->arena == NULL) {
+            json_deinit(val);
+        }
+        return rc;
+    }
+
+    p->state = PUSH_AFTER_VALUE;
+    return JSON_PUSH_NEED_MORE;
+}
+
+static int push_close(json_push_parser_t* p, json_object_t* obj) {
+    json_object_t val = p->stack[--p->depth].value;
+    return push_complete(p, &val, obj);
+}
+
+// Turns the collected bytes of a number or literal into a value using the regular parser
+static int push_finish_scalar(json_push_parser_t* p, json_object_t* obj) {
+    json_parse_state_t st;
+    parse_state_init(&st, p->arena, 0);
+    st.cur = p->scratch;
+    st.end = p->scratch + p->scratch_len;
+
+    json_object_t val;
+    int rc = parse_value(&st, &val);
+    if (rc == 0 && st.cur != st.end) {
+        rc = UNEXPECTED_TOKEN;
+    }
+
+    p->scratch_len = 0;
+    if (rc != 0) {
+        return rc;
+    }
+
+    return push_complete(p, &val, obj);
+}
+
+static int push_finish_string(json_push_parser_t* p, json_object_t* obj) {
+    // Multi byte sequences can be split across chunks, so the encoding is only checked once the string is whole
+    if (!simd_kernels()->utf8_valid(p->scratch, p->scratch_len)) {
+        p->scratch_len = 0;
+        return UNEXPECTED_TOKEN;
+    }
+
+    char* str;
+    size_t len;
+    int rc = copy_string(p->arena, p->scratch, p->scratch_len, p->string_escaped, &str, &len);
+    p->scratch_len = 0;
+
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (p->string_is_key) {
+        json_push_frame_t* frame = &p->stack[p->depth - 1];
+        frame->key = str;
+        frame->key_len = len;
+        p->state = PUSH_COLON;
+        return JSON_PUSH_NEED_MORE;
+    }
+
+    json_object_t val;
+    val.tag = STRING;
+    val.val.str = str;
+    val.val.view.len = len;
+    return push_complete(p, &val, obj);
+}
+
+static int is_scalar_byte(char c) {
+    return is_alphanumeric(c) || c == '.' || c == '-' || c == '+';
+}
+
+/**
+ * @brief - Feeds the next chunk of input to the parser
+ * @param p - pointer to the parser
+ * @param chunk - next bytes of the input
+ * @param len - number of bytes in chunk
+ * @param consumed - set to the number of bytes of `chunk` that were used, may be NULL
+ * @param obj - populated once the top level value closes
+ * @return 0 when a complete document was written to `obj`, bytes after `consumed` belong to the next one
+ * @return JSON_PUSH_NEED_MORE if the whole chunk was consumed without finishing the document
+ * @return DEPTH_LIMIT_EXCEEDED if containers nest deeper than `max_depth`
+ * @return negative number on failure, the partial document is discarded
+ */
+int json_push_parser_t_feed(json_push_parser_t* p, const char* chunk, size_t len, size_t* consumed, json_object_t* obj) {
+    const simd_kernels_t* kernels = simd_kernels();
+    size_t i = 0;
+    int rc = JSON_PUSH_NEED_MORE;
+
+    while (i < len && rc == JSON_PUSH_NEED_MORE) {
+        char c = chunk[i];
+
+        switch (p->state) {
+            case PUSH_STRING: {
+                // The byte after a backslash is collected as is, even if the backslash was the end of the last chunk
+                if (p->escape_pending) {
+                    rc = push_scratch_append(p, chunk + i, 1);
+                    if (rc != 0) break;
+                    rc = JSON_PUSH_NEED_MORE;
+
+                    p->escape_pending = 0;
+                    i++;
+                    break;
+                }
+
+                // Copy everything up to the next quote, backslash or control character in one go
+                size_t run = kernels->scan_string(chunk + i, len - i);
+                rc = push_scratch_append(p, chunk + i, run);
+                if (rc != 0) break;
+                rc = JSON_PUSH_NEED_MORE;
+
+                i += run;
+                if (i == len) break;
+
+                if (chunk[i] == '\\') {
+                    rc = push_scratch_append(p, chunk + i, 1);
+                    if (rc != 0) break;
+                    rc = JSON_PUSH_NEED_MORE;
+
+                    p->string_escaped = 1;
+                    p->escape_pending = 1;
+                    i++;
+                    break;
+                }
+
+                // Control characters are never valid raw
+                if (chunk[i] != '"') {
+                    rc = UNEXPECTED_TOKEN;
+                    break;
+                }
+
+                i++;
+                rc = push_finish_string(p, obj);
+                break;
+            }
+
+            case PUSH_SCALAR: {
+                size_t start = i;
+                while (i < len && is_scalar_byte(chunk[i])) i++;
+
+                rc = push_scratch_append(p, chunk + start, i - start);
+                if (rc != 0) break;
+                rc = JSON_PUSH_NEED_MORE;
+
+                // The scalar only ends once a delimiter shows up
+                if (i < len) {
+                    rc = push_finish_scalar(p, obj);
+                }
+                break;
+            }
+
+            default:
+                if (is_whitespace(c)) {
+                    i++;
+                    break;
+                }
+
+                switch (p->state) {
+                    case PUSH_VALUE_OR_END:
+                        if (c == ']') {
+                            i++;
+                            rc = push_close(p, obj);
+                            break;
+                        }
+                        // falls through
+
+                    case PUSH_VALUE:
+                        if (c == '{') {
+                            json_object_t container;
+                            container.tag = OBJECT;
+                            container.val.obj = mem_alloc(p->arena, sizeof(json_object_map_t));
+                            if (container.val.obj == NULL) {
+                                rc = ALLOCATION_FAILED;
+                                break;
+                            }
+
+                            json_object_map_t_init(container.val.obj);
+                            container.val.obj->arena = p->arena;
+
+                            rc = push_open(p, &container);
+                            if (rc != 0) {
+                                json_deinit(&container);
+                                break;
+                            }
+
+                            rc = JSON_PUSH_NEED_MORE;
+                            p->state = PUSH_KEY_OR_END;
+                            i++;
+                        } else if (c == '[') {
+                            json_object_t container;
+                            container.tag = ARRAY;
+                            container.val.arr = mem_alloc(p->arena, sizeof(json_array_t));
+                            if (container.val.arr == NULL) {
+                                rc = ALLOCATION_FAILED;
+                                break;
+                            }
+
+                            json_array_t_init(container.val.arr);
+                            container.val.arr->arena = p->arena;
+
+                            rc = push_open(p, &container);
+                            if (rc != 0) {
+                                json_deinit(&container);
+                                break;
+                            }
+
+                            rc = JSON_PUSH_NEED_MORE;
+                            p->state = PUSH_VALUE_OR_END;
+                            i++;
+                        } else if (c == '"') {
+                            p->state = PUSH_STRING;
+                            p->string_is_key = 0;
+                            p->string_escaped = 0;
+                            i++;
+                        } else if (is_scalar_byte(c)) {
+                            p->state = PUSH_SCALAR;
+                        } else {
+                            rc = UNEXPECTED_TOKEN;
+                        }
+                        break;
+
+                    case PUSH_KEY_OR_END:
+                    case PUSH_KEY:
+                        if (c == '"') {
+                            p->state = PUSH_STRING;
+                            p->string_is_key = 1;
+                            p->string_escaped = 0;
+                            i++;
+                        } else if (c == '}' && p->state == PUSH_KEY_OR_END) {
+                            i++;
+                            rc = push_close(p, obj);
+                        } else {
+                            rc = UNEXPECTED_TOKEN;
+                        }
+                        break;
+
+                    case PUSH_COLON:
+                        if (c != ':') {
+                            rc = UNEXPECTED_TOKEN;
+                            break;
+                        }
+
+                        p->state = PUSH_VALUE;
+                        i++;
+                        break;
+
+                    case PUSH_AFTER_VALUE: {
+                        int in_array = p->stack[p->depth - 1].value.tag == ARRAY;
+                        if (c == ',') {
+                            p->state = in_array ? PUSH_VALUE : PUSH_KEY;
+                            i++;
+                        } else if (c == (in_array ? ']' : '}')) {
+                            i++;
+                            rc = push_close(p, obj);
+                        } else {
+                            rc = UNEXPECTED_TOKEN;
+                        }
+                        break;
+                    }
+
+                    default:
+                        rc = UNEXPECTED_TOKEN;
+                        break;
+                }
+                break;
+        }
+    }
+
+    if (consumed != NULL) {
+        *consumed = i;
+    }
+
+    if (rc < 0) {
+        json_push_parser_t_reset(p);
+    }
+
+    return rc;
+}
+
+/**
+ * @brief - Signals the end of the input, completing a top level number or literal that was waiting for a delimiter
+ * @param p - pointer to the parser
+ * @param obj - populated with the final document
+ * @return 0 when a complete document was written to `obj`
+ * @return negative number if the input ended in the middle of a value
+ */
+int json_push_parser_t_finish(json_push_parser_t* p, json_object_t* obj) {
+    int rc = INDEX_GREATER_THAN_LEN;
+
+    if (p->state == PUSH_SCALAR && p->depth == 0) {
+        rc = push_finish_scalar(p, obj);
+    }
+
+    if (rc != 0) {
+        json_push_parser_t_reset(p);
+    }
+
+    return rc;
+}
+
+// WRITER IMPL
+
+// A floating point number as a 64 bit significand and a binary exponent, f * 2^e
+typedef struct {
+    uint64_t f;
+    int e;
+} diy_fp_t;
+
+// 10^k for k = -348, -340, ..., 340, significands rounded to nearest
+static const diy_fp_t cached_pow10[] = {
+    { 0xfa8fd5a0081c0288ull, -1220 },
+    { 0xbaaee17fa23ebf76ull, -1193 },
+    { 0x8b16fb203055ac76ull, -1166 },
+    { 0xcf42894a5dce35eaull, -1140 },
+    { 0x9a6bb0aa55653b2dull, -1113 },
+    { 0xe61acf033d1a45dfull, -1087 },
+    { 0xab70fe17c79ac6caull, -1060 },
+    { 0xff77b1fcbebcdc4full, -1034 },
+    { 0xbe5691ef416bd60cull, -1007 },
+    { 0x8dd01fad907ffc3cull, -980 },
+    { 0xd3515c2831559a83ull, -954 },
+    { 0x9d71ac8fada6c9b5ull, -927 },
+    { 0xea9c227723ee8bcbull, -901 },
+    { 0xaecc49914078536dull, -874 },
+    { 0x823c12795db6ce57ull, -847 },
+    { 0xc21094364dfb5637ull, -821 },
+    { 0x9096ea6f3848984full, -794 },
+    { 0xd77485cb25823ac7ull, -768 },
+    { 0xa086cfcd97bf97f4ull, -741 },
+    { 0xef340a98172aace5ull, -715 },
+    { 0xb23867fb2a35b28eull, -688 },
+    { 0x84c8d4dfd2c63f3bull, -661 },
+    { 0xc5dd44271ad3cdbaull, -635 },
+    { 0x936b9fcebb25c996ull, -608 },
+    { 0xdbac6c247d62a584ull, -582 },
+    { 0xa3ab66580d5fdaf6ull, -555 },
+    { 0xf3e2f893dec3f126ull, -529 },
+    { 0xb5b5ada8aaff80b8ull, -502 },
+    { 0x87625f056c7c4a8bull, -475 },
+    { 0xc9bcff6034c13053ull, -449 },
+    { 0x964e858c91ba2655ull, -422 },
+    { 0xdff9772470297ebdull, -396 },
+    { 0xa6dfbd9fb8e5b88full, -369 },
+    { 0xf8a95fcf88747d94ull, -343 },
+    { 0xb94470938fa89bcfull, -316 },
+    { 0x8a08f0f8bf0f156bull, -289 },
+    { 0xcdb02555653131b6ull, -263 },
+    { 0x993fe2c6d07b7facull, -236 },
+    { 0xe45c10c42a2b3b06ull, -210 },
+    { 0xaa242499697392d3ull, -183 },
+    { 0xfd87b5f28300ca0eull, -157 },
+    { 0xbce5086492111aebull, -130 },
+    { 0x8cbccc096f5088ccull, -103 },
+    { 0xd1b71758e219652cull, -77 },
+    { 0x9c40000000000000ull, -50 },
+    { 0xe8d4a51000000000ull, -24 },
+    { 0xad78ebc5ac620000ull, 3 },
+    { 0x813f3978f8940984ull, 30 },
+    { 0xc097ce7bc90715b3ull, 56 },
+    { 0x8f7e32ce7bea5c70ull, 83 },
+    { 0xd5d238a4abe98068ull, 109 },
+    { 0x9f4f2726179a2245ull, 136 },
+    { 0xed63a231d4c4fb27ull, 162 },
+    { 0xb0de65388cc8ada8ull, 189 },
+    { 0x83c7088e1aab65dbull, 216 },
+    { 0xc45d1df942711d9aull, 242 },
+    { 0x924d692ca61be758ull, 269 },
+    { 0xda01ee641a708deaull, 295 },
+    { 0xa26da3999aef774aull, 322 },
+    { 0xf209787bb47d6b85ull, 348 },
+    { 0xb454e4a179dd1877ull, 375 },
+    { 0x865b86925b9bc5c2ull, 402 },
+    { 0xc83553c5c8965d3dull, 428 },
+    { 0x952ab45cfa97a0b3ull, 455 },
+    { 0xde469fbd99a05fe3ull, 481 },
+    { 0xa59bc234db398c25ull, 508 },
+    { 0xf6c69a72a3989f5cull, 534 },
+    { 0xb7dcbf5354e9beceull, 561 },
+    { 0x88fcf317f22241e2ull, 588 },
+    { 0xcc20ce9bd35c78a5ull, 614 },
+    { 0x98165af37b2153dfull, 641 },
+    { 0xe2a0b5dc971f303aull, 667 },
+    { 0xa8d9d1535ce3b396ull, 694 },
+    { 0xfb9b7cd9a4a7443cull, 720 },
+    { 0xbb764c4ca7a44410ull, 747 },
+    { 0x8bab8eefb6409c1aull, 774 },
+    { 0xd01fef10a657842cull, 800 },
+    { 0x9b10a4e5e9913129ull, 827 },
+    { 0xe7109bfba19c0c9dull, 853 },
+    { 0xac2820d9623bf429ull, 880 },
+    { 0x80444b5e7aa7cf85ull, 907 },
+    { 0xbf21e44003acdd2dull, 933 },
+    { 0x8e679c2f5e44ff8full, 960 },
+    { 0xd433179d9c8cb841ull, 986 },
+    { 0x9e19db92b4e31ba9ull, 1013 },
+    { 0xeb96bf6ebadf77d9ull, 1039 },
+    { 0xaf87023b9bf0ee6bull, 1066 },
+};
+
+static const uint64_t pow10_u64[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull,
+};
+
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static diy_fp_t diy_fp_mul(diy_fp_t a, diy_fp_t b) {
+    uint64_t hi, lo;
+    mul128(a.f, b.f, &hi, &lo);
+
+    // Round off the dropped low half
+    diy_fp_t r = { hi + (lo >> 63), a.e + b.e + 64 };
+    return r;
+}
+
+static diy_fp_t diy_fp_normalize(diy_fp_t v) {
+    int shift = __builtin_clzll(v.f);
+    v.f <<= shift;
+    v.e -= shift;
+    return v;
+}
+
+// Grisu3's round and weed step: nudges the last digit down while that moves the result closer to `value`, then
+// returns 0 if the error of the products could mean a different digit was closer or the result is outside the boundaries
+static int grisu_round_weed(char* buf, int len, uint64_t distance_too_high_w, uint64_t unsafe_interval, uint64_t rest,
+                            uint64_t ten_kappa, uint64_t unit) {
+    uint64_t small_distance = distance_too_high_w - unit;
+    uint64_t big_distance = distance_too_high_w + unit;
+
+    while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+           (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance)) {
+        buf[len - 1]--;
+        rest += ten_kappa;
+    }
+
+    if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+        (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance)) {
+        return 0;
+    }
+
+    return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+static int count_digits32(uint32_t n) {
+    int digits = 1;
+    while (n >= 10) {
+        n /= 10;
+        digits++;
+    }
+    return digits;
+}
+
+// Generates the fewest digits that lie between the boundaries widened by one unit, the most the products can be off.
+// Returns 0 when that uncertainty could change the digits
+static int grisu_digits(diy_fp_t low, diy_fp_t w, diy_fp_t high, char* buf, int* len, int* k) {
+    uint64_t unit = 1;
+    uint64_t too_high = high.f + unit;
+    uint64_t unsafe_interval = too_high - (low.f - unit);
+
+    diy_fp_t one = { 1ull << -w.e, w.e };
+    uint32_t p1 = (uint32_t)(too_high >> -one.e);
+    uint64_t p2 = too_high & (one.f - 1);
+    int kappa = count_digits32(p1);
+
+    *len = 0;
+
+    // Integral part
+    while (kappa > 0) {
+        uint32_t pow = (uint32_t)pow10_u64[kappa - 1];
+        buf[(*len)++] = '0' + p1 / pow;
+        p1 %= pow;
+        kappa--;
+
+        uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+        if (rest < unsafe_interval) {
+            *k += kappa;
+            return grisu_round_weed(buf, *len, too_high - w.f, unsafe_interval, rest, (uint64_t)pow << -one.e, unit);
+        }
+    }
+
+    // Fractional part, the uncertainty grows with every digit
+    for (;;) {
+        p2 *= 10;
+        unit *= 10;
+        unsafe_interval *= 10;
+
+        buf[(*len)++] = '0' + (char)(p2 >> -one.e);
+        p2 &= one.f - 1;
+        kappa--;
+
+        if (p2 < unsafe_interval) {
+            *k += kappa;
+            return grisu_round_weed(buf, *len, (too_high - w.f) * unit, unsafe_interval, p2, one.f, unit);
+        }
+    }
+}
+
+// Grisu3: writes the shortest digits of a positive finite double to `buf` so that digits * 10^k reads back as `value`.
+// Returns 0 for the few doubles it can't prove the result for
+static int grisu3(double value, char* buf, int* len, int* k) {
+    const uint64_t hidden = 1ull << 52;
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int biased_e = (int)((bits >> 52) & 0x7FF);
+    uint64_t significand = bits & (hidden - 1);
+
+    diy_fp_t v;
+    if (biased_e != 0) {
+        v.f = significand + hidden;
+        v.e = biased_e - 1075;
+    } else {
+        v.f = significand;
+        v.e = -1074;
+    }
+
+    // Halfway points to the neighbouring doubles, anything strictly between them reads back as `value`.
+    // Right above a power of two the lower neighbour is twice as close
+    diy_fp_t plus = { (v.f << 1) + 1, v.e - 1 };
+    plus = diy_fp_normalize(plus);
+
+    diy_fp_t minus;
+    if (v.f == hidden) {
+        minus.f = (v.f << 2) - 1;
+        minus.e = v.e - 2;
+    } else {
+        minus.f = (v.f << 1) - 1;
+        minus.e = v.e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    // Pick the cached power that scales the upper boundary's exponent into [-60, -32]
+    double dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+    int ik = (int)dk;
+    if (dk - ik > 0.0) ik++;
+
+    unsigned int idx = (unsigned int)((ik >> 3) + 1);
+    *k = -(-348 + (int)idx * 8);
+    diy_fp_t c = cached_pow10[idx];
+
+    diy_fp_t w = diy_fp_mul(diy_fp_normalize(v), c);
+    diy_fp_t wp = diy_fp_mul(plus, c);
+    diy_fp_t wm = diy_fp_mul(minus, c);
+
+    return grisu_digits(wm, w, wp, buf, len, k);
+}
+
+// Exact fallback for the doubles Grisu3 gives up on. For each digit count the correctly rounded decimal is closest
+// to `value`, so if any decimal of that many digits reads back it is that one or its neighbour on the other side
+static void shortest_exact(double value, char* buf, int* len, int* k) {
+    char tmp[40];
+
+    for (int digits = 1; digits <= 17; digits++) {
+        snprintf(tmp, sizeof(tmp), "%.*e", digits - 1, value);
+
+        uint64_t m = 0;
+        const char* s = tmp;
+        for (; *s != 'e'; s++) {
+            if (is_numeric(*s)) m = m * 10 + (uint64_t)(*s - '0');
+        }
+        int e = atoi(s + 1) - (digits - 1);
+
+        double nearest = strtod(tmp, NULL);
+        if (nearest != value) {
+            m = nearest < value ? m + 1 : m - 1;
+            if (m == pow10_u64[digits]) {
+                // 99 + 1 -> 10e1
+                m /= 10;
+                e++;
+            } else if (m < pow10_u64[digits - 1]) {
+                // 10 - 1 -> 99e-1
+                m = m * 10 + 9;
+                e--;
+            }
+
+            snprintf(tmp, sizeof(tmp), "%llue%d", (unsigned long long)m, e);
+            if (strtod(tmp, NULL) != value) {
+                continue;
+            }
+        }
+
+        while (m % 10 == 0) {
+            m /= 10;
+            e++;
+        }
+
+        *len = snprintf(buf, 20, "%llu", (unsigned long long)m);
+        *k = e;
+        return;
+    }
+}
+
+static char* write_exponent(int k, char* out) {
+    if (k < 0) {
+        *out++ = '-';
+        k = -k;
+    }
+
+    if (k >= 100) {
+        *out++ = '0' + k / 100;
+        k %= 100;
+        *out++ = digit_pairs[k * 2];
+        *out++ = digit_pairs[k * 2 + 1];
+    } else if (k >= 10) {
+        *out++ = digit_pairs[k * 2];
+        *out++ = digit_pairs[k * 2 + 1];
+    } else {
+        *out++ = '0' + k;
+    }
+
+    return out;
+}
+
+// Lays out `len` digits scaled by 10^k, keeping a fraction or exponent so the value reads back as a double
+static char* format_digits(char* buf, int len, int k) {
+    int kk = len + k;
+
+    if (k >= 0 && kk <= 21) {
+        // 1234e7 -> 12340000000.0
+        for (int i = len; i < kk; i++) {
+            buf[i] = '0';
+        }
+        buf[kk] = '.';
+        buf[kk + 1] = '0';
+        return buf + kk + 2;
+    }
+
+    if (kk > 0 && kk <= 21) {
+        // 1234e-2 -> 12.34
+        memmove(buf + kk + 1, buf + kk, len - kk);
+        buf[kk] = '.';
+        return buf + len + 1;
+    }
+
+    if (kk > -6 && kk <= 0) {
+        // 1234e-6 -> 0.001234
+        int offset = 2 - kk;
+        memmove(buf + offset, buf, len);
+        buf[0] = '0';
+        buf[1] = '.';
+        for (int i = 2; i < offset; i++) {
+            buf[i] = '0';
+        }
+        return buf + len + offset;
+    }
+
+    if (len == 1) {
+        // 1e30
+        buf[1] = 'e';
+        return write_exponent(kk - 1, buf + 2);
+    }
+
+    // 1234e30 -> 1.234e33
+    memmove(buf + 2, buf + 1, len - 1);
+    buf[1] = '.';
+    buf[len + 1] = 'e';
+    return write_exponent(kk - 1, buf + len + 2);
+}
+
+// Writes the shortest text that reads back as `value` into `out` (at least 32 bytes), returning its length
+static size_t format_double(double value, char* out) {
+    char* p = out;
+
+    // JSON has no way to spell these
+    if (value != value || value - value != 0) {
+        memcpy(out, "null", 4);
+        return 4;
+    }
+
+    if (signbit(value)) {
+        *p++ = '-';
+        value = -value;
+    }
+
+    if (value == 0) {
+        memcpy(p, "0.0", 3);
+        return p + 3 - out;
+    }
+
+    int len, k;
+    if (!grisu3(value, p, &len, &k)) {
+        shortest_exact(value, p, &len, &k);
+    }
+    return format_digits(p, len, k) - out;
+}
+
+// Writes `value` into `out` (at least 20 bytes), returning its length
+static size_t format_int64(int64_t value, char* out) {
+    char tmp[20];
+    char* p = tmp + sizeof(tmp);
+    size_t sign = 0;
+
+    uint64_t v = (uint64_t)value;
+    if (value < 0) {
+        *out++ = '-';
+        sign = 1;
+        v = 0 - v;
+    }
+
+    while (v >= 100) {
+        size_t pair = (v % 100) * 2;
+        v /= 100;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    }
+
+    if (v >= 10) {
+        *--p = digit_pairs[v * 2 + 1];
+        *--p = digit_pairs[v * 2];
+    } else {
+        *--p = '0' + (char)v;
+    }
+
+    size_t len = tmp + sizeof(tmp) - p;
+    memcpy(out, p, len);
+    return sign + len;
+}
+
+/**
+ * @brief - Initializes a writer that collects its output in `buf`
+ * @param w - pointer to the writer to initialize
+ * @param flags - `JSON_WRITE_*` flags
+ */
+void json_writer_t_init(json_writer_t* w, unsigned int flags) {
+    w->buf = NULL;
+    w->len = 0;
+    w->capacity = 0;
+    w->sink = NULL;
+    w->ctx = NULL;
+    w->flags = flags;
+}
+
+/**
+ * @brief - Initializes a writer that streams its output to a sink in `JSON_WRITER_BUFFER_SIZE` chunks
+ * @param w - pointer to the writer to initialize
+ * @param flags - `JSON_WRITE_*` flags
+ * @param sink - function receiving the output
+ * @param ctx - passed through to `sink`
+ */
+void json_writer_t_init_sink(json_writer_t* w, unsigned int flags, json_sink_t sink, void* ctx) {
+    json_writer_t_init(w, flags);
+    w->sink = sink;
+    w->ctx = ctx;
+}
+
+/**
+ * @brief - Hands any buffered output to the sink, does nothing in buffer mode
+ * @param w - pointer to the writer
+ * @return 0 on success
+ * @return IO_ERROR if the sink failed
+ */
+int json_writer_t_flush(json_writer_t* w) {
+    if (w->sink == NULL || w->len == 0) {
+        return 0;
+    }
+
+    size_t len = w->len;
+    w->len = 0;
+    return w->sink(w->ctx, w->buf, len) == 0 ? 0 : IO_ERROR;
+}
+
+/**
+ * @brief - Frees the writer's buffer
+ * @param w - pointer to the writer
+ */
+void json_writer_t_deinit(json_writer_t* w) {
+    JSON_FREE(w->buf);
+    json_writer_t_init(w, w->flags);
+}
+
+// Makes room for `n` more bytes in `buf`, in sink mode by flushing first
+static int writer_reserve(json_writer_t* w, size_t n) {
+    if (w->len + n <= w->capacity) {
+        return 0;
+    }
+
+    if (w->sink != NULL) {
+        int rc = json_writer_t_flush(w);
+        if (rc != 0) return rc;
+        if (n <= w->capacity) return 0;
+    }
+
+    size_t capacity = w->capacity != 0 ? w->capacity : w->sink != NULL ? JSON_WRITER_BUFFER_SIZE : JSON_WRITER_START_SIZE;
+    while (capacity < w->len + n) {
+        capacity *= 2;
+    }
+
+    char* buf = JSON_REALLOC(w->buf, capacity);
+    if (buf == NULL) {
+        return ALLOCATION_FAILED;
+    }
+
+    w->buf = buf;
+    w->capacity = capacity;
+    return 0;
+}
+
+static int writer_append(json_writer_t* w, const char* data, size_t n) {
+    // Runs bigger than the whole buffer go straight to the sink
+    if (w->sink != NULL && n >= JSON_WRITER_BUFFER_SIZE) {
+        int rc = json_writer_t_flush(w);
+        if (rc != 0) return rc;
+        return w->sink(w->ctx, data, n) == 0 ? 0 : IO_ERROR;
+    }
+
+    int rc = writer_reserve(w, n);
+    if (rc != 0) return rc;
+
+    memcpy(w->buf + w->len, data, n);
+    w->len += n;
+    return 0;
+}
+
+static int writer_newline(json_writer_t* w, size_t depth) {
+    if (!(w->flags & JSON_WRITE_PRETTY)) {
+        return 0;
+    }
+
+    size_t n = 1 + depth * JSON_WRITE_INDENT;
+    int rc = writer_reserve(w, n);
+    if (rc != 0) return rc;
+
+    w->buf[w->len] = '\n';
+    memset(w->buf + w->len + 1, ' ', n - 1);
+    w->len += n;
+    return 0;
+}
+
+static int write_string(json_writer_t* w, const simd_kernels_t* kernels, const char* str, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+
+    int rc = writer_append(w, "\"", 1);
+    if (rc != 0) return rc;
+
+    size_t i = 0;
+    while (i < len) {
+        // Everything up to the next quote, backslash or control byte is copied in one go
+        size_t run = kernels->scan_string(str + i, len - i);
+        if (run > 0) {
+            rc = writer_append(w, str + i, run);
+            if (rc != 0) return rc;
+
+            i += run;
+            if (i == len) break;
+        }
+
+        unsigned char c = str[i++];
+        char esc[6] = { '\\', 0, '0', '0', 0, 0 };
+        size_t n = 2;
+        switch (c) {
+            case '"':  esc[1] = '"';  break;
+            case '\\': esc[1] = '\\'; break;
+            case '\b': esc[1] = 'b';  break;
+            case '\f': esc[1] = 'f';  break;
+            case '\n': esc[1] = 'n';  break;
+            case '\r': esc[1] = 'r';  break;
+            case '\t': esc[1] = 't';  break;
+            default:
+                esc[1] = 'u';
+                esc[4] = hex[c >> 4];
+                esc[5] = hex[c & 0xF];
+                n = 6;
+                break;
+        }
+
+        rc = writer_append(w, esc, n);
+        if (rc != 0) return rc;
+    }
+
+    return writer_append(w, "\"", 1);
+}
+
+// Writes a scalar, or the opening bracket of a container
+static int write_scalar(json_writer_t* w, const simd_kernels_t* kernels, const json_object_t* obj) {
+    char num[32];
+
+    switch (obj->tag) {
+        case NULL_VAL:
+            return writer_append(w, "null", 4);
+
+        case BOOLEAN:
+            return obj->val.boolean ? writer_append(w, "true", 4) : writer_append(w, "false", 5);
+
+        case INTEGER:
+            return writer_append(w, num, format_int64(obj->val.integer, num));
+
+        case NUMBER:
+            return writer_append(w, num, format_double(obj->val.number, num));
+
+        case STRING:
+        case STRING_VIEW: {
+            size_t len;
+            const char* str = json_object_t_string(obj, &len);
+            return write_string(w, kernels, str, len);
+        }
+
+        case OBJECT:
+            return writer_append(w, "{", 1);
+
+        case ARRAY:
+            return writer_append(w, "[", 1);
+
+        default:
+            return UNEXPECTED_TOKEN;
+    }
+}
+
+/**
+ * @brief - A container `write_value` is inside of
+ * @property obj - The object or array
+ * @property idx - Index of the next member or element to write
+ */
+typedef struct {
+    const json_object_t* obj;
+    size_t idx;
+} write_frame_t;
+
+// Writes a value of any depth, keeping the open containers on an explicit stack rather than recursing
+static int write_value(json_writer_t* w, const simd_kernels_t* kernels, const json_object_t* obj, size_t depth) {
+    write_frame_t local[JSON_WALK_STACK_SIZE];
+    write_frame_t* frames = local;
+    size_t len = 0;
+    size_t capacity = JSON_WALK_STACK_SIZE;
+    int rc;
+
+    for (;;) {
+        rc = write_scalar(w, kernels, obj);
+        if (rc != 0) goto done;
+
+        if ((obj->tag == OBJECT && obj->val.obj->len > 0) || (obj->tag == ARRAY && obj->val.arr->len > 0)) {
+            if (len == capacity) {
+                write_frame_t* grown = walk_stack_grow(frames, local, &capacity, sizeof(write_frame_t));
+                if (grown == NULL) {
+                    rc = ALLOCATION_FAILED;
+                    goto done;
+                }
+                frames = grown;
+            }
+
+            frames[len].obj = obj;
+            frames[len].idx = 0;
+            len++;
+        } else if (obj->tag == OBJECT || obj->tag == ARRAY) {
+            rc = writer_append(w, obj->tag == OBJECT ? "}" : "]", 1);
+            if (rc != 0) goto done;
+        }
+
+        // Close every container that is finished, then move on to the next member of the innermost open one
+        obj = NULL;
+        while (len > 0 && obj == NULL) {
+            write_frame_t* frame = &frames[len - 1];
+            const json_object_t* container = frame->obj;
+            size_t count = container->tag == OBJECT ? container->val.obj->len : container->val.arr->len;
+
+            if (frame->idx == count) {
+                len--;
+                rc = writer_newline(w, depth + len);
+                if (rc != 0) goto done;
+
+                rc = writer_append(w, container->tag == OBJECT ? "}" : "]", 1);
+                if (rc != 0) goto done;
+                continue;
+            }
+
+            if (frame->idx > 0) {
+                rc = writer_append(w, ",", 1);
+                if (rc != 0) goto done;
+            }
+
+            rc = writer_newline(w, depth + len);
+            if (rc != 0) goto done;
+
+            if (container->tag == OBJECT) {
+                const json_object_entry_t* entry = &container->val.obj->entries[frame->idx];
+
+                rc = write_string(w, kernels, entry->key, entry->key_len);
+                if (rc != 0) goto done;
+
+                rc = (w->flags & JSON_WRITE_PRETTY) ? writer_append(w, ": ", 2) : writer_append(w, ":", 1);
+                if (rc != 0) goto done;
+
+                obj = &entry->value;
+            } else {
+                obj = &container->val.arr->items[frame->idx];
+            }
+
+            frame->idx++;
+        }
+
+        if (obj == NULL) break;
+    }
+
+done:
+    if (frames != local) {
+        JSON_FREE(frames);
+    }
+
+    return rc;
+}
+
+/**
+ * @brief - Serializes a value, appending it to what the writer already holds
+ * Doubles are written in the shortest form that reads back to the same value, non finite ones as null.
+ * In sink mode everything is flushed before returning.
+ * @param w - pointer to the writer
+ * @param obj - the value to write
+ * @return 0 on success
+ * @return ALLOCATION_FAILED or IO_ERROR on failure
+ */
+int json_writer_t_write(json_writer_t* w, const json_object_t* obj) {
+    int rc = write_value(w, simd_kernels(), obj, 0);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return json_writer_t_flush(w);
+}
+
+/**
+ * @brief - Serializes a value into a newly allocated null terminated string
+ * @param obj - the value to write
+ * @param flags - `JSON_WRITE_*` flags
+ * @param out - set to the string, release it with JSON_FREE
+ * @param len - set to the length of the string, may be NULL
+ * @return 0 on success
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_write(const json_object_t* obj, unsigned int flags, char** out, size_t* len) {
+    json_writer_t w;
+    json_writer_t_init(&w, flags);
+
+    int rc = json_writer_t_write(&w, obj);
+    if (rc == 0) {
+        rc = writer_reserve(&w, 1);
+    }
+
+    if (rc != 0) {
+        json_writer_t_deinit(&w);
+        return rc;
+    }
+
+    w.buf[w.len] = '\0';
+    *out = w.buf;
+    if (len != NULL) {
+        *len = w.len;
+    }
+
+    return 0;
+}
+
+// LINES IMPL
+
+struct lines_pool_t;
+
+/**
+ * @brief - A thread of the JSON Lines pool, owning a range of tasks that idle workers steal from the back of
+ * @property lock - Guards `next` and `end`
+ * @property next - Next task this worker runs
+ * @property end - One past the last task this worker owns
+ * @property index - Position in the pool's worker array
+ * @property st - Parser state reused for every record the worker parses
+ * @property pool - The pool this worker belongs to
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    size_t next;
+    size_t end;
+    size_t index;
+    json_parse_state_t st;
+    struct lines_pool_t* pool;
+} lines_worker_t;
+
+/**
+ * @brief - Shared state of one parallel JSON Lines parse
+ * @property lines - Batch being filled
+ * @property data - Start of the input
+ * @property tasks - Task `t` covers records `[tasks[t], tasks[t + 1])`
+ * @property workers - The workers
+ * @property worker_count - Number of workers
+ */
+typedef struct lines_pool_t {
+    json_lines_t* lines;
+    const char* data;
+    const size_t* tasks;
+    lines_worker_t* workers;
+    size_t worker_count;
+} lines_pool_t;
+
+/**
+ * @brief - Initializes an empty batch
+ * @param lines - pointer to the batch to initialize
+ */
+void json_lines_t_init(json_lines_t* lines) {
+    lines->records = NULL;
+    lines->len = 0;
+    lines->errors = 0;
+    lines->arenas = NULL;
+    lines->arena_count = 0;
+    lines->file.data = NULL;
+    lines->file.len = 0;
+}
+
+/**
+ * @brief - Releases every record, the arenas and the file mapping
+ * @param lines - pointer to the batch to deinit
+ */
+void json_lines_t_deinit(json_lines_t* lines) {
+    for (size_t i = 0; i < lines->arena_count; i++) {
+        json_arena_t_deinit(&lines->arenas[i]);
+    }
+
+    JSON_FREE(lines->arenas);
+    JSON_FREE(lines->records);
+    json_mapped_file_t_close(&lines->file);
+    json_lines_t_init(lines);
+}
+
+// Finds every non blank line, newlines can't appear inside a valid record so they always end one
+static int lines_split(json_lines_t* lines, const char* data, size_t len) {
+    size_t capacity = 0;
+    const char* p = data;
+    const char* end = data + len;
+
+    while (p < end) {
+        const char* nl = memchr(p, '\n', end - p);
+        const char* line_end = nl != NULL ? nl : end;
+
+        const char* first = p;
+        while (first < line_end && is_whitespace(*first)) {
+            first++;
+        }
+
+        if (first < line_end) {
+            if (lines->len == capacity) {
+                capacity = capacity == 0 ? STREAM_START_SIZE : capacity * 2;
+                json_lines_record_t* records = JSON_REALLOC(lines->records, capacity * sizeof(json_lines_record_t));
+                if (records == NULL) {
+                    return ALLOCATION_FAILED;
+                }
+                lines->records = records;
+            }
+
+            json_lines_record_t* record = &lines->records[lines->len++];
+            record->value.tag = NULL_VAL;
+            record->rc = 0;
+            record->offset = p - data;
+            record->len = line_end - p;
+        }
+
+        p = line_end + 1;
+    }
+
+    return 0;
+}
+
+static int lines_pop(lines_worker_t* w, size_t* task) {
+    pthread_mutex_lock(&w->lock);
+    int found = w->next < w->end;
+    if (found) {
+        *task = w->next++;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return found;
+}
+
+// Takes the back half of the first other worker that still has tasks left
+static int lines_steal(lines_pool_t* pool, lines_worker_t* self, size_t* task) {
+    for (size_t i = 1; i < pool->worker_count; i++) {
+        lines_worker_t* victim = &pool->workers[(self->index + i) % pool->worker_count];
+
+        pthread_mutex_lock(&victim->lock);
+        size_t stolen = (victim->end - victim->next + 1) / 2;
+        size_t end = victim->end;
+        victim->end -= stolen;
+        pthread_mutex_unlock(&victim->lock);
+
+        if (stolen > 0) {
+            pthread_mutex_lock(&self->lock);
+            self->next = end - stolen + 1;
+            self->end = end;
+            pthread_mutex_unlock(&self->lock);
+
+            *task = end - stolen;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void* lines_worker_run(void* arg) {
+    lines_worker_t* w = arg;
+    lines_pool_t* pool = w->pool;
+    size_t task;
+
+    while (lines_pop(w, &task) || lines_steal(pool, w, &task)) {
+        for (size_t i = pool->tasks[task]; i < pool->tasks[task + 1]; i++) {
+            json_lines_record_t* record = &pool->lines->records[i];
+            record->rc = parse_document(&w->st, pool->data + record->offset, record->len, &record->value);
+            if (record->rc != 0) {
+                record->value.tag = NULL_VAL;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static int lines_parse(json_lines_t* lines, const char* data, size_t len, const json_lines_opts_t* opts) {
+    int rc = lines_split(lines, data, len);
+    if (rc != 0 || lines->len == 0) {
+        return rc;
+    }
+
+    // Records are grouped into tasks of about JSON_LINES_TASK_BYTES, enough work to make a steal worth its lock
+    size_t* tasks = JSON_MALLOC((lines->len + 1) * sizeof(size_t));
+    if (tasks == NULL) {
+        return ALLOCATION_FAILED;
+    }
+
+    size_t task_count = 0;
+    size_t bytes = 0;
+    tasks[0] = 0;
+    for (size_t i = 0; i < lines->len; i++) {
+        bytes += lines->records[i].len;
+        if (bytes >= JSON_LINES_TASK_BYTES || i + 1 == lines->len) {
+            tasks[++task_count] = i + 1;
+            bytes = 0;
+        }
+    }
+
+    size_t worker_count = opts != NULL ? opts->threads : 0;
+    if (worker_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (worker_count > task_count) {
+        worker_count = task_count;
+    }
+
+    lines_worker_t* workers = JSON_MALLOC(worker_count * sizeof(lines_worker_t));
+    pthread_t* threads = JSON_MALLOC(worker_count * sizeof(pthread_t));
+    lines->arenas = JSON_MALLOC(worker_count * sizeof(json_arena_t));
+    if (workers == NULL || threads == NULL || lines->arenas == NULL) {
+        JSON_FREE(tasks);
+        JSON_FREE(workers);
+        JSON_FREE(threads);
+        return ALLOCATION_FAILED;
+    }
+    lines->arena_count = worker_count;
+
+    lines_pool_t pool;
+    pool.lines = lines;
+    pool.data = data;
+    pool.tasks = tasks;
+    pool.workers = workers;
+    pool.worker_count = worker_count;
+
+    // Every worker starts out with an even share of the tasks
+    for (size_t i = 0; i < worker_count; i++) {
+        lines_worker_t* w = &workers[i];
+        json_arena_t_init(&lines->arenas[i]);
+        pthread_mutex_init(&w->lock, NULL);
+        w->next = i * task_count / worker_count;
+        w->end = (i + 1) * task_count / worker_count;
+        w->index = i;
+        w->pool = &pool;
+        parse_state_init(&w->st, &lines->arenas[i], opts != NULL ? opts->flags : 0);
+        w->st.intern = opts != NULL ? opts->intern : NULL;
+    }
+
+    // The calling thread is worker 0, and only returns once every task is taken,
+    // so a thread that fails to start just leaves its share to be stolen
+    size_t started = 1;
+    for (; started < worker_count; started++) {
+        if (pthread_create(&threads[started], NULL, lines_worker_run, &workers[started]) != 0) {
+            break;
+        }
+    }
+
+    lines_worker_run(&workers[0]);
+
+    for (size_t i = 1; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (size_t i = 0; i < worker_count; i++) {
+        parse_state_deinit(&workers[i].st);
+        pthread_mutex_destroy(&workers[i].lock);
+    }
+
+    for (size_t i = 0; i < lines->len; i++) {
+        if (lines->records[i].rc != 0) {
+            lines->errors++;
+        }
+    }
+
+    JSON_FREE(tasks);
+    JSON_FREE(workers);
+    JSON_FREE(threads);
+    return 0;
+}
+
+/**
+ * @brief - Splits a buffer of JSON Lines at record boundaries and parses the records on a work stealing thread pool
+ * Records from a previous parse into the same batch are released first.
+ * @param lines - pointer to an initialized batch
+ * @param data - the records, one per line
+ * @param len - length of data
+ * @param opts - options, NULL for the defaults
+ * @return 0 once every record was attempted, check `errors` and each record's `rc` for bad lines
+ * @return ALLOCATION_FAILED if the batch could not be set up
+ */
+int json_lines_t_parse(json_lines_t* lines, const char* data, size_t len, const json_lines_opts_t* opts) {
+    json_lines_t_deinit(lines);
+    return lines_parse(lines, data, len, opts);
+}
+
+/**
+ * @brief - Parses a JSON Lines file straight from a read only mapping, see `json_lines_t_parse`
+ * @param lines - pointer to an initialized batch
+ * @param path - path of the file
+ * @param opts - options, NULL for the defaults
+ * @return 0 once every record was attempted
+ * @return IO_ERROR or ALLOCATION_FAILED on failure
+ */
+int json_lines_t_parse_file(json_lines_t* lines, const char* path, const json_lines_opts_t* opts) {
+    json_lines_t_deinit(lines);
+
+    int rc = json_mapped_file_t_open(&lines->file, path);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return lines_parse(lines, lines->file.data, lines->file.len, opts);
+}
+
+// SAX IMPL
+
+/**
+ * @brief - Decodes the escape sequences of a raw string view
+ * @param str - raw string contents, without the quotes
+ * @param len - length of str
+ * @param out - buffer with room for at least `len` bytes, decoded strings are never longer
+ * @param out_len - set to the decoded length
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if an escape is malformed
+ */
+int json_unescape(const char* str, size_t len, char* out, size_t* out_len) {
+    return unescape_string(str, len, out, out_len);
+}
+
+// Fires the callback for a string, number or literal at the cursor
+static int sax_scalar(json_parse_state_t* st, const json_sax_handler_t* h, void* ctx) {
+    json_object_t val;
+    int rc;
+
+    if (*st->cur == '"') {
+        const char* str;
+        size_t len;
+        int escaped;
+        rc = scan_string(st, &str, &len, &escaped);
+        if (rc != 0) return rc;
+
+        // Nothing downstream decodes the string, so its escapes are checked here
+        if (escaped && !escapes_valid(str, len)) {
+            return UNEXPECTED_TOKEN;
+        }
+        return h->string != NULL ? h->string(ctx, str, len, escaped) : 0;
+    }
+
+    if (is_numeric(*st->cur) || *st->cur == '-') {
+        rc = parse_number(st, &val);
+        if (rc != 0) return rc;
+
+        if (val.tag == INTEGER) {
+            return h->integer != NULL ? h->integer(ctx, val.val.integer) : 0;
+        }
+        return h->number != NULL ? h->number(ctx, val.val.number) : 0;
+    }
+
+    rc = parse_literal(st, &val);
+    if (rc != 0) return rc;
+
+    if (val.tag == BOOLEAN) {
+        return h->boolean != NULL ? h->boolean(ctx, val.val.boolean) : 0;
+    }
+    return h->null != NULL ? h->null(ctx) : 0;
+}
+
+/**
+ * @brief - Walks a JSON buffer firing a callback per event, without building a tree or allocating anything
+ * Nesting is tracked in a fixed bit stack, so documents deeper than `JSON_SAX_MAX_DEPTH` are rejected.
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param handler - callbacks to fire
+ * @param ctx - passed through to every callback
+ * @return 0 on success
+ * @return whatever non zero value a callback returned to stop the parse
+ * @return negative number if the input is malformed, events already fired stay fired
+ */
+int json_sax_parse(const char* json, size_t len, const json_sax_handler_t* handler, void* ctx) {
+    json_parse_state_t st;
+    parse_state_init(&st, NULL, 0);
+    st.cur = json;
+    st.end = json + len;
+
+    // One bit per open container, set for arrays
+    uint64_t arrays[JSON_SAX_MAX_DEPTH / 64];
+    size_t depth = 0;
+
+    // The grammar positions are the same ones the push parser moves through
+    json_push_state_t state = PUSH_VALUE;
+    int rc = 0;
+
+    for (;;) {
+        skip_whitespace(&st);
+        if (st.cur >= st.end) {
+            return INDEX_GREATER_THAN_LEN;
+        }
+
+        char c = *st.cur;
+
+        switch (state) {
+            case PUSH_VALUE_OR_END:
+            case PUSH_KEY_OR_END:
+                if (c == (state == PUSH_VALUE_OR_END ? ']' : '}')) {
+                    state = PUSH_AFTER_VALUE;
+                    break;
+                }
+
+                state = state == PUSH_VALUE_OR_END ? PUSH_VALUE : PUSH_KEY;
+                continue;
+
+            case PUSH_VALUE:
+                if (c == '{' || c == '[') {
+                    if (depth == JSON_SAX_MAX_DEPTH) {
+                        return DEPTH_LIMIT_EXCEEDED;
+                    }
+
+                    uint64_t bit = 1ull << (depth % 64);
+                    if (c == '[') {
+                        arrays[depth / 64] |= bit;
+                        rc = handler->start_array != NULL ? handler->start_array(ctx) : 0;
+                        state = PUSH_VALUE_OR_END;
+                    } else {
+                        arrays[depth / 64] &= ~bit;
+                        rc = handler->start_object != NULL ? handler->start_object(ctx) : 0;
+                        state = PUSH_KEY_OR_END;
+                    }
+
+                    depth++;
+                    st.cur++;
+                } else {
+                    rc = sax_scalar(&st, handler, ctx);
+                    state = PUSH_AFTER_VALUE;
+                }
+                break;
+
+            case PUSH_KEY: {
+                if (c != '"') {
+                    return UNEXPECTED_TOKEN;
+                }
+
+                const char* key;
+                size_t key_len;
+                int escaped;
+                rc = scan_string(&st, &key, &key_len, &escaped);
+                if (rc != 0) {
+                    return rc;
+                }
+
+                if (escaped && !escapes_valid(key, key_len)) {
+                    return UNEXPECTED_TOKEN;
+                }
+
+                rc = handler->key != NULL ? handler->key(ctx, key, key_len, escaped) : 0;
+                state = PUSH_COLON;
+                break;
+            }
+
+            case PUSH_COLON:
+                if (c != ':') {
+                    return UNEXPECTED_TOKEN;
+                }
+
+                st.cur++;
+                state = PUSH_VALUE;
+                break;
+
+            default:
+                return UNEXPECTED_TOKEN;
+        }
+
+        if (rc != 0) {
+            return rc;
+        }
+
+        // Closes as many containers as end here, then moves past the comma to the next element
+        while (state == PUSH_AFTER_VALUE) {
+            if (depth == 0) {
+                // Only whitespace may follow the top level value
+                skip_whitespace(&st);
+                return st.cur == st.end ? 0 : UNEXPECTED_TOKEN;
+            }
+
+            skip_whitespace(&st);
+            if (st.cur >= st.end) {
+                return INDEX_GREATER_THAN_LEN;
+            }
+
+            int in_array = arrays[(depth - 1) / 64] >> ((depth - 1) % 64) & 1;
+            c = *st.cur++;
+
+            if (c == ',') {
+                state = in_array ? PUSH_VALUE : PUSH_KEY;
+            } else if (c == (in_array ? ']' : '}')) {
+                depth--;
+                if (in_array) {
+                    rc = handler->end_array != NULL ? handler->end_array(ctx) : 0;
+                } else {
+                    rc = handler->end_object != NULL ? handler->end_object(ctx) : 0;
+                }
+
+                if (rc != 0) {
+                    return rc;
+                }
+            } else {
+                return UNEXPECTED_TOKEN;
+            }
+        }
+    }
+}
+
+/**
+ * @brief - Runs `json_sax_parse` over a file through a read only mapping, so memory stays flat however large it is
+ * @param path - path of the JSON file
+ * @param handler - callbacks to fire
+ * @param ctx - passed through to every callback
+ * @return the result of `json_sax_parse`, or IO_ERROR if the file could not be mapped
+ */
+int json_sax_parse_file(const char* path, const json_sax_handler_t* handler, void* ctx) {
+    json_mapped_file_t file;
+    int rc = json_mapped_file_t_open(&file, path);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = json_sax_parse(file.data, file.len, handler, ctx);
+    json_mapped_file_t_close(&file);
+    return rc;
+}
+
+// VALIDATE IMPL
+
+// Grammar positions of the block validator, the container kind comes from the bit stack
+typedef enum {
+    VALIDATE_VALUE,
+    VALIDATE_VALUE_OR_END,
+    VALIDATE_KEY,
+    VALIDATE_KEY_OR_END,
+    VALIDATE_COLON,
+    VALIDATE_AFTER_VALUE,
+    VALIDATE_DONE,
+} validate_state_t;
+
+// Checks the number or literal starting at `p` and that it is followed by a delimiter
+static int validate_scalar(const char* p, const char* end) {
+    size_t len;
+    if (is_numeric(*p) || *p == '-') {
+        len = number_length(p, end);
+    } else if (end - p >= 4 && memcmp(p, "true", 4) == 0) {
+        len = 4;
+    } else if (end - p >= 5 && memcmp(p, "false", 5) == 0) {
+        len = 5;
+    } else if (end - p >= 4 && memcmp(p, "null", 4) == 0) {
+        len = 4;
+    } else {
+        return 0;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    p += len;
+    return p == end || is_whitespace(*p) || *p == ',' || *p == ':' || *p == ']' || *p == '}' || *p == '[' || *p == '{' || *p == '"';
+}
+
+/**
+ * @brief - Checks that a buffer holds exactly one well formed JSON document without building anything or allocating
+ * Covers the whole RFC 8259 grammar, including escapes, surrogate pairs and UTF-8 inside strings.
+ * Nesting is tracked in a fixed bit stack, so documents deeper than `JSON_VALIDATE_MAX_DEPTH` are rejected.
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @return 0 if the document is valid
+ * @return negative number if it is not
+ */
+int json_validate(const char* json, size_t len) {
+    const simd_kernels_t* kernels = simd_kernels();
+    const char* end = json + len;
+
+    // One bit per open container, set for arrays
+    uint64_t arrays[JSON_VALIDATE_MAX_DEPTH / 64];
+    size_t depth = 0;
+
+    validate_state_t state = VALIDATE_VALUE;
+    // Where a string leaves the grammar once it closes, AFTER_VALUE for values and COLON for keys
+    validate_state_t after_string = VALIDATE_AFTER_VALUE;
+
+    uint64_t escape_carry = 0;
+    uint64_t prev_in_string = 0;
+    uint64_t prev_scalar = 0;
+
+    int in_string = 0;
+    const char* string_start = NULL;
+    // Set when the open string overlaps a block holding a backslash or a non ASCII byte, only those strings are rechecked
+    int string_dirty = 0;
+
+    // Whole blocks are classified in vector registers, the grammar only looks at the bytes where tokens start
+    for (size_t base = 0; base < len; base += 64) {
+        json_block_masks_t m;
+        unsigned char tail[64];
+        const unsigned char* block = (const unsigned char*)json + base;
+
+        if (len - base < 64) {
+            // Pad the last block with whitespace so it never produces tokens
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, len - base);
+            block = tail;
+        }
+        kernels->classify(block, &m);
+
+        uint64_t high = 0;
+        for (int i = 0; i < 64; i += 8) {
+            high |= read_u64((const char*)block + i);
+        }
+        int block_dirty = m.backslash != 0 || (high & 0x8080808080808080ull) != 0;
+
+        uint64_t quote = m.quote & ~escaped_mask(m.backslash, &escape_carry);
+
+        // Set from an opening quote up to (not including) its closing quote
+        uint64_t strings = prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = (uint64_t)((int64_t)strings >> 63);
+
+        // Control characters are never valid raw inside a string, outside one they fail as scalars
+        if (m.control & strings) {
+            return UNEXPECTED_TOKEN;
+        }
+
+        uint64_t structural = m.structural & ~strings;
+        uint64_t scalar = ~(m.structural | m.whitespace | quote | strings);
+        uint64_t scalar_start = scalar & ~((scalar << 1) | prev_scalar);
+        prev_scalar = scalar >> 63;
+
+        uint64_t tokens = structural | quote | scalar_start;
+        if (in_string) {
+            string_dirty |= block_dirty;
+        }
+
+        while (tokens != 0) {
+            int bit = ctz64(tokens);
+            uint64_t mask = 1ull << bit;
+            tokens &= tokens - 1;
+
+            const char* at = json + base + bit;
+
+            if (quote & mask) {
+                if (in_string) {
+                    size_t str_len = at - string_start;
+                    if (string_dirty && (!escapes_valid(string_start, str_len) || !kernels->utf8_valid(string_start, str_len))) {
+                        return UNEXPECTED_TOKEN;
+                    }
+
+                    in_string = 0;
+                    state = after_string == VALIDATE_AFTER_VALUE && depth == 0 ? VALIDATE_DONE : after_string;
+                    continue;
+                }
+
+                if (state == VALIDATE_VALUE || state == VALIDATE_VALUE_OR_END) {
+                    after_string = VALIDATE_AFTER_VALUE;
+                } else if (state == VALIDATE_KEY || state == VALIDATE_KEY_OR_END) {
+                    after_string = VALIDATE_COLON;
+                } else {
+                    return UNEXPECTED_TOKEN;
+                }
+
+                in_string = 1;
+                string_start = at + 1;
+                string_dirty = block_dirty;
+                continue;
+            }
+
+            if (scalar_start & mask) {
+                if ((state != VALIDATE_VALUE && state != VALIDATE_VALUE_OR_END) || !validate_scalar(at, end)) {
+                    return UNEXPECTED_TOKEN;
+                }
+
+                state = depth == 0 ? VALIDATE_DONE : VALIDATE_AFTER_VALUE;
+                continue;
+            }
+
+            char c = *at;
+            switch (c) {
+                case '{':
+                case '[':
+                    if (state != VALIDATE_VALUE && state != VALIDATE_VALUE_OR_END) {
+                        return UNEXPECTED_TOKEN;
+                    }
+                    if (depth == JSON_VALIDATE_MAX_DEPTH) {
+                        return DEPTH_LIMIT_EXCEEDED;
+                    }
+
+                    if (c == '[') {
+                        arrays[depth / 64] |= 1ull << (depth % 64);
+                        state = VALIDATE_VALUE_OR_END;
+                    } else {
+                        arrays[depth / 64] &= ~(1ull << (depth % 64));
+                        state = VALIDATE_KEY_OR_END;
+                    }
+                    depth++;
+                    break;
+
+                case '}':
+                case ']': {
+                    if (depth == 0) {
+                        return UNEXPECTED_TOKEN;
+                    }
+
+                    int in_array = arrays[(depth - 1) / 64] >> ((depth - 1) % 64) & 1;
+                    if (in_array != (c == ']')) {
+                        return UNEXPECTED_TOKEN;
+                    }
+                    if (state != VALIDATE_AFTER_VALUE && state != (in_array ? VALIDATE_VALUE_OR_END : VALIDATE_KEY_OR_END)) {
+                        return UNEXPECTED_TOKEN;
+                    }
+
+                    depth--;
+                    state = depth == 0 ? VALIDATE_DONE : VALIDATE_AFTER_VALUE;
+                    break;
+                }
+
+                case ':':
+                    if (state != VALIDATE_COLON) {
+                        return UNEXPECTED_TOKEN;
+                    }
+                    state = VALIDATE_VALUE;
+                    break;
+
+                case ',':
+                    if (state != VALIDATE_AFTER_VALUE) {
+                        return UNEXPECTED_TOKEN;
+                    }
+                    state = arrays[(depth - 1) / 64] >> ((depth - 1) % 64) & 1 ? VALIDATE_VALUE : VALIDATE_KEY;
+                    break;
+
+                default:
+                    return UNEXPECTED_TOKEN;
+            }
+        }
+    }
+
+    // Strings get their own state once closed, so a value that never completed means the input ran out
+    if (in_string || state != VALIDATE_DONE) {
+        return INDEX_GREATER_THAN_LEN;
+    }
+
+    return 0;
+}
+
+// TAPE IMPL
+
+/**
+ * @brief - Initializes an empty tape
+ * @param tape - pointer to the tape to initialize
+ */
+void json_tape_t_init(json_tape_t* tape) {
+    tape->tape = NULL;
+    tape->len = 0;
+    tape->capacity = 0;
+    tape->strings = NULL;
+    tape->strings_len = 0;
+    tape->strings_capacity = 0;
+}
+
+/**
+ * @brief - Frees the tape's buffers
+ * @param tape - pointer to the tape to deinit
+ */
+void json_tape_t_deinit(json_tape_t* tape) {
+    JSON_FREE(tape->tape);
+    JSON_FREE(tape->strings);
+    json_tape_t_init(tape);
+}
+
+#define TAPE_ENTRY(type, payload) ((uint64_t)(unsigned char)(type) << 56 | (uint64_t)(payload))
+#define TAPE_PAYLOAD_MASK ((1ull << 56) - 1)
+#define TAPE_COUNT_MAX 0xFFFFFF
+
+// Open containers while a tape is being built, SAX already caps the depth
+typedef struct {
+    json_tape_t* tape;
+    uint32_t opens[JSON_SAX_MAX_DEPTH];
+    uint32_t counts[JSON_SAX_MAX_DEPTH];
+    size_t depth;
+} tape_builder_t;
+
+static inline char tape_type(const json_tape_t* tape, size_t idx) {
+    return (char)(tape->tape[idx] >> 56);
+}
+
+static inline uint64_t tape_payload(const json_tape_t* tape, size_t idx) {
+    return tape->tape[idx] & TAPE_PAYLOAD_MASK;
+}
+
+// Index of the entry right after the value starting at `idx`, containers are skipped in one hop
+static inline size_t tape_next(const json_tape_t* tape, size_t idx) {
+    switch (tape_type(tape, idx)) {
+        case '{':
+        case '[':
+            return (uint32_t)tape_payload(tape, idx);
+        case 'l':
+        case 'd':
+            return idx + 2;
+        default:
+            return idx + 1;
+    }
+}
+
+static int tape_emit(json_tape_t* tape, uint64_t entry) {
+    if (tape->len == tape->capacity) {
+        size_t capacity = tape->capacity == 0 ? JSON_TAPE_START_SIZE : tape->capacity * 2;
+        uint64_t* entries = JSON_REALLOC(tape->tape, capacity * sizeof(uint64_t));
+        if (entries == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        tape->tape = entries;
+        tape->capacity = capacity;
+    }
+
+    tape->tape[tape->len++] = entry;
+    return 0;
+}
+
+// Counts one more element in the innermost container, objects count their keys instead of their values
+static inline void tape_count(tape_builder_t* b, int is_key) {
+    if (b->depth == 0) {
+        return;
+    }
+
+    size_t top = b->depth - 1;
+    if ((is_key || tape_type(b->tape, b->opens[top]) == '[') && b->counts[top] < TAPE_COUNT_MAX) {
+        b->counts[top]++;
+    }
+}
+
+static int tape_open(tape_builder_t* b, char type) {
+    tape_count(b, 0);
+    if (b->tape->len >= UINT32_MAX) {
+        return ALLOCATION_FAILED;
+    }
+
+    b->opens[b->depth] = (uint32_t)b->tape->len;
+    b->counts[b->depth] = 0;
+    b->depth++;
+
+    // Patched with the close's index and the element count once the container ends
+    return tape_emit(b->tape, TAPE_ENTRY(type, 0));
+}
+
+static int tape_close(tape_builder_t* b, char type) {
+    json_tape_t* tape = b->tape;
+    b->depth--;
+
+    size_t open = b->opens[b->depth];
+    size_t close = tape->len;
+    if (close + 1 >= UINT32_MAX) {
+        return ALLOCATION_FAILED;
+    }
+
+    int rc = tape_emit(tape, TAPE_ENTRY(type, open));
+    if (rc != 0) {
+        return rc;
+    }
+
+    tape->tape[open] |= (uint64_t)b->counts[b->depth] << 32 | (uint64_t)(close + 1);
+    return 0;
+}
+
+// Appends a length prefixed, null terminated copy of the string to the side buffer and emits its entry
+static int tape_string(tape_builder_t* b, const char* str, size_t len, int escaped) {
+    json_tape_t* tape = b->tape;
+    if (len > UINT32_MAX) {
+        return ALLOCATION_FAILED;
+    }
+
+    size_t need = tape->strings_len + sizeof(uint32_t) + len + 1;
+    if (need > tape->strings_capacity) {
+        size_t capacity = tape->strings_capacity == 0 ? JSON_TAPE_START_SIZE : tape->strings_capacity;
+        while (capacity < need) {
+            capacity *= 2;
+        }
+
+        char* strings = JSON_REALLOC(tape->strings, capacity);
+        if (strings == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        tape->strings = strings;
+        tape->strings_capacity = capacity;
+    }
+
+    size_t offset = tape->strings_len;
+    char* dst = tape->strings + offset + sizeof(uint32_t);
+
+    // Decoded strings are never longer than their raw form, so decoding straight into place is safe
+    size_t n = len;
+    if (escaped) {
+        int rc = unescape_string(str, len, dst, &n);
+        if (rc != 0) {
+            return rc;
+        }
+    } else {
+        memcpy(dst, str, len);
+    }
+
+    uint32_t prefix = (uint32_t)n;
+    memcpy(tape->strings + offset, &prefix, sizeof(uint32_t));
+    dst[n] = '\0';
+    tape->strings_len = offset + sizeof(uint32_t) + n + 1;
+
+    return tape_emit(tape, TAPE_ENTRY('"', offset));
+}
+
+static int tape_on_start_object(void* ctx) {
+    return tape_open(ctx, '{');
+}
+
+static int tape_on_end_object(void* ctx) {
+    return tape_close(ctx, '}');
+}
+
+static int tape_on_start_array(void* ctx) {
+    return tape_open(ctx, '[');
+}
+
+static int tape_on_end_array(void* ctx) {
+    return tape_close(ctx, ']');
+}
+
+static int tape_on_key(void* ctx, const char* key, size_t len, int escaped) {
+    tape_count(ctx, 1);
+    return tape_string(ctx, key, len, escaped);
+}
+
+static int tape_on_string(void* ctx, const char* str, size_t len, int escaped) {
+    tape_count(ctx, 0);
+    return tape_string(ctx, str, len, escaped);
+}
+
+static int tape_on_integer(void* ctx, int64_t value) {
+    tape_builder_t* b = ctx;
+    tape_count(b, 0);
+
+    int rc = tape_emit(b->tape, TAPE_ENTRY('l', 0));
+    return rc != 0 ? rc : tape_emit(b->tape, (uint64_t)value);
+}
+
+static int tape_on_number(void* ctx, double value) {
+    tape_builder_t* b = ctx;
+    tape_count(b, 0);
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int rc = tape_emit(b->tape, TAPE_ENTRY('d', 0));
+    return rc != 0 ? rc : tape_emit(b->tape, bits);
+}
+
+static int tape_on_boolean(void* ctx, int value) {
+    tape_builder_t* b = ctx;
+    tape_count(b, 0);
+    return tape_emit(b->tape, TAPE_ENTRY(value ? 't' : 'f', 0));
+}
+
+static int tape_on_null(void* ctx) {
+    tape_builder_t* b = ctx;
+    tape_count(b, 0);
+    return tape_emit(b->tape, TAPE_ENTRY('n', 0));
+}
+
+/**
+ * @brief - Parses a JSON buffer onto the tape, replacing whatever it held but keeping its buffers
+ * @param tape - pointer to an initialized tape
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_tape_t_parse(json_tape_t* tape, const char* json, size_t len) {
+    static const json_sax_handler_t handler = {
+        .start_object = tape_on_start_object,
+        .end_object = tape_on_end_object,
+        .start_array = tape_on_start_array,
+        .end_array = tape_on_end_array,
+        .key = tape_on_key,
+        .string = tape_on_string,
+        .integer = tape_on_integer,
+        .number = tape_on_number,
+        .boolean = tape_on_boolean,
+        .null = tape_on_null,
+    };
+
+    tape_builder_t builder;
+    builder.tape = tape;
+    builder.depth = 0;
+
+    tape->len = 0;
+    tape->strings_len = 0;
+
+    int rc = json_sax_parse(json, len, &handler, &builder);
+    if (rc != 0) {
+        tape->len = 0;
+        tape->strings_len = 0;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief - Returns the top level value of a parsed tape
+ * @param tape - pointer to the tape
+ * @return reference to the root value
+ */
+json_tape_ref_t json_tape_t_root(const json_tape_t* tape) {
+    json_tape_ref_t ref = {tape, 0};
+    return ref;
+}
+
+/**
+ * @brief - Returns what kind of value a reference points at
+ * @param ref - the value
+ * @return OBJECT, ARRAY, STRING, INTEGER, NUMBER, BOOLEAN or NULL_VAL
+ */
+value_tag_t json_tape_ref_t_tag(json_tape_ref_t ref) {
+    switch (tape_type(ref.tape, ref.idx)) {
+        case '{':
+            return OBJECT;
+        case '[':
+            return ARRAY;
+        case '"':
+            return STRING;
+        case 'l':
+            return INTEGER;
+        case 'd':
+            return NUMBER;
+        case 't':
+        case 'f':
+            return BOOLEAN;
+        default:
+            return NULL_VAL;
+    }
+}
+
+/**
+ * @brief - Returns the number of members of an object or elements of an array
+ * @param ref - the container
+ * @return the count, 0 for anything that is not a container
+ */
+size_t json_tape_ref_t_len(json_tape_ref_t ref) {
+    char type = tape_type(ref.tape, ref.idx);
+    if (type != '{' && type != '[') {
+        return 0;
+    }
+
+    size_t count = (tape_payload(ref.tape, ref.idx) >> 32) & TAPE_COUNT_MAX;
+    if (count < TAPE_COUNT_MAX) {
+        return count;
+    }
+
+    // The stored count saturated, so the rest are counted by hopping over them
+    json_tape_iter_t it;
+    json_tape_ref_t value;
+    json_tape_iter_t_init(&it, ref);
+
+    count = 0;
+    while (json_tape_iter_t_next(&it, NULL, NULL, &value)) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief - Looks up an object member, hopping over other members' values in constant time each
+ * @param ref - the object
+ * @param key - name of the member
+ * @param key_len - length of key
+ * @param out - set to the member's value
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an object or the key is missing
+ */
+int json_tape_ref_t_get_n(json_tape_ref_t ref, const char* key, size_t key_len, json_tape_ref_t* out) {
+    const json_tape_t* tape = ref.tape;
+    if (tape_type(tape, ref.idx) != '{') {
+        return UNEXPECTED_TOKEN;
+    }
+
+    size_t end = (uint32_t)tape_payload(tape, ref.idx) - 1;
+    size_t idx = ref.idx + 1;
+
+    while (idx < end) {
+        const char* name = tape->strings + tape_payload(tape, idx);
+        uint32_t name_len;
+        memcpy(&name_len, name, sizeof(uint32_t));
+
+        if (name_len == key_len && memcmp(name + sizeof(uint32_t), key, key_len) == 0) {
+            out->tape = tape;
+            out->idx = idx + 1;
+            return 0;
+        }
+
+        idx = tape_next(tape, idx + 1);
+    }
+
+    return UNEXPECTED_TOKEN;
+}
+
+/**
+ * @brief - Looks up an object member by a null terminated key, see `json_tape_ref_t_get_n`
+ * @param ref - the object
+ * @param key - name of the member
+ * @param out - set to the member's value
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an object or the key is missing
+ */
+int json_tape_ref_t_get(json_tape_ref_t ref, const char* key, json_tape_ref_t* out) {
+    return json_tape_ref_t_get_n(ref, key, strlen(key), out);
+}
+
+/**
+ * @brief - Returns an array element
+ * @param ref - the array
+ * @param idx - index of the element
+ * @param out - set to the element
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an array
+ * @return INDEX_GREATER_THAN_LEN if `idx` is out of bounds
+ */
+int json_tape_ref_t_at(json_tape_ref_t ref, size_t idx, json_tape_ref_t* out) {
+    if (tape_type(ref.tape, ref.idx) != '[') {
+        return UNEXPECTED_TOKEN;
+    }
+
+    json_tape_iter_t it;
+    json_tape_iter_t_init(&it, ref);
+
+    while (json_tape_iter_t_next(&it, NULL, NULL, out)) {
+        if (idx-- == 0) {
+            return 0;
+        }
+    }
+
+    return INDEX_GREATER_THAN_LEN;
+}
+
+/**
+ * @brief - Reads a string value
+ * @param ref - the value
+ * @param len - set to the length of the string, may be NULL
+ * @return pointer to the null terminated, unescaped string
+ * @return NULL if the value is not a string
+ */
+const char* json_tape_ref_t_string(json_tape_ref_t ref, size_t* len) {
+    if (tape_type(ref.tape, ref.idx) != '"') {
+        return NULL;
+    }
+
+    const char* str = ref.tape->strings + tape_payload(ref.tape, ref.idx);
+    if (len != NULL) {
+        uint32_t n;
+        memcpy(&n, str, sizeof(uint32_t));
+        *len = n;
+    }
+
+    return str + sizeof(uint32_t);
+}
+
+/**
+ * @brief - Reads a number as a double
+ * @param ref - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a number
+ */
+int json_tape_ref_t_double(json_tape_ref_t ref, double* out) {
+    char type = tape_type(ref.tape, ref.idx);
+
+    // Only numbers have a payload entry, anything else may be the last entry on the tape
+    if (type == 'd') {
+        memcpy(out, &ref.tape->tape[ref.idx + 1], sizeof(double));
+        return 0;
+    }
+
+    if (type == 'l') {
+        *out = (double)(int64_t)ref.tape->tape[ref.idx + 1];
+        return 0;
+    }
+
+    return UNEXPECTED_TOKEN;
+}
+
+/**
+ * @brief - Reads an integer
+ * @param ref - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not an INTEGER
+ */
+int json_tape_ref_t_int64(json_tape_ref_t ref, int64_t* out) {
+    if (tape_type(ref.tape, ref.idx) != 'l') {
+        return UNEXPECTED_TOKEN;
+    }
+
+    *out = (int64_t)ref.tape->tape[ref.idx + 1];
+    return 0;
+}
+
+/**
+ * @brief - Reads a boolean
+ * @param ref - the value
+ * @param out - set to 1 for true and 0 for false
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a boolean
+ */
+int json_tape_ref_t_boolean(json_tape_ref_t ref, int* out) {
+    char type = tape_type(ref.tape, ref.idx);
+    if (type != 't' && type != 'f') {
+        return UNEXPECTED_TOKEN;
+    }
+
+    *out = type == 't';
+    return 0;
+}
+
+// Converts a scalar tape value, or starts an empty container for one
+static int tape_value_to_object(json_tape_ref_t ref, json_object_t* out, json_arena_t* arena) {
+    size_t len;
+
+    out->tag = NULL_VAL;
+
+    switch (tape_type(ref.tape, ref.idx)) {
+        case '{': {
+            json_object_map_t* map = mem_alloc(arena, sizeof(json_object_map_t));
+            if (map == NULL) {
+                return ALLOCATION_FAILED;
+            }
+
+            json_object_map_t_init(map);
+            map->arena = arena;
+            out->tag = OBJECT;
+            out->val.obj = map;
+            return 0;
+        }
+
+        case '[': {
+            json_array_t* arr = mem_alloc(arena, sizeof(json_array_t));
+            if (arr == NULL) {
+                return ALLOCATION_FAILED;
+            }
+
+            json_array_t_init(arr);
+            arr->arena = arena;
+            out->tag = ARRAY;
+            out->val.arr = arr;
+
+            // The element count is already known, so the array gets exactly one allocation
+            int rc = json_array_t_reserve(arr, json_tape_ref_t_len(ref));
+            if (rc != 0) {
+                if (arena == NULL) {
+                    json_deinit(out);
+                }
+                out->tag = NULL_VAL;
+            }
+            return rc;
+        }
+
+        case '"': {
+            const char* str = json_tape_ref_t_string(ref, &len);
+            char* buf;
+            int rc = copy_string(arena, str, len, 0, &buf, &len);
+            if (rc != 0) {
+                return rc;
+            }
+
+            out->tag = STRING;
+            out->val.str = buf;
+            out->val.view.len = len;
+            return 0;
+        }
+
+        case 'l':
+            out->tag = INTEGER;
+            return json_tape_ref_t_int64(ref, &out->val.integer);
+
+        case 'd':
+            out->tag = NUMBER;
+            return json_tape_ref_t_double(ref, &out->val.number);
+
+        case 't':
+        case 'f':
+            out->tag = BOOLEAN;
+            return json_tape_ref_t_boolean(ref, &out->val.boolean);
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief - A container `json_tape_ref_t_to_object` is filling in
+ * @property container - The object or array being built
+ * @property it - Position in the tape container
+ * @property key - Key of the member being converted
+ * @property key_len - Length of key
+ */
+typedef struct {
+    json_object_t container;
+    json_tape_iter_t it;
+    const char* key;
+    size_t key_len;
+} tape_frame_t;
+
+/**
+ * @brief - Builds a regular `json_object_t` tree out of a tape value
+ * @param ref - the value
+ * @param out - set to the converted value
+ * @param arena - arena to allocate the tree from, NULL for the heap
+ * @return 0 on success
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_tape_ref_t_to_object(json_tape_ref_t ref, json_object_t* out, json_arena_t* arena) {
+    tape_frame_t local[JSON_WALK_STACK_SIZE];
+    tape_frame_t* frames = local;
+    size_t len = 0;
+    size_t capacity = JSON_WALK_STACK_SIZE;
+    json_object_t item;
+    int rc;
+
+    out->tag = NULL_VAL;
+
+    for (;;) {
+        if (len == capacity) {
+            tape_frame_t* grown = walk_stack_grow(frames, local, &capacity, sizeof(tape_frame_t));
+            if (grown == NULL) {
+                rc = ALLOCATION_FAILED;
+                goto fail;
+            }
+            frames = grown;
+        }
+
+        rc = tape_value_to_object(ref, &item, arena);
+        if (rc != 0) goto fail;
+
+        // Containers stay open until their last member is converted, everything else is handed to the parent
+        if (item.tag == OBJECT || item.tag == ARRAY) {
+            frames[len].container = item;
+            json_tape_iter_t_init(&frames[len].it, ref);
+            len++;
+        } else if (len == 0) {
+            *out = item;
+            break;
+        } else {
+            goto add;
+        }
+
+    next:
+        {
+            tape_frame_t* frame = &frames[len - 1];
+            if (json_tape_iter_t_next(&frame->it, &frame->key, &frame->key_len, &ref)) {
+                continue;
+            }
+
+            item = frame->container;
+            len--;
+            if (len == 0) {
+                *out = item;
+                break;
+            }
+        }
+
+    add:
+        {
+            tape_frame_t* frame = &frames[len - 1];
+            if (frame->container.tag == OBJECT) {
+                rc = map_insert(frame->container.val.obj, (char*)frame->key, frame->key_len, &item, MAP_KEY_COPY);
+                if (rc != 0) {
+                    if (arena == NULL) {
+                        json_deinit(&item);
+                    }
+                    goto fail;
+                }
+            } else {
+                json_array_t_push(frame->container.val.arr, &item);
+            }
+        }
+        goto next;
+    }
+
+    if (frames != local) {
+        JSON_FREE(frames);
+    }
+    return 0;
+
+fail:
+    // Open containers are not attached to anything yet, the innermost ones are released first
+    if (arena == NULL) {
+        while (len > 0) {
+            json_deinit(&frames[--len].container);
+        }
+    }
+
+    if (frames != local) {
+        JSON_FREE(frames);
+    }
+
+    out->tag = NULL_VAL;
+    return rc;
+}
+
+/**
+ * @brief - Starts walking an object or array
+ * @param it - pointer to the iterator to initialize
+ * @param ref - the container, anything else yields no members
+ */
+void json_tape_iter_t_init(json_tape_iter_t* it, json_tape_ref_t ref) {
+    char type = tape_type(ref.tape, ref.idx);
+
+    it->tape = ref.tape;
+    it->idx = ref.idx + 1;
+    it->end = it->idx;
+    it->is_object = type == '{';
+
+    if (type == '{' || type == '[') {
+        it->end = (uint32_t)tape_payload(ref.tape, ref.idx) - 1;
+    }
+}
+
+/**
+ * @brief - Moves to the next member or element
+ * @param it - pointer to the iterator
+ * @param key - set to the member's key, or NULL for array elements, may be NULL
+ * @param key_len - set to the length of the key, may be NULL
+ * @param value - set to the member's value
+ * @return 1 if a member was produced
+ * @return 0 once the container is exhausted
+ */
+int json_tape_iter_t_next(json_tape_iter_t* it, const char** key, size_t* key_len, json_tape_ref_t* value) {
+    if (it->idx >= it->end) {
+        return 0;
+    }
+
+    const char* name = NULL;
+    size_t name_len = 0;
+
+    if (it->is_object) {
+        json_tape_ref_t key_ref = {it->tape, it->idx};
+        name = json_tape_ref_t_string(key_ref, &name_len);
+        it->idx++;
+    }
+
+    if (key != NULL) {
+        *key = name;
+    }
+    if (key_len != NULL) {
+        *key_len = name_len;
+    }
+
+    value->tape = it->tape;
+    value->idx = it->idx;
+    it->idx = tape_next(it->tape, it->idx);
+    return 1;
+}
+
+// PROJECTION IMPL
+
+/**
+ * @brief - Initializes an empty projection, which keeps nothing
+ * @param proj - pointer to the projection to initialize
+ */
+void json_projection_t_init(json_projection_t* proj) {
+    proj->nodes = NULL;
+    proj->len = 0;
+    proj->capacity = 0;
+}
+
+/**
+ * @brief - Frees the projection's nodes
+ * @param proj - pointer to the projection to deinit
+ */
+void json_projection_t_deinit(json_projection_t* proj) {
+    for (size_t i = 0; i < proj->len; i++) {
+        JSON_FREE(proj->nodes[i].name);
+    }
+
+    JSON_FREE(proj->nodes);
+    json_projection_t_init(proj);
+}
+
+static int projection_push(json_projection_t* proj, const char* name, size_t name_len) {
+    if (proj->len == proj->capacity) {
+        size_t capacity = proj->capacity == 0 ? 8 : proj->capacity * 2;
+        json_projection_node_t* nodes = JSON_REALLOC(proj->nodes, capacity * sizeof(json_projection_node_t));
+        if (nodes == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        proj->nodes = nodes;
+        proj->capacity = capacity;
+    }
+
+    char* copy = NULL;
+    if (name != NULL) {
+        copy = JSON_MALLOC(name_len + 1);
+        if (copy == NULL) {
+            return ALLOCATION_FAILED;
+        }
+
+        memcpy(copy, name, name_len);
+        copy[name_len] = '\0';
+    }
+
+    json_projection_node_t* node = &proj->nodes[proj->len++];
+    node->name = copy;
+    node->name_len = name_len;
+    node->first_child = 0;
+    node->next_sibling = 0;
+    node->terminal = 0;
+    return 0;
+}
+
+// Returns the index of `parent`'s child named `name`, or 0 when it has none
+static size_t projection_child(const json_projection_t* proj, size_t parent, const char* name, size_t name_len) {
+    size_t idx = proj->nodes[parent].first_child;
+    while (idx != 0) {
+        const json_projection_node_t* node = &proj->nodes[idx];
+        if (node->name_len == name_len && memcmp(node->name, name, name_len) == 0) {
+            return idx;
+        }
+        idx = node->next_sibling;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief - Adds a dotted path such as `person.name`, each segment naming an object member
+ * A path that is a prefix of another keeps the whole value and makes the longer one redundant.
+ * @param proj - pointer to the projection
+ * @param path - null terminated path, segments are split on `.`
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the path has an empty segment
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_projection_t_add(json_projection_t* proj, const char* path) {
+    // Checked up front so a bad path leaves the trie untouched
+    for (const char* p = path;; p++) {
+        if ((*p == '.' || *p == '\0') && (p == path || p[-1] == '.')) {
+            return UNEXPECTED_TOKEN;
+        }
+        if (*p == '\0') {
+            break;
+        }
+    }
+
+    if (proj->len == 0 && projection_push(proj, NULL, 0) != 0) {
+        return ALLOCATION_FAILED;
+    }
+
+    size_t node = 0;
+    const char* segment = path;
+
+    for (;;) {
+        const char* dot = strchr(segment, '.');
+        size_t segment_len = dot != NULL ? (size_t)(dot - segment) : strlen(segment);
+
+        size_t child = projection_child(proj, node, segment, segment_len);
+        if (child == 0) {
+            if (projection_push(proj, segment, segment_len) != 0) {
+                return ALLOCATION_FAILED;
+            }
+
+            child = proj->len - 1;
+            proj->nodes[child].next_sibling = proj->nodes[node].first_child;
+            proj->nodes[node].first_child = child;
+        }
+
+        node = child;
+        if (proj->nodes[node].terminal || dot == NULL) {
+            break;
+        }
+        segment = dot + 1;
+    }
+
+    proj->nodes[node].terminal = 1;
+    return 0;
+}
+
+// Builds the object at the cursor out of only the members `node` has children for
+static int parse_projected(json_parse_state_t* st, const json_projection_t* proj, size_t node, json_object_t* obj) {
+    json_object_map_t* map = mem_alloc(st->arena, sizeof(json_object_map_t));
+    if (map == NULL) {
+        return ALLOCATION_FAILED;
+    }
+
+    json_object_map_t_init(map);
+    map->arena = st->arena;
+
+    obj->tag = OBJECT;
+    obj->val.obj = map;
+
+    // Skip {
+    st->cur++;
+    skip_whitespace(st);
+
+    if (st->cur < st->end && *st->cur == '}') {
+        st->cur++;
+        return 0;
+    }
+
+    int rc;
+    while (st->cur < st->end) {
+        if (*st->cur != '"') {
+            rc = UNEXPECTED_TOKEN;
+            goto fail;
+        }
+
+        const char* key;
+        size_t key_len;
+        int escaped;
+        rc = scan_string(st, &key, &key_len, &escaped);
+        if (rc != 0) {
+            goto fail;
+        }
+
+        skip_whitespace(st);
+        if (st->cur >= st->end || *st->cur != ':') {
+            rc = st->cur >= st->end ? INDEX_GREATER_THAN_LEN : UNEXPECTED_TOKEN;
+            goto fail;
+        }
+        st->cur++;
+        skip_whitespace(st);
+
+        // Escaped keys have to be decoded before they can be matched, short ones on the stack
+        char scratch[128];
+        char* decoded = NULL;
+        const char* match = key;
+        size_t match_len = key_len;
+        if (escaped && key_len <= sizeof(scratch)) {
+            rc = unescape_string(key, key_len, scratch, &match_len);
+            match = scratch;
+        } else if (escaped) {
+            rc = copy_string(st->arena, key, key_len, 1, &decoded, &match_len);
+            match = decoded;
+        }
+
+        if (rc != 0) {
+            goto fail;
+        }
+
+        size_t child = projection_child(proj, node, match, match_len);
+        json_object_t val_obj;
+        val_obj.tag = NULL_VAL;
+
+        if (child != 0 && proj->nodes[child].terminal) {
+            rc = parse_value(st, &val_obj);
+        } else if (child != 0 && st->cur < st->end && *st->cur == '{') {
+            rc = parse_projected(st, proj, child, &val_obj);
+        } else {
+            child = 0;
+            rc = skip_value(st);
+        }
+
+        if (rc == 0 && child != 0) {
+            if (st->intern != NULL) {
+                rc = parse_insert_interned(st, map, match, match_len, 0, &val_obj);
+            } else if (decoded != NULL) {
+                rc = map_insert(map, decoded, match_len, &val_obj, MAP_KEY_TAKE);
+                decoded = NULL;
+            } else if (escaped) {
+                rc = map_insert(map, scratch, match_len, &val_obj, MAP_KEY_COPY);
+            } else if (st->flags & JSON_PARSE_BORROW_STRINGS) {
+                rc = map_insert(map, (char*)key, key_len, &val_obj, MAP_KEY_BORROW);
+            } else {
+                rc = map_insert(map, (char*)key, key_len, &val_obj, MAP_KEY_COPY);
+            }
+
+            if (rc != 0 && st->arena == NULL) {
+                json_deinit(&val_obj);
+            }
+        }
+
+        if (decoded != NULL) {
+            mem_free(st->arena, decoded);
+        }
+
+        if (rc != 0) {
+            goto fail;
+        }
+
+        skip_whitespace(st);
+        if (st->cur >= st->end) {
+            break;
+        }
+
+        if (*st->cur == ',') {
+            st->cur++;
+            skip_whitespace(st);
+        } else if (*st->cur == '}') {
+            st->cur++;
+            return 0;
+        } else {
+            rc = UNEXPECTED_TOKEN;
+            goto fail;
+        }
+    }
+
+    rc = INDEX_GREATER_THAN_LEN;
+
+fail:
+    if (st->arena == NULL) {
+        json_deinit(obj);
+    }
+    obj->tag = NULL_VAL;
+    return rc;
+}
+
+/**
+ * @brief - Parses only the members a projection names, skipping every other subtree without allocating
+ * The result is an OBJECT holding the matched values under their enclosing objects. Paths only descend through
+ * objects, a path reaching an array or scalar before its last segment matches nothing.
+ * Skipped subtrees are only checked for balanced brackets and terminated strings.
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param proj - the fields to keep
+ * @param obj - pointer to the JSON object to populate
+ * @param opts - parse options, NULL for the defaults
+ * @return 0 on success
+ * @return negative number on failure
+ */
+int json_parse_projected(const char* json, size_t len, const json_projection_t* proj, json_object_t* obj,
+                         const json_parse_opts_t* opts) {
+    json_parse_state_t st;
+    parse_state_init(&st, opts != NULL ? opts->arena : NULL, opts != NULL ? opts->flags : 0);
+    st.intern = opts != NULL ? opts->intern : NULL;
+    st.cur = json;
+    st.end = json + len;
+
+    obj->tag = NULL_VAL;
+    skip_whitespace(&st);
+
+    int rc;
+    if (st.cur < st.end && *st.cur == '{' && proj->len > 0) {
+        rc = parse_projected(&st, proj, 0, obj);
+    } else {
+        // Nothing can match below anything but an object, so the result is empty
+        rc = skip_value(&st);
+        if (rc == 0) {
+            json_object_map_t* map = mem_alloc(st.arena, sizeof(json_object_map_t));
+            if (map == NULL) {
+                rc = ALLOCATION_FAILED;
+            } else {
+                json_object_map_t_init(map);
+                map->arena = st.arena;
+                obj->tag = OBJECT;
+                obj->val.obj = map;
+            }
+        }
+    }
+
+    // Only whitespace may follow the top level value
+    if (rc == 0) {
+        skip_whitespace(&st);
+        if (st.cur != st.end) {
+            if (st.arena == NULL) {
+                json_deinit(obj);
+            }
+            obj->tag = NULL_VAL;
+            rc = UNEXPECTED_TOKEN;
+        }
+    }
+
+    parse_state_deinit(&st);
+    return rc;
+}
+
+// PATH IMPL
+
+// Reads a step as an array index, which has to be digits without a leading zero
+static size_t path_index(const char* key, size_t len) {
+    if (len == 0 || len > 19 || (key[0] == '0' && len > 1)) {
+        return JSON_PATH_NO_INDEX;
+    }
+
+    size_t index = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (!is_numeric(key[i])) {
+            return JSON_PATH_NO_INDEX;
+        }
+        index = index * 10 + (key[i] - '0');
+    }
+
+    return index;
+}
+
+// Sizes the step and key buffers for at most `steps` steps of an expression `len` bytes long
+static int path_alloc(json_path_t* path, size_t steps, size_t len) {
+    path->len = 0;
+    path->seed = json_hash_seed();
+    path->steps = NULL;
+    path->keys = NULL;
+
+    if (steps == 0) {
+        return 0;
+    }
+
+    path->steps = JSON_MALLOC(steps * sizeof(json_path_step_t));
+    path->keys = JSON_MALLOC(len + 1);
+    if (path->steps == NULL || path->keys == NULL) {
+        json_path_t_deinit(path);
+        return ALLOCATION_FAILED;
+    }
+
+    return 0;
+}
 
-    while (idx < size) {
-        tok.start = json + idx;
-        tok.len = 1;
-        flag = 1;
+static void path_push(json_path_t* path, const char* key, size_t key_len) {
+    json_path_step_t* step = &path->steps[path->len++];
+    step->key = key;
+    step->key_len = key_len;
+    step->hash = json_hash(key, key_len, path->seed);
+    step->index = path_index(key, key_len);
+}
 
-        switch (json[idx]) {
-            case '[': 
-                tok.tag = OPEN_BRACKET;
-                break;
+/**
+ * @brief - Compiles an RFC 6901 JSON Pointer such as `/person/tags/0`, with `~0` and `~1` escaping `~` and `/`
+ * @param path - pointer to the path to initialize
+ * @param pointer - null terminated pointer, the empty string selects the root
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the pointer is malformed
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_path_t_compile_pointer(json_path_t* path, const char* pointer) {
+    size_t len = strlen(pointer);
+    size_t steps = 0;
+    for (size_t i = 0; i < len; i++) {
+        steps += pointer[i] == '/';
+    }
 
-            case ']': 
-                tok.tag = CLOSE_BRACKET;
-                break;
+    if (len > 0 && pointer[0] != '/') {
+        path_alloc(path, 0, 0);
+        return UNEXPECTED_TOKEN;
+    }
 
-            case '{': 
-                tok.tag = OPEN_BRACE;
-                break;
+    if (path_alloc(path, steps, len) != 0) {
+        return ALLOCATION_FAILED;
+    }
 
-            case '}': 
-                tok.tag = CLOSE_BRACE;
-                break;
+    // Each token is decoded into the key buffer, which can only shrink it
+    char* out = path->keys;
+    const char* p = pointer;
+    while (*p == '/') {
+        p++;
+        char* key = out;
+
+        while (*p != '\0' && *p != '/') {
+            if (*p == '~') {
+                if (p[1] != '0' && p[1] != '1') {
+                    json_path_t_deinit(path);
+                    return UNEXPECTED_TOKEN;
+                }
 
-            case ',': 
-                tok.tag = COMMA;
-                break;
+                *out++ = p[1] == '0' ? '~' : '/';
+                p += 2;
+            } else {
+                *out++ = *p++;
+            }
+        }
 
-            case ':':
-                tok.tag = COLON;
-                break;
+        path_push(path, key, out - key);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief - Compiles a dotted path such as `person.tags[0]`, keys are split on `.` and `[`
+ * @param path - pointer to the path to initialize
+ * @param expr - null terminated path, the empty string selects the root
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the path is malformed
+ * @return ALLOCATION_FAILED on failure
+ */
+int json_path_t_compile(json_path_t* path, const char* expr) {
+    size_t len = strlen(expr);
+    size_t steps = len > 0;
+    for (size_t i = 0; i < len; i++) {
+        steps += expr[i] == '.' || expr[i] == '[';
+    }
+
+    if (path_alloc(path, steps, len) != 0) {
+        return ALLOCATION_FAILED;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    memcpy(path->keys, expr, len + 1);
+    const char* p = path->keys;
+
+    for (;;) {
+        const char* key = p;
+
+        if (*p == '[') {
+            // Brackets hold an index
+            key = ++p;
+            while (is_numeric(*p)) {
+                p++;
+            }
+
+            if (*p != ']' || path_index(key, p - key) == JSON_PATH_NO_INDEX) {
+                json_path_t_deinit(path);
+                return UNEXPECTED_TOKEN;
+            }
+
+            path_push(path, key, p - key);
+            p++;
+        } else {
+            while (*p != '\0' && *p != '.' && *p != '[') {
+                p++;
+            }
+
+            if (p == key) {
+                json_path_t_deinit(path);
+                return UNEXPECTED_TOKEN;
+            }
+
+            path_push(path, key, p - key);
+        }
+
+        if (*p == '\0') {
+            return 0;
+        }
+
+        // A dot always introduces a key, a bracket can follow any step
+        if (*p == '.') {
+            p++;
+            if (*p == '\0' || *p == '.' || *p == '[') {
+                json_path_t_deinit(path);
+                return UNEXPECTED_TOKEN;
+            }
+        } else if (*p != '[') {
+            json_path_t_deinit(path);
+            return UNEXPECTED_TOKEN;
+        }
+    }
+}
+
+/**
+ * @brief - Follows a compiled path from a value, using the precomputed hashes for every map lookup
+ * @param path - the compiled path
+ * @param root - value to start from
+ * @return pointer to the selected value
+ * @return NULL if any step is missing or lands on a scalar
+ */
+json_object_t* json_path_t_eval(const json_path_t* path, json_object_t* root) {
+    json_object_t* cur = root;
+    const json_path_step_t* step = path->steps;
+    const json_path_step_t* end = path->steps + path->len;
+
+    for (; step < end; step++) {
+        if (cur->tag == OBJECT) {
+            json_object_map_t* map = cur->val.obj;
+            if (map->len == 0) {
+                return NULL;
+            }
+
+            // Maps from before a seed change still hash with the old seed
+            uint64_t hash = map->seed == path->seed ? step->hash : json_hash(step->key, step->key_len, map->seed);
+            cur = map_lookup(map, step->key, step->key_len, hash);
+            if (cur == NULL) {
+                return NULL;
+            }
+        } else if (cur->tag == ARRAY) {
+            if (step->index >= cur->val.arr->len) {
+                return NULL;
+            }
+            cur = &cur->val.arr->items[step->index];
+        } else {
+            return NULL;
+        }
+    }
+
+    return cur;
+}
+
+/**
+ * @brief - Frees a compiled path
+ * @param path - pointer to the path to deinit
+ */
+void json_path_t_deinit(json_path_t* path) {
+    JSON_FREE(path->steps);
+    JSON_FREE(path->keys);
+    path->steps = NULL;
+    path->keys = NULL;
+    path->len = 0;
+}
+
+// SCHEMA IMPL
+
+// Hashes a key for dispatch. Unless the schema needs the full hash only the length and the first and last 8 bytes
+// are mixed, which already tell apart any keys up to 16 bytes long
+static inline uint64_t schema_hash(const char* key, size_t len, uint64_t seed, int full_hash) {
+    if (full_hash) {
+        return json_hash(key, len, seed);
+    }
+
+    uint64_t head, tail;
+    if (len >= 8) {
+        head = read_u64(key);
+        tail = read_u64(key + len - 8);
+    } else {
+        head = read_partial_u64(key, len);
+        tail = 0;
+    }
+
+    return hash_mix(head ^ seed, tail ^ len ^ HASH_K1);
+}
+
+// Tries to place every field in its own slot, returning 0 on the first collision
+static int schema_place(json_schema_t* schema) {
+    memset(schema->table, 0, schema->mask + 1);
+
+    for (size_t i = 0; i < schema->count; i++) {
+        const json_field_t* field = &schema->fields[i];
+        size_t slot = schema_hash(field->key, field->key_len, schema->seed, schema->full_hash) & schema->mask;
+        if (schema->table[slot] != 0) {
+            return 0;
+        }
+        schema->table[slot] = (uint8_t)(i + 1);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief - Finds a perfect hash for a set of fields, without allocating
+ * @param schema - pointer to the schema to fill in
+ * @param fields - the fields, they have to outlive the schema
+ * @param count - number of fields, at most `JSON_SCHEMA_MAX_FIELDS`
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if there are too many fields or two share a key
+ */
+int json_schema_t_compile(json_schema_t* schema, const json_field_t* fields, size_t count) {
+    schema->fields = fields;
+    schema->count = count;
+    schema->full_hash = 0;
+    schema->status = UNEXPECTED_TOKEN;
+
+    if (count > JSON_SCHEMA_MAX_FIELDS) {
+        return UNEXPECTED_TOKEN;
+    }
+
+    // Long keys that agree on their length and both ends need every byte hashed
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count; j++) {
+            const json_field_t* a = &fields[i];
+            const json_field_t* b = &fields[j];
+            if (a->key_len != b->key_len) {
+                continue;
+            }
+
+            if (memcmp(a->key, b->key, a->key_len) == 0) {
+                return UNEXPECTED_TOKEN;
+            }
+
+            if (a->key_len > 16 && memcmp(a->key, b->key, 8) == 0 &&
+                memcmp(a->key + a->key_len - 8, b->key + b->key_len - 8, 8) == 0) {
+                schema->full_hash = 1;
+            }
+        }
+    }
+
+    // Starts with a table four times the field count and doubles it whenever a few hundred seeds all collide
+    size_t size = 8;
+    while (size < count * 4) {
+        size *= 2;
+    }
+
+    for (; size <= JSON_SCHEMA_TABLE_SIZE; size *= 2) {
+        schema->mask = size - 1;
+        for (uint64_t attempt = 1; attempt <= 256; attempt++) {
+            schema->seed = hash_mix(attempt, HASH_K2);
+            if (schema_place(schema)) {
+                schema->status = 0;
+                return 0;
+            }
+        }
+    }
+
+    return UNEXPECTED_TOKEN;
+}
+
+static int schema_decode_object(json_parse_state_t* st, const json_schema_t* schema, char* out);
+
+// Decodes the value at the cursor into one field
+static int schema_decode_field(json_parse_state_t* st, const json_field_t* field, char* out) {
+    char* dst = out + field->offset;
+    json_object_t val;
+    int rc;
+
+    // null leaves the field as it was
+    if (*st->cur == 'n') {
+        return parse_literal(st, &val);
+    }
+
+    switch (field->kind) {
+        case JSON_FIELD_INT64:
+        case JSON_FIELD_DOUBLE:
+            if (!is_numeric(*st->cur) && *st->cur != '-') {
+                return UNEXPECTED_TOKEN;
+            }
+
+            rc = parse_number(st, &val);
+            if (rc != 0) {
+                return rc;
+            }
+
+            if (field->kind == JSON_FIELD_DOUBLE) {
+                double number = val.tag == INTEGER ? (double)val.val.integer : val.val.number;
+                memcpy(dst, &number, sizeof(double));
+            } else if (val.tag == INTEGER) {
+                memcpy(dst, &val.val.integer, sizeof(int64_t));
+            } else {
+                return UNEXPECTED_TOKEN;
+            }
+            return 0;
+
+        case JSON_FIELD_BOOL: {
+            rc = parse_literal(st, &val);
+            if (rc != 0) {
+                return rc;
+            }
+
+            int boolean = val.val.boolean;
+            memcpy(dst, &boolean, sizeof(int));
+            return 0;
+        }
+
+        case JSON_FIELD_STRING: {
+            if (*st->cur != '"') {
+                return UNEXPECTED_TOKEN;
+            }
+
+            const char* raw;
+            size_t len;
+            int escaped;
+            rc = scan_string(st, &raw, &len, &escaped);
+            if (rc != 0) {
+                return rc;
+            }
+
+            char* str;
+            rc = copy_string(st->arena, raw, len, escaped, &str, &len);
+            if (rc != 0) {
+                return rc;
+            }
+
+            // A repeated key replaces the string an earlier one stored
+            char* previous;
+            memcpy(&previous, dst, sizeof(char*));
+            if (st->arena == NULL) {
+                JSON_FREE(previous);
+            }
+            memcpy(dst, &str, sizeof(char*));
+            return 0;
+        }
+
+        case JSON_FIELD_STRUCT:
+            if (*st->cur != '{') {
+                return UNEXPECTED_TOKEN;
+            }
+            return schema_decode_object(st, field->schema(), dst);
+
+        case JSON_FIELD_VALUE:
+            rc = parse_value(st, &val);
+            if (rc != 0) {
+                return rc;
+            }
+
+            if (st->arena == NULL) {
+                json_deinit((json_object_t*)dst);
+            }
+            memcpy(dst, &val, sizeof(json_object_t));
+            return 0;
+    }
+
+    return UNEXPECTED_TOKEN;
+}
+
+static int schema_decode_object(json_parse_state_t* st, const json_schema_t* schema, char* out) {
+    if (schema->status != 0) {
+        return schema->status;
+    }
+
+    // Skip {
+    st->cur++;
+    skip_whitespace(st);
+
+    if (st->cur < st->end && *st->cur == '}') {
+        st->cur++;
+        return 0;
+    }
+
+    int rc;
+    while (st->cur < st->end) {
+        if (*st->cur != '"') {
+            return UNEXPECTED_TOKEN;
+        }
+
+        const char* key;
+        size_t key_len;
+        int escaped;
+        rc = scan_string(st, &key, &key_len, &escaped);
+        if (rc != 0) {
+            return rc;
+        }
+
+        skip_whitespace(st);
+        if (st->cur >= st->end || *st->cur != ':') {
+            return st->cur >= st->end ? INDEX_GREATER_THAN_LEN : UNEXPECTED_TOKEN;
+        }
+        st->cur++;
+        skip_whitespace(st);
+        if (st->cur >= st->end) {
+            return INDEX_GREATER_THAN_LEN;
+        }
+
+        // Escaped keys are decoded on the stack, ones too long for it can't be a field and are skipped
+        char scratch[128];
+        const json_field_t* field = NULL;
+        if (escaped && key_len <= sizeof(scratch)) {
+            rc = unescape_string(key, key_len, scratch, &key_len);
+            if (rc != 0) {
+                return rc;
+            }
+            key = scratch;
+            escaped = 0;
+        }
+
+        if (!escaped) {
+            size_t slot = schema_hash(key, key_len, schema->seed, schema->full_hash) & schema->mask;
+            uint8_t idx = schema->table[slot];
+            if (idx != 0) {
+                field = &schema->fields[idx - 1];
+                if (field->key_len != key_len || memcmp(field->key, key, key_len) != 0) {
+                    field = NULL;
+                }
+            }
+        }
+
+        rc = field != NULL ? schema_decode_field(st, field, out) : skip_value(st);
+        if (rc != 0) {
+            return rc;
+        }
+
+        skip_whitespace(st);
+        if (st->cur >= st->end) {
+            break;
+        }
+
+        if (*st->cur == ',') {
+            st->cur++;
+            skip_whitespace(st);
+        } else if (*st->cur == '}') {
+            st->cur++;
+            return 0;
+        } else {
+            return UNEXPECTED_TOKEN;
+        }
+    }
+
+    return INDEX_GREATER_THAN_LEN;
+}
+
+/**
+ * @brief - Decodes a JSON object straight into a struct, without building a tree
+ * Members missing from the JSON, or null in it, leave their field untouched. Unknown members are skipped.
+ * Without an arena, string and value fields have to start out zeroed and are released with `json_schema_t_deinit_struct`.
+ * @param schema - the struct's compiled schema
+ * @param json - JSON string buffer
+ * @param len - length of the JSON string buffer
+ * @param out - pointer to the struct to fill in
+ * @param arena - arena to allocate strings and values from, NULL for the heap
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if a member has the wrong type
+ * @return negative number on failure, `out` may be partially filled
+ */
+int json_schema_t_decode(const json_schema_t* schema, const char* json, size_t len, void* out, json_arena_t* arena) {
+    json_parse_state_t st;
+    parse_state_init(&st, arena, 0);
+    st.cur = json;
+    st.end = json + len;
+
+    skip_whitespace(&st);
+    if (st.cur >= st.end) {
+        return INDEX_GREATER_THAN_LEN;
+    }
+    if (*st.cur != '{') {
+        return UNEXPECTED_TOKEN;
+    }
+
+    int rc = schema_decode_object(&st, schema, out);
+
+    // Only whitespace may follow the top level value
+    if (rc == 0) {
+        skip_whitespace(&st);
+        rc = st.cur == st.end ? 0 : UNEXPECTED_TOKEN;
+    }
+
+    parse_state_deinit(&st);
+    return rc;
+}
+
+/**
+ * @brief - Frees the heap strings and values a decode stored in a struct, including nested ones
+ * @param schema - the struct's compiled schema
+ * @param out - pointer to the struct
+ */
+void json_schema_t_deinit_struct(const json_schema_t* schema, void* out) {
+    for (size_t i = 0; i < schema->count; i++) {
+        const json_field_t* field = &schema->fields[i];
+        char* dst = (char*)out + field->offset;
+
+        if (field->kind == JSON_FIELD_STRING) {
+            char* str;
+            memcpy(&str, dst, sizeof(char*));
+            JSON_FREE(str);
+            str = NULL;
+            memcpy(dst, &str, sizeof(char*));
+        } else if (field->kind == JSON_FIELD_STRUCT) {
+            json_schema_t_deinit_struct(field->schema(), dst);
+        } else if (field->kind == JSON_FIELD_VALUE) {
+            json_deinit((json_object_t*)dst);
+            ((json_object_t*)dst)->tag = NULL_VAL;
+        }
+    }
+}
+
+// BINARY IMPL
+
+#define BIN_ROOT_OFFSET 24
+#define BIN_HEADER_SIZE 40
+#define BIN_NODE_SIZE 16
+#define BIN_MEMBER_SIZE 40
+#define BIN_MEMBER_VALUE 24
+
+/**
+ * @brief - A key already written to the image, so repeated keys are stored once
+ * @property hash - Hash of the key with the image seed
+ * @property off - Offset of the key bytes in the image, 0 marks an empty slot
+ * @property len - Length of the key
+ */
+typedef struct {
+    uint64_t hash;
+    uint64_t off;
+    size_t len;
+} bin_key_slot_t;
+
+/**
+ * @brief - Image being built by `json_binary_write`
+ * @property buf - The image so far
+ * @property len - Bytes used in `buf`, always a multiple of 8
+ * @property capacity - Size of `buf`
+ * @property seed - Seed member hashes are computed with
+ * @property keys - Linearly probed table of the keys written so far
+ * @property key_count - Number of keys in `keys`
+ * @property key_mask - Number of slots in `keys` - 1
+ */
+typedef struct {
+    char* buf;
+    size_t len;
+    size_t capacity;
+    uint64_t seed;
+
+    bin_key_slot_t* keys;
+    size_t key_count;
+    size_t key_mask;
+} bin_writer_t;
+
+/**
+ * @brief - A member's position in an object with its hash, sorted to build the lookup index
+ */
+typedef struct {
+    uint64_t hash;
+    uint32_t idx;
+} bin_sort_entry_t;
+
+// Appends `n` zeroed bytes padded to 8, returning their offset or 0 when out of memory (offset 0 is the header)
+static size_t bin_reserve(bin_writer_t* w, size_t n) {
+    size_t off = w->len;
+    size_t need = off + ((n + 7) & ~(size_t)7);
+
+    if (need > w->capacity) {
+        size_t capacity = w->capacity == 0 ? JSON_BINARY_START_SIZE : w->capacity;
+        while (capacity < need) {
+            capacity *= 2;
+        }
+
+        char* buf = JSON_REALLOC(w->buf, capacity);
+        if (buf == NULL) {
+            return 0;
+        }
+
+        w->buf = buf;
+        w->capacity = capacity;
+    }
+
+    memset(w->buf + off, 0, need - off);
+    w->len = need;
+    return off;
+}
+
+static void bin_put_node(bin_writer_t* w, size_t off, char type, uint32_t len, uint64_t payload) {
+    w->buf[off] = type;
+    memcpy(w->buf + off + 4, &len, sizeof(len));
+    memcpy(w->buf + off + 8, &payload, sizeof(payload));
+}
+
+static int bin_string(bin_writer_t* w, const char* str, size_t len, size_t* out) {
+    if (len > UINT32_MAX) {
+        return UNEXPECTED_TOKEN;
+    }
+
+    size_t off = bin_reserve(w, len + 1);
+    if (off == 0) {
+        return ALLOCATION_FAILED;
+    }
+
+    memcpy(w->buf + off, str, len);
+    *out = off;
+    return 0;
+}
+
+static int bin_keys_grow(bin_writer_t* w) {
+    size_t slot_count = w->keys == NULL ? JSON_BINARY_KEYS_START_SLOTS : (w->key_mask + 1) * 2;
+    bin_key_slot_t* keys = JSON_MALLOC(slot_count * sizeof(bin_key_slot_t));
+    if (keys == NULL) {
+        return ALLOCATION_FAILED;
+    }
+    memset(keys, 0, slot_count * sizeof(bin_key_slot_t));
+
+    size_t mask = slot_count - 1;
+    for (size_t i = 0; w->keys != NULL && i <= w->key_mask; i++) {
+        if (w->keys[i].off != 0) {
+            size_t pos = w->keys[i].hash & mask;
+            while (keys[pos].off != 0) {
+                pos = (pos + 1) & mask;
+            }
+            keys[pos] = w->keys[i];
+        }
+    }
+
+    JSON_FREE(w->keys);
+    w->keys = keys;
+    w->key_mask = mask;
+    return 0;
+}
+
+// Writes a key once, later members with the same key point at the first copy
+static int bin_key(bin_writer_t* w, const char* key, size_t len, uint64_t hash, size_t* out) {
+    if (w->keys == NULL || (w->key_count + 1) * 2 > w->key_mask + 1) {
+        int rc = bin_keys_grow(w);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    size_t pos = hash & w->key_mask;
+    while (w->keys[pos].off != 0) {
+        bin_key_slot_t* slot = &w->keys[pos];
+        if (slot->hash == hash && slot->len == len && memcmp(w->buf + slot->off, key, len) == 0) {
+            *out = slot->off;
+            return 0;
+        }
+        pos = (pos + 1) & w->key_mask;
+    }
+
+    int rc = bin_string(w, key, len, out);
+    if (rc != 0) {
+        return rc;
+    }
+
+    w->keys[pos].hash = hash;
+    w->keys[pos].off = *out;
+    w->keys[pos].len = len;
+    w->key_count++;
+    return 0;
+}
+
+static int bin_sort_compare(const void* a, const void* b) {
+    const bin_sort_entry_t* x = a;
+    const bin_sort_entry_t* y = b;
+    if (x->hash != y->hash) {
+        return x->hash < y->hash ? -1 : 1;
+    }
+    return x->idx < y->idx ? -1 : x->idx > y->idx;
+}
+
+// Encodes a scalar into the node at offset `node`, or reserves the body of a container
+static int bin_encode_value(bin_writer_t* w, const json_object_t* obj, size_t node, size_t* body) {
+    int rc;
+
+    *body = 0;
+
+    switch (obj->tag) {
+        case NULL_VAL:
+            bin_put_node(w, node, 'n', 0, 0);
+            return 0;
+
+        case BOOLEAN:
+            bin_put_node(w, node, obj->val.boolean ? 't' : 'f', 0, 0);
+            return 0;
+
+        case INTEGER:
+            bin_put_node(w, node, 'l', 0, (uint64_t)obj->val.integer);
+            return 0;
+
+        case NUMBER: {
+            uint64_t bits;
+            memcpy(&bits, &obj->val.number, sizeof(bits));
+            bin_put_node(w, node, 'd', 0, bits);
+            return 0;
+        }
+
+        case STRING:
+        case STRING_VIEW: {
+            size_t len;
+            const char* str = json_object_t_string(obj, &len);
+
+            size_t off;
+            rc = bin_string(w, str, len, &off);
+            if (rc != 0) return rc;
+
+            bin_put_node(w, node, 's', (uint32_t)len, off);
+            return 0;
+        }
+
+        case ARRAY:
+            if (obj->val.arr->len > UINT32_MAX) {
+                return UNEXPECTED_TOKEN;
+            }
+
+            *body = bin_reserve(w, obj->val.arr->len * BIN_NODE_SIZE);
+            return *body == 0 ? ALLOCATION_FAILED : 0;
+
+        case OBJECT:
+            if (obj->val.obj->len > UINT32_MAX) {
+                return UNEXPECTED_TOKEN;
+            }
+
+            *body = bin_reserve(w, obj->val.obj->len * (BIN_MEMBER_SIZE + sizeof(uint32_t)));
+            return *body == 0 ? ALLOCATION_FAILED : 0;
+
+        default:
+            return UNEXPECTED_TOKEN;
+    }
+}
+
+/**
+ * @brief - A container `bin_encode` is filling in
+ * @property obj - The object or array
+ * @property node - Offset of the node that points at the container
+ * @property body - Offset of the container's members or elements
+ * @property idx - Index of the next member or element to encode
+ * @property order - Member hashes for the lookup index, NULL for arrays
+ */
+typedef struct {
+    const json_object_t* obj;
+    size_t node;
+    size_t body;
+    size_t idx;
+    bin_sort_entry_t* order;
+} bin_frame_t;
+
+// Encodes `obj` into the node at offset `node`, appending whatever it points at to the image
+static int bin_encode(bin_writer_t* w, const json_object_t* obj, size_t node) {
+    bin_frame_t local[JSON_WALK_STACK_SIZE];
+    bin_frame_t* frames = local;
+    size_t len = 0;
+    size_t capacity = JSON_WALK_STACK_SIZE;
+    size_t body;
+    int rc;
+
+    for (;;) {
+        rc = bin_encode_value(w, obj, node, &body);
+        if (rc != 0) goto done;
+
+        if (obj->tag == OBJECT || obj->tag == ARRAY) {
+            if (len == capacity) {
+                bin_frame_t* grown = walk_stack_grow(frames, local, &capacity, sizeof(bin_frame_t));
+                if (grown == NULL) {
+                    rc = ALLOCATION_FAILED;
+                    goto done;
+                }
+                frames = grown;
+            }
+
+            bin_sort_entry_t* order = NULL;
+            if (obj->tag == OBJECT) {
+                size_t count = obj->val.obj->len;
+                order = JSON_MALLOC((count == 0 ? 1 : count) * sizeof(bin_sort_entry_t));
+                if (order == NULL) {
+                    rc = ALLOCATION_FAILED;
+                    goto done;
+                }
+            }
+
+            frames[len].obj = obj;
+            frames[len].node = node;
+            frames[len].body = body;
+            frames[len].idx = 0;
+            frames[len].order = order;
+            len++;
+        }
+
+        // Finish every container that is complete, then move on to the next member of the innermost open one
+        obj = NULL;
+        while (len > 0 && obj == NULL) {
+            bin_frame_t* frame = &frames[len - 1];
+
+            if (frame->obj->tag == ARRAY) {
+                const json_array_t* arr = frame->obj->val.arr;
+                if (frame->idx < arr->len) {
+                    obj = &arr->items[frame->idx];
+                    node = frame->body + frame->idx * BIN_NODE_SIZE;
+                    frame->idx++;
+                    continue;
+                }
+
+                bin_put_node(w, frame->node, '[', (uint32_t)arr->len, frame->body);
+                len--;
+                continue;
+            }
+
+            const json_object_map_t* map = frame->obj->val.obj;
+            size_t count = map->len;
+
+            // Members keep their original order, only the index after them is sorted
+            if (frame->idx < count) {
+                const json_object_entry_t* entry = &map->entries[frame->idx];
+                uint64_t hash = json_hash(entry->key, entry->key_len, w->seed);
+
+                size_t key_off;
+                rc = bin_key(w, entry->key, entry->key_len, hash, &key_off);
+                if (rc != 0) goto done;
+
+                size_t member = frame->body + frame->idx * BIN_MEMBER_SIZE;
+                uint32_t key_len = (uint32_t)entry->key_len;
+                uint64_t key_off64 = key_off;
+                memcpy(w->buf + member, &hash, sizeof(hash));
+                memcpy(w->buf + member + 8, &key_off64, sizeof(key_off64));
+                memcpy(w->buf + member + 16, &key_len, sizeof(key_len));
+
+                frame->order[frame->idx].hash = hash;
+                frame->order[frame->idx].idx = (uint32_t)frame->idx;
+
+                obj = &entry->value;
+                node = member + BIN_MEMBER_VALUE;
+                frame->idx++;
+                continue;
+            }
+
+            qsort(frame->order, count, sizeof(bin_sort_entry_t), bin_sort_compare);
+
+            size_t index = frame->body + count * BIN_MEMBER_SIZE;
+            for (size_t i = 0; i < count; i++) {
+                memcpy(w->buf + index + i * sizeof(uint32_t), &frame->order[i].idx, sizeof(uint32_t));
+            }
+
+            bin_put_node(w, frame->node, '{', (uint32_t)count, frame->body);
+            JSON_FREE(frame->order);
+            len--;
+        }
+
+        if (obj == NULL) break;
+    }
+
+done:
+    while (len > 0) {
+        JSON_FREE(frames[--len].order);
+    }
+
+    if (frames != local) {
+        JSON_FREE(frames);
+    }
+
+    return rc;
+}
+
+/**
+ * @brief - Encodes a value into a newly allocated binary image
+ * @param obj - the value to encode
+ * @param out - set to the image, release it with JSON_FREE
+ * @param len - set to the size of the image
+ * @return 0 on success
+ * @return ALLOCATION_FAILED on failure
+ * @return UNEXPECTED_TOKEN if a string or container is too large for its 32 bit length
+ */
+int json_binary_write(const json_object_t* obj, char** out, size_t* len) {
+    bin_writer_t w;
+    memset(&w, 0, sizeof(w));
+    w.seed = json_hash_seed();
+
+    // The header is the first reservation, so offset 0 never names anything else
+    int rc = ALLOCATION_FAILED;
+    if (bin_reserve(&w, BIN_HEADER_SIZE) == 0 && w.buf != NULL) {
+        rc = bin_encode(&w, obj, BIN_ROOT_OFFSET);
+    }
+    JSON_FREE(w.keys);
 
-            case '"':
-                tok.tag = QUOTATION;
-                break;
+    if (rc != 0) {
+        JSON_FREE(w.buf);
+        return rc;
+    }
 
-            case ' ':
-            case '\t':
-            case '\n':
-                while (is_whitespace(json[idx])) idx++;
-                flag = 0;
-                break;
+    uint32_t version = JSON_BINARY_VERSION;
+    uint64_t size = w.len;
+    memcpy(w.buf, "CJB1", 4);
+    memcpy(w.buf + 4, &version, sizeof(version));
+    memcpy(w.buf + 8, &w.seed, sizeof(w.seed));
+    memcpy(w.buf + 16, &size, sizeof(size));
 
-            default:
-                if (is_alphabetic(json[idx])) {
-                    const char* start = json + idx;
+    *out = w.buf;
+    *len = w.len;
+    return 0;
+}
 
-                    while (is_alphanumeric(json[idx])) {
-                        idx++;
-                        tok.len++;
-                    }
+/**
+ * @brief - Encodes a value and writes the image to a file
+ * @param obj - the value to encode
+ * @param path - path of the file to create or replace
+ * @return 0 on success
+ * @return IO_ERROR if the file could not be written, or any error of `json_binary_write`
+ */
+int json_binary_write_file(const json_object_t* obj, const char* path) {
+    char* image;
+    size_t len;
+    int rc = json_binary_write(obj, &image, &len);
+    if (rc != 0) {
+        return rc;
+    }
 
-                    idx--;
-                    tok.tag = STR;
-                    tok.len--;
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        JSON_FREE(image);
+        return IO_ERROR;
+    }
 
-                    char buf[tok.len + 1];
-                    strncpy(buf, start, tok.len);
-                    buf[tok.len] = '\0';
+    size_t written = 0;
+    while (written < len) {
+        ssize_t n = write(fd, image + written, len - written);
+        if (n <= 0) {
+            rc = IO_ERROR;
+            break;
+        }
+        written += (size_t)n;
+    }
 
-                    if (strcmp(buf, "true") == 0) {
-                        tok.tag = TRUE;
-                    } else if (strcmp(buf, "false") == 0) {
-                        tok.tag = FALSE;
-                    } else if (strcmp(buf, "null") == 0) {
-                        tok.tag = NULL_TAG;
-                    }
+    if (close(fd) != 0) {
+        rc = IO_ERROR;
+    }
 
-                } else if (is_numeric(json[idx])) {
-                    while (is_numeric(json[idx]) || json[idx] == '.') {
-                        idx++;
-                        tok.len++;
-                    }
-                    tok.tag = NUM;
-                    idx--;
-                    tok.len--;
+    JSON_FREE(image);
+    return rc;
+}
 
-                } else {
-                    return 1;
-                }
+/**
+ * @brief - Opens an image held in memory without copying or decoding it, the buffer has to outlive the image
+ * @param bin - pointer to the image to populate
+ * @param data - start of the image
+ * @param len - size of the buffer
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the buffer does not hold an image of this version
+ */
+int json_binary_t_open(json_binary_t* bin, const char* data, size_t len) {
+    bin->data = NULL;
+    bin->len = 0;
+    bin->seed = 0;
+    bin->mapped = 0;
 
-                break;
-        }
+    if (data == NULL || len < BIN_HEADER_SIZE || memcmp(data, "CJB1", 4) != 0) {
+        return UNEXPECTED_TOKEN;
+    }
 
-        if (flag) {
-            token_stream_t_push(stream, tok);
-            idx++;
-        }
+    // Read back natively, so an image from a host of the other byte order fails here too
+    uint32_t version;
+    uint64_t size;
+    memcpy(&version, data + 4, sizeof(version));
+    memcpy(&size, data + 16, sizeof(size));
+    if (version != JSON_BINARY_VERSION || size != len) {
+        return UNEXPECTED_TOKEN;
     }
 
+    bin->data = data;
+    bin->len = len;
+    memcpy(&bin->seed, data + 8, sizeof(bin->seed));
     return 0;
 }
 
 /**
- * @brief prints the token out
- * @param t - pointer to the token to print
+ * @brief - Maps an image file read only and opens it in place, pages are only read once they are queried
+ * @param bin - pointer to the image to populate
+ * @param path - path of the image file
+ * @return 0 on success
+ * @return IO_ERROR if the file could not be mapped
+ * @return UNEXPECTED_TOKEN if the file does not hold an image of this version
  */
-void token_t_print(token_t* t) {
-    const char* tag;
+int json_binary_t_open_file(json_binary_t* bin, const char* path) {
+    bin->data = NULL;
+    bin->len = 0;
+    bin->mapped = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return IO_ERROR;
+    }
 
-    switch (t->tag) {
-        case OPEN_BRACE:
-            tag = "OPEN_BRACE";
-            break;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return IO_ERROR;
+    }
 
-        case CLOSE_BRACE:
-            tag = "CLOSE_BRACE";
-            break;
+    if ((size_t)st.st_size < BIN_HEADER_SIZE) {
+        close(fd);
+        return UNEXPECTED_TOKEN;
+    }
 
-        case OPEN_BRACKET:
-            tag = "OPEN_BRACKET";
-            break;
+    // Unlike `json_mapped_file_t` nothing is prefaulted, opening costs the same however big the image is
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
 
-        case CLOSE_BRACKET:
-            tag = "CLOSE_BRACKET";
-            break;
+    if (data == MAP_FAILED) {
+        return IO_ERROR;
+    }
 
-        case QUOTATION:
-            tag = "QUOTATION";
-            break;
+#ifdef MADV_RANDOM
+    madvise(data, (size_t)st.st_size, MADV_RANDOM);
+#endif
 
-        case COMMA:
-            tag = "COMMA";
-            break;
+    int rc = json_binary_t_open(bin, data, (size_t)st.st_size);
+    if (rc != 0) {
+        munmap(data, (size_t)st.st_size);
+        return rc;
+    }
 
-        case NUM:
-            tag = "NUM";
-            break;
+    bin->mapped = 1;
+    return 0;
+}
 
-        case TRUE:
-            tag = "TRUE";
-            break;
+/**
+ * @brief - Releases the mapping of an image opened with `json_binary_t_open_file`, refs into it become invalid
+ * @param bin - pointer to the image to close
+ */
+void json_binary_t_close(json_binary_t* bin) {
+    if (bin->mapped) {
+        munmap((void*)bin->data, bin->len);
+    }
 
-        case COLON:
-            tag = "COLON";
-            break;
+    bin->data = NULL;
+    bin->len = 0;
+    bin->mapped = 0;
+}
 
-        case FALSE:
-            tag = "FALSE";
-            break;
+/**
+ * @brief - A node read out of an image
+ */
+typedef struct {
+    char type;
+    uint32_t len;
+    uint64_t payload;
+} bin_node_t;
+
+// Checks that `count` items of `size` bytes at `off` lie inside the image, counts are 32 bit so this cannot overflow
+static inline int bin_span(const json_binary_t* bin, uint64_t off, uint64_t count, uint64_t size) {
+    return off <= bin->len && count * size <= bin->len - off;
+}
 
-        case NULL_TAG:
-            tag = "NULL_TAG";
-            break;
+// Reads the node at `off`, anything outside the image reads as null
+static inline bin_node_t bin_node(const json_binary_t* bin, size_t off) {
+    bin_node_t node = { 'n', 0, 0 };
+    if (bin->data == NULL || !bin_span(bin, off, 1, BIN_NODE_SIZE)) {
+        return node;
+    }
 
-        case STR:
-            tag = "STR";
-            break;
+    node.type = bin->data[off];
+    memcpy(&node.len, bin->data + off + 4, sizeof(node.len));
+    memcpy(&node.payload, bin->data + off + 8, sizeof(node.payload));
+
+    // Containers and strings whose contents run past the end are treated as null too. Bodies are always written after
+    // their node, so requiring that keeps a damaged image from sending a walk around in circles
+    int container = node.type == '[' || node.type == '{';
+    if ((container && node.payload <= off) ||
+        (node.type == '[' && !bin_span(bin, node.payload, node.len, BIN_NODE_SIZE)) ||
+        (node.type == '{' && !bin_span(bin, node.payload, node.len, BIN_MEMBER_SIZE + sizeof(uint32_t))) ||
+        (node.type == 's' && !bin_span(bin, node.payload, (uint64_t)node.len + 1, 1))) {
+        node.type = 'n';
+    }
+
+    return node;
+}
+
+// Reads a member's key, returning NULL if it runs past the end of the image
+static const char* bin_member_key(const json_binary_t* bin, size_t member, size_t* len) {
+    uint64_t off;
+    uint32_t key_len;
+    memcpy(&off, bin->data + member + 8, sizeof(off));
+    memcpy(&key_len, bin->data + member + 16, sizeof(key_len));
 
+    if (!bin_span(bin, off, (uint64_t)key_len + 1, 1)) {
+        return NULL;
     }
 
-    printf("%s - %d\n", tag, t->len);
+    *len = key_len;
+    return bin->data + off;
 }
 
 /**
- * @brief prints the token's value within a buffer
- * @param t - pointer to the token to print
+ * @brief - Returns the top level value of an image
+ * @param bin - pointer to the opened image
+ * @return reference to the root value
  */
-void token_t_src_print(token_t* t) {
-    for (int offset = 0; offset < t->len; offset++) {
-        printf("%c", (t->start + offset)[0]);
-    }
+json_binary_ref_t json_binary_t_root(const json_binary_t* bin) {
+    json_binary_ref_t ref = { bin, BIN_ROOT_OFFSET };
+    return ref;
 }
 
-static int parse_value(token_stream_t* s, int* idx, json_object_t* obj);
-static int parse_object(token_stream_t* s, int* idx, json_object_t* obj);
-static int parse_number(token_stream_t* s, int* idx, json_object_t* obj);
-static int parse_boolean(token_stream_t* s, int* idx, json_object_t* obj);
-static int parse_null(token_stream_t* s, int* idx, json_object_t* obj);
-static int parse_string(token_stream_t* s, int* idx, json_object_t* obj);
-
-static int parse_object(token_stream_t* s, int* idx, json_object_t* obj) {
-    obj->tag = OBJECT;
-    json_object_map_t* map = malloc(sizeof(json_object_map_t));
-    obj->val.obj = map;
-    json_object_map_t_init(obj->val.obj);
+/**
+ * @brief - Returns what kind of value a reference points at
+ * @param ref - the value
+ * @return OBJECT, ARRAY, STRING, INTEGER, NUMBER, BOOLEAN or NULL_VAL, NULL_VAL for a node outside the image
+ */
+value_tag_t json_binary_ref_t_tag(json_binary_ref_t ref) {
+    switch (bin_node(ref.bin, ref.off).type) {
+        case '{': return OBJECT;
+        case '[': return ARRAY;
+        case 's': return STRING;
+        case 'l': return INTEGER;
+        case 'd': return NUMBER;
+        case 't':
+        case 'f': return BOOLEAN;
+        default: return NULL_VAL;
+    }
+}
 
-    // Skip {
-    (*idx)++;
+/**
+ * @brief - Returns the number of members of an object or elements of an array
+ * @param ref - the container
+ * @return the count, 0 for anything that is not a container
+ */
+size_t json_binary_ref_t_len(json_binary_ref_t ref) {
+    bin_node_t node = bin_node(ref.bin, ref.off);
+    return node.type == '{' || node.type == '[' ? node.len : 0;
+}
 
-    while (*idx < s->len) {
-        token_t* t = &s->items[*idx];
+/**
+ * @brief - Looks up an object member with a binary search over its hash sorted index
+ * @param ref - the object
+ * @param key - name of the member
+ * @param key_len - length of key
+ * @param out - set to the member's value
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an object or the key is missing
+ */
+int json_binary_ref_t_get_n(json_binary_ref_t ref, const char* key, size_t key_len, json_binary_ref_t* out) {
+    const json_binary_t* bin = ref.bin;
+    bin_node_t node = bin_node(bin, ref.off);
+    if (node.type != '{') {
+        return UNEXPECTED_TOKEN;
+    }
 
-        if (t->tag == CLOSE_BRACE) {
-            (*idx)++;
-            return 0;
+    uint64_t hash = json_hash(key, key_len, bin->seed);
+    const char* members = bin->data + node.payload;
+    const char* index = members + (size_t)node.len * BIN_MEMBER_SIZE;
+
+    // Lower bound of the hash in the sorted index, then every member sharing it is compared
+    size_t lo = 0;
+    size_t hi = node.len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        uint32_t idx;
+        memcpy(&idx, index + mid * sizeof(uint32_t), sizeof(idx));
+        if (idx >= node.len) {
+            return UNEXPECTED_TOKEN;
         }
 
-        json_object_t key_obj;
-        parse_string(s, idx, &key_obj);
-        char* key = key_obj.val.str;
+        if (read_u64(members + (size_t)idx * BIN_MEMBER_SIZE) < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
 
-        t = &s->items[*idx];
-        if (t->tag != COLON) {
-            free(key);
+    for (; lo < node.len; lo++) {
+        uint32_t idx;
+        memcpy(&idx, index + lo * sizeof(uint32_t), sizeof(idx));
+        if (idx >= node.len) {
             return UNEXPECTED_TOKEN;
         }
-        (*idx)++;
 
-        json_object_t val_obj;
-        parse_value(s, idx, &val_obj);
-        
-        json_object_map_t_insert(obj->val.obj, key, &val_obj);
-        free(key);
-        
-        t = &s->items[*idx];
-        if (t->tag == COMMA) {
-            (*idx)++;
-        } else if (t->tag != CLOSE_BRACE) {
-            return UNEXPECTED_TOKEN;
+        size_t member = node.payload + (size_t)idx * BIN_MEMBER_SIZE;
+        if (read_u64(bin->data + member) != hash) {
+            break;
+        }
+
+        size_t len;
+        const char* name = bin_member_key(bin, member, &len);
+        if (name != NULL && len == key_len && memcmp(name, key, key_len) == 0) {
+            out->bin = bin;
+            out->off = member + BIN_MEMBER_VALUE;
+            return 0;
         }
     }
 
-    return 0;
+    return UNEXPECTED_TOKEN;
 }
 
-static int parse_number(token_stream_t* s, int* idx, json_object_t* obj) {
-    token_t* t = &s->items[*idx];
-    const char* start = t->start;
+/**
+ * @brief - Looks up an object member by a null terminated key, see `json_binary_ref_t_get_n`
+ * @param ref - the object
+ * @param key - name of the member
+ * @param out - set to the member's value
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an object or the key is missing
+ */
+int json_binary_ref_t_get(json_binary_ref_t ref, const char* key, json_binary_ref_t* out) {
+    return json_binary_ref_t_get_n(ref, key, strlen(key), out);
+}
 
-    char buf[t->len + 1];
-    strncpy(buf, start, t->len);
-    buf[t->len] = '\0';
+/**
+ * @brief - Returns an array element
+ * @param ref - the array
+ * @param idx - index of the element
+ * @param out - set to the element
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if `ref` is not an array
+ * @return INDEX_GREATER_THAN_LEN if `idx` is out of bounds
+ */
+int json_binary_ref_t_at(json_binary_ref_t ref, size_t idx, json_binary_ref_t* out) {
+    bin_node_t node = bin_node(ref.bin, ref.off);
+    if (node.type != '[') {
+        return UNEXPECTED_TOKEN;
+    }
 
-    obj->tag = NUMBER;
-    obj->val.number = strtof(buf, NULL);
+    if (idx >= node.len) {
+        return INDEX_GREATER_THAN_LEN;
+    }
 
-    (*idx)++;
+    out->bin = ref.bin;
+    out->off = node.payload + idx * BIN_NODE_SIZE;
     return 0;
 }
 
-static int parse_boolean(token_stream_t* s, int* idx, json_object_t* obj) {
-    token_t* t = &s->items[*idx];
-    obj->tag = BOOLEAN;
+/**
+ * @brief - Reads a string value straight out of the image
+ * @param ref - the value
+ * @param len - set to the length of the string, may be NULL
+ * @return pointer to the null terminated string
+ * @return NULL if the value is not a string
+ */
+const char* json_binary_ref_t_string(json_binary_ref_t ref, size_t* len) {
+    bin_node_t node = bin_node(ref.bin, ref.off);
+    if (node.type != 's') {
+        return NULL;
+    }
+
+    if (len != NULL) {
+        *len = node.len;
+    }
 
-    switch (t->tag) {
-        case TRUE:
-            obj->val.boolean = 1;
-            break;
+    return ref.bin->data + node.payload;
+}
 
-        case FALSE:
-            obj->val.boolean = 0;
-            break;
-    
-        default:
-            // Should technically be unreachable
-            return UNEXPECTED_TOKEN;
-            break;
+/**
+ * @brief - Reads a number as a double
+ * @param ref - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a number
+ */
+int json_binary_ref_t_double(json_binary_ref_t ref, double* out) {
+    bin_node_t node = bin_node(ref.bin, ref.off);
+    if (node.type == 'd') {
+        memcpy(out, &node.payload, sizeof(double));
+        return 0;
     }
 
-    (*idx)++;
+    if (node.type == 'l') {
+        *out = (double)(int64_t)node.payload;
+        return 0;
+    }
+
+    return UNEXPECTED_TOKEN;
+}
+
+/**
+ * @brief - Reads an integer
+ * @param ref - the value
+ * @param out - set to the number
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not an INTEGER
+ */
+int json_binary_ref_t_int64(json_binary_ref_t ref, int64_t* out) {
+    bin_node_t node = bin_node(ref.bin, ref.off);
+    if (node.type != 'l') {
+        return UNEXPECTED_TOKEN;
+    }
+
+    *out = (int64_t)node.payload;
     return 0;
 }
 
-static int parse_null(token_stream_t* s, int* idx, json_object_t* obj) {
-    obj->tag = NULL_VAL;
-    (*idx)++;
+/**
+ * @brief - Reads a boolean
+ * @param ref - the value
+ * @param out - set to 1 for true and 0 for false
+ * @return 0 on success
+ * @return UNEXPECTED_TOKEN if the value is not a boolean
+ */
+int json_binary_ref_t_boolean(json_binary_ref_t ref, int* out) {
+    bin_node_t node = bin_node(ref.bin, ref.off);
+    if (node.type != 't' && node.type != 'f') {
+        return UNEXPECTED_TOKEN;
+    }
+
+    *out = node.type == 't';
     return 0;
 }
 
-static int parse_string(token_stream_t* s, int* idx, json_object_t* obj) {
-    // skip the "
-    (*idx)++;
+/**
+ * @brief - Starts walking an object or array, members come back in their original order
+ * @param it - pointer to the iterator to initialize
+ * @param ref - the container, anything else yields no members
+ */
+void json_binary_iter_t_init(json_binary_iter_t* it, json_binary_ref_t ref) {
+    bin_node_t node = bin_node(ref.bin, ref.off);
+
+    it->bin = ref.bin;
+    it->body = node.payload;
+    it->idx = 0;
+    it->len = node.type == '{' || node.type == '[' ? node.len : 0;
+    it->is_object = node.type == '{';
+}
 
-    token_t* t = &s->items[*idx];
-    if(t->tag != STR) {
-        return UNEXPECTED_TOKEN;
+/**
+ * @brief - Moves to the next member or element
+ * @param it - pointer to the iterator
+ * @param key - set to the member's key, or NULL for array elements, may be NULL
+ * @param key_len - set to the length of the key, may be NULL
+ * @param value - set to the member's value
+ * @return 1 if a member was produced
+ * @return 0 once the container is exhausted
+ */
+int json_binary_iter_t_next(json_binary_iter_t* it, const char** key, size_t* key_len, json_binary_ref_t* value) {
+    if (it->idx >= it->len) {
+        return 0;
     }
 
-    const char* start = t->start;
+    const char* name = NULL;
+    size_t name_len = 0;
+    value->bin = it->bin;
 
-    char* buf = malloc((t->len + 1) * sizeof(char));
-    strncpy(buf, start, t->len);
-    buf[t->len] = '\0';
+    if (it->is_object) {
+        size_t member = it->body + it->idx * BIN_MEMBER_SIZE;
+        name = bin_member_key(it->bin, member, &name_len);
+        if (name == NULL) {
+            return 0;
+        }
+        value->off = member + BIN_MEMBER_VALUE;
+    } else {
+        value->off = it->body + it->idx * BIN_NODE_SIZE;
+    }
 
-    obj->tag = STRING;
-    obj->val.str = buf;
+    if (key != NULL) *key = name;
+    if (key_len != NULL) *key_len = name_len;
 
-    // skip the " again and move on
-    (*idx) += 2;
-    return 0;
+    it->idx++;
+    return 1;
 }
 
-static int parse_value(token_stream_t* s, int* idx, json_object_t* obj) {
-    if (*idx >= s->len) return INDEX_GREATER_THAN_LEN;
-    token_t* t = &s->items[*idx];
-    switch (t->tag) {
-        case OPEN_BRACE:
-            parse_object(s, idx, obj);
-            break;
+// Writes a scalar of a binary image, or the opening bracket of a container
+static int write_binary_scalar(json_writer_t* w, const simd_kernels_t* kernels, json_binary_ref_t ref, bin_node_t node) {
+    char num[32];
 
-        case QUOTATION:
-            parse_string(s, idx, obj);
-            break;
+    switch (node.type) {
+        case 't':
+            return writer_append(w, "true", 4);
 
-        case NUM:
-            parse_number(s, idx, obj);
-            break;
+        case 'f':
+            return writer_append(w, "false", 5);
 
-        case TRUE:
-        case FALSE:
-            parse_boolean(s, idx, obj);
-            break;
+        case 'l':
+            return writer_append(w, num, format_int64((int64_t)node.payload, num));
 
-        case NULL_TAG:
-            parse_null(s, idx, obj);
-            break;
+        case 'd': {
+            double d;
+            memcpy(&d, &node.payload, sizeof(d));
+            return writer_append(w, num, format_double(d, num));
+        }
+
+        case 's':
+            return write_string(w, kernels, ref.bin->data + node.payload, node.len);
+
+        case '{':
+            return writer_append(w, "{", 1);
+
+        case '[':
+            return writer_append(w, "[", 1);
 
         default:
-            return UNEXPECTED_TOKEN;
-            break;
+            return writer_append(w, "null", 4);
     }
+}
 
-    return 0;
+// Writes a value of a binary image, keeping the open containers on an explicit stack like `write_value`
+static int write_binary_value(json_writer_t* w, const simd_kernels_t* kernels, json_binary_ref_t ref, size_t depth) {
+    json_binary_iter_t local[JSON_WALK_STACK_SIZE];
+    json_binary_iter_t* frames = local;
+    size_t len = 0;
+    size_t capacity = JSON_WALK_STACK_SIZE;
+    const char* key;
+    size_t key_len;
+    int rc;
+
+    for (;;) {
+        bin_node_t node = bin_node(ref.bin, ref.off);
+        rc = write_binary_scalar(w, kernels, ref, node);
+        if (rc != 0) goto done;
+
+        if (node.type == '{' || node.type == '[') {
+            if (len == capacity) {
+                json_binary_iter_t* grown = walk_stack_grow(frames, local, &capacity, sizeof(json_binary_iter_t));
+                if (grown == NULL) {
+                    rc = ALLOCATION_FAILED;
+                    goto done;
+                }
+                frames = grown;
+            }
+
+            json_binary_iter_t_init(&frames[len], ref);
+            len++;
+        }
+
+        // Close every container that is finished, then move on to the next member of the innermost open one
+        int advanced = 0;
+        while (len > 0 && !advanced) {
+            json_binary_iter_t* it = &frames[len - 1];
+
+            if (!json_binary_iter_t_next(it, &key, &key_len, &ref)) {
+                len--;
+                if (it->len > 0) {
+                    rc = writer_newline(w, depth + len);
+                    if (rc != 0) goto done;
+                }
+
+                rc = writer_append(w, it->is_object ? "}" : "]", 1);
+                if (rc != 0) goto done;
+                continue;
+            }
+
+            if (it->idx > 1) {
+                rc = writer_append(w, ",", 1);
+                if (rc != 0) goto done;
+            }
+
+            rc = writer_newline(w, depth + len);
+            if (rc != 0) goto done;
+
+            if (it->is_object) {
+                rc = write_string(w, kernels, key, key_len);
+                if (rc != 0) goto done;
+
+                rc = (w->flags & JSON_WRITE_PRETTY) ? writer_append(w, ": ", 2) : writer_append(w, ":", 1);
+                if (rc != 0) goto done;
+            }
+
+            advanced = 1;
+        }
+
+        if (!advanced) break;
+    }
+
+done:
+    if (frames != local) {
+        JSON_FREE(frames);
+    }
+
+    return rc;
 }
 
 /**
- * @brief Parses a JSON buffer into a JSON Object
- * @param json - JSON string buffer
- * @param len - length of the JSON string buffer
- * @param obj - pointer to the JSON object to populate
+ * @brief - Serializes a value of a binary image as JSON text, appending it to what the writer already holds
+ * @param w - pointer to the writer
+ * @param ref - the value to write
  * @return 0 on success
- * @return negative number on failure
+ * @return ALLOCATION_FAILED or IO_ERROR on failure
  */
-int json_parse(const char* json, int len, json_object_t* obj) {
-    token_stream_t s;
-    tokenize_json(json, len, &s);
-
-    int idx = 0;
-
-    int return_code = parse_value(&s, &idx, obj);
+int json_writer_t_write_binary(json_writer_t* w, json_binary_ref_t ref) {
+    int rc = write_binary_value(w, simd_kernels(), ref, 0);
+    if (rc != 0) {
+        return rc;
+    }
 
-    token_stream_t_deinit(&s);
-    return return_code;
+    return json_writer_t_flush(w);
 }
 
 /**
- * @brief Frees all memory tied to the JSON Object if it had any heap stored values (sub-objects or strings)
- * Does not free the underlying pointer
- * @param json - JSON object to deinit
+ * @brief - Converts a value of a binary image back into a newly allocated JSON string
+ * @param ref - the value to write
+ * @param flags - `JSON_WRITE_*` flags
+ * @param out - set to the string, release it with JSON_FREE
+ * @param len - set to the length of the string, may be NULL
+ * @return 0 on success
+ * @return ALLOCATION_FAILED on failure
  */
-void json_deinit(json_object_t* json) {
-    switch (json->tag) {
-        case STRING:
-            free(json->val.str);
-            break;
+int json_binary_ref_t_to_json(json_binary_ref_t ref, unsigned int flags, char** out, size_t* len) {
+    json_writer_t w;
+    json_writer_t_init(&w, flags);
 
-        case OBJECT:
-            json_object_map_t_deinit(json->val.obj);
-            free(json->val.obj);
-            break;
+    int rc = json_writer_t_write_binary(&w, ref);
+    if (rc == 0) {
+        rc = writer_reserve(&w, 1);
+    }
 
-        case NUMBER: 
-        case BOOLEAN:
-        case NULL_VAL:
-        default:
-            break;
+    if (rc != 0) {
+        json_writer_t_deinit(&w);
+        return rc;
     }
+
+    w.buf[w.len] = '\0';
+    *out = w.buf;
+    if (len != NULL) {
+        *len = w.len;
+    }
+
+    return 0;
 }
 
 #endif //JSON_H
@@ -0,0 +1,39 @@
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+int main () {
+    const char* json = "{\"person\":{\"name\": \"Teller\", \"age\":7}, \"is_awesome\":true}";
+    json_document_t doc;
+    json_document_t_init(&doc);
+
+    if (json_document_t_parse(&doc, json, strlen(json)) != 0) {
+        return 1;
+    }
+
+    json_object_map_t* person = json_object_map_t_get(doc.root.val.obj, "person")->val.obj;
+
+    printf("Name: %s\n", json_object_map_t_get(person, "name")->val.str);
+    printf("Age: %lld\n", (long long)json_object_map_t_get(person, "age")->val.integer);
+
+    printf("Allocations: %zu in %zu block(s), %zu bytes used of %zu reserved\n",
+           doc.arena.alloc_count, doc.arena.block_count, doc.arena.bytes_allocated, doc.arena.bytes_reserved);
+
+    if (doc.arena.block_count != 1 || doc.arena.alloc_count == 0) {
+        return 1;
+    }
+
+    // Big allocations still come out of the arena
+    void* big = json_arena_t_alloc(&doc.arena, JSON_ARENA_BLOCK_SIZE * 4);
+    memset(big, 0, JSON_ARENA_BLOCK_SIZE * 4);
+
+    char* grown = json_arena_t_alloc(&doc.arena, 8);
+    strcpy(grown, "1234567");
+    grown = json_arena_t_realloc(&doc.arena, grown, 8, 64);
+    if (strcmp(grown, "1234567") != 0) {
+        return 1;
+    }
+
+    json_document_t_deinit(&doc);
+    return 0;
+}
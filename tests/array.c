@@ -0,0 +1,85 @@
+#include "../json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main () {
+    const char* json = "{\"name\": \"series\", \"points\": [1.5, 2, -3e2], \"tags\": [\"a\", [\"b\", {}], []]}";
+    json_object_t obj;
+
+    if (json_parse(json, strlen(json), &obj) != 0) {
+        return 1;
+    }
+
+    json_array_t* points = json_object_map_t_get(obj.val.obj, "points")->val.arr;
+    double values[3];
+    if (points->len != 3 || json_array_t_copy_doubles(points, values) != 0) {
+        return 1;
+    }
+    printf("Points: %g %g %g\n", values[0], values[1], values[2]);
+
+    json_array_t* tags = json_object_map_t_get(obj.val.obj, "tags")->val.arr;
+    for (size_t i = 0; i < tags->len; i++) {
+        json_object_t* tag = &tags->items[i];
+        printf("Tag %zu: %s\n", i, tag->tag == STRING ? tag->val.str : tag->tag == ARRAY ? "(array)" : "?");
+    }
+
+    json_object_t* nested = json_array_t_get(json_array_t_get(tags, 1)->val.arr, 0);
+    if (nested == NULL || nested->tag != STRING || strcmp(nested->val.str, "b") != 0 || json_array_t_get(tags, 3) != NULL) {
+        return 1;
+    }
+
+    if (json_array_t_copy_doubles(tags, values) != UNEXPECTED_TOKEN) {
+        return 1;
+    }
+
+    json_deinit(&obj);
+
+    // A large numeric array parsed into an arena is one exact size buffer
+    size_t count = 100000;
+    char* big = malloc(count * 12 + 2);
+    size_t n = 0;
+    big[n++] = '[';
+    for (size_t i = 0; i < count; i++) {
+        n += sprintf(big + n, "%s%zu.5", i == 0 ? "" : ",", i);
+    }
+    big[n++] = ']';
+
+    json_document_t doc;
+    json_document_t_init(&doc);
+    if (json_document_t_parse(&doc, big, n) != 0 || doc.root.tag != ARRAY || doc.root.val.arr->len != count
+            || doc.root.val.arr->capacity != count) {
+        return 1;
+    }
+
+    double* all = malloc(count * sizeof(double));
+    json_array_t_copy_doubles(doc.root.val.arr, all);
+    for (size_t i = 0; i < count; i++) {
+        if (all[i] != i + 0.5) {
+            printf("element %zu is %g\n", i, all[i]);
+            return 1;
+        }
+    }
+    printf("Parsed %zu numbers from %zu arena blocks\n", count, doc.arena.block_count);
+
+    free(all);
+    free(big);
+    json_document_t_deinit(&doc);
+
+    // Arrays built by hand grow geometrically and own what is pushed into them
+    json_array_t arr;
+    json_array_t_init(&arr);
+    for (int i = 0; i < 100; i++) {
+        json_object_t val;
+        val.tag = STRING;
+        val.val.str = malloc(16);
+        val.val.view.len = sprintf(val.val.str, "item%d", i);
+        if (json_array_t_push(&arr, &val) != 0) {
+            return 1;
+        }
+    }
+
+    printf("Built %zu items, capacity %zu, last %s\n", arr.len, arr.capacity, json_array_t_get(&arr, 99)->val.str);
+    json_array_t_deinit(&arr);
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../json.h"
+
+static const char* json =
+    "{\"name\": \"Teller\", \"age\": 7, \"ratio\": 0.5, \"is_awesome\": true, \"nothing\": null, "
+    "\"tags\": [\"magic\", \"cards\", \"caf\\u00e9\"], "
+    "\"shows\": [{\"city\": \"Vegas\", \"nights\": 300}, {\"city\": \"Reno\", \"nights\": -2}], \"empty\": {}, \"none\": []}";
+
+int main () {
+    int failed = 0;
+
+    json_object_t obj;
+    if (json_parse(json, strlen(json), &obj) != 0) {
+        return 1;
+    }
+
+    char* image;
+    size_t image_len;
+    if (json_binary_write(&obj, &image, &image_len) != 0) {
+        return 1;
+    }
+
+    json_binary_t bin;
+    if (json_binary_t_open(&bin, image, image_len) != 0) {
+        printf("open\n");
+        return 1;
+    }
+
+    // Lookups read straight out of the image
+    json_binary_ref_t root = json_binary_t_root(&bin);
+    json_binary_ref_t v;
+    int64_t i;
+    double d;
+    int b;
+    size_t len;
+
+    if (json_binary_ref_t_tag(root) != OBJECT || json_binary_ref_t_len(root) != 9) {
+        printf("root\n");
+        failed = 1;
+    }
+
+    if (json_binary_ref_t_get(root, "name", &v) != 0 || strcmp(json_binary_ref_t_string(v, &len), "Teller") != 0 || len != 6) {
+        printf("name\n");
+        failed = 1;
+    }
+
+    if (json_binary_ref_t_get(root, "age", &v) != 0 || json_binary_ref_t_int64(v, &i) != 0 || i != 7 ||
+        json_binary_ref_t_double(v, &d) != 0 || d != 7.0) {
+        printf("age\n");
+        failed = 1;
+    }
+
+    if (json_binary_ref_t_get(root, "ratio", &v) != 0 || json_binary_ref_t_double(v, &d) != 0 || d != 0.5 ||
+        json_binary_ref_t_int64(v, &i) != UNEXPECTED_TOKEN) {
+        printf("ratio\n");
+        failed = 1;
+    }
+
+    if (json_binary_ref_t_get(root, "is_awesome", &v) != 0 || json_binary_ref_t_boolean(v, &b) != 0 || b != 1 ||
+        json_binary_ref_t_get(root, "nothing", &v) != 0 || json_binary_ref_t_tag(v) != NULL_VAL) {
+        printf("literals\n");
+        failed = 1;
+    }
+
+    json_binary_ref_t shows, show;
+    if (json_binary_ref_t_get(root, "shows", &shows) != 0 || json_binary_ref_t_at(shows, 1, &show) != 0 ||
+        json_binary_ref_t_get(show, "nights", &v) != 0 || json_binary_ref_t_int64(v, &i) != 0 || i != -2 ||
+        json_binary_ref_t_at(shows, 2, &show) != INDEX_GREATER_THAN_LEN) {
+        printf("nested\n");
+        failed = 1;
+    }
+
+    if (json_binary_ref_t_get(root, "missing", &v) != UNEXPECTED_TOKEN || json_binary_ref_t_get(shows, "city", &v) != UNEXPECTED_TOKEN ||
+        json_binary_ref_t_get_n(root, "names", 4, &v) != 0) {
+        printf("missing key\n");
+        failed = 1;
+    }
+
+    // Iteration keeps the original member order
+    const char* order[] = { "name", "age", "ratio", "is_awesome", "nothing", "tags", "shows", "empty", "none" };
+    json_binary_iter_t it;
+    json_binary_iter_t_init(&it, root);
+    const char* key;
+    size_t key_len;
+    size_t n = 0;
+    while (json_binary_iter_t_next(&it, &key, &key_len, &v)) {
+        if (n >= 9 || strlen(order[n]) != key_len || memcmp(order[n], key, key_len) != 0) {
+            printf("iteration order\n");
+            failed = 1;
+            break;
+        }
+        n++;
+    }
+    if (n != 9) {
+        printf("iteration count\n");
+        failed = 1;
+    }
+
+    // Converting back gives the same text as writing the tree
+    unsigned int flags[] = { 0, JSON_WRITE_PRETTY };
+    for (size_t f = 0; f < 2; f++) {
+        char* expected;
+        char* actual;
+        json_write(&obj, flags[f], &expected, NULL);
+        json_binary_ref_t_to_json(root, flags[f], &actual, NULL);
+        if (strcmp(expected, actual) != 0) {
+            printf("to json %zu:\n%s\n%s\n", f, expected, actual);
+            failed = 1;
+        }
+        JSON_FREE(expected);
+        JSON_FREE(actual);
+    }
+
+    // Repeated keys are stored once
+    const char* repeated = "[{\"a_long_repeated_key\": 1}, {\"a_long_repeated_key\": 2}, {\"a_long_repeated_key\": 3}]";
+    const char* single = "[{\"a_long_repeated_key\": 1}, {\"b\": 2}, {\"c\": 3}]";
+    json_object_t r, s;
+    char* r_image;
+    char* s_image;
+    size_t r_len, s_len;
+    json_parse(repeated, strlen(repeated), &r);
+    json_parse(single, strlen(single), &s);
+    json_binary_write(&r, &r_image, &r_len);
+    json_binary_write(&s, &s_image, &s_len);
+    if (r_len >= s_len) {
+        printf("keys not deduplicated: %zu vs %zu\n", r_len, s_len);
+        failed = 1;
+    }
+    JSON_FREE(r_image);
+    JSON_FREE(s_image);
+    json_deinit(&r);
+    json_deinit(&s);
+
+    // A file is mapped and queried in place
+    char path[] = "/tmp/json_binary_XXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+
+    json_binary_t mapped;
+    if (json_binary_write_file(&obj, path) != 0 || json_binary_t_open_file(&mapped, path) != 0 || !mapped.mapped ||
+        json_binary_ref_t_get(json_binary_t_root(&mapped), "tags", &v) != 0 || json_binary_ref_t_at(v, 2, &v) != 0 ||
+        strcmp(json_binary_ref_t_string(v, NULL), "caf\xc3\xa9") != 0) {
+        printf("mapped file\n");
+        failed = 1;
+    }
+    json_binary_t_close(&mapped);
+    unlink(path);
+
+    // Damaged images are rejected up front
+    json_binary_t bad;
+    if (json_binary_t_open(&bad, image, image_len - 8) != UNEXPECTED_TOKEN || json_binary_t_open(&bad, image, 16) != UNEXPECTED_TOKEN) {
+        printf("truncated image\n");
+        failed = 1;
+    }
+
+    image[0] = 'X';
+    if (json_binary_t_open(&bad, image, image_len) != UNEXPECTED_TOKEN) {
+        printf("bad magic\n");
+        failed = 1;
+    }
+    image[0] = 'C';
+
+    uint32_t version = JSON_BINARY_VERSION + 1;
+    memcpy(image + 4, &version, sizeof(version));
+    if (json_binary_t_open(&bad, image, image_len) != UNEXPECTED_TOKEN) {
+        printf("bad version\n");
+        failed = 1;
+    }
+
+    if (json_binary_t_open_file(&bad, "/tmp/json_binary_does_not_exist") != IO_ERROR) {
+        printf("missing file\n");
+        failed = 1;
+    }
+
+    JSON_FREE(image);
+    json_deinit(&obj);
+    return failed;
+}
@@ -0,0 +1,60 @@
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+int main () {
+    const char* json = "{\"name\": \"Teller\", \"quote\": \"say \\\"hi\\\"\\n\", \"caf\\u00e9\": \"\\ud83d\\ude00\", \"plain\": {\"inner\": \"x\"}}";
+    json_parse_opts_t opts = { .flags = JSON_PARSE_BORROW_STRINGS };
+
+    json_object_t obj;
+    if (json_parse_ex(json, strlen(json), &obj, &opts) != 0) {
+        return 1;
+    }
+
+    json_object_map_t* map = obj.val.obj;
+
+    // Plain strings and keys point into the input
+    json_object_t* name = json_object_map_t_get(map, "name");
+    size_t len;
+    const char* str = json_object_t_string(name, &len);
+    printf("name: %.*s (%s)\n", (int)len, str, name->tag == STRING_VIEW ? "borrowed" : "owned");
+    if (name->tag != STRING_VIEW || str < json || str >= json + strlen(json) || len != 6) {
+        return 1;
+    }
+    if (!(map->entries[0].flags & JSON_ENTRY_BORROWED_KEY)) {
+        return 1;
+    }
+
+    // Escaped strings are decoded into their own buffer
+    json_object_t* quote = json_object_map_t_get(map, "quote");
+    printf("quote: %s", quote->val.str);
+    if (quote->tag != STRING || strcmp(quote->val.str, "say \"hi\"\n") != 0 || quote->val.view.len != 9) {
+        return 1;
+    }
+
+    json_object_t* emoji = json_object_map_t_get(map, "caf\xc3\xa9");
+    if (emoji == NULL || strcmp(emoji->val.str, "\xf0\x9f\x98\x80") != 0) {
+        return 1;
+    }
+    printf("emoji key and surrogate pair decoded\n");
+
+    json_deinit(&obj);
+
+    // Without the flag everything is owned
+    json_parse(json, strlen(json), &obj);
+    if (json_object_map_t_get(obj.val.obj, "name")->tag != STRING) {
+        return 1;
+    }
+    json_deinit(&obj);
+
+    // Broken escapes are rejected
+    const char* bad[] = { "\"\\x\"", "\"\\u12\"", "\"\\ud800\"", "\"\\udc00\"", "\"\\" };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        if (json_parse_ex(bad[i], strlen(bad[i]), &obj, &opts) == 0) {
+            printf("accepted %s\n", bad[i]);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../json.h"
+
+// Builds `depth` nested levels alternating objects and arrays around a single number
+static char* build_document(size_t depth, size_t* len) {
+    char* buf = malloc(depth * 8 + 16);
+    if (buf == NULL) {
+        return NULL;
+    }
+    size_t n = 0;
+
+    for (size_t i = 0; i < depth; i++) {
+        n += sprintf(buf + n, i % 2 == 0 ? "{\"a\":" : "[");
+    }
+    n += sprintf(buf + n, "7");
+    for (size_t i = depth; i > 0; i--) {
+        buf[n++] = (i - 1) % 2 == 0 ? '}' : ']';
+    }
+
+    *len = n;
+    return buf;
+}
+
+// Walks down to the innermost value, returning how many levels it passed
+static size_t walk(const json_object_t* obj, const json_object_t** leaf) {
+    size_t depth = 0;
+    while (obj->tag == OBJECT || obj->tag == ARRAY) {
+        obj = obj->tag == OBJECT ? json_object_map_t_get(obj->val.obj, "a") : json_array_t_get(obj->val.arr, 0);
+        depth++;
+    }
+
+    *leaf = obj;
+    return depth;
+}
+
+int main () {
+    int failed = 0;
+    size_t len;
+    const json_object_t* leaf;
+    json_object_t obj;
+    char* out;
+
+    // The default limit is inclusive
+    char* json = build_document(JSON_PARSE_MAX_DEPTH, &len);
+    if (json == NULL) {
+        return 1;
+    }
+    if (json_parse(json, len, &obj) != 0 || walk(&obj, &leaf) != JSON_PARSE_MAX_DEPTH || leaf->val.integer != 7) {
+        printf("default limit\n");
+        failed = 1;
+    }
+    json_deinit(&obj);
+    free(json);
+
+    json = build_document(JSON_PARSE_MAX_DEPTH + 1, &len);
+    if (json == NULL) {
+        return 1;
+    }
+    int rc = json_parse(json, len, &obj);
+    if (rc != DEPTH_LIMIT_EXCEEDED || obj.tag != NULL_VAL) {
+        printf("default limit exceeded\n");
+        failed = 1;
+    }
+    if (rc == 0) {
+        json_deinit(&obj);
+    }
+    free(json);
+
+    // Deep documents no longer depend on the size of the C stack
+    size_t depth = 100000;
+    json = build_document(depth, &len);
+    if (json == NULL) {
+        return 1;
+    }
+
+    json_document_t doc;
+    json_document_t_init(&doc);
+    json_parser_t parser;
+    json_parser_t_init(&parser);
+
+    json_parse_opts_t opts = { .max_depth = depth };
+    if (json_parser_t_parse_document(&parser, &doc, json, len, &opts) != 0 || walk(&doc.root, &leaf) != depth || leaf->val.integer != 7) {
+        printf("deep document\n");
+        failed = 1;
+    }
+
+    opts.max_depth = depth - 1;
+    if (json_parser_t_parse_document(&parser, &doc, json, len, &opts) != DEPTH_LIMIT_EXCEEDED) {
+        printf("configured limit\n");
+        failed = 1;
+    }
+
+    // The frame stack is kept by the parser, so a second deep parse reuses it
+    size_t frames_capacity = parser.frames_capacity;
+    opts.max_depth = depth;
+    if (json_parser_t_parse_document(&parser, &doc, json, len, &opts) != 0 || parser.frames_capacity != frames_capacity ||
+        frames_capacity < depth) {
+        printf("frame reuse\n");
+        failed = 1;
+    }
+
+    // A deep document cut short fails cleanly
+    if (json_parser_t_parse_document(&parser, &doc, json, len - 10, &opts) != INDEX_GREATER_THAN_LEN || doc.root.tag != NULL_VAL) {
+        printf("truncated deep document\n");
+        failed = 1;
+    }
+
+    json_document_t_deinit(&doc);
+    json_parser_t_deinit(&parser);
+    free(json);
+
+    // Heap trees of any depth are written and released without recursing
+    depth = 200000;
+    json = build_document(depth, &len);
+    if (json == NULL) {
+        return 1;
+    }
+    opts.max_depth = depth;
+    if (json_parse_ex(json, len, &obj, &opts) != 0 || walk(&obj, &leaf) != depth || leaf->val.integer != 7) {
+        printf("deep heap document\n");
+        failed = 1;
+    }
+
+    size_t out_len;
+    out = NULL;
+    if (json_write(&obj, 0, &out, &out_len) != 0 || out_len != len || memcmp(out, json, len) != 0) {
+        printf("deep write\n");
+        failed = 1;
+    }
+    JSON_FREE(out);
+
+    // So are binary images
+    json_binary_t bin;
+    char* image;
+    size_t image_len;
+    if (json_binary_write(&obj, &image, &image_len) != 0) {
+        printf("deep binary write\n");
+        failed = 1;
+    } else {
+        out = NULL;
+        if (json_binary_t_open(&bin, image, image_len) != 0 || json_binary_ref_t_to_json(json_binary_t_root(&bin), 0, &out, &out_len) != 0 ||
+            out_len != len || memcmp(out, json, len) != 0) {
+            printf("deep binary to json\n");
+            failed = 1;
+        }
+        JSON_FREE(out);
+        json_binary_t_close(&bin);
+        JSON_FREE(image);
+    }
+    json_deinit(&obj);
+    free(json);
+
+    // Tapes are capped by SAX, converting one at the cap still takes the explicit stack past its local frames
+    json = build_document(JSON_SAX_MAX_DEPTH, &len);
+    if (json == NULL) {
+        return 1;
+    }
+    json_tape_t tape;
+    json_tape_t_init(&tape);
+    obj.tag = NULL_VAL;
+    if (json_tape_t_parse(&tape, json, len) != 0 || json_tape_ref_t_to_object(json_tape_t_root(&tape), &obj, NULL) != 0 ||
+        walk(&obj, &leaf) != JSON_SAX_MAX_DEPTH || leaf->val.integer != 7) {
+        printf("deep tape conversion\n");
+        failed = 1;
+    }
+    json_deinit(&obj);
+    json_tape_t_deinit(&tape);
+    free(json);
+
+    // Heap trees are released with every level that was already open
+    json = build_document(2000, &len);
+    if (json == NULL) {
+        return 1;
+    }
+    json[len - 500] = 'x';
+    opts.max_depth = 2000;
+    rc = json_parse_ex(json, len, &obj, &opts);
+    if (rc != UNEXPECTED_TOKEN || obj.tag != NULL_VAL) {
+        printf("malformed heap document\n");
+        failed = 1;
+    }
+    if (rc == 0) {
+        json_deinit(&obj);
+    }
+    free(json);
+
+    // Mixed containers still close in the right order
+    const char* mixed = "{\"a\": [1, {\"b\": [[], {}, [2, 3]]}, \"c\"], \"d\": {\"e\": [4]}}";
+    out = NULL;
+    if (json_parse(mixed, strlen(mixed), &obj) != 0 || json_write(&obj, 0, &out, NULL) != 0 ||
+        strcmp(out, "{\"a\":[1,{\"b\":[[],{},[2,3]]},\"c\"],\"d\":{\"e\":[4]}}") != 0) {
+        printf("mixed containers\n");
+        failed = 1;
+    }
+    JSON_FREE(out);
+    json_deinit(&obj);
+
+    const char* mismatched[] = { "[1, 2}", "{\"a\": 1]", "[{]}", "{\"a\": [}" };
+    for (size_t i = 0; i < sizeof(mismatched) / sizeof(mismatched[0]); i++) {
+        rc = json_parse(mismatched[i], strlen(mismatched[i]), &obj);
+        if (rc != UNEXPECTED_TOKEN) {
+            printf("accepted mismatched %s\n", mismatched[i]);
+            failed = 1;
+        }
+        if (rc == 0) {
+            json_deinit(&obj);
+        }
+    }
+
+    return failed;
+}
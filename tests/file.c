@@ -0,0 +1,50 @@
+#include "../json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main () {
+    char path[] = "/tmp/json_file_testXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return 1;
+    }
+
+    const char* json = "{\"person\":{\"name\": \"Teller\", \"age\":7}, \"is_awesome\":true}\n";
+    if (write(fd, json, strlen(json)) != (ssize_t)strlen(json)) {
+        return 1;
+    }
+    close(fd);
+
+    json_object_t obj;
+    if (json_parse_file(path, &obj) != 0) {
+        return 1;
+    }
+
+    json_object_map_t* person = json_object_map_t_get(obj.val.obj, "person")->val.obj;
+    printf("Name: %s\n", json_object_map_t_get(person, "name")->val.str);
+    json_deinit(&obj);
+
+    json_document_t doc;
+    json_document_t_init(&doc);
+    if (json_document_t_parse_file(&doc, path) != 0) {
+        return 1;
+    }
+    printf("Awesome: %d\n", json_object_map_t_get(doc.root.val.obj, "is_awesome")->val.boolean);
+    json_document_t_deinit(&doc);
+
+    // Missing and empty files fail cleanly
+    int rc = json_parse_file("/nonexistent/file.json", &obj);
+    printf("Missing file: %d\n", rc);
+    if (rc != IO_ERROR) {
+        return 1;
+    }
+
+    fd = open(path, O_WRONLY | O_TRUNC);
+    close(fd);
+    rc = json_parse_file(path, &obj);
+    printf("Empty file: %d\n", rc);
+
+    unlink(path);
+    return rc == INDEX_GREATER_THAN_LEN ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include "../json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RECORDS 5000
+
+static const char* entry_key(json_object_t* obj, size_t i) {
+    return obj->val.obj->entries[i].key;
+}
+
+int main () {
+    int failed = 0;
+
+    json_intern_t intern;
+    if (json_intern_t_init(&intern) != 0) {
+        return 1;
+    }
+
+    // Equal keys always come back as the same pointer, whatever buffer they were read from
+    char a[] = "level";
+    char b[] = "levelx";
+    const char* first = json_intern_t_intern(&intern, a, 5);
+    if (first == a || strcmp(first, "level") != 0 || json_intern_t_intern(&intern, b, 5) != first ||
+        json_intern_t_intern(&intern, b, 6) == first) {
+        printf("canonical pointers\n");
+        failed = 1;
+    }
+
+    // Documents parsed with the table share their keys instead of copying them
+    const char* doc1 = "{\"id\": 1, \"level\": \"info\", \"nested\": {\"id\": 2}, \"l\\u0065vel\": \"dup\"}";
+    const char* doc2 = "{\"level\": \"warn\", \"id\": 3}";
+    json_parse_opts_t opts = { .intern = &intern };
+    json_object_t one, two;
+    if (json_parse_ex(doc1, strlen(doc1), &one, &opts) != 0 || json_parse_ex(doc2, strlen(doc2), &two, &opts) != 0) {
+        return 1;
+    }
+
+    json_object_t* nested = json_object_map_t_get(one.val.obj, "nested");
+    if (one.val.obj->len != 3 || entry_key(&one, 1) != first || entry_key(&two, 0) != first ||
+        entry_key(&one, 0) != entry_key(&two, 1) || entry_key(nested, 0) != entry_key(&two, 1) ||
+        !(one.val.obj->entries[0].flags & JSON_ENTRY_INTERNED_KEY)) {
+        printf("shared keys\n");
+        failed = 1;
+    }
+
+    // The escaped duplicate decoded to the same key and replaced the first value
+    json_object_t* level = json_object_map_t_get(one.val.obj, "level");
+    if (level == NULL || strcmp(level->val.str, "dup") != 0) {
+        printf("escaped key\n");
+        failed = 1;
+    }
+
+    // Freeing the documents leaves the canonical keys alone
+    json_deinit(&one);
+    json_deinit(&two);
+    if (strcmp(first, "level") != 0) {
+        failed = 1;
+    }
+
+    // Escaped keys too long for the stack, and keys that outgrow the first slot table
+    char long_doc[512], long_key[301];
+    memset(long_key, 'k', 300);
+    long_key[300] = '\0';
+    sprintf(long_doc, "{\"%.299s\\u006b\": 1}", long_key);
+    if (json_parse_ex(long_doc, strlen(long_doc), &one, &opts) != 0 ||
+        entry_key(&one, 0) != json_intern_t_intern(&intern, long_key, 300)) {
+        printf("long key\n");
+        failed = 1;
+    }
+    json_deinit(&one);
+
+    for (int i = 0; i < 2000; i++) {
+        char key[16];
+        int len = sprintf(key, "key_%d", i);
+        const char* canonical = json_intern_t_intern(&intern, key, len);
+        if (canonical == NULL || strcmp(canonical, key) != 0 || json_intern_t_intern(&intern, key, len) != canonical) {
+            printf("bulk key %d\n", i);
+            failed = 1;
+            break;
+        }
+    }
+
+    json_intern_stats_t stats;
+    json_intern_t_stats(&intern, &stats);
+    printf("lookups %zu, hits %zu, unique %zu, stored %zu, saved %zu\n",
+           stats.lookups, stats.hits, stats.unique_keys, stats.bytes_stored, stats.bytes_saved);
+    if (stats.unique_keys != 2005 || stats.lookups != stats.hits + stats.unique_keys || stats.bytes_saved == 0) {
+        failed = 1;
+    }
+
+    // Worker threads of a batch share one table
+    char* buf = malloc((size_t)RECORDS * 64);
+    size_t n = 0;
+    for (int i = 0; i < RECORDS; i++) {
+        n += sprintf(buf + n, "{\"id\": %d, \"level\": \"info\", \"service\": \"s%d\"}\n", i, i % 7);
+    }
+
+    json_lines_t lines;
+    json_lines_t_init(&lines);
+    json_lines_opts_t lines_opts = { 4, 0, &intern };
+    if (json_lines_t_parse(&lines, buf, n, &lines_opts) != 0 || lines.len != RECORDS || lines.errors != 0) {
+        return 1;
+    }
+
+    for (size_t i = 0; i < lines.len; i++) {
+        json_object_t* record = &lines.records[i].value;
+        if (entry_key(record, 1) != first || entry_key(record, 0) != entry_key(&lines.records[0].value, 0) ||
+            json_object_map_t_get(record->val.obj, "id") == NULL) {
+            printf("record %zu\n", i);
+            failed = 1;
+            break;
+        }
+    }
+
+    json_intern_stats_t after;
+    json_intern_t_stats(&intern, &after);
+    if (after.unique_keys != stats.unique_keys + 1 || after.lookups - stats.lookups != RECORDS * 3) {
+        printf("batch stats\n");
+        failed = 1;
+    }
+
+    json_lines_t_deinit(&lines);
+    free(buf);
+    json_intern_t_deinit(&intern);
+    return failed;
+}
@@ -0,0 +1,79 @@
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* invalid[] = {
+    "",
+    "{",
+    "{\"a\"",
+    "{\"a\":",
+    "{\"a\":1",
+    "{\"a\":1,}",
+    "{\"a\" 1}",
+    "{a:1}",
+    "{\"a\":tru}",
+    "{\"a\":truex}",
+    "{\"a\":\"unterminated}",
+    "{\"a\":1} trailing",
+    "{\"a\":1}}",
+    "{\"a\":{\"b\":{\"c\":}}}",
+    "01",
+    "-",
+    "1.",
+    ".5",
+    "+1",
+    "1e",
+    "1e+",
+    "1.e5",
+    "--1",
+    "[",
+    "[1,]",
+    "[1 2]",
+    "[1}",
+    "{\"a\":[}",
+    "[[1]",
+};
+
+static const char* valid[] = {
+    "{}",
+    " { } ",
+    "{\"a\":{}}",
+    "\"top level string\"",
+    "12.5",
+    "-0",
+    "-1.5E+3",
+    "{\"a\":-2e-2}",
+    "null",
+    "[]",
+    "[ 1 , [2, []] , {\"a\": [\"b\"]} ]",
+    "{\"a\" : 1 ,\r\n \"b\" : { \"c\" : false } }",
+};
+
+int main () {
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        json_object_t obj;
+        int rc = json_parse(invalid[i], strlen(invalid[i]), &obj);
+        printf("%-28s -> %d\n", invalid[i], rc);
+
+        if (rc == 0) {
+            json_deinit(&obj);
+            failed = 1;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        json_object_t obj;
+        int rc = json_parse(valid[i], strlen(valid[i]), &obj);
+        printf("%-28s -> %d\n", valid[i], rc);
+
+        if (rc != 0) {
+            failed = 1;
+        } else {
+            json_deinit(&obj);
+        }
+    }
+
+    return failed;
+}
@@ -0,0 +1,87 @@
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+static json_object_t* lookup_name(json_object_map_t* map) {
+    return json_object_map_t_get_key(map, JSON_KEY("name"));
+}
+
+int main () {
+    int failed = 0;
+
+    const char* json = "{\"name\": \"Teller\", \"age\": 31, \"a\": 1, \"ab\": 2, \"abc\": 3}";
+    json_object_t obj;
+    if (json_parse(json, strlen(json), &obj) != 0) {
+        return 1;
+    }
+    json_object_map_t* map = obj.val.obj;
+
+    // Literal handles hash once at their call site and stay cached
+    json_object_t* name = lookup_name(map);
+    if (name == NULL || strcmp(name->val.str, "Teller") != 0) {
+        printf("literal lookup\n");
+        failed = 1;
+    }
+
+    json_key_t* age = JSON_KEY("age");
+    if (age->seed != 0 || json_object_map_t_get_key(map, age)->val.integer != 31 || age->seed != map->seed ||
+        age->hash != json_hash("age", 3, map->seed)) {
+        printf("cached hash\n");
+        failed = 1;
+    }
+
+    // Runtime handles, including keys that are prefixes of each other
+    const char* keys[] = { "a", "ab", "abc" };
+    for (int i = 0; i < 3; i++) {
+        json_key_t key;
+        json_key_t_init(&key, keys[i], strlen(keys[i]));
+        json_object_t* found = json_object_map_t_get_key(map, &key);
+        if (found == NULL || found->val.integer != i + 1) {
+            printf("runtime key %s\n", keys[i]);
+            failed = 1;
+        }
+    }
+
+    json_key_t missing;
+    json_key_t_init(&missing, "abcd", 4);
+    if (json_object_map_t_get_key(map, &missing) != NULL) {
+        failed = 1;
+    }
+
+    // Inserting through a handle replaces the same entry a string insert would find
+    json_object_t val = { .tag = INTEGER, .val.integer = 32 };
+    if (json_object_map_t_insert_key(map, age, &val) != 0 || map->len != 5 ||
+        json_object_map_t_get(map, "age")->val.integer != 32) {
+        printf("insert replace\n");
+        failed = 1;
+    }
+
+    json_key_t fresh;
+    json_key_t_init(&fresh, "fresh", 5);
+    val.val.integer = 5;
+    if (json_object_map_t_insert_key(map, &fresh, &val) != 0 || json_object_map_t_get(map, "fresh")->val.integer != 5) {
+        printf("insert new\n");
+        failed = 1;
+    }
+
+    // An empty map never matches
+    json_object_map_t empty;
+    json_object_map_t_init(&empty);
+    if (json_object_map_t_get_key(&empty, age) != NULL) {
+        failed = 1;
+    }
+
+    // After a seed change the handle rehashes for maps built under the new seed, and again for the old ones
+    json_set_hash_seed(map->seed + 2);
+    json_object_t reseeded;
+    json_parse(json, strlen(json), &reseeded);
+    if (json_object_map_t_get_key(reseeded.val.obj, age) == NULL || age->seed != reseeded.val.obj->seed ||
+        json_object_map_t_get_key(map, age) == NULL || age->seed != map->seed || lookup_name(reseeded.val.obj) == NULL) {
+        printf("reseeded lookup\n");
+        failed = 1;
+    }
+
+    json_deinit(&reseeded);
+    json_deinit(&obj);
+    return failed;
+}
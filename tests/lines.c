@@ -0,0 +1,103 @@
+#include "../json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RECORDS 20000
+
+// Every record carries its own index so ordering can be checked, with a blank line, a CRLF line and a bad line mixed in
+static char* build_lines(size_t* len) {
+    char* buf = malloc((size_t)RECORDS * 96);
+    size_t n = 0;
+
+    for (int i = 0; i < RECORDS; i++) {
+        if (i == 7) {
+            n += sprintf(buf + n, "\n   \n");
+        }
+
+        if (i == 500) {
+            n += sprintf(buf + n, "{\"id\": %d, \"broken\": }\n", i);
+        } else {
+            n += sprintf(buf + n, "{\"id\": %d, \"level\": \"info\", \"tags\": [\"a\", \"b\"], \"ms\": %d.5}%s\n", i, i % 97, i == 9 ? "\r" : "");
+        }
+    }
+
+    *len = n;
+    return buf;
+}
+
+static int check(json_lines_t* lines) {
+    if (lines->len != RECORDS || lines->errors != 1) {
+        printf("%zu records, %zu errors\n", lines->len, lines->errors);
+        return 1;
+    }
+
+    for (size_t i = 0; i < lines->len; i++) {
+        json_lines_record_t* record = &lines->records[i];
+        if (i == 500) {
+            if (record->rc == 0 || record->value.tag != NULL_VAL) {
+                return 1;
+            }
+            continue;
+        }
+
+        json_object_t* id = record->rc == 0 ? json_object_map_t_get(record->value.val.obj, "id") : NULL;
+        if (id == NULL || id->tag != INTEGER || id->val.integer != (int64_t)i) {
+            printf("record %zu out of order\n", i);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main () {
+    size_t len;
+    char* data = build_lines(&len);
+
+    json_lines_t lines;
+    json_lines_t_init(&lines);
+
+    // The same batch on one thread and on more threads than there are cores, reusing the batch each time
+    size_t threads[] = { 1, 4, 0 };
+    for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+        json_lines_opts_t opts = { threads[i], 0, NULL };
+        if (json_lines_t_parse(&lines, data, len, &opts) != 0 || check(&lines) != 0) {
+            printf("%zu threads failed\n", threads[i]);
+            return 1;
+        }
+        printf("%zu threads: %zu records, %zu errors, %zu arenas\n", threads[i], lines.len, lines.errors, lines.arena_count);
+    }
+
+    // Straight from a file, with strings borrowed from the mapping
+    char path[] = "/tmp/json_lines_testXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || write(fd, data, len) != (ssize_t)len) {
+        return 1;
+    }
+    close(fd);
+
+    json_lines_opts_t opts = { 4, JSON_PARSE_BORROW_STRINGS, NULL };
+    int rc = json_lines_t_parse_file(&lines, path, &opts);
+    unlink(path);
+    if (rc != 0 || check(&lines) != 0) {
+        return 1;
+    }
+
+    json_object_t* level = json_object_map_t_get(lines.records[3].value.val.obj, "level");
+    if (level->tag != STRING_VIEW) {
+        return 1;
+    }
+    printf("file: %zu records, first level %.*s\n", lines.len, (int)level->val.view.len, level->val.view.ptr);
+
+    json_lines_t_deinit(&lines);
+
+    // Nothing but blank lines
+    if (json_lines_t_parse(&lines, "\n\n  \n", 5, NULL) != 0 || lines.len != 0) {
+        return 1;
+    }
+    json_lines_t_deinit(&lines);
+
+    free(data);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "../json.h"
+#include <stdio.h>
+
+#define KEY_COUNT 100000
+
+int main () {
+    json_object_map_t json_map;
+    json_object_map_t_init(&json_map);
+
+    char key[32];
+    json_object_t val;
+    val.tag = NUMBER;
+
+    for (int i = 0; i < KEY_COUNT; i++) {
+        snprintf(key, sizeof(key), "key%d", i);
+        val.val.number = i;
+        json_object_map_t_insert(&json_map, key, &val);
+    }
+
+    // Overwriting keeps a single entry
+    val.val.number = -1;
+    json_object_map_t_insert(&json_map, "key42", &val);
+
+    if (json_map.len != KEY_COUNT) {
+        return 1;
+    }
+
+    for (int i = 0; i < KEY_COUNT; i++) {
+        snprintf(key, sizeof(key), "key%d", i);
+        json_object_t* found = json_object_map_t_get(&json_map, key);
+        double expected = i == 42 ? -1 : i;
+        if (found == NULL || found->val.number != expected) {
+            printf("missing %s\n", key);
+            return 1;
+        }
+    }
+
+    if (json_object_map_t_get(&json_map, "key") != NULL || json_object_map_t_get(&json_map, "yek1") != NULL) {
+        return 1;
+    }
+
+    // Entries keep their insertion order
+    printf("first: %s, last: %s\n", json_map.entries[0].key, json_map.entries[json_map.len - 1].key);
+    printf("%zu entries in %zu slots\n", json_map.len, json_map.slot_mask + 1);
+
+    // Anagrams hash differently
+    if (json_hash("number", 6, 1) == json_hash("rumben", 6, 1)) {
+        return 1;
+    }
+
+    json_object_map_t_deinit(&json_map);
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+// Inputs around the edges of the fast paths: halfway cases, subnormals, overflow and long mantissas
+static const char* doubles[] = {
+    "0.1",
+    "-0.0",
+    "1.7976931348623157e308",
+    "1.7976931348623159e308",
+    "2.2250738585072014e-308",
+    "2.2250738585072011e-308",
+    "4.9406564584124654e-324",
+    "2.4703282292062327e-324",
+    "2.4703282292062328e-324",
+    "1e-400",
+    "1e400",
+    "9007199254740993",
+    "9007199254740993.0",
+    "9223372036854775808",
+    "-9223372036854775809",
+    "123456789012345678901234567890",
+    "0.000000000000000000000000000000000001",
+    "1.00000000000000011102230246251565404236316680908203125",
+    "1.00000000000000011102230246251565404236316680908203124",
+    "7.2057594037927933e16",
+    "3.14159265358979323846264338327950288",
+    "1e23",
+    "8.98846567431158e307",
+    "0.30000000000000004",
+    "123.456e-5",
+};
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// Parses `text` as a top level document and checks it matches strtod bit for bit
+static int check_double(const char* text) {
+    json_object_t obj;
+    if (json_parse(text, strlen(text), &obj) != 0) {
+        printf("failed to parse %s\n", text);
+        return 1;
+    }
+
+    double got;
+    if (json_object_t_as_double(&obj, &got) != 0) {
+        printf("%s is not a number\n", text);
+        return 1;
+    }
+
+    double want = strtod(text, NULL);
+    if (memcmp(&got, &want, sizeof(got)) != 0) {
+        printf("%s: got %.17g, want %.17g\n", text, got, want);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int check_integer(const char* text, int64_t want) {
+    json_object_t obj;
+    if (json_parse(text, strlen(text), &obj) != 0 || obj.tag != INTEGER || obj.val.integer != want) {
+        printf("%s did not parse to the integer %lld\n", text, (long long)want);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main () {
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(doubles) / sizeof(doubles[0]); i++) {
+        failed |= check_double(doubles[i]);
+    }
+
+    // Random bit patterns printed at a few precisions, which shortens or lengthens the mantissa
+    const char* formats[] = { "%.17g", "%.16g", "%.15g", "%.6e", "%.25e" };
+    char buf[64];
+    int checked = 0;
+    for (int i = 0; i < 200000; i++) {
+        uint64_t bits = next_random();
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        if (d != d || d - d != 0) continue;
+
+        snprintf(buf, sizeof(buf), formats[i % 5], d);
+        failed |= check_double(buf);
+        checked++;
+    }
+
+    failed |= check_integer("0", 0);
+    failed |= check_integer("7", 7);
+    failed |= check_integer("-42", -42);
+    failed |= check_integer("9223372036854775807", INT64_MAX);
+    failed |= check_integer("-9223372036854775808", INT64_MIN);
+
+    // A whole number written with an exponent is still a double, but reads back as an int64_t
+    json_object_t obj;
+    int64_t n;
+    const char* text = "1e3";
+    if (json_parse(text, strlen(text), &obj) != 0 || obj.tag != NUMBER || json_object_t_as_int64(&obj, &n) != 0 || n != 1000) {
+        printf("1e3 did not read back as 1000\n");
+        failed = 1;
+    }
+
+    text = "2.5";
+    if (json_parse(text, strlen(text), &obj) != 0 || json_object_t_as_int64(&obj, &n) == 0) {
+        printf("2.5 read back as an integer\n");
+        failed = 1;
+    }
+
+    // The tokenizer follows the same grammar
+    token_stream_t stream;
+    text = "{\"a\": -1.5e+3, \"b\": 0}";
+    if (tokenize_json(text, strlen(text), &stream) != 0 || stream.len != 13 || stream.items[5].tag != NUM || stream.items[5].len != 7) {
+        printf("tokenizer split -1.5e+3 wrong\n");
+        failed = 1;
+    }
+    token_stream_t_deinit(&stream);
+
+    printf("Checked %d random doubles against strtod\n", checked);
+    return failed;
+}
@@ -11,7 +11,7 @@ int main () {
     json_object_map_t* person = json_object_map_t_get(obj.val.obj, "person")->val.obj;
 
     printf("Name: %s\n", json_object_map_t_get(person, "name")->val.str);
-    printf("Age: %0.f\n", json_object_map_t_get(person, "age")->val.number);
+    printf("Age: %lld\n", (long long)json_object_map_t_get(person, "age")->val.integer);
 
     printf("Are they awesome? %s\n", json_object_map_t_get(obj.val.obj, "is_awesome")->val.boolean ? "yes" : "no");
 
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t heap_allocs = 0;
+
+static void* counting_malloc(size_t size) {
+    heap_allocs++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ptr, size_t size) {
+    heap_allocs++;
+    return realloc(ptr, size);
+}
+
+#define JSON_MALLOC(size) counting_malloc(size)
+#define JSON_REALLOC(ptr, size) counting_realloc(ptr, size)
+
+#include "../json.h"
+
+// Builds a document with `count` records, big enough to spill over a single arena block
+static char* build_document(int count, size_t* len) {
+    char* buf = malloc(count * 96 + 16);
+    size_t n = 0;
+
+    n += sprintf(buf + n, "{\"records\": [");
+    for (int i = 0; i < count; i++) {
+        n += sprintf(buf + n, "%s{\"id\": %d, \"name\": \"record%d\", \"tags\": [1, 2, 3], \"ok\": true}", i == 0 ? "" : ", ", i, i);
+    }
+    n += sprintf(buf + n, "]}");
+
+    *len = n;
+    return buf;
+}
+
+int main () {
+    int failed = 0;
+
+    size_t len;
+    char* json = build_document(2000, &len);
+
+    json_parser_t parser;
+    json_parser_t_init(&parser);
+
+    json_document_t doc;
+    json_document_t_init(&doc);
+
+    // The first parses grow the arena and the element stack, after that the memory is reused
+    for (int i = 0; i < 2; i++) {
+        if (json_parser_t_parse_document(&parser, &doc, json, len, NULL) != 0) {
+            return 1;
+        }
+    }
+
+    size_t allocs = heap_allocs;
+    size_t blocks = doc.arena.block_count;
+    for (int i = 0; i < 100; i++) {
+        if (json_parser_t_parse_document(&parser, &doc, json, len, NULL) != 0) {
+            return 1;
+        }
+    }
+
+    printf("Steady state: %zu heap allocations over 100 parses, %zu byte arena in %zu block(s) ever requested\n",
+           heap_allocs - allocs, doc.arena.bytes_reserved, doc.arena.block_count);
+
+    if (heap_allocs != allocs || doc.arena.block_count != blocks || doc.arena.head->next != NULL) {
+        printf("steady state allocates\n");
+        failed = 1;
+    }
+
+    json_object_t* records = json_object_map_t_get(doc.root.val.obj, "records");
+    json_object_t* last = json_array_t_get(records->val.arr, 1999);
+    if (records->val.arr->len != 2000 || json_object_map_t_get(last->val.obj, "id")->val.integer != 1999) {
+        printf("reused document contents\n");
+        failed = 1;
+    }
+
+    // A smaller document fits in the same memory, options still apply
+    const char* small = "{\"name\": \"Teller\"}";
+    json_parse_opts_t opts = { .flags = JSON_PARSE_BORROW_STRINGS };
+    allocs = heap_allocs;
+    if (json_parser_t_parse_document(&parser, &doc, small, strlen(small), &opts) != 0 || heap_allocs != allocs ||
+        json_object_map_t_get(doc.root.val.obj, "name")->tag != STRING_VIEW) {
+        printf("small document\n");
+        failed = 1;
+    }
+
+    // A failed parse leaves an empty document that can be parsed into again
+    const char* bad = "{\"name\": [1, 2";
+    if (json_parser_t_parse_document(&parser, &doc, bad, strlen(bad), NULL) >= 0 || doc.root.tag != NULL_VAL ||
+        json_parser_t_parse_document(&parser, &doc, small, strlen(small), NULL) != 0) {
+        printf("failed parse\n");
+        failed = 1;
+    }
+
+    // Heap trees only reuse the element stack, they are freed as usual
+    json_object_t obj;
+    if (json_parser_t_parse(&parser, json, len, &obj, NULL) != 0 || obj.tag != OBJECT) {
+        printf("heap parse\n");
+        failed = 1;
+    }
+    json_deinit(&obj);
+
+    // Resetting an arena by hand keeps one block big enough for what it held
+    json_arena_t arena;
+    json_arena_t_init(&arena);
+    json_arena_t_alloc(&arena, JSON_ARENA_BLOCK_SIZE);
+    json_arena_t_alloc(&arena, JSON_ARENA_BLOCK_SIZE);
+    size_t reserved = arena.bytes_reserved;
+    if (json_arena_t_reset(&arena) != 0 || arena.bytes_reserved != reserved || arena.alloc_count != 0 ||
+        arena.head->next != NULL || arena.head->used != 0) {
+        printf("arena reset\n");
+        failed = 1;
+    }
+    json_arena_t_deinit(&arena);
+
+    json_document_t_deinit(&doc);
+    json_parser_t_deinit(&parser);
+    free(json);
+    return failed;
+}
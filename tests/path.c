@@ -0,0 +1,119 @@
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+int main () {
+    int failed = 0;
+
+    const char* json = "{\"person\": {\"name\": \"Teller\", \"tags\": [\"a\", {\"deep\": [10, 20]}]},"
+                       " \"a/b\": 1, \"m~n\": 2, \"\": 3, \"0\": {\"1\": 4}, \"list\": [[5, 6], [7]]}";
+    json_object_t root;
+    if (json_parse(json, strlen(json), &root) != 0) {
+        return 1;
+    }
+
+    // Pointers and dotted paths selecting the same values
+    struct {
+        const char* pointer;
+        const char* dotted;
+        int64_t expected;
+    } cases[] = {
+        { "/person/tags/1/deep/1", "person.tags[1].deep[1]", 20 },
+        { "/a~1b", NULL, 1 },
+        { "/m~0n", "m~n", 2 },
+        { "/", NULL, 3 },
+        { "/0/1", "0.1", 4 },
+        { "/list/0/1", "list[0][1]", 6 },
+        { "/list/1/0", "list.1.0", 7 },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        json_path_t path;
+        if (json_path_t_compile_pointer(&path, cases[i].pointer) != 0) {
+            printf("compile %s\n", cases[i].pointer);
+            return 1;
+        }
+
+        json_object_t* found = json_path_t_eval(&path, &root);
+        if (found == NULL || found->tag != INTEGER || found->val.integer != cases[i].expected) {
+            printf("pointer %s\n", cases[i].pointer);
+            failed = 1;
+        }
+        json_path_t_deinit(&path);
+
+        if (cases[i].dotted == NULL) {
+            continue;
+        }
+
+        if (json_path_t_compile(&path, cases[i].dotted) != 0) {
+            printf("compile %s\n", cases[i].dotted);
+            return 1;
+        }
+
+        found = json_path_t_eval(&path, &root);
+        if (found == NULL || found->tag != INTEGER || found->val.integer != cases[i].expected) {
+            printf("dotted %s\n", cases[i].dotted);
+            failed = 1;
+        }
+        json_path_t_deinit(&path);
+    }
+
+    // The empty path is the root itself
+    json_path_t path;
+    json_path_t_compile_pointer(&path, "");
+    if (path.len != 0 || json_path_t_eval(&path, &root) != &root) {
+        failed = 1;
+    }
+    json_path_t_deinit(&path);
+
+    json_path_t_compile(&path, "");
+    if (json_path_t_eval(&path, &root) != &root) {
+        failed = 1;
+    }
+    json_path_t_deinit(&path);
+
+    // Missing members, out of range or non numeric indices, and steps below scalars select nothing
+    const char* missing[] = { "/nope", "/person/tags/2", "/person/tags/-", "/person/tags/01", "/person/name/x", "/list/a" };
+    for (size_t i = 0; i < sizeof(missing) / sizeof(missing[0]); i++) {
+        if (json_path_t_compile_pointer(&path, missing[i]) != 0 || json_path_t_eval(&path, &root) != NULL) {
+            printf("found %s\n", missing[i]);
+            failed = 1;
+        }
+        json_path_t_deinit(&path);
+    }
+
+    // Malformed paths are rejected
+    const char* bad_pointers[] = { "person", "/a~2", "/a~" };
+    for (size_t i = 0; i < sizeof(bad_pointers) / sizeof(bad_pointers[0]); i++) {
+        if (json_path_t_compile_pointer(&path, bad_pointers[i]) != UNEXPECTED_TOKEN) {
+            printf("compiled %s\n", bad_pointers[i]);
+            failed = 1;
+        }
+    }
+
+    const char* bad_paths[] = { ".a", "a.", "a..b", "a[", "a[]", "a[x]", "a[01]", "a[0]b", "a.[0]" };
+    for (size_t i = 0; i < sizeof(bad_paths) / sizeof(bad_paths[0]); i++) {
+        if (json_path_t_compile(&path, bad_paths[i]) != UNEXPECTED_TOKEN) {
+            printf("compiled %s\n", bad_paths[i]);
+            failed = 1;
+        }
+    }
+
+    // A path compiled under one seed still finds keys in maps built under another
+    json_path_t_compile(&path, "person.name");
+    json_set_hash_seed(json_hash_seed() + 2);
+
+    json_object_t reseeded;
+    json_parse(json, strlen(json), &reseeded);
+    json_object_t* name = json_path_t_eval(&path, &reseeded);
+    if (reseeded.val.obj->seed == path.seed || name == NULL || strcmp(name->val.str, "Teller") != 0 ||
+        json_path_t_eval(&path, &root) == NULL) {
+        printf("reseeded lookup\n");
+        failed = 1;
+    }
+    json_path_t_deinit(&path);
+    json_deinit(&reseeded);
+
+    json_deinit(&root);
+    return failed;
+}
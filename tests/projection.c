@@ -0,0 +1,135 @@
+#include <stdlib.h>
+
+// Counts heap allocations so the test can check skipped subtrees cost nothing
+static size_t allocations = 0;
+
+static void* counting_malloc(size_t size) {
+    allocations++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ptr, size_t size) {
+    allocations++;
+    return realloc(ptr, size);
+}
+
+#define JSON_MALLOC(size) counting_malloc(size)
+#define JSON_REALLOC(ptr, size) counting_realloc(ptr, size)
+
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+static int written_as(json_object_t* obj, const char* expected) {
+    char* out;
+    if (json_write(obj, 0, &out, NULL) != 0) {
+        return 0;
+    }
+
+    printf("%s\n", out);
+    int same = strcmp(out, expected) == 0;
+    JSON_FREE(out);
+    return same;
+}
+
+int main () {
+    int failed = 0;
+
+    const char* json = "{\"id\": 7, \"person\": {\"name\": \"Teller\", \"age\": 31, \"tags\": [\"a\", \"}\", {\"x\": [1]}]},"
+                       " \"noise\": [{\"a\": \"]\\\"\"}, [[[]]], -1.5e3, true, null],"
+                       " \"meta\": {\"ts\": 1700000000, \"source\": {\"host\": \"h\", \"port\": 80}},"
+                       " \"sc\\u0061lar\": \"escaped key\", \"person\": {\"name\": \"Dup\"}}";
+
+    json_projection_t proj;
+    json_projection_t_init(&proj);
+    const char* paths[] = { "person.name", "meta.ts", "meta.source", "meta.source.host", "scalar", "noise.a", "id.x" };
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        if (json_projection_t_add(&proj, paths[i]) != 0) {
+            return 1;
+        }
+    }
+
+    if (json_projection_t_add(&proj, "a..b") != UNEXPECTED_TOKEN || json_projection_t_add(&proj, ".a") != UNEXPECTED_TOKEN ||
+        json_projection_t_add(&proj, "a.") != UNEXPECTED_TOKEN || json_projection_t_add(&proj, "") != UNEXPECTED_TOKEN) {
+        printf("bad path accepted\n");
+        failed = 1;
+    }
+
+    // Only the requested members survive, later duplicates still replace earlier ones
+    json_object_t obj;
+    if (json_parse_projected(json, strlen(json), &proj, &obj, NULL) != 0) {
+        return 1;
+    }
+
+    if (!written_as(&obj, "{\"person\":{\"name\":\"Dup\"},\"meta\":{\"ts\":1700000000,\"source\":{\"host\":\"h\",\"port\":80}},"
+                          "\"scalar\":\"escaped key\"}")) {
+        failed = 1;
+    }
+    json_deinit(&obj);
+
+    // Skipping allocates nothing, so an unrelated projection parses in exactly one allocation for the root map
+    json_projection_t none;
+    json_projection_t_init(&none);
+    json_projection_t_add(&none, "missing");
+
+    size_t before = allocations;
+    if (json_parse_projected(json, strlen(json), &none, &obj, NULL) != 0 || allocations - before != 1 ||
+        !written_as(&obj, "{}")) {
+        printf("skip allocated %zu times\n", allocations - before);
+        failed = 1;
+    }
+    json_deinit(&obj);
+
+    // Arena and borrowed strings behave as they do for json_parse_ex
+    json_arena_t arena;
+    json_arena_t_init(&arena);
+    json_parse_opts_t opts = { .arena = &arena, .flags = JSON_PARSE_BORROW_STRINGS };
+    if (json_parse_projected(json, strlen(json), &proj, &obj, &opts) != 0 ||
+        json_object_map_t_get(json_object_map_t_get(obj.val.obj, "person")->val.obj, "name")->tag != STRING_VIEW) {
+        printf("arena projection\n");
+        failed = 1;
+    }
+    json_arena_t_deinit(&arena);
+
+    // Escaped keys too long for the stack are decoded on the heap
+    char long_key[201], long_doc[512];
+    memset(long_key, 'k', 200);
+    long_key[200] = '\0';
+    sprintf(long_doc, "{\"%.199s\\u006b\": 1, \"%.199s\\u006a\": 2}", long_key, long_key);
+
+    json_projection_t long_proj;
+    json_projection_t_init(&long_proj);
+    json_projection_t_add(&long_proj, long_key);
+    if (json_parse_projected(long_doc, strlen(long_doc), &long_proj, &obj, NULL) != 0 || obj.val.obj->len != 1 ||
+        json_object_map_t_get(obj.val.obj, long_key)->val.integer != 1) {
+        printf("long escaped key\n");
+        failed = 1;
+    }
+    json_deinit(&obj);
+    json_projection_t_deinit(&long_proj);
+
+    // Non object documents project to nothing, but are still checked
+    const char* others[] = { "[1, {\"a\": 2}]", " 3 ", "\"s\"", "null" };
+    for (size_t i = 0; i < sizeof(others) / sizeof(others[0]); i++) {
+        if (json_parse_projected(others[i], strlen(others[i]), &proj, &obj, NULL) != 0 || obj.tag != OBJECT ||
+            obj.val.obj->len != 0) {
+            printf("rejected %s\n", others[i]);
+            failed = 1;
+        }
+        json_deinit(&obj);
+    }
+
+    // Malformed input fails wherever it sits, kept or skipped
+    const char* invalid[] = { "", "{", "{\"noise\": [1, 2}", "{\"noise\": \"open}", "{\"noise\": tru}", "{\"noise\": 1}}",
+                              "{\"person\": {\"name\": }}", "{\"noise\" 1}", "{\"id\": 1,}", "{} x", "{\"noise\": [\"\\\"]}" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        if (json_parse_projected(invalid[i], strlen(invalid[i]), &proj, &obj, NULL) >= 0) {
+            printf("accepted %s\n", invalid[i]);
+            failed = 1;
+        }
+    }
+
+    json_projection_t_deinit(&none);
+    json_projection_t_deinit(&proj);
+    return failed;
+}
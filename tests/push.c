@@ -0,0 +1,178 @@
+#include "../json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int json_equal(json_object_t* a, json_object_t* b) {
+    if (a->tag != b->tag) {
+        return 0;
+    }
+
+    switch (a->tag) {
+        case NUMBER:
+            return a->val.number == b->val.number;
+
+        case INTEGER:
+            return a->val.integer == b->val.integer;
+
+        case STRING:
+            return strcmp(a->val.str, b->val.str) == 0;
+
+        case BOOLEAN:
+            return a->val.boolean == b->val.boolean;
+
+        case OBJECT:
+            if (a->val.obj->len != b->val.obj->len) {
+                return 0;
+            }
+
+            for (size_t i = 0; i < a->val.obj->len; i++) {
+                json_object_entry_t* entry = &a->val.obj->entries[i];
+                json_object_t* other = json_object_map_t_get(b->val.obj, entry->key);
+                if (other == NULL || !json_equal(&entry->value, other)) {
+                    return 0;
+                }
+            }
+            return 1;
+
+        case ARRAY:
+            if (a->val.arr->len != b->val.arr->len) {
+                return 0;
+            }
+
+            for (size_t i = 0; i < a->val.arr->len; i++) {
+                if (!json_equal(&a->val.arr->items[i], &b->val.arr->items[i])) {
+                    return 0;
+                }
+            }
+            return 1;
+
+        default:
+            return 1;
+    }
+}
+
+int main () {
+    const char* json = "{\"person\":{\"name\": \"Teller\", \"age\":7, \"tags\": {}}, \"ids\": [1, -2.5e3, [], [\"x\", {\"y\": [null]}]], \"is_awesome\":true, \"score\": 12.25, \"none\": null, \"esc\\\"aped\": \"a\\\\b\\u00e9\"}";
+    size_t len = strlen(json);
+
+    json_object_t expected;
+    json_parse(json, len, &expected);
+
+    // Every possible two chunk split
+    for (size_t split = 0; split <= len; split++) {
+        json_push_parser_t p;
+        json_push_parser_t_init(&p, NULL);
+
+        json_object_t obj;
+        int rc = json_push_parser_t_feed(&p, json, split, NULL, &obj);
+        if (rc == JSON_PUSH_NEED_MORE) {
+            rc = json_push_parser_t_feed(&p, json + split, len - split, NULL, &obj);
+        }
+
+        if (rc != 0 || !json_equal(&obj, &expected)) {
+            printf("split at %zu failed: %d\n", split, rc);
+            return 1;
+        }
+
+        json_deinit(&obj);
+        json_push_parser_t_deinit(&p);
+    }
+
+    // One byte at a time, into an arena
+    json_arena_t arena;
+    json_arena_t_init(&arena);
+
+    json_push_parser_t p;
+    json_push_parser_t_init(&p, &arena);
+
+    json_object_t obj;
+    int rc = JSON_PUSH_NEED_MORE;
+    for (size_t i = 0; i < len && rc == JSON_PUSH_NEED_MORE; i++) {
+        rc = json_push_parser_t_feed(&p, json + i, 1, NULL, &obj);
+    }
+
+    if (rc != 0 || !json_equal(&obj, &expected)) {
+        return 1;
+    }
+
+    json_push_parser_t_deinit(&p);
+    json_arena_t_deinit(&arena);
+    json_deinit(&expected);
+
+    // Back to back documents in one chunk, the last one a bare number finished by end of input
+    const char* stream = "{\"a\":1} [2, 3]\n42.5";
+    size_t offset = 0;
+    int docs = 0;
+
+    json_push_parser_t_init(&p, NULL);
+    while (offset < strlen(stream)) {
+        size_t consumed;
+        rc = json_push_parser_t_feed(&p, stream + offset, strlen(stream) - offset, &consumed, &obj);
+        offset += consumed;
+
+        if (rc == 0) {
+            docs++;
+            json_deinit(&obj);
+        } else if (rc != JSON_PUSH_NEED_MORE) {
+            return 1;
+        }
+    }
+
+    if (json_push_parser_t_finish(&p, &obj) != 0 || obj.tag != NUMBER || obj.val.number != 42.5) {
+        return 1;
+    }
+    docs++;
+    printf("Parsed %d streamed documents\n", docs);
+
+    // Malformed input is reported and the partial document dropped
+    rc = json_push_parser_t_feed(&p, "{\"a\":{\"b\" 1}}", 13, NULL, &obj);
+    printf("Malformed chunk: %d\n", rc);
+    if (rc >= 0) {
+        return 1;
+    }
+
+    // Brackets have to match the container they close
+    rc = json_push_parser_t_feed(&p, "{\"a\":[1}", 9, NULL, &obj);
+    printf("Mismatched bracket: %d\n", rc);
+    if (rc >= 0) {
+        return 1;
+    }
+
+    // Empty strings and empty chunks before anything was buffered
+    json_push_parser_t_deinit(&p);
+    json_push_parser_t_init(&p, NULL);
+    if (json_push_parser_t_feed(&p, "", 0, NULL, &obj) != JSON_PUSH_NEED_MORE ||
+        json_push_parser_t_feed(&p, "{\"\":\"\"}", 7, NULL, &obj) != 0 || obj.val.obj->len != 1) {
+        return 1;
+    }
+    json_deinit(&obj);
+
+    // Nesting is limited like json_parse, and the limit can be raised
+    size_t depth = JSON_PARSE_MAX_DEPTH + 1;
+    char* deep = malloc(depth * 2);
+    if (deep == NULL) {
+        return 1;
+    }
+    memset(deep, '[', depth);
+    memset(deep + depth, ']', depth);
+
+    rc = json_push_parser_t_feed(&p, deep, depth * 2, NULL, &obj);
+    printf("Depth %zu: %d\n", depth, rc);
+    if (rc != DEPTH_LIMIT_EXCEEDED || json_push_parser_t_feed(&p, deep + 1, depth * 2 - 2, NULL, &obj) != 0) {
+        free(deep);
+        return 1;
+    }
+    json_deinit(&obj);
+
+    p.max_depth = depth;
+    if (json_push_parser_t_feed(&p, deep, depth * 2, NULL, &obj) != 0) {
+        free(deep);
+        return 1;
+    }
+    json_deinit(&obj);
+    free(deep);
+
+    json_push_parser_t_deinit(&p);
+    return docs == 3 ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+#include <stdlib.h>
+
+// Counts heap allocations so the test can check the SAX walk never makes one
+static size_t allocations = 0;
+
+static void* counting_malloc(size_t size) {
+    allocations++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ptr, size_t size) {
+    allocations++;
+    return realloc(ptr, size);
+}
+
+#define JSON_MALLOC(size) counting_malloc(size)
+#define JSON_REALLOC(ptr, size) counting_realloc(ptr, size)
+
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+// Writes every event into a trace string
+typedef struct {
+    char trace[1024];
+    size_t len;
+} trace_t;
+
+static void emit(trace_t* t, const char* text, size_t len) {
+    memcpy(t->trace + t->len, text, len);
+    t->len += len;
+    t->trace[t->len] = '\0';
+}
+
+static int on_start_object(void* ctx) { emit(ctx, "{ ", 2); return 0; }
+static int on_end_object(void* ctx) { emit(ctx, "} ", 2); return 0; }
+static int on_start_array(void* ctx) { emit(ctx, "[ ", 2); return 0; }
+static int on_end_array(void* ctx) { emit(ctx, "] ", 2); return 0; }
+static int on_null(void* ctx) { emit(ctx, "null ", 5); return 0; }
+
+static int on_key(void* ctx, const char* key, size_t len, int escaped) {
+    char decoded[64];
+    json_unescape(key, len, decoded, &len);
+    emit(ctx, "k:", 2);
+    emit(ctx, decoded, len);
+    emit(ctx, " ", 1);
+    return 0;
+}
+
+static int on_string(void* ctx, const char* str, size_t len, int escaped) {
+    emit(ctx, escaped ? "e:" : "s:", 2);
+    emit(ctx, str, len);
+    emit(ctx, " ", 1);
+    return 0;
+}
+
+static int on_integer(void* ctx, int64_t value) {
+    char buf[32];
+    emit(ctx, buf, sprintf(buf, "i:%lld ", (long long)value));
+    return 0;
+}
+
+static int on_number(void* ctx, double value) {
+    char buf[32];
+    emit(ctx, buf, sprintf(buf, "n:%g ", value));
+    return 0;
+}
+
+static int on_boolean(void* ctx, int value) {
+    emit(ctx, value ? "true " : "false ", value ? 5 : 6);
+    return 0;
+}
+
+// Sums every "amount" field in the document, the kind of aggregation SAX is for
+typedef struct {
+    int next_is_amount;
+    double total;
+} sum_t;
+
+static int sum_key(void* ctx, const char* key, size_t len, int escaped) {
+    ((sum_t*)ctx)->next_is_amount = len == 6 && memcmp(key, "amount", 6) == 0;
+    return 0;
+}
+
+static int sum_integer(void* ctx, int64_t value) {
+    sum_t* s = ctx;
+    if (s->next_is_amount) s->total += value;
+    return 0;
+}
+
+static int sum_number(void* ctx, double value) {
+    sum_t* s = ctx;
+    if (s->next_is_amount) s->total += value;
+    return 0;
+}
+
+static int stop_at_array(void* ctx) {
+    return 7;
+}
+
+int main () {
+    const json_sax_handler_t tracer = {
+        on_start_object, on_end_object, on_start_array, on_end_array,
+        on_key, on_string, on_integer, on_number, on_boolean, on_null,
+    };
+
+    const char* json = "{\"name\": \"Teller\", \"esc\\u0061ped\": \"a\\nb\", \"list\": [1, -2.5, [], {}, true, null], \"empty\": {}}";
+    trace_t trace = { { 0 }, 0 };
+
+    allocations = 0;
+    int rc = json_sax_parse(json, strlen(json), &tracer, &trace);
+    printf("%s\n", trace.trace);
+
+    const char* expected = "{ k:name s:Teller k:escaped e:a\\nb k:list [ i:1 n:-2.5 [ ] { } true null ] k:empty { } } ";
+    if (rc != 0 || strcmp(trace.trace, expected) != 0 || allocations != 0) {
+        printf("trace mismatch (rc %d, %zu allocations)\n", rc, allocations);
+        return 1;
+    }
+
+    // Aggregating without a tree gives the same total as walking one
+    const char* orders = "[{\"id\": 1, \"amount\": 10}, {\"id\": 2, \"amount\": 2.5, \"meta\": {\"amount\": 1}}, {\"id\": 3}]";
+    sum_t sum = { 0, 0 };
+    json_sax_handler_t summer = { 0 };
+    summer.key = sum_key;
+    summer.integer = sum_integer;
+    summer.number = sum_number;
+    if (json_sax_parse(orders, strlen(orders), &summer, &sum) != 0 || sum.total != 13.5) {
+        printf("sum %g\n", sum.total);
+        return 1;
+    }
+    printf("Total amount: %g\n", sum.total);
+
+    // A callback can stop the walk early
+    json_sax_handler_t stopper = { 0 };
+    stopper.start_array = stop_at_array;
+    if (json_sax_parse(orders, strlen(orders), &stopper, NULL) != 7) {
+        return 1;
+    }
+
+    // Malformed input is rejected the same way json_parse rejects it
+    const char* invalid[] = { "", "{", "[1,]", "{\"a\" 1}", "{\"a\":1}}", "[1}", "{\"a\":[}", "01", "tru", "\"open", "{} x",
+                              "[\"\\4\"]", "[\"\\+\"]", "{\"c\":\"\\ud83d\\uude00\"}", "{\"\\x\":1}", "[\"\\u12\"]" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        if (json_sax_parse(invalid[i], strlen(invalid[i]), &summer, &sum) >= 0) {
+            printf("accepted %s\n", invalid[i]);
+            return 1;
+        }
+    }
+
+    // Nesting past the bit stack is refused
+    size_t depth = JSON_SAX_MAX_DEPTH + 1;
+    char* deep = malloc(depth * 2);
+    memset(deep, '[', depth);
+    memset(deep + depth, ']', depth);
+    rc = json_sax_parse(deep, depth * 2, &summer, &sum);
+    printf("Depth %zu: %d\n", depth, rc);
+    if (rc != DEPTH_LIMIT_EXCEEDED || json_sax_parse(deep + 1, depth * 2 - 2, &summer, &sum) != 0) {
+        return 1;
+    }
+    free(deep);
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "../json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    char* city;
+    int64_t zip;
+} address_t;
+
+typedef struct {
+    char* name;
+    int64_t age;
+    double score;
+    int active;
+    address_t address;
+    json_object_t extra;
+} person_t;
+
+#define ADDRESS_FIELDS(X)                          \
+    X("city", city, JSON_FIELD_STRING, NULL)       \
+    X("zip", zip, JSON_FIELD_INT64, NULL)
+
+JSON_SCHEMA(address, address_t, ADDRESS_FIELDS)
+
+#define PERSON_FIELDS(X)                                       \
+    X("name", name, JSON_FIELD_STRING, NULL)                   \
+    X("age", age, JSON_FIELD_INT64, NULL)                      \
+    X("score", score, JSON_FIELD_DOUBLE, NULL)                 \
+    X("active", active, JSON_FIELD_BOOL, NULL)                 \
+    X("address", address, JSON_FIELD_STRUCT, address_schema)   \
+    X("extra", extra, JSON_FIELD_VALUE, NULL)
+
+JSON_SCHEMA(person, person_t, PERSON_FIELDS)
+
+int main () {
+    int failed = 0;
+
+    // Unknown members of any shape are skipped, repeated ones replace earlier values
+    const char* json = "{\"name\": \"first\", \"ignored\": {\"name\": [1, \"}\"]}, \"age\": 31, \"score\": 7,"
+                       " \"active\": true, \"address\": {\"zip\": 12345, \"city\": \"Gen\\u00e8ve\", \"unknown\": null},"
+                       " \"extra\": [1, {\"a\": 2}], \"n\\u0061me\": \"Teller\", \"age\": null}";
+
+    person_t p;
+    memset(&p, 0, sizeof(p));
+    if (person_decode(json, strlen(json), &p, NULL) != 0) {
+        printf("decode failed\n");
+        return 1;
+    }
+
+    printf("%s %lld %.1f %d %s %lld\n", p.name, (long long)p.age, p.score, p.active, p.address.city, (long long)p.address.zip);
+    if (strcmp(p.name, "Teller") != 0 || p.age != 31 || p.score != 7.0 || p.active != 1 ||
+        strcmp(p.address.city, "Gen\xc3\xa8ve") != 0 || p.address.zip != 12345 ||
+        p.extra.tag != ARRAY || p.extra.val.arr->len != 2) {
+        failed = 1;
+    }
+    person_deinit(&p);
+    if (p.name != NULL || p.address.city != NULL || p.extra.tag != NULL_VAL) {
+        failed = 1;
+    }
+
+    // Missing members keep whatever the struct held
+    memset(&p, 0, sizeof(p));
+    p.age = -1;
+    json_arena_t arena;
+    json_arena_t_init(&arena);
+    if (person_decode(" { \"score\": -2.5e1 } ", 21, &p, &arena) != 0 || p.age != -1 || p.score != -25.0 || p.name != NULL) {
+        printf("partial decode\n");
+        failed = 1;
+    }
+
+    if (person_decode(json, strlen(json), &p, &arena) != 0 || strcmp(p.address.city, "Gen\xc3\xa8ve") != 0) {
+        printf("arena decode\n");
+        failed = 1;
+    }
+    json_arena_t_deinit(&arena);
+
+    // Members of the wrong type, and malformed input, fail
+    const char* invalid[] = { "", "[]", "{", "{\"age\": 1.5}", "{\"age\": \"1\"}", "{\"score\": true}", "{\"active\": 1}",
+                              "{\"name\": 3}", "{\"address\": []}", "{\"ignored\": [}", "{\"age\": 1,}", "{} x",
+                              "{\"address\": {\"zip\": \"x\"}}", "{\"n\\x\": 1}" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        memset(&p, 0, sizeof(p));
+        if (person_decode(invalid[i], strlen(invalid[i]), &p, NULL) >= 0) {
+            printf("accepted %s\n", invalid[i]);
+            failed = 1;
+        }
+        person_deinit(&p);
+    }
+
+    // The largest schema still gets a collision free table, including long keys that only differ in the middle
+    static char keys[JSON_SCHEMA_MAX_FIELDS][40];
+    json_field_t fields[JSON_SCHEMA_MAX_FIELDS + 1];
+    for (int i = 0; i < JSON_SCHEMA_MAX_FIELDS; i++) {
+        int len = sprintf(keys[i], i % 2 ? "field_%d" : "a_rather_long_prefix_%02d_and_suffix", i);
+        fields[i] = (json_field_t){ keys[i], (size_t)len, (size_t)i * sizeof(int64_t), JSON_FIELD_INT64, NULL };
+    }
+
+    json_schema_t schema;
+    if (json_schema_t_compile(&schema, fields, JSON_SCHEMA_MAX_FIELDS) != 0 || !schema.full_hash) {
+        printf("large schema\n");
+        failed = 1;
+    }
+
+    char doc[4096];
+    size_t n = sprintf(doc, "{");
+    for (int i = 0; i < JSON_SCHEMA_MAX_FIELDS; i++) {
+        n += sprintf(doc + n, "%s\"%s\": %d", i == 0 ? "" : ", ", keys[i], i * 3);
+    }
+    sprintf(doc + n, "}");
+
+    int64_t values[JSON_SCHEMA_MAX_FIELDS];
+    if (json_schema_t_decode(&schema, doc, strlen(doc), values, NULL) != 0) {
+        failed = 1;
+    }
+    for (int i = 0; i < JSON_SCHEMA_MAX_FIELDS; i++) {
+        if (values[i] != i * 3) {
+            printf("field %d\n", i);
+            failed = 1;
+        }
+    }
+
+    // Too many fields, or the same key twice, can't be compiled
+    fields[JSON_SCHEMA_MAX_FIELDS] = (json_field_t){ "extra", 5, 0, JSON_FIELD_INT64, NULL };
+    json_field_t twice[2] = { fields[1], fields[1] };
+    if (json_schema_t_compile(&schema, fields, JSON_SCHEMA_MAX_FIELDS + 1) != UNEXPECTED_TOKEN ||
+        json_schema_t_compile(&schema, twice, 2) != UNEXPECTED_TOKEN) {
+        printf("bad schema compiled\n");
+        failed = 1;
+    }
+
+    return failed;
+}
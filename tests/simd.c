@@ -0,0 +1,144 @@
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* backends[] = { "scalar", "sse2", "avx2", "neon" };
+
+static const char* document =
+    "{\"name\" : \"a string with spaces, commas: and {braces} [inside]\",\n"
+    "    \"escaped\": \"quote \\\" still inside \\\\\",    \"n\": 12.5,\n"
+    "\t\"flags\": [true, false, null], \"nested\": {\"deeper\": {\"key\": \"value\"}},"
+    "                                                                          "
+    "\"last\":\"ends here\"}";
+
+static int tokenize_signature(char* out, size_t cap) {
+    token_stream_t t;
+    if (tokenize_json(document, strlen(document), &t) != 0) {
+        return -1;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < t.len && n + 32 < cap; i++) {
+        n += snprintf(out + n, cap - n, "%d:%ld:%zu ", t.items[i].tag, (long)(t.items[i].start - document), (size_t)t.items[i].len);
+    }
+
+    token_stream_t_deinit(&t);
+    return 0;
+}
+
+// Parses `bytes` as the contents of a string value, so only the UTF-8 check can reject it
+static int string_parses(const unsigned char* bytes, size_t len) {
+    char buf[256];
+    buf[0] = '"';
+    memcpy(buf + 1, bytes, len);
+    buf[len + 1] = '"';
+
+    json_object_t obj;
+    if (json_parse(buf, len + 2, &obj) != 0) {
+        return 0;
+    }
+    json_deinit(&obj);
+    return 1;
+}
+
+int main () {
+    printf("Detected backend: %s\n", json_simd_backend());
+
+    char block[64];
+    unsigned int state = 12345;
+    const char alphabet[] = "{}[]:,\"\\ \t\n\r\x01\x1f abcxyz0129\x7f\x80\xff";
+
+    static char expected[8192];
+    json_simd_set_backend("scalar");
+    if (tokenize_signature(expected, sizeof(expected)) != 0) {
+        printf("scalar tokenize failed\n");
+        return 1;
+    }
+
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+        if (json_simd_set_backend(backends[b]) != 0) {
+            printf("%s: unsupported\n", backends[b]);
+            continue;
+        }
+
+        for (int round = 0; round < 2000; round++) {
+            for (int i = 0; i < 64; i++) {
+                state = state * 1103515245 + 12345;
+                block[i] = alphabet[(state >> 16) % (sizeof(alphabet) - 1)];
+            }
+
+            json_block_masks_t got, want;
+            json_classify_block(block, &got);
+            json_simd_set_backend("scalar");
+            json_classify_block(block, &want);
+            json_simd_set_backend(backends[b]);
+
+            if (memcmp(&got, &want, sizeof(got)) != 0) {
+                printf("%s: classification mismatch\n", backends[b]);
+                return 1;
+            }
+        }
+
+        static char actual[8192];
+        if (tokenize_signature(actual, sizeof(actual)) != 0 || strcmp(actual, expected) != 0) {
+            printf("%s: token mismatch\n", backends[b]);
+            return 1;
+        }
+
+        json_object_t obj;
+        const char* json = "{\"a long key that spans more than thirty two bytes\": \"and a long value that also spans more than thirty two bytes\"}";
+        if (json_parse(json, strlen(json), &obj) != 0) {
+            printf("%s: parse failed\n", backends[b]);
+            return 1;
+        }
+        json_deinit(&obj);
+
+        // Random mixes of lead, continuation and ASCII bytes hit every UTF-8 error class at every offset
+        const unsigned char utf8_alphabet[] = { 'a', ' ', 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF, 0xC0, 0xC2, 0xDF,
+                                                0xE0, 0xE1, 0xED, 0xEF, 0xF0, 0xF4, 0xF5, 0xFF };
+        for (int round = 0; round < 20000; round++) {
+            unsigned char bytes[200];
+            state = state * 1103515245 + 12345;
+            size_t len = (state >> 16) % sizeof(bytes);
+            for (size_t i = 0; i < len; i++) {
+                state = state * 1103515245 + 12345;
+                // Mostly ASCII so long valid stretches, and errors deep into a block, are common
+                bytes[i] = (state >> 16) % 4 == 0 ? utf8_alphabet[(state >> 20) % sizeof(utf8_alphabet)] : 'a';
+            }
+
+            int got = string_parses(bytes, len);
+            json_simd_set_backend("scalar");
+            int want = string_parses(bytes, len);
+            json_simd_set_backend(backends[b]);
+
+            if (got != want) {
+                printf("%s: utf8 mismatch on a %zu byte string\n", backends[b], len);
+                return 1;
+            }
+        }
+
+        // Well formed text of every sequence length, straddling the 32 byte vector boundary
+        const char* text = "\"0123456789012345678901234567890caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 \xf4\x8f\xbf\xbf\"";
+        const char* broken[] = {
+            "\"01234567890123456789012345678901234567\xe2\x82\"",
+            "\"0123456789012345678901234567890\xf0\x9f\x98\"",
+            "\"0123456789012345678901234567890123456789\xed\xa0\x80\"",
+            "\"0123456789012345678901234567890123456789\xc1\xbf\"",
+        };
+        if (json_parse(text, strlen(text), &obj) != 0) {
+            printf("%s: valid utf8 rejected\n", backends[b]);
+            return 1;
+        }
+        json_deinit(&obj);
+        for (size_t i = 0; i < sizeof(broken) / sizeof(broken[0]); i++) {
+            if (json_parse(broken[i], strlen(broken[i]), &obj) == 0 || json_validate(broken[i], strlen(broken[i])) == 0) {
+                printf("%s: invalid utf8 %zu accepted\n", backends[b], i);
+                return 1;
+            }
+        }
+
+        printf("%s: ok\n", backends[b]);
+    }
+
+    return 0;
+}
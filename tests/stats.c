@@ -0,0 +1,115 @@
+#define JSON_ENABLE_STATS
+#include "../json.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    int phases[JSON_PHASE_COUNT][2];
+    size_t allocs;
+    size_t bytes;
+} hook_log_t;
+
+static void on_phase(void* ctx, json_phase_t phase, int end) {
+    ((hook_log_t*)ctx)->phases[phase][end]++;
+}
+
+static void on_alloc(void* ctx, void* ptr, size_t size) {
+    hook_log_t* log = ctx;
+    if (ptr != NULL) {
+        log->allocs++;
+        log->bytes += size;
+    }
+}
+
+int main () {
+    int failed = 0;
+
+    const char* json = "{\"name\": \"Teller\", \"tags\": [\"a\", [1, [2, {\"deep\": true}]]], \"age\": 7, \"none\": null}";
+    size_t len = strlen(json);
+
+    hook_log_t log;
+    memset(&log, 0, sizeof(log));
+
+    json_parse_stats_t stats;
+    json_parse_stats_t_init(&stats);
+    stats.hooks.on_phase = on_phase;
+    stats.hooks.on_alloc = on_alloc;
+    stats.hooks.ctx = &log;
+
+    json_parse_opts_t opts = { .stats = &stats };
+    json_object_t obj;
+    if (json_parse_ex(json, len, &obj, &opts) != 0) {
+        return 1;
+    }
+    json_deinit_stats(&obj, &stats);
+
+    printf("tokens %zu, bytes %zu, depth %zu, allocs %zu (%zu bytes), inserts %zu, max probe %zu\n", stats.tokens,
+           stats.bytes, stats.max_depth, stats.allocs, stats.alloc_bytes, stats.map_inserts, stats.max_probe);
+    printf("parse %llu ns, alloc %llu ns, deinit %llu ns\n", (unsigned long long)stats.ns[JSON_PHASE_PARSE],
+           (unsigned long long)stats.ns[JSON_PHASE_ALLOC], (unsigned long long)stats.ns[JSON_PHASE_DEINIT]);
+
+    // 12 values and 5 keys, the object holding "deep" is five levels down
+    if (stats.tokens != 17 || stats.bytes != len || stats.max_depth != 5 || stats.map_inserts != 5) {
+        printf("counters\n");
+        failed = 1;
+    }
+
+    size_t probes = 0;
+    for (size_t i = 0; i < JSON_STATS_PROBE_BUCKETS; i++) {
+        probes += stats.probe_histogram[i];
+    }
+    if (probes != stats.map_inserts || stats.max_probe == 0) {
+        printf("probe histogram\n");
+        failed = 1;
+    }
+
+    // Every map, array, string and key copy is an allocation, before counting the buffers behind them
+    if (stats.allocs < 12 || stats.allocs != log.allocs || stats.alloc_bytes != log.bytes) {
+        printf("allocations\n");
+        failed = 1;
+    }
+
+    if (log.phases[JSON_PHASE_PARSE][0] != 1 || log.phases[JSON_PHASE_PARSE][1] != 1 ||
+        log.phases[JSON_PHASE_DEINIT][0] != 1 || log.phases[JSON_PHASE_DEINIT][1] != 1 ||
+        log.phases[JSON_PHASE_ALLOC][0] != 0) {
+        printf("phase hooks\n");
+        failed = 1;
+    }
+
+    if (stats.ns[JSON_PHASE_PARSE] == 0 || stats.ns[JSON_PHASE_ALLOC] > stats.ns[JSON_PHASE_PARSE]) {
+        printf("timings\n");
+        failed = 1;
+    }
+
+    // Counters add up across parses, arena allocations count too
+    json_parse_stats_t before = stats;
+    json_arena_t arena;
+    json_arena_t_init(&arena);
+    opts.arena = &arena;
+    if (json_parse_ex(json, len, &obj, &opts) != 0 || stats.tokens != 2 * before.tokens || stats.bytes != 2 * len ||
+        stats.allocs <= before.allocs) {
+        printf("accumulate\n");
+        failed = 1;
+    }
+    json_arena_t_deinit(&arena);
+    opts.arena = NULL;
+
+    // A failed parse reports how far it got
+    json_parse_stats_t_init(&stats);
+    const char* bad = "[1, 2, {\"a\": x}]";
+    if (json_parse_ex(bad, strlen(bad), &obj, &opts) >= 0 || stats.bytes != 13 || stats.max_depth != 2) {
+        printf("failed parse: %zu bytes, depth %zu\n", stats.bytes, stats.max_depth);
+        failed = 1;
+    }
+
+    // Parses without stats record nothing, even with stats enabled
+    json_parse_stats_t_init(&stats);
+    json_parse(json, len, &obj);
+    json_deinit_stats(&obj, NULL);
+    if (stats.tokens != 0 || stats.allocs != 0 || stats.map_inserts != 0) {
+        printf("recorded without stats\n");
+        failed = 1;
+    }
+
+    return failed;
+}
@@ -0,0 +1,160 @@
+#include "../json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main () {
+    int failed = 0;
+
+    const char* json = "{\"name\":\"Teller\",\"quote\":\"say \\\"hi\\\"\\n caf\\u00e9\",\"age\":7,\"score\":12.25,"
+                       "\"tags\":[\"a\",[],{}],\"ok\":true,\"none\":null,\"nested\":{\"deep\":[1,[2,[3]]],\"x\":false},\"last\":-1}";
+
+    json_tape_t tape;
+    json_tape_t_init(&tape);
+    if (json_tape_t_parse(&tape, json, strlen(json)) != 0) {
+        return 1;
+    }
+    printf("Tape: %zu entries, %zu string bytes\n", tape.len, tape.strings_len);
+
+    json_tape_ref_t root = json_tape_t_root(&tape);
+    if (json_tape_ref_t_tag(root) != OBJECT || json_tape_ref_t_len(root) != 9) {
+        return 1;
+    }
+
+    // Lookups hop over the nested containers before them
+    json_tape_ref_t val;
+    int64_t i;
+    double d;
+    int b;
+    size_t len;
+
+    if (json_tape_ref_t_get(root, "last", &val) != 0 || json_tape_ref_t_int64(val, &i) != 0 || i != -1) {
+        printf("last\n");
+        failed = 1;
+    }
+
+    if (json_tape_ref_t_get(root, "score", &val) != 0 || json_tape_ref_t_double(val, &d) != 0 || d != 12.25 ||
+        json_tape_ref_t_int64(val, &i) == 0) {
+        printf("score\n");
+        failed = 1;
+    }
+
+    if (json_tape_ref_t_get(root, "quote", &val) != 0 ||
+        strcmp(json_tape_ref_t_string(val, &len), "say \"hi\"\n caf\xc3\xa9") != 0 || len != 15) {
+        printf("quote\n");
+        failed = 1;
+    }
+
+    if (json_tape_ref_t_get(root, "ok", &val) != 0 || json_tape_ref_t_boolean(val, &b) != 0 || b != 1 ||
+        json_tape_ref_t_get(root, "none", &val) != 0 || json_tape_ref_t_tag(val) != NULL_VAL) {
+        printf("literals\n");
+        failed = 1;
+    }
+
+    if (json_tape_ref_t_get(root, "missing", &val) != UNEXPECTED_TOKEN ||
+        json_tape_ref_t_get_n(root, "nam", 3, &val) != UNEXPECTED_TOKEN) {
+        printf("missing key found\n");
+        failed = 1;
+    }
+
+    // Arrays index through the same hops
+    json_tape_ref_t nested, deep, inner;
+    if (json_tape_ref_t_get(root, "nested", &nested) != 0 || json_tape_ref_t_get(nested, "deep", &deep) != 0 ||
+        json_tape_ref_t_len(deep) != 2 || json_tape_ref_t_at(deep, 1, &inner) != 0 ||
+        json_tape_ref_t_at(inner, 1, &inner) != 0 || json_tape_ref_t_at(inner, 0, &inner) != 0 ||
+        json_tape_ref_t_int64(inner, &i) != 0 || i != 3) {
+        printf("nested\n");
+        failed = 1;
+    }
+
+    if (json_tape_ref_t_at(deep, 2, &val) != INDEX_GREATER_THAN_LEN || json_tape_ref_t_at(root, 0, &val) != UNEXPECTED_TOKEN) {
+        printf("bad index\n");
+        failed = 1;
+    }
+
+    // Iteration yields members in document order
+    const char* keys[] = { "name", "quote", "age", "score", "tags", "ok", "none", "nested", "last" };
+    json_tape_iter_t it;
+    const char* key;
+    size_t n = 0;
+    json_tape_iter_t_init(&it, root);
+    while (json_tape_iter_t_next(&it, &key, &len, &val)) {
+        if (n >= 9 || strcmp(key, keys[n]) != 0 || len != strlen(keys[n])) {
+            printf("member %zu\n", n);
+            failed = 1;
+        }
+        n++;
+    }
+    if (n != 9) {
+        failed = 1;
+    }
+
+    json_tape_ref_t tags;
+    json_tape_ref_t_get(root, "tags", &tags);
+    value_tag_t tag_types[] = { STRING, ARRAY, OBJECT };
+    n = 0;
+    json_tape_iter_t_init(&it, tags);
+    while (json_tape_iter_t_next(&it, &key, NULL, &val)) {
+        if (key != NULL || json_tape_ref_t_tag(val) != tag_types[n] || (n > 0 && json_tape_ref_t_len(val) != 0)) {
+            failed = 1;
+        }
+        n++;
+    }
+    if (n != 3) {
+        failed = 1;
+    }
+
+    // Converting back gives the same tree the pointer parser builds
+    json_object_t direct, converted;
+    char *a, *c;
+    json_parse(json, strlen(json), &direct);
+    if (json_tape_ref_t_to_object(root, &converted, NULL) != 0) {
+        return 1;
+    }
+    json_write(&direct, 0, &a, NULL);
+    json_write(&converted, 0, &c, NULL);
+    printf("%s\n", c);
+    if (strcmp(a, c) != 0) {
+        printf("converted tree differs\n");
+        failed = 1;
+    }
+    JSON_FREE(c);
+    json_deinit(&converted);
+
+    json_arena_t arena;
+    json_arena_t_init(&arena);
+    if (json_tape_ref_t_to_object(nested, &converted, &arena) != 0 || json_write(&converted, 0, &c, NULL) != 0 ||
+        strcmp(c, "{\"deep\":[1,[2,[3]]],\"x\":false}") != 0) {
+        printf("arena conversion\n");
+        failed = 1;
+    }
+    JSON_FREE(c);
+    json_arena_t_deinit(&arena);
+    JSON_FREE(a);
+    json_deinit(&direct);
+
+    // A scalar document, and a reparse reusing the buffers
+    if (json_tape_t_parse(&tape, " 42 ", 4) != 0 || tape.len != 2 ||
+        json_tape_ref_t_int64(json_tape_t_root(&tape), &i) != 0 || i != 42) {
+        printf("scalar root\n");
+        failed = 1;
+    }
+
+    // A one entry tape has nothing after its root to misread as a number
+    if (json_tape_t_parse(&tape, "null", 4) != 0 || tape.len != 1 || json_tape_ref_t_double(json_tape_t_root(&tape), &d) != UNEXPECTED_TOKEN) {
+        printf("null root read as a number\n");
+        failed = 1;
+    }
+
+    // Malformed input leaves an empty tape
+    const char* invalid[] = { "", "{", "[1,]", "{\"a\" 1}", "[1}", "\"bad \\x\"", "{\"\\q\":1}", "{} x" };
+    for (size_t k = 0; k < sizeof(invalid) / sizeof(invalid[0]); k++) {
+        if (json_tape_t_parse(&tape, invalid[k], strlen(invalid[k])) >= 0 || tape.len != 0) {
+            printf("accepted %s\n", invalid[k]);
+            failed = 1;
+        }
+    }
+
+    json_tape_t_deinit(&tape);
+    return failed;
+}
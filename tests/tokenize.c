@@ -7,7 +7,7 @@ int main() {
     char* src = "{\"foo\": null}";
     tokenize_json(src, 13, &t);
 
-    for (int i = 0; i < t.len; i++) {
+    for (size_t i = 0; i < t.len; i++) {
         token_t_print(&t.items[i]);
         // token_t_src_print(&t.items[i]);
     }
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t heap_allocs = 0;
+
+static void* counting_malloc(size_t size) {
+    heap_allocs++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ptr, size_t size) {
+    heap_allocs++;
+    return realloc(ptr, size);
+}
+
+#define JSON_MALLOC(size) counting_malloc(size)
+#define JSON_REALLOC(ptr, size) counting_realloc(ptr, size)
+
+#include "../json.h"
+
+static const char* valid[] = {
+    "{\"person\":{\"name\": \"Teller\", \"age\":7}, \"is_awesome\":true}",
+    "[1, -0, 0.5, -1.25e+10, 3E-2, 12345678901234567890123]",
+    "\"say \\\"hi\\\"\\n\\t\\/\\\\\\b\\f\\r\"",
+    "\"caf\\u00e9 \\ud83d\\ude00\"",
+    "\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 \xef\xbf\xbf\"",
+    "  [ [] , {} , [ { } ] ]  ",
+    "null",
+    "-12",
+    "{\"\\u0061\": [true, false, null]}",
+};
+
+static const char* invalid[] = {
+    "",
+    "   ",
+    "{\"a\": 1,}",
+    "[1, 2",
+    "[1 2]",
+    "{\"a\" 1}",
+    "{1: 2}",
+    "01",
+    "1.",
+    "-",
+    "1e",
+    "trueish",
+    "nul",
+    "[1] x",
+    "\"unterminated",
+    "\"bad \\x escape\"",
+    "\"short \\u12\"",
+    "\"lone high \\ud83d\"",
+    "\"lone low \\ude00\"",
+    "\"raw \n newline\"",
+    "\"stray \x80 continuation\"",
+    "\"overlong \xc0\xaf\"",
+    "\"overlong \xe0\x80\xaf\"",
+    "\"surrogate \xed\xa0\x80\"",
+    "\"too big \xf4\x90\x80\x80\"",
+    "\"truncated \xe2\x82\"",
+    "[}",
+    "{]",
+};
+
+int main () {
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        int rc = json_validate(valid[i], strlen(valid[i]));
+        if (rc != 0) {
+            printf("rejected valid %zu (%d): %s\n", i, rc, valid[i]);
+            failed = 1;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        if (json_validate(invalid[i], strlen(invalid[i])) >= 0) {
+            printf("accepted invalid %zu: %s\n", i, invalid[i]);
+            failed = 1;
+        }
+    }
+
+    // Nesting is limited by the fixed bit stack
+    size_t deep_len = JSON_VALIDATE_MAX_DEPTH + 1;
+    char* deep = malloc(deep_len * 2);
+    memset(deep, '[', deep_len);
+    memset(deep + deep_len, ']', deep_len);
+    if (json_validate(deep + 1, 2 * (deep_len - 1)) != 0 || json_validate(deep, 2 * deep_len) != DEPTH_LIMIT_EXCEEDED) {
+        printf("depth limit\n");
+        failed = 1;
+    }
+    free(deep);
+
+    // Nothing above touched the heap
+    heap_allocs = 0;
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        json_validate(valid[i], strlen(valid[i]));
+    }
+    if (heap_allocs != 0) {
+        printf("validation allocated %zu times\n", heap_allocs);
+        failed = 1;
+    }
+
+    return failed;
+}
@@ -0,0 +1,133 @@
+#include "../json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t rng_state = 0x5DEECE66Dull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// Collects sink output so it can be compared against the buffered writer
+typedef struct {
+    char data[4096];
+    size_t len;
+    int calls;
+} collected_t;
+
+static int collect(void* ctx, const char* data, size_t len) {
+    collected_t* c = ctx;
+    if (c->len + len > sizeof(c->data)) {
+        return 1;
+    }
+
+    memcpy(c->data + c->len, data, len);
+    c->len += len;
+    c->calls++;
+    return 0;
+}
+
+int main () {
+    int failed = 0;
+
+    const char* json = "{\"name\":\"Teller\",\"quote\":\"say \\\"hi\\\"\\n\\ttab \\u0001 caf\\u00e9\",\"age\":7,\"score\":12.25,"
+                       "\"tags\":[\"a\",[],{}],\"ok\":true,\"none\":null,\"big\":-9223372036854775808,\"tiny\":1e-7}";
+    json_object_t obj;
+    if (json_parse(json, strlen(json), &obj) != 0) {
+        return 1;
+    }
+
+    // Compact output only differs from the input where escapes and numbers have a canonical spelling
+    char* out;
+    size_t len;
+    if (json_write(&obj, 0, &out, &len) != 0 || len != strlen(out)) {
+        return 1;
+    }
+    printf("%s\n", out);
+
+    const char* expected = "{\"name\":\"Teller\",\"quote\":\"say \\\"hi\\\"\\n\\ttab \\u0001 caf\xc3\xa9\",\"age\":7,\"score\":12.25,"
+                           "\"tags\":[\"a\",[],{}],\"ok\":true,\"none\":null,\"big\":-9223372036854775808,\"tiny\":1e-7}";
+    if (strcmp(out, expected) != 0) {
+        printf("compact output differs\n");
+        failed = 1;
+    }
+
+    // And reads back into the same document
+    json_object_t again;
+    char* twice;
+    if (json_parse(out, len, &again) != 0 || json_write(&again, 0, &twice, NULL) != 0 || strcmp(out, twice) != 0) {
+        printf("round trip differs\n");
+        failed = 1;
+    }
+    json_deinit(&again);
+    JSON_FREE(twice);
+    JSON_FREE(out);
+
+    // Pretty output, and the same bytes through a sink
+    json_object_t* tags = json_object_map_t_get(obj.val.obj, "tags");
+    json_write(tags, JSON_WRITE_PRETTY, &out, &len);
+    printf("%s\n", out);
+    if (strcmp(out, "[\n    \"a\",\n    [],\n    {}\n]") != 0) {
+        failed = 1;
+    }
+    JSON_FREE(out);
+
+    json_write(&obj, JSON_WRITE_PRETTY, &out, &len);
+    collected_t collected = { { 0 }, 0, 0 };
+    json_writer_t w;
+    json_writer_t_init_sink(&w, JSON_WRITE_PRETTY, collect, &collected);
+    if (json_writer_t_write(&w, &obj) != 0 || collected.len != len || memcmp(collected.data, out, len) != 0) {
+        printf("sink output differs\n");
+        failed = 1;
+    }
+    json_writer_t_deinit(&w);
+    JSON_FREE(out);
+    json_deinit(&obj);
+
+    // Doubles are written in a form that reads back to the exact same bits
+    const char* fixed[] = { "0.1", "-0.0", "5e-324", "1.7976931348623157e308", "2.2250738585072014e-308", "123456789012345680000.0", "1e21", "0.000001", "1e-7" };
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        json_object_t num = { NUMBER, { .number = strtod(fixed[i], NULL) } };
+        json_write(&num, 0, &out, NULL);
+        double back = strtod(out, NULL);
+        printf("%s -> %s\n", fixed[i], out);
+        if (memcmp(&back, &num.val.number, sizeof(back)) != 0) {
+            failed = 1;
+        }
+        JSON_FREE(out);
+    }
+
+    // Grisu2 wrote an extra digit for these, Grisu3 can't settle them and they go through the exact fallback
+    const char* shortest[][2] = { { "2.7183163742986588e276", "2.718316374298659e276" }, { "30892612233637952", "30892612233637950.0" } };
+    for (size_t i = 0; i < sizeof(shortest) / sizeof(shortest[0]); i++) {
+        json_object_t num = { NUMBER, { .number = strtod(shortest[i][0], NULL) } };
+        json_write(&num, 0, &out, NULL);
+        if (strcmp(out, shortest[i][1]) != 0) {
+            printf("%s -> %s, expected %s\n", shortest[i][0], out, shortest[i][1]);
+            failed = 1;
+        }
+        JSON_FREE(out);
+    }
+
+    for (int i = 0; i < 200000; i++) {
+        uint64_t bits = next_random();
+        json_object_t num;
+        num.tag = NUMBER;
+        memcpy(&num.val.number, &bits, sizeof(double));
+        if (num.val.number != num.val.number || num.val.number - num.val.number != 0) continue;
+
+        json_write(&num, 0, &out, &len);
+        double back = strtod(out, NULL);
+        if (memcmp(&back, &num.val.number, sizeof(back)) != 0) {
+            printf("%s does not read back as %.17g\n", out, num.val.number);
+            failed = 1;
+        }
+        JSON_FREE(out);
+    }
+
+    return failed;
+}